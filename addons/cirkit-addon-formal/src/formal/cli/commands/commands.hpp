@@ -38,6 +38,7 @@
 
 #include <formal/cli/commands/exact_mig.hpp>
 #include <formal/cli/commands/exact_xmg.hpp>
+#include <formal/cli/commands/exactdb.hpp>
 #include <formal/cli/commands/xmglut.hpp>
 #include <formal/cli/commands/xmgmine.hpp>
 
@@ -45,6 +46,7 @@
   cli.set_category( "Synthesis" ); \
   ADD_COMMAND( exact_mig );        \
   ADD_COMMAND( exact_xmg );        \
+  ADD_COMMAND( exactdb );          \
   ADD_COMMAND( xmglut );           \
   ADD_COMMAND( xmgmine );
 
@@ -26,6 +26,8 @@
 
 #include "exact_mig.hpp"
 
+#include <vector>
+
 #include <boost/format.hpp>
 #include <boost/optional.hpp>
 
@@ -63,7 +65,9 @@ exact_mig_command::exact_mig_command( const environment::ptr& env )
     ( "start_depth",       value_with_default( &start_depth ), "start value for depth enumeration" )
     ( "mig,m",                                                 "load spec from MIG instead of truth table" )
     ( "incremental,i",                                         "incremental SAT solving" )
-    ( "all_solutions,a",                                       "enumerate all solutions (only with non incremental)" )
+    ( "portfolio,p",                                           "solve encodings and gate counts concurrently (only for size-optimum)" )
+    ( "threads",           value_with_default( &threads ),     "number of threads for portfolio (0: one per core)" )
+    ( "all_solutions,a",                                       "enumerate all solutions" )
     ( "breaking",          value_with_default( &breaking ),    "symmetry breaking\ns: structural hashing\na: associativity\nl: co-lexicographic ordering\nt: support\ny: symmetric variables" )
     ( "print_solutions",                                       "print solutions" )
     ( "enc_int",                                               "encode numbers as integers (not bit-vectors)" )
@@ -83,6 +87,8 @@ bool exact_mig_command::execute()
   settings->set( "start",               start );
   settings->set( "start_depth",         start_depth );
   settings->set( "incremental",         is_set( "incremental" ) );
+  settings->set( "portfolio",           is_set( "portfolio" ) );
+  settings->set( "num_threads",         threads );
   settings->set( "all_solutions",       is_set( "all_solutions" ) );
   settings->set( "breaking",            breaking );
   settings->set( "enc_with_bitvectors", !is_set( "enc_int" ) );
@@ -142,6 +148,15 @@ bool exact_mig_command::execute()
   print_runtime();
   std::cout << format( "[i] memory: %.2f MB" ) % statistics->get<double>( "memory" ) << std::endl;
 
+  if ( is_verbose() )
+  {
+    const auto& solve_times = statistics->get<std::vector<double>>( "solve_times" );
+    for ( auto i = 0u; i < solve_times.size(); ++i )
+    {
+      std::cout << format( "[i] solver call %d: %.2f seconds" ) % ( i + 1u ) % solve_times[i] << std::endl;
+    }
+  }
+
   return true;
 }
 
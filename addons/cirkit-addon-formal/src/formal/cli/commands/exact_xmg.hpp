@@ -56,6 +56,7 @@ private:
   unsigned              objective = 0u;
   unsigned              start = 1u;
   unsigned              timeout;
+  unsigned              threads = 0u;
   std::string           breaking = "CIsalty";
 };
 
@@ -0,0 +1,205 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "exactdb.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/format.hpp>
+#include <boost/program_options.hpp>
+
+#include <alice/rules.hpp>
+#include <core/utils/bitset_utils.hpp>
+#include <core/utils/conversion_utils.hpp>
+#include <core/utils/program_options.hpp>
+#include <core/utils/string_utils.hpp>
+#include <classical/utils/exact_db.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <formal/synthesis/exact_db_generate.hpp>
+
+using namespace boost::program_options;
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+exactdb_command::exactdb_command( const environment::ptr& env )
+  : cirkit_command( env, "Exact synthesis database" )
+{
+  opts.add_options()
+    ( "filename,f", value( &filename ),                "database file (created if it does not exist)" )
+    ( "basis,b",    value_with_default( &basis ),      "gate basis: mig, xmg, or aig" )
+    ( "generate,g", value( &generate ),                "compute entries for all NPN classes with this number of variables (at most 4)" )
+    ( "lut_file",   value( &lut_file ),                "compute entries for the NPN classes of the truth tables in binary form in each line of this file" )
+    ( "import",     value( &import_file ),             "add entries from library file with lines '0x<npn> <expression>'" )
+    ( "export",     value( &export_file ),             "write entries of basis to library file" )
+    ( "threads",    value_with_default( &threads ),    "number of threads (0: one per core)" )
+    ( "timeout,t",  value( &timeout ),                 "timeout in seconds for each class" )
+    ( "capacity",   value_with_default( &capacity ),   "number of entries (only for new databases)" )
+    ;
+  be_verbose();
+}
+
+command::rules_t exactdb_command::validity_rules() const
+{
+  return {
+    {[this]() { return is_set( "filename" ); }, "filename needs to be set" },
+    {[this]() { return basis == "mig" || basis == "xmg" || basis == "aig"; }, "basis must be mig, xmg, or aig" },
+    {[this]() { return !is_set( "generate" ) || generate <= 4u; }, "generate supports at most 4 variables" },
+    {[this]() { return !( is_set( "generate" ) || is_set( "lut_file" ) ) || basis != "aig"; }, "exact synthesis is not available for AIGs" },
+    file_exists_if_set( *this, lut_file, "lut_file" ),
+    file_exists_if_set( *this, import_file, "import" )
+  };
+}
+
+bool exactdb_command::execute()
+{
+  using boost::format;
+
+  exact_db::ptr db;
+  try
+  {
+    db = std::make_shared<exact_db>( filename, capacity );
+  }
+  catch ( const char* e )
+  {
+    std::cerr << e << std::endl;
+    return true;
+  }
+
+  const auto b = exact_db_basis_from_name( basis );
+
+  if ( is_set( "import" ) )
+  {
+    std::ifstream in( import_file.c_str(), std::ifstream::in );
+    std::string line;
+    auto added = 0u;
+
+    while ( getline( in, line ) )
+    {
+      boost::trim( line );
+      if ( line.empty() ) { continue; }
+
+      const auto p = split_string_pair( line, " " );
+      const tt npn( convert_hex2bin( p.first.substr( 2u ) ) );
+
+      if ( !db->contains( b, npn ) && db->insert( b, npn, exact_db_make_entry( b, p.second ) ) )
+      {
+        ++added;
+      }
+    }
+
+    std::cout << format( "[i] imported %d entries" ) % added << std::endl;
+  }
+
+  if ( is_set( "generate" ) || is_set( "lut_file" ) )
+  {
+    std::vector<tt> functions;
+
+    if ( is_set( "generate" ) )
+    {
+      tt t( 1u << generate );
+      do
+      {
+        functions.push_back( t );
+        inc( t );
+      } while ( t.any() );
+    }
+
+    if ( is_set( "lut_file" ) )
+    {
+      std::ifstream in( lut_file.c_str(), std::ifstream::in );
+      std::string line;
+
+      while ( getline( in, line ) )
+      {
+        boost::trim( line );
+        if ( line.empty() ) { continue; }
+        functions.push_back( tt( line ) );
+      }
+    }
+
+    auto settings = make_settings();
+    settings->set( "num_threads", threads );
+    if ( is_set( "timeout" ) )
+    {
+      settings->set( "timeout", boost::optional<unsigned>( timeout ) );
+    }
+
+    const auto added = exact_db_generate( *db, b, functions, settings, statistics );
+
+    std::cout << format( "[i] classes: %d, already stored: %d, added: %d, failed: %d" )
+      % statistics->get<unsigned>( "num_classes" ) % statistics->get<unsigned>( "skipped" ) % added % statistics->get<unsigned>( "failed" ) << std::endl;
+    print_runtime();
+  }
+
+  if ( is_set( "export" ) )
+  {
+    std::ofstream os( export_file.c_str(), std::ofstream::out );
+    db->foreach_entry( [&os, b]( exact_db_basis eb, const tt& npn, const exact_db_entry& entry ) {
+        if ( eb == b )
+        {
+          os << "0x" << tt_to_hex( npn ) << " " << entry.expression << std::endl;
+        }
+      } );
+  }
+
+  /* summary */
+  std::map<exact_db_basis, unsigned> counts;
+  db->foreach_entry( [&counts]( exact_db_basis eb, const tt& npn, const exact_db_entry& entry ) { ++counts[eb]; } );
+
+  std::cout << format( "[i] entries: %d / %d, expressions: %d / %d bytes" ) % db->size() % db->capacity() % db->arena_size() % db->arena_capacity() << std::endl;
+  for ( const auto& p : counts )
+  {
+    std::cout << format( "[i] - %s: %d" ) % exact_db_basis_name( p.first ) % p.second << std::endl;
+  }
+
+  return true;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,75 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file exactdb.hpp
+ *
+ * @brief Exact synthesis database
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef CLI_EXACTDB_COMMAND_HPP
+#define CLI_EXACTDB_COMMAND_HPP
+
+#include <string>
+
+#include <core/cli/cirkit_command.hpp>
+
+namespace cirkit
+{
+
+class exactdb_command : public cirkit_command
+{
+public:
+  exactdb_command( const environment::ptr& env );
+
+protected:
+  rules_t validity_rules() const;
+  bool execute();
+
+private:
+  std::string filename;
+  std::string basis = "xmg";
+  unsigned    generate;
+  std::string lut_file;
+  std::string import_file;
+  std::string export_file;
+  unsigned    threads = 0u;
+  unsigned    timeout;
+  unsigned    capacity = 1u << 16u;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
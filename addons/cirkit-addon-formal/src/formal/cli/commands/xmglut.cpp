@@ -26,6 +26,8 @@
 
 #include "xmglut.hpp"
 
+#include <iostream>
+
 #include <boost/optional.hpp>
 #include <boost/program_options.hpp>
 
@@ -71,6 +73,8 @@ xmglut_command::xmglut_command( const environment::ptr& env )
     ( "noxor",                                       "don't use XOR, only works with LUT sizes up to 4" )
     ( "blif_name",  value( &blif_name ),             "read cover from BLIF instead of AIG" )
     ( "dump_luts",  value( &dump_luts ),             "if not empty, all LUTs will be written to file without performing mapping" )
+    ( "priority",   value( &priority ),              "with --xmg, keep at most this many cuts per node (faster, but not depth-optimal)" )
+    ( "npn_cache",  value( &npn_cache ),             "persistent NPN cache file for the LUT functions (created if it does not exist)" )
     ( "progress,p",                                  "show progress" )
     ;
   add_new_option();
@@ -96,6 +100,10 @@ bool xmglut_command::execute()
   settings->set( "lut_size", lut_size );
   settings->set( "noxor", is_set( "noxor" ) );
   settings->set( "progress", is_set( "progress" ) );
+  if ( is_set( "priority" ) )
+  {
+    settings->set( "priority", priority );
+  }
   if ( is_set( "dump_luts" ) )
   {
     settings->set( "npn", false );
@@ -105,6 +113,10 @@ bool xmglut_command::execute()
   {
     settings->set( "timeout", boost::optional<unsigned>( timeout ) );
   }
+  if ( is_set( "npn_cache" ) )
+  {
+    settings->set( "npn_cache", npn_cache );
+  }
 
   lut_graph_t lut;
   if ( is_set( "xmg" ) )
@@ -124,7 +136,16 @@ bool xmglut_command::execute()
     //const auto lut = abc_lut_mapping( aig(), lut_size, settings );
   }
 
-  const auto xmg = xmg_from_lut_mapping( lut, settings, statistics );
+  xmg_graph xmg;
+  try
+  {
+    xmg = xmg_from_lut_mapping( lut, settings, statistics );
+  }
+  catch ( const char* e )
+  {
+    std::cerr << e << std::endl;
+    return true;
+  }
 
   if ( !is_set( "dump_luts" ) )
   {
@@ -56,9 +56,11 @@ public:
 private:
   unsigned lut_size    = 6u;
   unsigned timeout;
+  unsigned priority;
   std::string map_cmd  = "&if -a -K %d";
   std::string blif_name;
   std::string dump_luts;
+  std::string npn_cache;
 };
 
 }
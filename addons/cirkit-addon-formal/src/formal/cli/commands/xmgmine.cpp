@@ -30,6 +30,7 @@
 #include <boost/program_options.hpp>
 
 #include <alice/rules.hpp>
+#include <core/utils/program_options.hpp>
 #include <classical/cli/stores.hpp>
 #include <formal/xmg/xmg_mine.hpp>
 #include <formal/xmg/xmg_minlib.hpp>
@@ -43,11 +44,13 @@ xmgmine_command::xmgmine_command( const environment::ptr& env )
   : cirkit_command( env, "Mine optimum XMGs" )
 {
   opts.add_options()
-    ( "lut_file",  value( &lut_file ), "filename with truth table in binary form in each line" )
-    ( "opt_file",  value( &opt_file ), "filename with optimum XMG database" )
-    ( "timeout,t", value( &timeout ),  "timeout in seconds (afterwards, heuristics are tried)" )
-    ( "add,a",                         "add current XMG to database" )
-    ( "verify",                        "verifies entries in optimum XMG database" )
+    ( "lut_file",  value( &lut_file ),              "filename with truth table in binary form in each line" )
+    ( "opt_file",  value( &opt_file ),              "filename with optimum XMG database" )
+    ( "timeout,t", value( &timeout ),               "timeout in seconds (afterwards, heuristics are tried)" )
+    ( "threads",   value_with_default( &threads ), "number of threads for exact synthesis (0: one per core)" )
+    ( "database",  value( &database ),              "exact synthesis database (see exactdb), consulted before and filled by exact synthesis" )
+    ( "add,a",                                      "add current XMG to database" )
+    ( "verify",                                     "verifies entries in optimum XMG database" )
     ;
   be_verbose();
 }
@@ -115,6 +118,11 @@ bool xmgmine_command::execute()
     {
       settings->set( "timeout", boost::optional<unsigned>( timeout ) );
     }
+    settings->set( "num_threads", threads );
+    if ( is_set( "database" ) )
+    {
+      settings->set( "database", database );
+    }
     xmg_mine( lut_file, opt_file, settings );
   }
 
@@ -55,7 +55,9 @@ protected:
 private:
   std::string lut_file;
   std::string opt_file;
+  std::string database;
   unsigned    timeout;
+  unsigned    threads = 1u;
 };
 
 }
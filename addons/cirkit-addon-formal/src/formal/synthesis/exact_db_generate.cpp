@@ -0,0 +1,230 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "exact_db_generate.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+#include <boost/format.hpp>
+#include <boost/optional.hpp>
+
+#include <core/utils/thread_pool.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/functions/npn_canonization.hpp>
+#include <classical/mig/mig_from_string.hpp>
+#include <classical/mig/mig_utils.hpp>
+#include <classical/utils/expression_parser.hpp>
+#include <classical/xmg/xmg_expr.hpp>
+#include <classical/xmg/xmg_string.hpp>
+#include <classical/xmg/xmg_utils.hpp>
+#include <formal/synthesis/exact_mig.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+exact_db_entry make_entry( const mig_graph& mig )
+{
+  const auto& info = mig_info( mig );
+
+  exact_db_entry entry;
+  entry.size = boost::num_vertices( mig ) - info.inputs.size() - 1u;
+  compute_levels( mig, entry.depth );
+  entry.expression = mig_to_string( mig, info.outputs.front().first );
+  return entry;
+}
+
+exact_db_entry make_entry( const xmg_graph& xmg )
+{
+  exact_db_entry entry;
+  entry.size = xmg.num_gates();
+  entry.depth = compute_depth( xmg );
+  entry.expression = expression_to_string( xmg_to_expression( xmg, xmg.outputs().front().first ) );
+  return entry;
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+exact_db_entry exact_db_make_entry( exact_db_basis basis, const std::string& expression )
+{
+  exact_db_entry entry;
+
+  if ( basis == exact_db_basis::mig )
+  {
+    entry = make_entry( mig_from_string( expression ) );
+  }
+  else
+  {
+    /* AIG expressions are XMG expressions without MAJ and XOR */
+    entry = make_entry( xmg_from_string( expression ) );
+  }
+
+  /* keep the expression as given */
+  entry.expression = expression;
+  return entry;
+}
+
+unsigned exact_db_generate( exact_db& db, exact_db_basis basis, const std::vector<tt>& functions,
+                            const properties::ptr& settings,
+                            const properties::ptr& statistics )
+{
+  /* settings */
+  auto num_threads = get( settings, "num_threads", 0u );
+  const auto timeout     = get( settings, "timeout",     boost::optional<unsigned>() );
+  const auto verbose     = get( settings, "verbose",     false );
+
+  /* timing */
+  properties_timer t( statistics );
+
+  if ( basis == exact_db_basis::aig )
+  {
+    throw "Error: exact synthesis is not available for AIGs";
+  }
+
+  /* distinct NPN classes that are not stored yet */
+  std::set<std::pair<unsigned, unsigned long>> seen;
+  std::vector<tt> classes;
+  auto skipped = 0u, failed = 0u;
+
+  for ( const auto& f : functions )
+  {
+    if ( !exact_db::is_storable( f ) )
+    {
+      ++failed;
+      continue;
+    }
+
+    boost::dynamic_bitset<> phase;
+    std::vector<unsigned> perm;
+    const auto npn = exact_npn_canonization_fast( f, phase, perm );
+
+    if ( !seen.insert( {npn.size(), npn.to_ulong()} ).second ) { continue; }
+
+    if ( db.contains( basis, npn ) )
+    {
+      ++skipped;
+    }
+    else
+    {
+      classes.push_back( npn );
+    }
+  }
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] %d classes, %d already stored, %d to compute" ) % seen.size() % skipped % classes.size() << std::endl;
+  }
+
+  /* exact synthesis, each result is stored immediately */
+  std::mutex mutex;
+  auto added = 0u;
+
+  const auto compute = [&]( unsigned i ) {
+    auto es_settings = std::make_shared<properties>();
+    es_settings->set( "timeout", timeout );
+
+    boost::optional<exact_db_entry> entry;
+    if ( basis == exact_db_basis::mig )
+    {
+      const auto mig = exact_mig_with_sat( classes[i], es_settings );
+      if ( (bool)mig ) { entry = make_entry( *mig ); }
+    }
+    else
+    {
+      const auto xmg = exact_xmg_with_sat( classes[i], es_settings );
+      if ( (bool)xmg ) { entry = make_entry( *xmg ); }
+    }
+
+    const auto stored = (bool)entry && db.insert( basis, classes[i], *entry );
+
+    std::lock_guard<std::mutex> lock( mutex );
+    if ( stored )
+    {
+      ++added;
+    }
+    else
+    {
+      ++failed;
+    }
+
+    if ( verbose )
+    {
+      if ( stored )
+      {
+        std::cout << boost::format( "[i] 0x%s %s (size %d, depth %d)" ) % tt_to_hex( classes[i] ) % entry->expression % entry->size % entry->depth << std::endl;
+      }
+      else
+      {
+        std::cout << boost::format( "[w] no entry for 0x%s" ) % tt_to_hex( classes[i] ) << std::endl;
+      }
+    }
+  };
+
+  if ( num_threads == 0u )
+  {
+    num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  }
+
+  if ( num_threads == 1u )
+  {
+    for ( auto i = 0u; i < classes.size(); ++i )
+    {
+      compute( i );
+    }
+  }
+  else
+  {
+    thread_pool pool( num_threads - 1u );
+    pool.parallel_for( 0u, static_cast<unsigned>( classes.size() ), compute, 1u );
+  }
+
+  set( statistics, "num_classes", static_cast<unsigned>( seen.size() ) );
+  set( statistics, "skipped",     skipped );
+  set( statistics, "failed",      failed );
+
+  return added;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,83 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file exact_db_generate.hpp
+ *
+ * @brief Fills exact synthesis databases
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef EXACT_DB_GENERATE_HPP
+#define EXACT_DB_GENERATE_HPP
+
+#include <string>
+#include <vector>
+
+#include <core/properties.hpp>
+#include <classical/utils/exact_db.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+namespace cirkit
+{
+
+/**
+ * @brief Computes optimum circuits for NPN classes and stores them in db
+ *
+ * The functions are NPN canonized, and exact synthesis is applied to all
+ * classes that are not yet stored for basis in db.  Since every result is
+ * stored as soon as it is found, an interrupted run continues where it
+ * stopped when called again.  Exact synthesis is available for the MIG
+ * and XMG bases.  Returns the number of added entries.
+ *
+ * Settings:
+ *   num_threads (unsigned)                  : number of threads, 0 for one per core (0)
+ *   timeout     (boost::optional<unsigned>) : timeout in seconds for each class (none)
+ *   verbose     (bool)                      : be verbose (false)
+ *
+ * Statistics:
+ *   runtime, num_classes, skipped (already stored), failed (timeout or database full)
+ */
+unsigned exact_db_generate( exact_db& db, exact_db_basis basis, const std::vector<tt>& functions,
+                            const properties::ptr& settings = properties::ptr(),
+                            const properties::ptr& statistics = properties::ptr() );
+
+/**
+ * @brief Computes size and depth of an expression in the given basis
+ */
+exact_db_entry exact_db_make_entry( exact_db_basis basis, const std::string& expression );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
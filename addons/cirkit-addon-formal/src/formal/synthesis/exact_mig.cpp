@@ -26,8 +26,14 @@
 
 #include "exact_mig.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <limits>
+#include <list>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
@@ -37,12 +43,15 @@
 #include <boost/variant.hpp>
 
 #include <core/utils/range_utils.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/mig/mig_from_string.hpp>
 #include <classical/mig/mig_utils.hpp>
 #include <classical/utils/spec_representation.hpp>
 
 #ifdef ADDON_FORMAL
+#include <formal/synthesis/exact_simulation.hpp>
+#include <formal/utils/z3_assumptions.hpp>
 #include <formal/utils/z3_utils.hpp>
 #include <z3++.h>
 #endif
@@ -393,7 +402,8 @@ struct exact_mig_instance
     num_vars( num_vars ),
     with_xor( with_xor ),
     enc_bv( enc_bv ),
-    solver( make_solver( expl ) )
+    solver( make_solver( expl ) ),
+    assumptions( ctx, solver )
   {
     auto upper_bound = 7u;
     if ( num_vars > 4u )
@@ -664,54 +674,22 @@ struct exact_mig_instance
 
   void constrain( const tt& spec )
   {
-    auto N = 1u << num_vars;
+    exact_constrain_levels( *this );
 
-    std::vector<std::vector<z3::expr>> out( N );
-    std::vector<std::vector<std::vector<z3::expr>>> in( 3u, std::vector<std::vector<z3::expr>>( N ) );
-
-    /* value constraints */
-    for ( auto j = 0u; j < N; ++j )
+    for ( auto j = 0u; j < sim_out.size(); ++j )
     {
-      for ( auto level = 0u; level < gates.size(); ++level )
-      {
-        out[j] += ctx.bool_const( str( format( "out_%d_%d" ) % j % level ).c_str() );
-        in[0u][j] += ctx.bool_const( str( format( "in1_%d_%d" ) % j % level ).c_str() );
-        in[1u][j] += ctx.bool_const( str( format( "in2_%d_%d" ) % j % level ).c_str() );
-        in[2u][j] += ctx.bool_const( str( format( "in3_%d_%d" ) % j % level ).c_str() );
-
-        /* assertion for out[j][level] = M(in1[j][level],in2[j][level],in3[j][level] */
-        if ( with_xor )
-        {
-          solver.add( out[j][level] == ( implies( !gates[level].type(), ( in[0u][j][level] && in[1u][j][level] ) || ( in[0u][j][level] && in[2u][j][level] ) || ( in[1u][j][level] && in[2u][j][level] ) )
-                                         && implies( gates[level].type(), logic_xor( in[0u][j][level], in[1u][j][level] ) ) ) );
-        }
-        else
-        {
-          solver.add( out[j][level] == ( ( in[0u][j][level] && in[1u][j][level] ) || ( in[0u][j][level] && in[2u][j][level] ) || ( in[1u][j][level] && in[2u][j][level] ) ) );
-        }
-
-        /* assertions for in[x][j][level] = neg[level] ^ ite( sel[level], ... ) */
-        boost::dynamic_bitset<> val( num_vars, j );
-        for ( auto x = 0u; x < 3u; ++x )
-        {
-          solver.add( implies( equals( gates[level][x].sel, 0 ),
-                               in[x][j][level] == logic_xor( gates[level][x].neg, ctx.bool_val( false ) ) ) );
+      solver.add( sim_out[j].back() == ctx.bool_val( spec[j] ) );
+    }
+  }
 
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            solver.add( implies( equals( gates[level][x].sel, l + 1 ),
-                                 in[x][j][level] == logic_xor( gates[level][x].neg, ctx.bool_val( val[l] ) ) ) );
-          }
-          for ( auto l = 0u; l < level; ++l )
-          {
-            solver.add( implies( equals( gates[level][x].sel, l + 1 + num_vars ),
-                                 in[x][j][level] == logic_xor( gates[level][x].neg, out[j][l] ) ) );
-          }
-        }
-      }
+  /* returns an activation literal that, when assumed, bounds the depth of the last gate */
+  z3::expr activate_depth( unsigned max_depth )
+  {
+    add_depth_variables();
 
-      solver.add( out[j].back() == ctx.bool_val( spec[j] ) );
-    }
+    const auto act = assumptions.new_literal();
+    solver.add( implies( act, less_equals( dvars[3u].back(), max_depth ) ) );
+    return act;
   }
 
   mig_graph extract_mig( const std::string& model_name, const std::string& output_name, bool invert, bool very_verbose )
@@ -865,13 +843,20 @@ struct exact_mig_instance
   }
 
   void add_depth_constraints( int max_depth )
+  {
+    add_depth_variables();
+    solver.add( less_equals( dvars[3u].back(), max_depth ) );
+  }
+
+  /* adds depth variables for all levels that do not have them yet */
+  void add_depth_variables()
   {
     const auto num_gates = gates.size();
 
     /* depth variables d[x][i], x = 0,1,2,3, i = 0,1,2,...,num_gates - 1 */
-    std::vector<std::vector<z3::expr>> dvars( 4u );
+    dvars.resize( 4u );
 
-    for ( auto i = 0u; i < num_gates; ++i )
+    for ( auto i = dvars[3u].size(); i < num_gates; ++i )
     {
       /* create variables, it's safe because of topological order */
       for ( auto x = 0u; x < 4u; ++x )
@@ -910,8 +895,6 @@ struct exact_mig_instance
         }
       }
     }
-
-    solver.add( less_equals( dvars[3u][num_gates - 1u], max_depth ) );
   }
 
   /* some helper methods */
@@ -973,6 +956,14 @@ struct exact_mig_instance
 
   unsigned bw;
 
+  /* per-minterm simulation and depth variables, kept across levels */
+  std::vector<std::vector<z3::expr>>              sim_out;
+  std::vector<std::vector<std::vector<z3::expr>>> sim_in;
+  std::vector<std::vector<z3::expr>>              dvars;
+
+  /* activation literals of the incremental session */
+  z3_assumptions assumptions;
+
   /* spec properties */
   boost::dynamic_bitset<>                    support;
   std::vector<std::pair<unsigned, unsigned>> symmetries;
@@ -999,6 +990,8 @@ public:
     start               = get( settings, "start",               1u );
     start_depth         = get( settings, "start_depth",         1u );
     incremental         = get( settings, "incremental",         false );
+    portfolio           = get( settings, "portfolio",           false );
+    num_threads         = get( settings, "num_threads",         0u );
     all_solutions       = get( settings, "all_solutions",       false );
 
     /* encoding */
@@ -1045,9 +1038,26 @@ public:
       spec.invert();
     }
 
-    if ( incremental )
+    if ( portfolio && objective == 0u && spec.is_explicit() )
     {
-      return exact_mig_size_incremental();
+      return exact_mig_size_portfolio();
+    }
+
+    /* a persistent solver session requires explicit value constraints */
+    if ( incremental && spec.is_explicit() )
+    {
+      switch ( objective )
+      {
+      case 0u:
+        return exact_mig_size_incremental();
+      case 1u:
+        return exact_mig_size_depth_incremental();
+      case 2u:
+        return exact_mig_depth_size_incremental();
+      default:
+        assert( false );
+        return std::vector<T>();
+      }
     }
     else
     {
@@ -1085,7 +1095,7 @@ public:
 
       constrain( inst );
 
-      const auto result = inst->solver.check();
+      const auto result = check( inst );
       if ( result == z3::sat )
       {
         store_memory( inst );
@@ -1137,7 +1147,7 @@ public:
       if ( d ) /* find best depth */
       {
         inst->add_depth_constraints( d );
-        const auto result = inst->solver.check();
+        const auto result = check( inst );
         if ( result == z3::sat )
         {
           store_memory( inst );
@@ -1153,7 +1163,7 @@ public:
       }
       else
       {
-        const auto result = inst->solver.check();
+        const auto result = check( inst );
         if ( result == z3::sat )
         {
           d = start_depth;
@@ -1196,7 +1206,7 @@ public:
         constrain( inst );
         inst->add_depth_constraints( d );
 
-        const auto result = inst->solver.check();
+        const auto result = check( inst );
         if ( result == z3::sat )
         {
           store_memory( inst );
@@ -1212,6 +1222,9 @@ public:
     }
   }
 
+  /* all incremental variants keep one solver session in which gates are added
+   * level by level; the constraints that depend on the number of gates or on
+   * the depth bound are only enabled by assumptions */
   std::vector<T> exact_mig_size_incremental()
   {
     const auto inst = create_instance();
@@ -1230,10 +1243,9 @@ public:
         std::cout << boost::format( "[i] check for realization with %d gates" ) % inst->gates.size() << std::endl;
       }
 
-      /* solve */
-      inst->solver.push();
-      constrain( inst );
-      const auto result = inst->solver.check();
+      inst->assumptions.set( {activate_output( inst )} );
+
+      const auto result = check( inst );
       if ( result == z3::sat )
       {
         store_memory( inst );
@@ -1244,10 +1256,344 @@ public:
         last_size = inst->gates.size();
         return std::vector<T>();
       }
-      inst->solver.pop();
     }
   }
 
+  std::vector<T> exact_mig_size_depth_incremental()
+  {
+    auto inst = create_instance();
+
+    for ( unsigned i = 1u; i < start; ++i )
+    {
+      inst->add_level( symmetry_breaking );
+    }
+
+    /* find best size */
+    while ( true )
+    {
+      inst->add_level( symmetry_breaking );
+
+      if ( verbose )
+      {
+        std::cout << boost::format( "[i] check for realization with %d gates" ) % inst->gates.size() << std::endl;
+      }
+
+      inst->assumptions.set( {activate_output( inst )} );
+
+      const auto result = check( inst );
+      if ( result == z3::sat )
+      {
+        break;
+      }
+      else if ( result == z3::unknown && !timeout_heuristic )
+      {
+        return std::vector<T>();
+      }
+    }
+
+    /* find best depth; associativity symmetry breaking does not preserve depth
+     * and has been added permanently, therefore a new session is started */
+    const unsigned k = inst->gates.size();
+    symmetry_breaking.reset( 3u );
+
+    inst = create_instance();
+    for ( auto i = 0u; i < k; ++i )
+    {
+      inst->add_level( symmetry_breaking );
+    }
+    const auto size_act = activate_output( inst );
+
+    for ( auto d = start_depth; ; ++d )
+    {
+      if ( verbose )
+      {
+        std::cout << boost::format( "[i] check for realization with %d gates and depth %d" ) % k % d << std::endl;
+      }
+
+      inst->assumptions.set( {size_act, inst->activate_depth( d )} );
+
+      const auto result = check( inst );
+      if ( result == z3::sat )
+      {
+        store_memory( inst );
+        return extract_solutions( inst );
+      }
+      else if ( result == z3::unknown && !timeout_heuristic )
+      {
+        last_size = k;
+        return std::vector<T>();
+      }
+    }
+  }
+
+  std::vector<T> exact_mig_depth_size_incremental()
+  {
+    symmetry_breaking.reset( 3u );
+    auto d = start_depth;
+
+    while ( true )
+    {
+      const auto max_gates = ( static_cast<int>( pow( 3, d ) ) - 1 ) / 2;
+      const int first = ( d == start_depth ) ? start : 1;
+
+      /* one session per depth bound, gates are added while the bound holds */
+      const auto inst = create_instance();
+
+      for ( auto i = 1; i < first; ++i )
+      {
+        inst->add_level( symmetry_breaking );
+      }
+
+      for ( int k = first; k <= max_gates; ++k )
+      {
+        if ( verbose )
+        {
+          std::cout << boost::format( "[i] check for realization with depth %d and %d gates" ) % d % k << std::endl;
+        }
+
+        inst->add_level( symmetry_breaking );
+        inst->assumptions.set( {activate_output( inst ), inst->activate_depth( d )} );
+
+        const auto result = check( inst );
+        if ( result == z3::sat )
+        {
+          store_memory( inst );
+          return extract_solutions( inst );
+        }
+        else if ( result == z3::unknown && !timeout_heuristic )
+        {
+          return std::vector<T>();
+        }
+      }
+
+      ++d;
+    }
+  }
+
+  /* portfolio: each job checks one gate count with one encoding and symmetry
+   * breaking variant, jobs run concurrently in increasing order of gate
+   * counts; a gate count is optimum as soon as one job realizes it and all
+   * smaller gate counts are refuted, remaining jobs are interrupted */
+  std::vector<T> exact_mig_size_portfolio()
+  {
+    struct running_job
+    {
+      unsigned                            k;
+      std::shared_ptr<exact_mig_instance> inst;
+      bool                                cancelled;
+      bool                                solving;
+    };
+
+    /* variants (XMG encoding requires bit-vectors) */
+    std::vector<std::pair<bool, boost::dynamic_bitset<>>> variants;
+    auto light_breaking = symmetry_breaking;
+    light_breaking.reset( 3u );
+    light_breaking.reset( 6u );
+
+    for ( auto enc_bv : {enc_with_bitvectors, !enc_with_bitvectors} )
+    {
+      if ( with_xor<T>() && !enc_bv ) { continue; }
+
+      for ( const auto& sb : {symmetry_breaking, light_breaking} )
+      {
+        const auto variant = std::make_pair( enc_bv, sb );
+        if ( std::find( variants.begin(), variants.end(), variant ) == variants.end() )
+        {
+          variants.push_back( variant );
+        }
+      }
+    }
+    const unsigned num_variants = variants.size();
+
+    /* shared state: per gate count (offset by start) 0 = open, 1 = refuted, 2 = failed */
+    std::mutex                mutex;
+    unsigned                  next_job = 0u;
+    std::vector<unsigned>     status, unanswered;
+    unsigned                  limit = std::numeric_limits<unsigned>::max(); /* smallest realized or failed gate count */
+    bool                      realized = false;
+    std::vector<T>            solutions;
+    std::list<running_job>    running;
+    bool                      aborted = false;                              /* a worker threw, its job is never erased */
+
+    const auto is_resolved = [&]( unsigned k ) {
+      return k >= limit || ( k - start < status.size() && status[k - start] != 0u );
+    };
+
+    /* called with locked mutex; an interrupt that reaches a solver just
+     * before it enters check() can get lost, therefore cancelled jobs that
+     * are still solving are interrupted again on every update and by
+     * workers that have no jobs left (see watch) */
+    const auto update = [&]() {
+      for ( auto& job : running )
+      {
+        if ( !job.cancelled && is_resolved( job.k ) )
+        {
+          job.cancelled = true;
+        }
+        if ( job.cancelled && job.solving )
+        {
+          Z3_interrupt( job.inst->ctx );
+        }
+      }
+    };
+
+    /* run by workers without jobs left: repeats update until no job is
+     * running, such that a job which lost its interrupt stops promptly
+     * even if no other job finishes */
+    const auto watch = [&]() {
+      while ( true )
+      {
+        {
+          std::lock_guard<std::mutex> lock( mutex );
+          if ( running.empty() || aborted ) { return; }
+          update();
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+      }
+    };
+
+    const auto worker = [&]() {
+      while ( true )
+      {
+        typename std::list<running_job>::iterator it;
+        unsigned k, v;
+
+        /* pick next open job */
+        {
+          std::lock_guard<std::mutex> lock( mutex );
+          do
+          {
+            k = start + next_job / num_variants;
+            v = next_job % num_variants;
+            if ( k >= limit ) { return; }
+            ++next_job;
+          } while ( is_resolved( k ) );
+
+          if ( status.size() <= k - start )
+          {
+            status.resize( k - start + 1u, 0u );
+            unanswered.resize( k - start + 1u, num_variants );
+          }
+
+          if ( verbose )
+          {
+            std::cout << boost::format( "[i] check for realization with %d gates (variant %d)" ) % k % v << std::endl;
+          }
+
+          it = running.insert( running.end(), {k, create_instance( variants[v].first ), false, false} );
+        }
+
+        const auto inst = it->inst;
+        for ( auto i = 0u; i < k; ++i )
+        {
+          inst->add_level( variants[v].second );
+        }
+        constrain( inst );
+
+        auto runtime = 0.0;
+        auto result = z3::unknown;
+        /* decide under the lock whether to solve, from here on update()
+         * interrupts this job when it is cancelled */
+        bool skip;
+        {
+          std::lock_guard<std::mutex> lock( mutex );
+          skip = it->cancelled || is_resolved( k );
+          it->solving = !skip;
+        }
+        if ( !skip )
+        {
+          increment_timer t( &runtime );
+          result = inst->assumptions.check();
+        }
+
+        /* extract outside the lock, the model belongs to this job */
+        std::vector<T> job_solutions;
+        if ( result == z3::sat )
+        {
+          job_solutions = extract_solutions( inst );
+        }
+
+        std::lock_guard<std::mutex> lock( mutex );
+        const auto cancelled = it->cancelled;
+        running.erase( it );
+
+        if ( skip ) { continue; }
+        solve_times.push_back( runtime );
+
+        /* a job cancelled while solving may still have returned a result,
+         * but its gate count is already resolved */
+        if ( cancelled || is_resolved( k ) ) { continue; }
+
+        if ( result == z3::sat )
+        {
+          limit = k;
+          realized = true;
+          solutions = job_solutions;
+          store_memory( inst );
+        }
+        else if ( result == z3::unsat )
+        {
+          status[k - start] = 1u;
+        }
+        else if ( --unanswered[k - start] == 0u )
+        {
+          if ( timeout_heuristic )
+          {
+            status[k - start] = 1u;
+          }
+          else
+          {
+            status[k - start] = 2u;
+            limit = k;
+            realized = false;
+          }
+        }
+
+        update();
+      }
+    };
+
+    if ( num_threads == 0u )
+    {
+      num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+
+    if ( num_threads == 1u )
+    {
+      worker();
+    }
+    else
+    {
+      thread_pool pool( num_threads - 1u );
+      task_group group;
+      for ( auto i = 0u; i < num_threads; ++i )
+      {
+        pool.submit( group, [&]() {
+            try
+            {
+              worker();
+            }
+            catch ( ... )
+            {
+              std::lock_guard<std::mutex> lock( mutex );
+              aborted = true;
+              throw;
+            }
+            watch();
+          } );
+      }
+      pool.wait( group );
+    }
+
+    if ( !realized )
+    {
+      last_size = limit;
+      return std::vector<T>();
+    }
+
+    return solutions;
+  }
+
 private:
   template<typename C, typename std::enable_if<std::is_same<mig_graph, C>::value>::type* = nullptr>
   bool with_xor() const
@@ -1317,7 +1663,12 @@ private:
 
   inline std::shared_ptr<exact_mig_instance> create_instance() const
   {
-    auto inst = std::make_shared<exact_mig_instance>( spec.num_vars(), with_xor<T>(), enc_with_bitvectors, spec.is_explicit(), timeout );
+    return create_instance( enc_with_bitvectors );
+  }
+
+  inline std::shared_ptr<exact_mig_instance> create_instance( bool enc_bv ) const
+  {
+    auto inst = std::make_shared<exact_mig_instance>( spec.num_vars(), with_xor<T>(), enc_bv, spec.is_explicit(), timeout );
     inst->support    = support;
     inst->symmetries = symmetries;
     return inst;
@@ -1333,7 +1684,7 @@ private:
       {
         migs.push_back( extract_solution<T>( inst ) );
         inst->block_solution();
-      } while ( inst->solver.check() == z3::sat );
+      } while ( inst->assumptions.check() == z3::sat );
 
       return migs;
     }
@@ -1366,6 +1717,42 @@ private:
     spec.apply_visitor( constrain_visitor( inst ) );
   }
 
+  struct activate_output_visitor : public boost::static_visitor<z3::expr>
+  {
+    activate_output_visitor( const std::shared_ptr<exact_mig_instance>& inst ) : inst( inst ) {}
+
+    z3::expr operator()( const tt& spec ) const
+    {
+      return exact_activate_output( *inst, spec );
+    }
+
+    z3::expr operator()( const mig_graph& spec ) const
+    {
+      assert( false );
+      return inst->ctx.bool_val( true );
+    }
+
+  private:
+    const std::shared_ptr<exact_mig_instance>& inst;
+  };
+
+  z3::expr activate_output( const std::shared_ptr<exact_mig_instance>& inst ) const
+  {
+    return spec.apply_visitor( activate_output_visitor( inst ) );
+  }
+
+  z3::check_result check( const std::shared_ptr<exact_mig_instance>& inst )
+  {
+    auto runtime = 0.0;
+    auto result = z3::unknown;
+    {
+      increment_timer t( &runtime );
+      result = inst->assumptions.check();
+    }
+    solve_times.push_back( runtime );
+    return result;
+  }
+
   void make_symmetry_breaking_bitset()
   {
     symmetry_breaking.resize( 7u );
@@ -1408,6 +1795,8 @@ private:
   std::string output_name;
   unsigned objective;
   bool incremental;
+  bool portfolio;
+  unsigned num_threads;
   bool all_solutions;
   std::string breaking;
   bool enc_with_bitvectors;
@@ -1435,6 +1824,7 @@ public:
   /* some statistics */
   unsigned last_size = 0u; /* the last level that has been tried (helpful when using timeout) */
   double   memory    = -1.0; /* memory usage */
+  std::vector<double> solve_times; /* run-time of each solver call */
 };
 #endif
 
@@ -1462,6 +1852,7 @@ boost::optional<mig_graph> exact_mig_with_sat( const tt& spec,
   }
   set( statistics, "last_size", mgr.last_size );
   set( statistics, "memory", mgr.memory );
+  set( statistics, "solve_times", mgr.solve_times );
 
   if ( migs.empty() )
   {
@@ -1497,6 +1888,7 @@ boost::optional<mig_graph> exact_mig_with_sat( const mig_graph& spec,
   }
   set( statistics, "last_size", mgr.last_size );
   set( statistics, "memory", mgr.memory );
+  set( statistics, "solve_times", mgr.solve_times );
 
   if ( migs.empty() )
   {
@@ -1534,6 +1926,7 @@ boost::optional<xmg_graph> exact_xmg_with_sat( const tt& spec,
   }
   set( statistics, "last_size", mgr.last_size );
   set( statistics, "memory", mgr.memory );
+  set( statistics, "solve_times", mgr.solve_times );
 
   if ( xmgs.empty() )
   {
@@ -1569,6 +1962,7 @@ boost::optional<xmg_graph> exact_xmg_with_sat( const mig_graph& spec,
   }
   set( statistics, "last_size", mgr.last_size );
   set( statistics, "memory", mgr.memory );
+  set( statistics, "solve_times", mgr.solve_times );
 
   if ( xmgs.empty() )
   {
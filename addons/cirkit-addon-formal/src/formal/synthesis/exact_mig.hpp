@@ -56,7 +56,9 @@ namespace cirkit
    | model_name          | Name of the MIG model                         | std::string( "exact" ) |
    | output_name         | Name of the output                            | std::string( "f" )     |
    | output_inverter     | Allow output inversion in encoding            | false                  |
-   | incremental         | Explicit or incremental SAT solving           | false                  |
+   | incremental         | Keep one solver session (truth tables only)   | false                  |
+   | portfolio           | Concurrent encodings and gate counts          | false                  |
+   | num_threads         | Threads for portfolio (0: one per core)       | 0u                     |
    | min_depth           | Smallest MIG with smallest depth              | false                  |
    | all_solutions       | Enumerate all solutions                       | false                  |
    | enc_with_bitvectors | Encode numbers as bit-vectors and not as ints | false                  |
@@ -0,0 +1,141 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file exact_simulation.hpp
+ *
+ * @brief Simulation constraints shared by exact MIG and XMG synthesis
+ *
+ * The instance provides the solver, its gates with select and negation
+ * variables, the per-minterm simulation variables sim_out and sim_in,
+ * and the activation literals of its incremental session.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef EXACT_SIMULATION_HPP
+#define EXACT_SIMULATION_HPP
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/format.hpp>
+
+#include <classical/utils/truth_table_utils.hpp>
+#include <formal/utils/z3_utils.hpp>
+
+#include <z3++.h>
+
+namespace cirkit
+{
+
+/* adds value constraints for all levels that have not been constrained yet;
+ * they do not depend on the number of gates and can be kept in the solver */
+template<typename Instance>
+void exact_constrain_levels( Instance& inst )
+{
+  using boost::format;
+  using boost::str;
+
+  auto& ctx = inst.ctx;
+  const auto& gates = inst.gates;
+  const auto N = 1u << inst.num_vars;
+
+  inst.sim_out.resize( N );
+  inst.sim_in.resize( 3u, std::vector<std::vector<z3::expr>>( N ) );
+
+  /* value constraints */
+  for ( auto j = 0u; j < N; ++j )
+  {
+    auto& out = inst.sim_out[j];
+    for ( auto level = out.size(); level < gates.size(); ++level )
+    {
+      out.push_back( ctx.bool_const( str( format( "out_%d_%d" ) % j % level ).c_str() ) );
+      inst.sim_in[0u][j].push_back( ctx.bool_const( str( format( "in1_%d_%d" ) % j % level ).c_str() ) );
+      inst.sim_in[1u][j].push_back( ctx.bool_const( str( format( "in2_%d_%d" ) % j % level ).c_str() ) );
+      inst.sim_in[2u][j].push_back( ctx.bool_const( str( format( "in3_%d_%d" ) % j % level ).c_str() ) );
+
+      const auto& in1 = inst.sim_in[0u][j][level];
+      const auto& in2 = inst.sim_in[1u][j][level];
+      const auto& in3 = inst.sim_in[2u][j][level];
+
+      /* assertion for out[j][level] = M(in1[j][level],in2[j][level],in3[j][level] */
+      if ( inst.with_xor )
+      {
+        inst.solver.add( out[level] == ( implies( !gates[level].type(), ( in1 && in2 ) || ( in1 && in3 ) || ( in2 && in3 ) )
+                                         && implies( gates[level].type(), logic_xor( in1, in2 ) ) ) );
+      }
+      else
+      {
+        inst.solver.add( out[level] == ( ( in1 && in2 ) || ( in1 && in3 ) || ( in2 && in3 ) ) );
+      }
+
+      /* assertions for in[x][j][level] = neg[level] ^ ite( sel[level], ... ) */
+      boost::dynamic_bitset<> val( inst.num_vars, j );
+      for ( auto x = 0u; x < 3u; ++x )
+      {
+        const auto& in = inst.sim_in[x][j][level];
+
+        inst.solver.add( implies( inst.equals( gates[level][x].sel, 0u ),
+                                  in == logic_xor( gates[level][x].neg, ctx.bool_val( false ) ) ) );
+
+        for ( auto l = 0u; l < inst.num_vars; ++l )
+        {
+          inst.solver.add( implies( inst.equals( gates[level][x].sel, l + 1u ),
+                                    in == logic_xor( gates[level][x].neg, ctx.bool_val( val[l] ) ) ) );
+        }
+        for ( auto l = 0u; l < level; ++l )
+        {
+          inst.solver.add( implies( inst.equals( gates[level][x].sel, l + 1u + inst.num_vars ),
+                                    in == logic_xor( gates[level][x].neg, out[l] ) ) );
+        }
+      }
+    }
+  }
+}
+
+/* returns an activation literal that, when assumed, requires the last gate to realize spec */
+template<typename Instance>
+z3::expr exact_activate_output( Instance& inst, const tt& spec )
+{
+  exact_constrain_levels( inst );
+
+  const auto act = inst.assumptions.new_literal();
+  for ( auto j = 0u; j < inst.sim_out.size(); ++j )
+  {
+    inst.solver.add( implies( act, inst.sim_out[j].back() == inst.ctx.bool_val( spec[j] ) ) );
+  }
+  return act;
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
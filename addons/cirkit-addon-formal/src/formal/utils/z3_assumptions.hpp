@@ -0,0 +1,79 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file z3_assumptions.hpp
+ *
+ * @brief Activation literals for incremental Z3 sessions
+ *
+ * Constraints that only hold for some queries are guarded by an
+ * activation literal act (the caller adds act -> constraint to the
+ * solver) and enabled by passing act as an assumption to check.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef Z3_ASSUMPTIONS_HPP
+#define Z3_ASSUMPTIONS_HPP
+
+#include <vector>
+
+#include <z3++.h>
+
+namespace cirkit
+{
+
+class z3_assumptions
+{
+public:
+  z3_assumptions( z3::context& ctx, z3::solver& solver );
+
+  /* returns a fresh activation literal */
+  z3::expr new_literal();
+
+  /* literals assumed in all following calls to check */
+  void set( const std::vector<z3::expr>& literals );
+
+  /* solves under the current assumptions */
+  z3::check_result check();
+
+private:
+  z3::context&          ctx;
+  z3::solver&           solver;
+  std::vector<z3::expr> literals;
+  unsigned              num_literals = 0u;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
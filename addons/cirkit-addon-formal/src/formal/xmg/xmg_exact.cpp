@@ -41,6 +41,8 @@
 #include <classical/utils/spec_representation.hpp>
 
 #ifdef ADDON_FORMAL
+#include <formal/synthesis/exact_simulation.hpp>
+#include <formal/utils/z3_assumptions.hpp>
 #include <formal/utils/z3_utils.hpp>
 #include <z3++.h>
 #endif
@@ -207,7 +209,8 @@ struct xmg_exact_instance
    */
   xmg_exact_instance( unsigned num_vars, bool expl, boost::optional<unsigned> timeout = boost::none ) :
     num_vars( num_vars ),
-    solver( make_solver( expl ) )
+    solver( make_solver( expl ) ),
+    assumptions( ctx, solver )
   {
     auto upper_bound = 7u;
     if ( num_vars > 4u )
@@ -343,53 +346,11 @@ struct xmg_exact_instance
 
   void constrain( const tt& spec )
   {
-    auto N = 1u << num_vars;
+    exact_constrain_levels( *this );
 
-    std::vector<std::vector<z3::expr>> out( N );
-    std::vector<std::vector<std::vector<z3::expr>>> in( 3u, std::vector<std::vector<z3::expr>>( N ) );
-
-    /* value constraints */
-    for ( auto j = 0u; j < N; ++j )
+    for ( auto j = 0u; j < sim_out.size(); ++j )
     {
-      for ( auto level = 0u; level < gates.size(); ++level )
-      {
-        out[j] += ctx.bool_const( str( format( "out_%d_%d" ) % j % level ).c_str() );
-        in[0u][j] += ctx.bool_const( str( format( "in1_%d_%d" ) % j % level ).c_str() );
-        in[1u][j] += ctx.bool_const( str( format( "in2_%d_%d" ) % j % level ).c_str() );
-        in[2u][j] += ctx.bool_const( str( format( "in3_%d_%d" ) % j % level ).c_str() );
-
-        /* assertion for out[j][level] = M(in1[j][level],in2[j][level],in3[j][level] */
-        if ( with_xor )
-        {
-          solver.add( out[j][level] == ( implies( !gates[level].type(), ( in[0u][j][level] && in[1u][j][level] ) || ( in[0u][j][level] && in[2u][j][level] ) || ( in[1u][j][level] && in[2u][j][level] ) )
-                                         && implies( gates[level].type(), logic_xor( in[0u][j][level], in[1u][j][level] ) ) ) );
-        }
-        else
-        {
-          solver.add( out[j][level] == ( ( in[0u][j][level] && in[1u][j][level] ) || ( in[0u][j][level] && in[2u][j][level] ) || ( in[1u][j][level] && in[2u][j][level] ) ) );
-        }
-
-        /* assertions for in[x][j][level] = neg[level] ^ ite( sel[level], ... ) */
-        boost::dynamic_bitset<> val( num_vars, j );
-        for ( auto x = 0u; x < 3u; ++x )
-        {
-          solver.add( implies( equals( gates[level][x].sel, 0 ),
-                               in[x][j][level] == logic_xor( gates[level][x].neg, ctx.bool_val( false ) ) ) );
-
-          for ( auto l = 0u; l < num_vars; ++l )
-          {
-            solver.add( implies( equals( gates[level][x].sel, l + 1 ),
-                                 in[x][j][level] == logic_xor( gates[level][x].neg, ctx.bool_val( val[l] ) ) ) );
-          }
-          for ( auto l = 0u; l < level; ++l )
-          {
-            solver.add( implies( equals( gates[level][x].sel, l + 1 + num_vars ),
-                                 in[x][j][level] == logic_xor( gates[level][x].neg, out[j][l] ) ) );
-          }
-        }
-      }
-
-      solver.add( out[j].back() == ctx.bool_val( spec[j] ) );
+      solver.add( sim_out[j].back() == ctx.bool_val( spec[j] ) );
     }
   }
 
@@ -500,6 +461,13 @@ struct xmg_exact_instance
 
   unsigned bw;
 
+  /* per-minterm simulation variables, kept across levels */
+  std::vector<std::vector<z3::expr>>              sim_out;
+  std::vector<std::vector<std::vector<z3::expr>>> sim_in;
+
+  /* activation literals of the incremental session */
+  z3_assumptions assumptions;
+
   /* spec properties */
   boost::dynamic_bitset<>                    support;
   std::vector<std::pair<unsigned, unsigned>> symmetries;
@@ -522,6 +490,7 @@ public:
 
     /* control algorithm */
     start               = get( settings, "start",               1u );
+    incremental         = get( settings, "incremental",         false );
     all_solutions       = get( settings, "all_solutions",       false );
 
     /* encoding */
@@ -566,7 +535,14 @@ public:
       spec.invert();
     }
 
-    return exact_mig_size_explicit();
+    if ( incremental && spec.is_explicit() )
+    {
+      return exact_mig_size_incremental();
+    }
+    else
+    {
+      return exact_mig_size_explicit();
+    }
   }
 
   std::vector<xmg_graph> exact_mig_size_explicit()
@@ -588,7 +564,7 @@ public:
 
       constrain( inst );
 
-      const auto result = inst->solver.check();
+      const auto result = check( inst );
       if ( result == z3::sat )
       {
         return extract_solutions( inst );
@@ -603,6 +579,41 @@ public:
     }
   }
 
+  /* keeps one solver session and enables the output constraint of the last
+   * gate by an assumption */
+  std::vector<xmg_graph> exact_mig_size_incremental()
+  {
+    const auto inst = create_instance();
+
+    for ( unsigned i = 1u; i < start; ++i )
+    {
+      inst->add_level( symmetry_breaking );
+    }
+
+    while ( true )
+    {
+      inst->add_level( symmetry_breaking );
+
+      if ( verbose )
+      {
+        std::cout << boost::format( "[i] check for realization with %d gates" ) % inst->gates.size() << std::endl;
+      }
+
+      inst->assumptions.set( {activate_output( inst )} );
+
+      const auto result = check( inst );
+      if ( result == z3::sat )
+      {
+        return extract_solutions( inst );
+      }
+      else if ( result == z3::unknown && !timeout_heuristic )
+      {
+        last_size = inst->gates.size();
+        return std::vector<xmg_graph>();
+      }
+    }
+  }
+
 private:
   xmg_graph create_trivial( unsigned id, bool complement )
   {
@@ -645,7 +656,7 @@ private:
       {
         migs.push_back( extract_solution( inst ) );
         inst->block_solution();
-      } while ( inst->solver.check() == z3::sat );
+      } while ( inst->assumptions.check() == z3::sat );
 
       return migs;
     }
@@ -678,6 +689,42 @@ private:
     spec.apply_visitor( constrain_visitor( inst ) );
   }
 
+  struct activate_output_visitor : public boost::static_visitor<z3::expr>
+  {
+    activate_output_visitor( const std::shared_ptr<xmg_exact_instance>& inst ) : inst( inst ) {}
+
+    z3::expr operator()( const tt& spec ) const
+    {
+      return exact_activate_output( *inst, spec );
+    }
+
+    z3::expr operator()( const mig_graph& spec ) const
+    {
+      assert( false );
+      return inst->ctx.bool_val( true );
+    }
+
+  private:
+    const std::shared_ptr<xmg_exact_instance>& inst;
+  };
+
+  z3::expr activate_output( const std::shared_ptr<xmg_exact_instance>& inst ) const
+  {
+    return spec.apply_visitor( activate_output_visitor( inst ) );
+  }
+
+  z3::check_result check( const std::shared_ptr<xmg_exact_instance>& inst )
+  {
+    auto runtime = 0.0;
+    auto result = z3::unknown;
+    {
+      increment_timer t( &runtime );
+      result = inst->assumptions.check();
+    }
+    solve_times.push_back( runtime );
+    return result;
+  }
+
   void make_symmetry_breaking_bitset()
   {
     symmetry_breaking.resize( 7u );
@@ -703,6 +750,7 @@ private:
   unsigned start;
   std::string model_name;
   std::string output_name;
+  bool incremental;
   bool all_solutions;
   std::string breaking;
   boost::optional<unsigned> timeout;
@@ -728,6 +776,7 @@ private:
 public:
   /* some statistics */
   unsigned last_size = 0u; /* the last level that has been tried (helpful when using timeout) */
+  std::vector<double> solve_times; /* run-time of each solver call */
 };
 
 /******************************************************************************
@@ -752,6 +801,7 @@ boost::optional<xmg_graph> xmg_exact_with_sat( const tt& spec,
     set( statistics, "all_solutions", migs );
   }
   set( statistics, "last_size", mgr.last_size );
+  set( statistics, "solve_times", mgr.solve_times );
 
   if ( migs.empty() )
   {
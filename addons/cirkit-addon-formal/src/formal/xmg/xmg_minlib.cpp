@@ -44,6 +44,7 @@
 #include <classical/xmg/xmg_expr.hpp>
 #include <classical/xmg/xmg_simulate.hpp>
 #include <classical/xmg/xmg_string.hpp>
+#include <classical/xmg/xmg_utils.hpp>
 #include <formal/synthesis/exact_mig.hpp>
 #include <formal/xmg/xmg_exact_heuristic.hpp>
 
@@ -93,7 +94,7 @@ std::string xmg_minlib_manager::format_library_entry( const std::string& hex, co
   return boost::str( boost::format( "0x%s %s" ) % hex % expr );
 }
 
-std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
+std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex, bool npn_representative )
 {
   const auto it = library.find( hex );
 
@@ -102,13 +103,25 @@ std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
     return it->second;
   }
 
+  tt spec( convert_hex2bin( hex ) );
+
+  exact_db_entry entry;
+  if ( database && npn_representative && database->lookup( exact_db_basis::xmg, spec, entry ) )
+  {
+    add_to_library( hex, entry.expression );
+    return entry.expression;
+  }
+
   auto exs_settings = std::make_shared<properties>();
   exs_settings->set( "verbose", true );
   exs_settings->set( "timeout", timeout );
+  if ( num_threads != 1u )
+  {
+    exs_settings->set( "portfolio", true );
+    exs_settings->set( "num_threads", num_threads );
+  }
   auto exs_statistics = std::make_shared<properties>();
 
-  tt spec( convert_hex2bin( hex ) );
-
   if ( verbose )
   {
     std::cout << "[i] no entry for " << spec << " (" << hex << "), find with exact synthesis" << std::endl;
@@ -156,6 +169,16 @@ std::string xmg_minlib_manager::find_or_create_xmg( const std::string& hex )
 
   add_to_library( hex, str );
 
+  /* only optimum results for NPN representatives are shared through the database */
+  if ( database && npn_representative && (bool)xmg_exact && database->is_storable( spec ) )
+  {
+    exact_db_entry entry;
+    entry.size       = xmg.num_gates();
+    entry.depth      = compute_depth( xmg );
+    entry.expression = str;
+    database->insert( exact_db_basis::xmg, spec, entry );
+  }
+
   if ( verbose )
   {
     std::cout << "[i] new entry: " << format_library_entry( hex, str ) << std::endl;
@@ -191,8 +214,24 @@ npn_manager::npn_classifier_t make_classifier()
 xmg_minlib_manager::xmg_minlib_manager( const properties::ptr& settings )
   : npn( 4096, make_classifier() )
 {
-  timeout = get( settings, "timeout", timeout );
-  verbose = get( settings, "verbose", verbose );
+  timeout     = get( settings, "timeout",     timeout );
+  verbose     = get( settings, "verbose",     verbose );
+  num_threads = get( settings, "num_threads", num_threads );
+
+  /* persistent database of optimum XMGs, consulted before exact synthesis */
+  const auto database_file = get( settings, "database", std::string() );
+  if ( !database_file.empty() )
+  {
+    database = std::make_shared<exact_db>( database_file );
+  }
+
+  /* persistent NPN cache; make_classifier is none of the npn command's
+     approaches, so its files use the next free approach index */
+  const auto npn_cache_file = get( settings, "npn_cache", std::string() );
+  if ( !npn_cache_file.empty() )
+  {
+    npn.set_persistent_cache( std::make_shared<npn_cache>( npn_cache_file, 5u ) );
+  }
 }
 
 xmg_minlib_manager::~xmg_minlib_manager()
@@ -259,7 +298,7 @@ xmg_graph xmg_minlib_manager::find_xmg( const tt& spec )
   }
   auto xfs_settings = std::make_shared<properties>();
   xfs_settings->set( "primary_inputs", pis );
-  const auto min_xmg_expr = find_or_create_xmg( tt_to_hex( npn_spec ) );
+  const auto min_xmg_expr = find_or_create_xmg( tt_to_hex( npn_spec ), true );
   xmg.create_po( xmg_from_string( xmg, min_xmg_expr, xfs_settings ) ^ phase[numvars], "f" );
 
   return xmg;
@@ -277,7 +316,7 @@ xmg_graph xmg_minlib_manager::find_xmg_no_npn( const tt& spec )
   }
   auto xfs_settings = std::make_shared<properties>();
   xfs_settings->set( "primary_inputs", pis );
-  const auto min_xmg_expr = find_or_create_xmg( tt_to_hex( spec ) );
+  const auto min_xmg_expr = find_or_create_xmg( tt_to_hex( spec ), false );
   xmg.create_po( xmg_from_string( xmg, min_xmg_expr, xfs_settings ), "f" );
 
   return xmg;
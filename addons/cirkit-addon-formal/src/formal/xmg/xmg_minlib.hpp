@@ -45,6 +45,7 @@
 #include <boost/optional.hpp>
 
 #include <core/properties.hpp>
+#include <classical/utils/exact_db.hpp>
 #include <classical/utils/npn_manager.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 #include <classical/xmg/xmg.hpp>
@@ -78,13 +79,16 @@ private:
   void add_to_library( const std::string& hex, const std::string& expr );
   std::string format_library_entry( const std::string& hex, const std::string& expr );
 
-  std::string find_or_create_xmg( const std::string& hex );
+  /* the database is only used if hex is an NPN representative */
+  std::string find_or_create_xmg( const std::string& hex, bool npn_representative );
 
 private:
   std::unordered_map<std::string, std::string> library;
   npn_manager                                  npn;
   boost::optional<unsigned>                    timeout;
   bool                                         verbose;
+  unsigned                                     num_threads = 1u;
+  exact_db::ptr                                database;
 
   bool auto_update = false;
   std::ofstream update_out;
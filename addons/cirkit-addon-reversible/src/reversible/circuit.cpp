@@ -26,6 +26,7 @@
 
 #include "circuit.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -41,6 +42,79 @@ namespace cirkit
   using boost::adaptors::indirected;
   using boost::adaptors::transformed;
 
+  gate* gate_arena::allocate()
+  {
+    if ( !free_gates.empty() )
+    {
+      auto* g = free_gates.back();
+      free_gates.pop_back();
+      return g;
+    }
+
+    if ( chunks.empty() || chunk_used == chunk_size )
+    {
+      /* small circuits are common, so start with small chunks */
+      chunk_size = chunks.empty() ? 16u : std::min( 2u * chunk_size, 4096u );
+      chunks.emplace_back( new gate[chunk_size] );
+      chunk_used = 0u;
+    }
+
+    return &chunks.back()[chunk_used++];
+  }
+
+  void gate_arena::release( gate* g )
+  {
+    *g = gate();
+    free_gates.push_back( g );
+  }
+
+  standard_circuit::standard_circuit( const standard_circuit& other )
+    : lines( other.lines ),
+      inputs( other.inputs ),
+      outputs( other.outputs ),
+      constants( other.constants ),
+      garbage( other.garbage ),
+      name( other.name ),
+      inputbuses( other.inputbuses ),
+      outputbuses( other.outputbuses ),
+      statesignals( other.statesignals )
+  {
+    append_gates( other );
+  }
+
+  standard_circuit& standard_circuit::operator=( const standard_circuit& other )
+  {
+    if ( this != &other )
+    {
+      standard_circuit copy( other );
+      *this = std::move( copy );
+    }
+    return *this;
+  }
+
+  void standard_circuit::append_gates( const standard_circuit& other )
+  {
+    const auto n = other.gates.size();
+    gates.reserve( gates.size() + n );
+
+    for ( auto i = 0u; i < n; ++i )
+    {
+      const auto* g = other.gates[i];
+      auto* copy = arena.allocate();
+      *copy = *g;
+      gates.push_back( copy );
+
+      if ( !other.annotations.empty() )
+      {
+        const auto it = other.annotations.find( g );
+        if ( it != other.annotations.end() )
+        {
+          annotations[copy] = it->second;
+        }
+      }
+    }
+  }
+
   struct num_gates_visitor : public boost::static_visitor<unsigned>
   {
     unsigned operator()( const standard_circuit& circ ) const
@@ -203,13 +277,13 @@ namespace cirkit
   {
     gate& operator()( standard_circuit& circ ) const
     {
-      circ.gates.push_back( std::make_shared<gate>() );
+      circ.gates.push_back( circ.arena.allocate() );
       return *circ.gates.back();
     }
 
     gate& operator()( subcircuit& circ ) const
     {
-      circ.base->gates.insert( circ.base->gates.begin() + circ.to, std::make_shared<gate>() );
+      circ.base->gates.insert( circ.base->gates.begin() + circ.to, circ.base->arena.allocate() );
       ++circ.to;
 
       gate& g = **( circ.base->gates.begin() + circ.to - 1 );
@@ -221,13 +295,13 @@ namespace cirkit
   {
     gate& operator()( standard_circuit& circ ) const
     {
-      circ.gates.insert( circ.gates.begin(), std::make_shared<gate>() );
+      circ.gates.insert( circ.gates.begin(), circ.arena.allocate() );
       return *circ.gates.front();
     }
 
     gate& operator()( subcircuit& circ ) const
     {
-      circ.base->gates.insert( circ.base->gates.begin() + circ.from, std::make_shared<gate>() );
+      circ.base->gates.insert( circ.base->gates.begin() + circ.from, circ.base->arena.allocate() );
       ++circ.to;
 
       gate& g = **( circ.base->gates.begin() + circ.from );
@@ -241,13 +315,13 @@ namespace cirkit
 
     gate& operator()( standard_circuit& circ ) const
     {
-      circ.gates.insert( circ.gates.begin() + pos, std::make_shared<gate>() );
+      circ.gates.insert( circ.gates.begin() + pos, circ.arena.allocate() );
       return *circ.gates.at( pos );
     }
 
     gate& operator()( subcircuit& circ ) const
     {
-      circ.base->gates.insert( circ.base->gates.begin() + circ.from + pos, std::make_shared<gate>() );
+      circ.base->gates.insert( circ.base->gates.begin() + circ.from + pos, circ.base->arena.allocate() );
       ++circ.to;
 
       gate& g = **( circ.base->gates.begin() + circ.from + pos );
@@ -266,7 +340,10 @@ namespace cirkit
     {
       if ( pos < circ.gates.size() )
       {
+        auto* g = circ.gates[pos];
         circ.gates.erase( circ.gates.begin() + pos );
+        circ.annotations.erase( g );
+        circ.arena.release( g );
       }
     }
 
@@ -274,7 +351,10 @@ namespace cirkit
     {
       if ( pos < circ.to )
       {
+        auto* g = circ.base->gates[circ.from + pos];
         circ.base->gates.erase( circ.base->gates.begin() + circ.from + pos );
+        circ.base->annotations.erase( g );
+        circ.base->arena.release( g );
         --circ.to;
       }
     }
@@ -106,6 +106,35 @@ namespace cirkit
    */
   using constant = boost::optional<bool>;
 
+  /**
+   * @brief Storage for the gates of a circuit
+   *
+   * Gates are allocated in chunks of growing size and keep their
+   * address for their whole lifetime, such that references and the
+   * gate order vector of a circuit remain valid when other gates are
+   * added or removed.  Released gates are reset and recycled.
+   *
+   * @since  2.3
+   */
+  class gate_arena
+  {
+  public:
+    gate_arena() {}
+    gate_arena( const gate_arena& ) = delete;
+    gate_arena( gate_arena&& ) = default;
+    gate_arena& operator=( const gate_arena& ) = delete;
+    gate_arena& operator=( gate_arena&& ) = default;
+
+    gate* allocate();
+    void release( gate* g );
+
+  private:
+    std::vector<std::unique_ptr<gate[]>> chunks;
+    std::vector<gate*>                   free_gates;
+    unsigned                             chunk_size = 0u;
+    unsigned                             chunk_used = 0u;
+  };
+
   /**
    * @brief Represents a circuit
    *
@@ -177,8 +206,30 @@ namespace cirkit
       garbage.resize( lines, false );
     }
 
+    /**
+     * @brief Copy Constructor
+     *
+     * Copies all gates into the arena of the new circuit, annotations
+     * are transferred to the copied gates.
+     *
+     * @since  2.3
+     */
+    standard_circuit( const standard_circuit& other );
+    standard_circuit( standard_circuit&& other ) = default;
+
+    standard_circuit& operator=( const standard_circuit& other );
+    standard_circuit& operator=( standard_circuit&& other ) = default;
+
+    /**
+     * @brief Appends copies of all gates of \p other
+     *
+     * @since  2.3
+     */
+    void append_gates( const standard_circuit& other );
+
     /** @cond */
-    std::vector<std::shared_ptr<gate> > gates;
+    std::vector<gate*> gates;
+    gate_arena arena;
     unsigned lines;
 
     std::vector<std::string> inputs;
@@ -377,21 +428,21 @@ namespace cirkit
     /**
      * @brief Mutable iterator for accessing the gates in a circuit
      */
-    using iterator = boost::indirect_iterator<std::vector<std::shared_ptr<gate>>::iterator>;
+    using iterator = boost::indirect_iterator<std::vector<gate*>::iterator>;
 
     /**
      * @brief Constant iterator for accessing the gates in a circuit
      */
-    using const_iterator = boost::indirect_iterator<std::vector<std::shared_ptr<gate>>::const_iterator>;
+    using const_iterator = boost::indirect_iterator<std::vector<gate*>::const_iterator>;
 
     /**
      * @brief Mutable reverse iterator for accessing the gates in a circuit
      */
-    using reverse_iterator = boost::indirect_iterator<std::vector<std::shared_ptr<gate>>::reverse_iterator>;
+    using reverse_iterator = boost::indirect_iterator<std::vector<gate*>::reverse_iterator>;
     /**
      * @brief Constant reverse iterator for accessing the gates in a circuit
      */
-    using const_reverse_iterator = boost::indirect_iterator<std::vector<std::shared_ptr<gate>>::const_reverse_iterator>;
+    using const_reverse_iterator = boost::indirect_iterator<std::vector<gate*>::const_reverse_iterator>;
 
     /**
      * @brief Returns the number of gates
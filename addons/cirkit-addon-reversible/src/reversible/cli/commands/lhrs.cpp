@@ -29,6 +29,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <boost/format.hpp>
 #include <boost/program_options.hpp>
 
 #include <core/utils/program_options.hpp>
@@ -57,11 +58,14 @@ lhrs_command::lhrs_command( const environment::ptr& env )
     ( "onlylines",          bool_switch( &params.onlylines ),                 "do not create gates (useful for qubit estimation)" )
     ( "area_iters_init",    value_with_default( &area_iters_init ),           "number of exact area recovery iterations (in initial mapping)" )
     ( "flow_iters_init",    value_with_default( &flow_iters_init ),           "number of area flow recovery iterations (in initial mapping)" )
+    ( "threads",            value_with_default( &params.num_threads ),        "number of threads for per-LUT synthesis (0: one per core)" )
+    ( "cache",              bool_switch( &params.cache ),                     "reuse circuits for LUTs with the same function up to input permutation" )
+    ( "cache_file",         value( &params.cache_file ),                      "load LUT cache from and store it to this file (implies --cache)" )
     ;
 
   boost::program_options::options_description esopdecomp_options( "ESOP decomposition options" );
   esopdecomp_options.add_options()
-    ( "esopscript",      value_with_default( &params.script ),       "ESOP optimization script\ndef: default exorcism script\ndef_wo4: default without exorlink-4\nnone: do not optimize ESOP cover" )
+    ( "esopscript",      value_with_default( &params.script ),       "ESOP optimization script\ndef: default exorcism script\ndef_wo4: default without exorlink-4\nparallel: multi-threaded exorcism (single-output covers)\nnone: do not optimize ESOP cover" )
     ( "esopcovermethod", value_with_default( &params.cover_method ), "ESOP cover method\naig (0): directly from AIG\nbdd (1): using PSDKRO method from BDD\naignew (2): new AIG-based method\nauto (3): tries to estimate the best method for each LUT" )
     ( "esoppostopt",     bool_switch( &params.optimize_postesop ),   "post-optimize network derived from ESOP synthesis" )
     ;
@@ -92,7 +96,8 @@ lhrs_command::lhrs_command( const environment::ptr& env )
 command::rules_t lhrs_command::validity_rules() const
 {
   return {
-    {has_store_element<aig_graph>( env )}
+    {has_store_element<aig_graph>( env )},
+    {[this]() { return params.num_threads == 1u || !is_set( "dumpfile" ); }, "dumpfile requires a single thread"}
   };
 }
 
@@ -124,9 +129,33 @@ bool lhrs_command::execute()
 
   print_runtime( stats.runtime );
 
+  if ( params.cache || is_set( "cache_file" ) )
+  {
+    const auto lookups = stats.cache_hits + stats.cache_misses;
+    std::cout << boost::format( "[i] LUT cache: %d hits, %d misses (hit rate: %.2f%%)" )
+      % stats.cache_hits % stats.cache_misses % ( lookups ? 100.0 * stats.cache_hits / lookups : 0.0 ) << std::endl;
+  }
+
+  if ( params.verbose && stats.mapping_cache_hits + stats.mapping_cache_misses > 0u )
+  {
+    std::cout << boost::format( "[i] sub-LUT mappings: %d computed, %d reused (mapping runtime: %.2f secs)" )
+      % stats.mapping_cache_misses % stats.mapping_cache_hits % stats.mapping_runtime << std::endl;
+  }
+
+  if ( stats.num_threads > 1u )
+  {
+    std::cout << boost::format( "[i] per-LUT synthesis: %.2f secs in %.2f secs on %d threads (speedup: %.2f)" )
+      % stats.lut_runtime % stats.pipeline_runtime % stats.num_threads % speedup() << std::endl;
+  }
+
   return true;
 }
 
+double lhrs_command::speedup() const
+{
+  return stats.pipeline_runtime > 0.0 ? stats.lut_runtime / stats.pipeline_runtime : 1.0;
+}
+
 command::log_opt_t lhrs_command::log() const
 {
   log_map_t map({
@@ -147,7 +176,16 @@ command::log_opt_t lhrs_command::log() const
       {"cover_runtime", stats.cover_runtime},
       {"class_counter", stats.class_counter},
       {"class_runtime", stats.class_runtime},
-      {"mapping_runtime", stats.mapping_runtime}
+      {"mapping_runtime", stats.mapping_runtime},
+      {"num_threads", stats.num_threads},
+      {"lut_runtime", stats.lut_runtime},
+      {"pipeline_runtime", stats.pipeline_runtime},
+      {"wait_runtime", stats.wait_runtime},
+      {"speedup", speedup()},
+      {"cache_hits", stats.cache_hits},
+      {"cache_misses", stats.cache_misses},
+      {"mapping_cache_hits", stats.mapping_cache_hits},
+      {"mapping_cache_misses", stats.mapping_cache_misses}
     });
 
   if ( is_set( "bounds" ) )
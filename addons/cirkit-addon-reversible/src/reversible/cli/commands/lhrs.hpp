@@ -54,6 +54,9 @@ protected:
 public:
   log_opt_t log() const;
 
+private:
+  double speedup() const;
+
 private:
   lhrs_params params;
   lhrs_stats  stats;
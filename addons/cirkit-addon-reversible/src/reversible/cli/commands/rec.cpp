@@ -54,6 +54,8 @@ rec_command::rec_command( const environment::ptr& env )
     ( "id1",            value_with_default( &id1 ), "ID of first circuit" )
     ( "id2",            value_with_default( &id2 ), "ID of second circuit" )
     ( "name_mapping,n",                             "map circuits by name instead by index" )
+    ( "sim_words",        value_with_default( &sim_words ),        "64-bit words of random patterns simulated before SAT (0: disable)" )
+    ( "exhaustive_lines", value_with_default( &exhaustive_lines ), "decide circuits up to this many lines by exhaustive simulation" )
     ;
   be_verbose();
 }
@@ -64,6 +66,8 @@ bool rec_command::execute()
 
   auto settings = make_settings();
   settings->set( "name_mapping", is_set( "name_mapping" ) );
+  settings->set( "simulation_words", sim_words );
+  settings->set( "exhaustive_lines", exhaustive_lines );
   result = xorsat_equivalence_check( circuits[id1], circuits[id2], settings, statistics );
 
   print_runtime();
@@ -84,7 +88,8 @@ command::log_opt_t rec_command::log() const
 {
   return log_opt_t({
       {"runtime", statistics->get<double>( "runtime" )},
-      {"equivalent", result}
+      {"equivalent", result},
+      {"decided_by_simulation", statistics->get<bool>( "decided_by_simulation" )}
     });
 }
 
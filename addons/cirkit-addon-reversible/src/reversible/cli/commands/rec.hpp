@@ -55,6 +55,8 @@ public:
 private:
   unsigned id1 = 0u;
   unsigned id2 = 1u;
+  unsigned sim_words = 64u;
+  unsigned exhaustive_lines = 16u;
   bool result;
 };
 
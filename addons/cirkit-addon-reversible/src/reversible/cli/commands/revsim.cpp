@@ -31,6 +31,7 @@
 
 #include <alice/rules.hpp>
 #include <reversible/cli/stores.hpp>
+#include <reversible/simulation/bitsliced_simulation.hpp>
 #include <reversible/simulation/partial_simulation.hpp>
 #include <reversible/simulation/simple_simulation.hpp>
 
@@ -44,6 +45,7 @@ revsim_command::revsim_command( const environment::ptr& env )
 {
   opts.add_options()
     ( "partial,r",                    "use partial simulation" )
+    ( "all,a",                        "simulate all input patterns (bit-sliced)" )
     ( "pattern,p", value( &pattern ), "simulation pattern" )
     ;
   add_positional_option( "pattern" );
@@ -53,6 +55,9 @@ command::rules_t revsim_command::validity_rules() const
 {
   return {
     has_store_element<circuit>( env ),
+    {[this]() { return !is_set( "all" ) || !is_set( "partial" ); }, "all and partial cannot be combined" },
+    {[this]() { return !is_set( "all" ) || env->store<circuit>().current().lines() <= 20u; }, "all supports circuits with at most 20 lines" },
+    {[this]() { return !is_set( "all" ) || bitsliced_simulator::is_supported( env->store<circuit>().current() ); }, "all supports Toffoli, Fredkin, and Peres gates only" },
     {[this]() {
         /* ext. pattern? */
         if ( pattern == "0*" || pattern == "1*") { return true; }
@@ -66,7 +71,8 @@ command::rules_t revsim_command::validity_rules() const
         }
         return true;
       }, "pattern must consists of 0s and 1s" },
-    {[this]() { return pattern == "0*" ||
+    {[this]() { return is_set( "all" ) ||
+                       pattern == "0*" ||
                        pattern == "1*" ||
                        ( is_set( "partial" ) || env->store<circuit>().current().lines() == pattern.size() ); }, "pattern bits must equal number of lines" }
   };
@@ -76,6 +82,27 @@ bool revsim_command::execute()
 {
   const auto& circuits = env->store<circuit>();
 
+  if ( is_set( "all" ) )
+  {
+    const auto n = circuits.current().lines();
+    const bitsliced_simulator sim( circuits.current() );
+
+    sim.foreach_pattern_block( [n]( std::uint64_t first, std::uint64_t count, const bitsliced_simulator::state_t&, const bitsliced_simulator::state_t& outputs, unsigned num_words ) {
+        for ( auto p = 0ull; p < count; ++p )
+        {
+          boost::dynamic_bitset<> output( n );
+          for ( auto l = 0u; l < n; ++l )
+          {
+            output[l] = ( outputs[l * num_words + ( p >> 6u )] >> ( p & 63u ) ) & 1u;
+          }
+          std::cout << boost::dynamic_bitset<>( n, first + p ) << " " << output << std::endl;
+        }
+        return true;
+      } );
+
+    return true;
+  }
+
   /* prepare pattern */
   if ( pattern == "0*" || pattern == "1*" )
   {
@@ -30,6 +30,8 @@
 
 #include <core/properties.hpp>
 #include <core/utils/bitset_utils.hpp>
+#include <reversible/simulation/bitsliced_simulation.hpp>
+#include <reversible/simulation/simple_simulation.hpp>
 
 namespace cirkit
 {
@@ -77,6 +79,44 @@ namespace cirkit
     return true;
   }
 
+  bool circuit_to_truth_table( const circuit& circ, binary_truth_table& spec )
+  {
+    if ( !bitsliced_simulator::is_supported( circ ) || circ.lines() >= 64u )
+    {
+      return circuit_to_truth_table( circ, spec, simple_simulation_func() );
+    }
+
+    const bitsliced_simulator sim( circ );
+    const auto n = circ.lines();
+
+    binary_truth_table::cube_type in_cube( n ), out_cube( n );
+
+    sim.foreach_pattern_block( [&]( std::uint64_t first, std::uint64_t count, const bitsliced_simulator::state_t&, const bitsliced_simulator::state_t& outputs, unsigned num_words ) {
+        for ( auto p = 0ull; p < count; ++p )
+        {
+          const auto word = p >> 6u;
+          const auto bit  = p & 63u;
+
+          for ( auto l = 0u; l < n; ++l )
+          {
+            in_cube[l]  = ( ( first + p ) >> l ) & 1u ? true : false;
+            out_cube[l] = ( outputs[l * num_words + word] >> bit ) & 1u ? true : false;
+          }
+
+          spec.add_entry( in_cube, out_cube );
+        }
+        return true;
+      } );
+
+    // metadata
+    spec.set_inputs( circ.inputs() );
+    spec.set_outputs( circ.outputs() );
+    spec.set_constants( circ.constants() );
+    spec.set_garbage( circ.garbage() );
+
+    return true;
+  }
+
 }
 
 // Local Variables:
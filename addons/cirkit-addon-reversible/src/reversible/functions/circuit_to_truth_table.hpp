@@ -62,6 +62,22 @@ namespace cirkit
    */
   bool circuit_to_truth_table( const circuit& circ, binary_truth_table& spec, const functor<bool(boost::dynamic_bitset<>&, const circuit&, const boost::dynamic_bitset<>&)>& simulation );
 
+  /**
+   * @brief Generates a truth table from a circuit using bit-sliced simulation
+   *
+   * Simulates 64 patterns per word operation using \ref cirkit::bitsliced_simulator "bitsliced_simulator"
+   * and falls back to \ref cirkit::simple_simulation "simple_simulation" if the circuit
+   * contains gates that are not supported by the bit-sliced simulator.
+   *
+   * @param circ Circuit to be simulated
+   * @param spec Empty truth table to be constructed
+   *
+   * @return true on success, false otherwise
+   *
+   * @since  2.3
+   */
+  bool circuit_to_truth_table( const circuit& circ, binary_truth_table& spec );
+
 }
 
 #endif /* CIRCUIT_TO_TRUTH_TABLE_HPP */
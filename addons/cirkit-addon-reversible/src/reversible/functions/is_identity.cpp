@@ -30,12 +30,30 @@
 #include <boost/range/numeric.hpp>
 
 #include <reversible/rcbdd.hpp>
+#include <reversible/simulation/bitsliced_simulation.hpp>
 
 namespace cirkit
 {
 
 bool is_identity( const circuit& circ )
 {
+  if ( bitsliced_simulator::is_supported( circ ) )
+  {
+    const bitsliced_simulator sim( circ );
+
+    /* small circuits are decided by exhaustive simulation */
+    if ( circ.lines() <= 20u )
+    {
+      return bitsliced_is_identity( sim );
+    }
+
+    /* try to refute cheaply before building BDDs */
+    if ( !bitsliced_is_identity_on_random_patterns( sim, 64u ) )
+    {
+      return false;
+    }
+  }
+
   rcbdd mgr;
   mgr.initialize_manager();
   mgr.create_variables( circ.lines() );
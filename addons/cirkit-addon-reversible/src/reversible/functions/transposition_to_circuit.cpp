@@ -71,7 +71,7 @@ namespace cirkit
         {
           if ( k != target )
           {
-            controls += make_var( k );
+            controls.push_back( make_var( k ) );
           }
         }
         append_toffoli( circ_block_c, controls, target );
@@ -88,7 +88,7 @@ namespace cirkit
         {
           if ( k != target )
           {
-            controls += make_var( k );
+            controls.push_back( make_var( k ) );
           }
         }
         append_toffoli( circ_block_c, controls, target );
@@ -26,100 +26,146 @@
 
 #include "gate.hpp"
 
-#include <boost/assign/std/vector.hpp>
-#include <boost/range/adaptors.hpp>
-#include <boost/range/algorithm.hpp>
+#include <algorithm>
+
+#include <reversible/target_tags.hpp>
 
 namespace cirkit
 {
-  using namespace boost::assign;
-
-  class gate::priv
-  {
-  public:
-    priv() {}
-
-    priv( priv& other )
-      : controls( other.controls ),
-        targets( other.targets ),
-        target_type( other.target_type ) {}
-
-      control_container controls;
-      target_container targets;
-      boost::any     target_type;
-  };
-
 
   gate::gate()
-    : d( new priv() )
   {
   }
 
   gate::gate( const gate& other )
-    : d( new priv() )
   {
     operator=( other );
   }
 
+  gate::gate( gate&& other )
+    : _controls( std::move( other._controls ) ),
+      _targets( std::move( other._targets ) ),
+      _kind( other._kind ),
+      _type( std::move( other._type ) )
+  {
+  }
+
   gate::~gate()
   {
-    delete d;
   }
 
   gate& gate::operator=( const gate& other )
   {
     if ( this != &other )
     {
-      d->controls = other.controls();
-      d->targets = other.targets();
-      d->target_type = other.type();
+      _controls = other._controls;
+      _targets = other._targets;
+      _kind = other._kind;
+      _type = other._type;
+    }
+    return *this;
+  }
+
+  gate& gate::operator=( gate&& other )
+  {
+    if ( this != &other )
+    {
+      _controls = std::move( other._controls );
+      _targets = std::move( other._targets );
+      _kind = other._kind;
+      _type = std::move( other._type );
     }
     return *this;
   }
 
   gate::control_container& gate::controls() const
   {
-    return d->controls;
+    return _controls;
   }
 
   gate::target_container& gate::targets() const
   {
-    return d->targets;
+    return _targets;
   }
 
   unsigned gate::size() const
   {
-    return d->controls.size() + d->targets.size();
+    return _controls.size() + _targets.size();
   }
 
   void gate::add_control( variable c )
   {
-    d->controls += c;
+    _controls.push_back( c );
   }
 
   void gate::remove_control( variable c )
   {
-    d->controls.erase( boost::remove( d->controls, c ) );
+    _controls.erase( std::remove( _controls.begin(), _controls.end(), c ), _controls.end() );
   }
 
   void gate::add_target( unsigned l )
   {
-    d->targets += l;
+    _targets.push_back( l );
   }
 
   void gate::remove_target( unsigned l )
   {
-    d->targets.erase( boost::remove( d->targets, l ) );
+    _targets.erase( std::remove( _targets.begin(), _targets.end(), l ), _targets.end() );
   }
 
   void gate::set_type( const boost::any& t )
   {
-    d->target_type = t;
+    if ( t.empty() )
+    {
+      _kind = gate_kind::none;
+    }
+    else if ( is_type<toffoli_tag>( t ) )
+    {
+      _kind = gate_kind::toffoli;
+    }
+    else if ( is_type<fredkin_tag>( t ) )
+    {
+      _kind = gate_kind::fredkin;
+    }
+    else if ( is_type<peres_tag>( t ) )
+    {
+      _kind = gate_kind::peres;
+    }
+    else
+    {
+      if ( is_type<module_tag>( t ) )
+      {
+        _kind = gate_kind::module;
+      }
+      else if ( is_type<stg_tag>( t ) )
+      {
+        _kind = gate_kind::stg;
+      }
+      else
+      {
+        _kind = gate_kind::other;
+      }
+      _type = t;
+      return;
+    }
+
+    /* the common tags carry no data and are not stored */
+    _type = boost::any();
   }
 
   const boost::any& gate::type() const
   {
-    return d->target_type;
+    static const boost::any toffoli_type = toffoli_tag();
+    static const boost::any fredkin_type = fredkin_tag();
+    static const boost::any peres_type   = peres_tag();
+
+    switch ( _kind )
+    {
+    case gate_kind::toffoli: return toffoli_type;
+    case gate_kind::fredkin: return fredkin_type;
+    case gate_kind::peres:   return peres_type;
+    default:                 return _type;
+    }
   }
 
 }
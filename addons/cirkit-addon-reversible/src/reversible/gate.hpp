@@ -45,9 +45,30 @@
 
 #include <boost/any.hpp>
 
+#include <core/utils/small_vector.hpp>
+
 namespace cirkit
 {
 
+  /**
+   * @brief Kind of a gate, derived from its type tag
+   *
+   * The kind is cached when the type is set such that checks like
+   * is_toffoli() do not need to inspect the boost::any type tag.
+   *
+   * @since  2.3
+   */
+  enum class gate_kind : unsigned char
+  {
+    none,
+    toffoli,
+    fredkin,
+    peres,
+    module,
+    stg,
+    other
+  };
+
   /**
    * @brief Represents a gate in a circuit
    *
@@ -64,15 +85,21 @@ namespace cirkit
 
     /**
      * @brief Container for storing control lines
+     *
+     * Up to four controls are stored inline without heap allocation.
+     *
      * @since  2.0
      */
-    using control_container = std::vector<variable>;
+    using control_container = small_vector<variable, 4u>;
 
     /**
      * @brief Container for storing target lines
+     *
+     * Up to two targets are stored inline without heap allocation.
+     *
      * @since 2.0
      */
-    using target_container = std::vector<unsigned>;
+    using target_container = small_vector<unsigned, 2u>;
 
   public:
     /**
@@ -96,13 +123,20 @@ namespace cirkit
     gate( const gate& other );
 
     /**
-     * @brief Default deconstructor
+     * @brief Move Constructor
      *
-     * Clears private data
+     * @param other Gate to be moved
+     *
+     * @since  2.3
+     */
+    gate( gate&& other );
+
+    /**
+     * @brief Default deconstructor
      *
      * @since  1.0
      */
-    virtual ~gate();
+    ~gate();
 
     /**
      * @brief Assignment operator
@@ -115,6 +149,17 @@ namespace cirkit
      */
     gate& operator=( const gate& other );
 
+    /**
+     * @brief Move assignment operator
+     *
+     * @param other Gate to be moved
+     *
+     * @return Pointer to instance
+     *
+     * @since  2.3
+     */
+    gate& operator=( gate&& other );
+
     /**
      * @brief Returns the control lines
      *
@@ -139,7 +184,7 @@ namespace cirkit
      *
      * @return Number of control and target lines.
      */
-    virtual unsigned size() const;
+    unsigned size() const;
 
     /**
      * @brief Adds a control line to the gate
@@ -148,7 +193,7 @@ namespace cirkit
      *
      * @since 1.0
      */
-    virtual void add_control( variable c );
+    void add_control( variable c );
 
     /**
      * @brief Remove control line to the gate
@@ -157,7 +202,7 @@ namespace cirkit
      *
      * @since 1.0
      */
-    virtual void remove_control( variable c );
+    void remove_control( variable c );
 
     /**
      * @brief Adds a target to the desired line
@@ -166,7 +211,7 @@ namespace cirkit
      *
      * @since 1.0
      */
-    virtual void add_target( unsigned l );
+    void add_target( unsigned l );
 
     /**
      * @brief Removes a target from the desired line
@@ -175,7 +220,7 @@ namespace cirkit
      *
      * @since 1.0
      */
-    virtual void remove_target( unsigned l );
+    void remove_target( unsigned l );
 
     /**
      * @brief Sets the type of the target line(s)
@@ -184,7 +229,7 @@ namespace cirkit
      *
      * @since  1.0
      */
-    virtual void set_type( const boost::any& t );
+    void set_type( const boost::any& t );
 
     /**
      * @brief Returns the type of the target line(s)
@@ -193,11 +238,24 @@ namespace cirkit
      *
      * @since  1.0
      */
-    virtual const boost::any& type() const;
+    const boost::any& type() const;
+
+    /**
+     * @brief Returns the kind of the gate
+     *
+     * @return gate kind, derived from the type tag
+     *
+     * @since  2.3
+     */
+    inline gate_kind kind() const { return _kind; }
 
   private:
-    class priv;
-    priv* const d;
+    mutable control_container _controls;
+    mutable target_container  _targets;
+    gate_kind                 _kind = gate_kind::none;
+
+    /* only set for module, STG, and other custom type tags */
+    boost::any                _type;
   };
 }
 
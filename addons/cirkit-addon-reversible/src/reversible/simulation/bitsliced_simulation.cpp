@@ -0,0 +1,232 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "bitsliced_simulation.hpp"
+
+#include <cassert>
+#include <random>
+
+#include <reversible/gate.hpp>
+#include <reversible/target_tags.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/* value of line l < 6 in 64 consecutive patterns in counting order */
+static const std::uint64_t projections[] = {
+  0xaaaaaaaaaaaaaaaaull,
+  0xccccccccccccccccull,
+  0xf0f0f0f0f0f0f0f0ull,
+  0xff00ff00ff00ff00ull,
+  0xffff0000ffff0000ull,
+  0xffffffff00000000ull
+};
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+bitsliced_simulator::bitsliced_simulator( const circuit& circ )
+  : num_lines( circ.lines() )
+{
+  program.reserve( circ.num_gates() );
+
+  for ( const auto& g : circ )
+  {
+    instruction ins;
+    ins.first_control = controls.size();
+
+    if ( is_toffoli( g ) )
+    {
+      ins.op = opcode::toffoli;
+      ins.target1 = ins.target2 = g.targets().front();
+      for ( const auto& c : g.controls() )
+      {
+        controls.push_back( {c.line(), c.polarity() ? 0ull : ~0ull} );
+      }
+    }
+    else if ( is_fredkin( g ) )
+    {
+      ins.op = opcode::fredkin;
+      ins.target1 = g.targets().at( 0u );
+      ins.target2 = g.targets().at( 1u );
+      for ( const auto& c : g.controls() )
+      {
+        controls.push_back( {c.line(), c.polarity() ? 0ull : ~0ull} );
+      }
+    }
+    else if ( is_peres( g ) )
+    {
+      /* only the first control is considered, as in core_gate_simulation */
+      ins.op = opcode::peres;
+      ins.target1 = g.targets().at( 0u );
+      ins.target2 = g.targets().at( 1u );
+      const auto& c = g.controls().front();
+      controls.push_back( {c.line(), c.polarity() ? 0ull : ~0ull} );
+    }
+    else
+    {
+      throw "unsupported gate type for bit-sliced simulation";
+    }
+
+    ins.num_controls = controls.size() - ins.first_control;
+    program.push_back( ins );
+  }
+}
+
+bool bitsliced_simulator::is_supported( const circuit& circ )
+{
+  for ( const auto& g : circ )
+  {
+    if ( !is_toffoli( g ) && !is_fredkin( g ) && !is_peres( g ) )
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void bitsliced_simulator::simulate( state_t& state, unsigned num_words ) const
+{
+  assert( state.size() >= num_lines * num_words );
+
+  std::vector<std::uint64_t> mask( num_words );
+
+  for ( const auto& ins : program )
+  {
+    /* word-wise conjunction of all controls */
+    std::fill( mask.begin(), mask.end(), ~0ull );
+    for ( auto i = ins.first_control; i < ins.first_control + ins.num_controls; ++i )
+    {
+      const auto& c = controls[i];
+      const auto* src = &state[c.line * num_words];
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        mask[w] &= src[w] ^ c.complement;
+      }
+    }
+
+    auto* t1 = &state[ins.target1 * num_words];
+    auto* t2 = &state[ins.target2 * num_words];
+
+    switch ( ins.op )
+    {
+    case opcode::toffoli:
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        t1[w] ^= mask[w];
+      }
+      break;
+
+    case opcode::fredkin:
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        const auto diff = ( t1[w] ^ t2[w] ) & mask[w];
+        t1[w] ^= diff;
+        t2[w] ^= diff;
+      }
+      break;
+
+    case opcode::peres:
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        t2[w] ^= t1[w] & mask[w];
+        t1[w] ^= mask[w];
+      }
+      break;
+    }
+  }
+}
+
+void bitsliced_simulator::assign_counting_patterns( state_t& state, std::uint64_t first_word, unsigned num_words ) const
+{
+  state.resize( num_lines * num_words );
+
+  for ( auto l = 0u; l < num_lines; ++l )
+  {
+    auto* dst = &state[l * num_words];
+
+    if ( l < 6u )
+    {
+      std::fill( dst, dst + num_words, projections[l] );
+    }
+    else if ( l - 6u < 64u )
+    {
+      for ( auto w = 0u; w < num_words; ++w )
+      {
+        dst[w] = ( ( first_word + w ) >> ( l - 6u ) ) & 1u ? ~0ull : 0ull;
+      }
+    }
+    else
+    {
+      std::fill( dst, dst + num_words, 0ull );
+    }
+  }
+}
+
+void bitsliced_simulator::assign_random_patterns( state_t& state, unsigned num_words, unsigned seed ) const
+{
+  std::mt19937_64 gen( seed );
+
+  state.resize( num_lines * num_words );
+  std::generate( state.begin(), state.end(), gen );
+}
+
+bool bitsliced_is_identity( const bitsliced_simulator& sim )
+{
+  assert( sim.lines() < 64u );
+
+  return sim.foreach_pattern_block( []( std::uint64_t, std::uint64_t, const bitsliced_simulator::state_t& inputs, const bitsliced_simulator::state_t& outputs, unsigned ) {
+      return inputs == outputs;
+    } );
+}
+
+bool bitsliced_is_identity_on_random_patterns( const bitsliced_simulator& sim, unsigned num_words, unsigned seed )
+{
+  bitsliced_simulator::state_t inputs, outputs;
+
+  sim.assign_random_patterns( inputs, num_words, seed );
+  outputs = inputs;
+  sim.simulate( outputs, num_words );
+
+  return inputs == outputs;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,146 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file bitsliced_simulation.hpp
+ *
+ * @brief Bit-sliced simulation of reversible circuits
+ *
+ * Every circuit line is represented by a vector of 64-bit words,
+ * where bit j of word w holds the value of the line for pattern
+ * 64 * w + j.  A gate is then simulated for 64 patterns at once
+ * using word-wide AND, XOR, and swap operations.  The gate list is
+ * compiled into a flat instruction stream once and can be simulated
+ * on arbitrarily many pattern blocks afterwards.
+ *
+ * Supported gate types are Toffoli (also with negative controls),
+ * Fredkin, and Peres gates.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef BITSLICED_SIMULATION_HPP
+#define BITSLICED_SIMULATION_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include <reversible/circuit.hpp>
+
+namespace cirkit
+{
+
+class bitsliced_simulator
+{
+public:
+  /* state holds num_words words per line, words of line l start at index l * num_words */
+  using state_t = std::vector<std::uint64_t>;
+
+  explicit bitsliced_simulator( const circuit& circ );
+
+  /* true, if all gates of circ can be compiled */
+  static bool is_supported( const circuit& circ );
+
+  inline unsigned lines() const { return num_lines; }
+
+  /* simulates all num_words * 64 patterns in state in-place */
+  void simulate( state_t& state, unsigned num_words ) const;
+
+  /* assigns patterns 64 * first_word, ..., 64 * ( first_word + num_words ) - 1 in counting order,
+     i.e., line l carries bit l of the pattern index */
+  void assign_counting_patterns( state_t& state, std::uint64_t first_word, unsigned num_words ) const;
+
+  /* assigns random patterns */
+  void assign_random_patterns( state_t& state, unsigned num_words, unsigned seed ) const;
+
+  /* simulates all 2^n patterns in counting order in blocks of at most block_words words
+     and calls f( first_pattern, num_patterns, inputs, outputs, num_words ) for each block;
+     stops early and returns false as soon as f returns false */
+  template<typename Fn>
+  bool foreach_pattern_block( Fn&& f, unsigned block_words = 64u ) const
+  {
+    const auto total_words = num_lines <= 6u ? 1ull : ( 1ull << ( num_lines - 6u ) );
+    const auto num_patterns = num_lines < 6u ? ( 1ull << num_lines ) : 64ull;
+
+    state_t inputs, outputs;
+
+    for ( auto first_word = 0ull; first_word < total_words; first_word += block_words )
+    {
+      const auto num_words = static_cast<unsigned>( std::min<unsigned long long>( block_words, total_words - first_word ) );
+
+      assign_counting_patterns( inputs, first_word, num_words );
+      outputs = inputs;
+      simulate( outputs, num_words );
+
+      if ( !f( first_word << 6u, num_words * num_patterns, inputs, outputs, num_words ) )
+      {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+private:
+  enum class opcode : unsigned { toffoli, fredkin, peres };
+
+  struct instruction
+  {
+    opcode   op;
+    unsigned target1;
+    unsigned target2;
+    unsigned first_control; /* index into controls */
+    unsigned num_controls;
+  };
+
+  struct control
+  {
+    unsigned      line;
+    std::uint64_t complement; /* all-ones for negative controls */
+  };
+
+  unsigned                 num_lines;
+  std::vector<instruction> program;
+  std::vector<control>     controls;
+};
+
+/* exhaustively checks whether the circuit computes the identity (requires fewer than 64 lines) */
+bool bitsliced_is_identity( const bitsliced_simulator& sim );
+
+/* returns false, if some of num_words * 64 random patterns is not mapped to itself */
+bool bitsliced_is_identity_on_random_patterns( const bitsliced_simulator& sim, unsigned num_words, unsigned seed = 0u );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
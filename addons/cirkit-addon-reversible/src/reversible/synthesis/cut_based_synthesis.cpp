@@ -514,7 +514,7 @@ bool cut_based_synthesis( circuit& circ, const aig_graph& aig,
               std::cout << inputs[pos] << " is not in node_to_line" << std::endl;
               assert( false );
             }
-            controls += make_var( node_to_line[inputs[pos]], cube.first.test( pos ) );
+            controls.push_back( make_var( node_to_line[inputs[pos]], cube.first.test( pos ) ) );
           } );
 
         append_toffoli( circ, controls, target );
@@ -633,7 +633,7 @@ bool cut_based_synthesis( circuit& circ, const aig_graph& aig,
         gate::control_container controls;
         for ( const auto& c : g.controls() )
         {
-          controls += make_var( circuit_line_map[c.line()], c.polarity() );
+          controls.push_back( make_var( circuit_line_map[c.line()], c.polarity() ) );
         }
         append_toffoli( circ, controls, circuit_line_map[g.targets().front()] );
       }
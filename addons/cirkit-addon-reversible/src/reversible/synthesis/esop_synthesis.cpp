@@ -248,7 +248,7 @@ bool esop_synthesis( circuit& circ, const std::string& filename, properties::ptr
       {
         if ( in_bit )
         {
-          controls += make_var( ( 1u - *in_bit ) * n + index ); // considers polarity to choose line
+          controls.push_back( make_var( ( 1u - *in_bit ) * n + index ) ); // considers polarity to choose line
         }
         ++index;
       }
@@ -319,7 +319,7 @@ bool esop_synthesis( circuit& circ, const std::string& filename, properties::ptr
         {
           if ( negative_control_lines )
           {
-            controls += make_var( index, *in_bit );
+            controls.push_back( make_var( index, *in_bit ) );
           }
           else
           {
@@ -328,7 +328,7 @@ bool esop_synthesis( circuit& circ, const std::string& filename, properties::ptr
               append_not( circ, index );
               polarity.at( index ) = *in_bit;
             }
-            controls += make_var( index );
+            controls.push_back( make_var( index ) );
           }
         }
         ++index;
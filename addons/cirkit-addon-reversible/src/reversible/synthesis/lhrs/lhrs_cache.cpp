@@ -0,0 +1,287 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "lhrs_cache.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+
+#include <boost/any.hpp>
+#include <boost/format.hpp>
+
+#include <reversible/gate.hpp>
+#include <reversible/target_tags.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+bool is_writable( const circuit& circ )
+{
+  return std::all_of( circ.begin(), circ.end(), []( const gate& g ) {
+      return ( is_toffoli( g ) || is_stg( g ) ) && g.targets().size() == 1u;
+    } );
+}
+
+std::string hex_or_dash( const boost::dynamic_bitset<>& bs )
+{
+  return bs.empty() ? std::string( "-" ) : tt_to_hex( bs );
+}
+
+bool is_hex_or_dash( const std::string& s )
+{
+  return s == "-" || ( !s.empty() && std::all_of( s.begin(), s.end(), []( char c ) { return std::isxdigit( static_cast<unsigned char>( c ) ) != 0; } ) );
+}
+
+boost::dynamic_bitset<> bitset_from_hex_or_dash( const std::string& s )
+{
+  return s == "-" ? boost::dynamic_bitset<>() : tt_from_hex( s );
+}
+
+void write_gate( std::ostream& os, const gate& g )
+{
+  if ( is_toffoli( g ) )
+  {
+    os << "t " << g.targets().front();
+  }
+  else
+  {
+    const auto& stg = boost::any_cast<stg_tag>( g.type() );
+    os << boost::format( "s %d %s %s" ) % g.targets().front() % hex_or_dash( stg.function ) % hex_or_dash( stg.affine_class );
+  }
+
+  for ( const auto& c : g.controls() )
+  {
+    os << ( c.polarity() ? " " : " !" ) << c.line();
+  }
+  os << std::endl;
+}
+
+bool read_gate( const std::string& line, circuit& circ )
+{
+  std::istringstream is( line );
+
+  std::string type;
+  unsigned target;
+  if ( !( is >> type >> target ) || ( type != "t" && type != "s" ) || target >= circ.lines() )
+  {
+    return false;
+  }
+
+  std::string function, affine_class;
+  if ( type == "s" && !( is >> function >> affine_class && is_hex_or_dash( function ) && is_hex_or_dash( affine_class ) ) )
+  {
+    return false;
+  }
+
+  gate::control_container controls;
+  std::string control;
+  while ( is >> control )
+  {
+    const auto polarity = control[0] != '!';
+    std::istringstream cs( polarity ? control : control.substr( 1u ) );
+    unsigned index;
+    if ( !( cs >> index ) || !cs.eof() || index >= circ.lines() || index == target )
+    {
+      return false;
+    }
+    controls.push_back( make_var( index, polarity ) );
+  }
+
+  auto& g = circ.append_gate();
+  for ( const auto& c : controls )
+  {
+    g.add_control( c );
+  }
+  g.add_target( target );
+
+  if ( type == "t" )
+  {
+    g.set_type( toffoli_tag() );
+  }
+  else
+  {
+    stg_tag stg;
+    stg.function = bitset_from_hex_or_dash( function );
+    stg.affine_class = bitset_from_hex_or_dash( affine_class );
+    g.set_type( stg );
+    if ( affine_class != "-" )
+    {
+      circ.annotate( g, "affine", affine_class );
+    }
+  }
+
+  return true;
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+lhrs_cache::lhrs_cache( const std::string& signature )
+  : signature( signature )
+{
+}
+
+lhrs_cache::entry_ptr lhrs_cache::lookup( const std::string& key ) const
+{
+  const auto it = entries.find( key );
+  return it == entries.end() ? entry_ptr() : it->second;
+}
+
+void lhrs_cache::insert( const std::string& key, const entry_ptr& e )
+{
+  entries[key] = e;
+}
+
+bool lhrs_cache::read( const std::string& filename )
+{
+  std::ifstream is( filename.c_str(), std::ifstream::in );
+
+  std::string line;
+  if ( !std::getline( is, line ) || line != "lhrs-cache 1" ||
+       !std::getline( is, line ) || line != "signature " + signature )
+  {
+    return false;
+  }
+
+  /* entries are only taken over if the whole file is valid */
+  decltype( entries ) read_entries;
+
+  while ( std::getline( is, line ) )
+  {
+    std::istringstream ls( line );
+    std::string tag, key;
+    unsigned lut_based, lines, num_gates;
+
+    if ( !( ls >> tag >> key >> lut_based >> lines >> num_gates ) || tag != "entry" )
+    {
+      return false;
+    }
+
+    auto e = std::make_shared<entry>();
+    e->circ.set_lines( lines );
+    e->lut_based = lut_based != 0u;
+
+    for ( auto i = 0u; i < num_gates; ++i )
+    {
+      if ( !std::getline( is, line ) || !read_gate( line, e->circ ) )
+      {
+        return false;
+      }
+    }
+
+    read_entries[key] = e;
+  }
+
+  for ( auto& kv : read_entries )
+  {
+    entries[kv.first] = std::move( kv.second );
+  }
+
+  return true;
+}
+
+bool lhrs_cache::write( const std::string& filename ) const
+{
+  std::ofstream os( filename.c_str(), std::ofstream::out );
+  if ( !os )
+  {
+    return false;
+  }
+
+  os << "lhrs-cache 1" << std::endl
+     << "signature " << signature << std::endl;
+
+  for ( const auto& kv : entries )
+  {
+    const auto& circ = kv.second->circ;
+    if ( !is_writable( circ ) ) { continue; }
+
+    os << boost::format( "entry %s %d %d %d" ) % kv.first % kv.second->lut_based % circ.lines() % circ.num_gates() << std::endl;
+    for ( const auto& g : circ )
+    {
+      write_gate( os, g );
+    }
+  }
+
+  return static_cast<bool>( os );
+}
+
+tt lhrs_cache_canonize( const tt& func, unsigned num_inputs, std::vector<unsigned>& position )
+{
+  std::vector<std::size_t> weight( num_inputs );
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    weight[i] = tt_cof1( func, i ).count();
+  }
+
+  /* order[j] is the input at canonical position j */
+  std::vector<unsigned> order( num_inputs );
+  std::iota( order.begin(), order.end(), 0u );
+  std::stable_sort( order.begin(), order.end(), [&weight]( unsigned a, unsigned b ) { return weight[a] < weight[b]; } );
+
+  /* move inputs to their position by swapping variables */
+  std::vector<unsigned> input_at( num_inputs );
+  position.resize( num_inputs );
+  std::iota( input_at.begin(), input_at.end(), 0u );
+  std::iota( position.begin(), position.end(), 0u );
+
+  auto canon = func;
+  for ( auto j = 0u; j < num_inputs; ++j )
+  {
+    const auto i = order[j];
+    const auto p = position[i];
+    if ( p == j ) { continue; }
+
+    canon = tt_permute( canon, j, p );
+
+    const auto other = input_at[j];
+    std::swap( input_at[j], input_at[p] );
+    position[other] = p;
+    position[i] = j;
+  }
+
+  return canon;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,103 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file lhrs_cache.hpp
+ *
+ * @brief Cache for synthesized LUTs in LHRS
+ *
+ * Maps LUT functions to synthesized gate sequences.  Functions are
+ * canonized under input permutation by sorting the inputs according to
+ * the number of minterms in their positive cofactor (ties keep the
+ * original order), such that many LUTs that only differ in the order
+ * of their inputs share one entry.  Gates are stored on abstract lines:
+ * the canonical inputs 0, ..., k - 1, the target k, and clean ancillae
+ * k + 1, k + 2, ...
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef LHRS_CACHE_HPP
+#define LHRS_CACHE_HPP
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <classical/utils/truth_table_utils.hpp>
+#include <reversible/circuit.hpp>
+
+namespace cirkit
+{
+
+class lhrs_cache
+{
+public:
+  struct entry
+  {
+    circuit circ;      /* gates on abstract lines */
+    bool    lut_based; /* synthesized by LUT decomposition */
+  };
+
+  using entry_ptr = std::shared_ptr<const entry>;
+
+public:
+  /* signature describes the synthesis parameters, files with another signature are ignored */
+  explicit lhrs_cache( const std::string& signature );
+
+  entry_ptr lookup( const std::string& key ) const;
+  void insert( const std::string& key, const entry_ptr& e );
+
+  inline std::size_t size() const { return entries.size(); }
+
+  /* entries with other gates than Toffoli and STG gates are not written */
+  bool read( const std::string& filename );
+  bool write( const std::string& filename ) const;
+
+private:
+  std::string                                signature;
+  std::unordered_map<std::string, entry_ptr> entries;
+};
+
+/**
+ * @brief Canonizes a LUT function under input permutation
+ *
+ * func must have at least num_inputs variables.  Returns the canonical
+ * function, position[i] is the canonical position of input i.
+ */
+tt lhrs_cache_canonize( const tt& func, unsigned num_inputs, std::vector<unsigned>& position );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
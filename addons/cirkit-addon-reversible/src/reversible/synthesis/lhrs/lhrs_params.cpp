@@ -145,6 +145,10 @@ std::istream& operator>>( std::istream& in, exorcism_script& script )
   {
     script = exorcism_script::def_wo4;
   }
+  else if ( token == "parallel" || token == "3" )
+  {
+    script = exorcism_script::parallel;
+  }
   else
   {
     in.setstate( std::ios_base::failbit );
@@ -162,6 +166,8 @@ std::ostream& operator<<( std::ostream& out, const exorcism_script& script )
     return out << "def";
   case exorcism_script::def_wo4:
     return out << "def_wo4";
+  case exorcism_script::parallel:
+    return out << "parallel";
   }
 
   return out;
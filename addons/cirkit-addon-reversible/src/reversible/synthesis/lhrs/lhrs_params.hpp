@@ -72,6 +72,7 @@ struct lhrs_params
   gia_graph::esop_cover_method cover_method       = gia_graph::esop_cover_method::aig_threshold; /* method to extract initial ESOP cover */
   bool                         optimize_postesop  = false;                                       /* post-optimize ESOP cover */
   exorcism_script              script             = exorcism_script::def_wo4;                    /* optimize ESOP synthesized circuit */
+  unsigned                     exorcism_threads   = 0u;                                          /* threads for parallel exorcism script, 0u: one per core */
 
   lhrs_mapping_strategy        mapping_strategy   = lhrs_mapping_strategy::direct;               /* mapping strategy */
   bool                         satlut             = false;                                       /* perform SAT-based LUT mapping as post-processing step */
@@ -80,6 +81,11 @@ struct lhrs_params
   unsigned                     class_method       = 0u;                                          /* classification method: 0u: spectral, 1u: affine */
   unsigned                     max_func_size      = 0u;                                          /* max function size for DB lookup, 0u: automatic based on class_method */
 
+  unsigned                     num_threads        = 1u;                                          /* threads for per-LUT synthesis, 1u: serial, 0u: one per core */
+
+  bool                         cache              = false;                                       /* reuse circuits for LUTs with the same function up to input permutation */
+  std::string                  cache_file;                                                       /* load LUT cache from and store it to this file (implies cache) */
+
   bool                         progress           = false;                                       /* show progress line */
   bool                         verbose            = false;                                       /* be verbose */
 
@@ -109,6 +115,19 @@ struct lhrs_stats
   unsigned num_decomp_default = 0u;
   unsigned num_decomp_lut     = 0u;
 
+  /* per-LUT synthesis; with several threads the runtimes above are accumulated CPU times of all threads */
+  unsigned num_threads      = 1u;
+  double   lut_runtime      = 0.0;  /* sum of wall times to synthesize each LUT */
+  double   pipeline_runtime = 0.0;  /* wall time of all synthesis steps */
+  double   wait_runtime     = 0.0;  /* wall time spent waiting for worker threads */
+
+  unsigned cache_hits   = 0u;
+  unsigned cache_misses = 0u;
+
+  /* sub-LUT mappings reused among the decomposition candidates of a LUT */
+  unsigned mapping_cache_hits   = 0u;
+  unsigned mapping_cache_misses = 0u;
+
   std::vector<std::vector<unsigned>> class_counter;
 };
 
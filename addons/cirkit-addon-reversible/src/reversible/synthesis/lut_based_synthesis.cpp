@@ -26,11 +26,19 @@
 
 #include "lut_based_synthesis.hpp"
 
+#include <atomic>
+#include <deque>
 #include <fstream>
+#include <future>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_set>
 #include <vector>
 
+#include <boost/filesystem.hpp>
 #include <boost/format.hpp>
-#include <boost/range/algorithm_ext/push_back.hpp>
 #include <boost/variant.hpp>
 
 #include <core/utils/conversion_utils.hpp>
@@ -38,6 +46,7 @@
 #include <core/utils/range_utils.hpp>
 #include <core/utils/temporary_filename.hpp>
 #include <core/utils/terminal.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/abc/gia/gia.hpp>
 #include <classical/abc/gia/gia_utils.hpp>
@@ -57,6 +66,7 @@
 #include <reversible/io/print_circuit.hpp>
 #include <reversible/optimization/esop_post_optimization.hpp>
 #include <reversible/synthesis/esop_synthesis.hpp>
+#include <reversible/synthesis/lhrs/lhrs_cache.hpp>
 #include <reversible/synthesis/optimal_quantum_circuits.hpp>
 #include <reversible/utils/costs.hpp>
 
@@ -88,6 +98,30 @@ gate& append_stg_from_line_map( circuit& circ, uint64_t func, uint64_t affine_cl
   return g;
 }
 
+/* truth table of a single-output network, with at least 6 variables */
+tt simulate_lut( const gia_graph& lut )
+{
+  const auto num_vars = std::max( 6, lut.num_inputs() );
+
+  std::vector<tt> values( lut.size() );
+  values[0u] = tt( 1u << num_vars );
+
+  lut.foreach_input( [&values, num_vars]( int index, int e ) {
+      values[index] = tt_nth_var( e );
+      tt_extend( values[index], num_vars );
+    } );
+
+  lut.foreach_and( [&values]( int index, abc::Gia_Obj_t* obj ) {
+      const auto& f0 = values[abc::Gia_ObjFaninId0( obj, index )];
+      const auto& f1 = values[abc::Gia_ObjFaninId1( obj, index )];
+      values[index] = ( abc::Gia_ObjFaninC0( obj ) ? ~f0 : f0 ) & ( abc::Gia_ObjFaninC1( obj ) ? ~f1 : f1 );
+    } );
+
+  const auto po = abc::Gia_ManCo( lut, 0 );
+  const auto& f = values[abc::Gia_ObjFaninId0p( lut, po )];
+  return abc::Gia_ObjFaninC0( po ) ? ~f : f;
+}
+
 /******************************************************************************
  * Merge properties                                                           *
  ******************************************************************************/
@@ -417,6 +451,20 @@ private:
  * Partial synthesizers                                                       *
  ******************************************************************************/
 
+/* a single LUT to synthesize; everything that accesses the mapped network is
+   prepared by the manager, such that jobs can be synthesized in any thread */
+struct lut_job
+{
+  unsigned                   step_index;    /* index into the order heuristic's steps */
+  int                        index;         /* LUT node in the mapped network */
+  int                        num_inputs;    /* LUT size */
+  uint64_t                   truth_table;   /* LUT function, if LUT is not extracted */
+  std::shared_ptr<gia_graph> lut;           /* extracted LUT, only if needed */
+  unsigned                   lines;         /* number of lines in the circuit */
+  std::vector<unsigned>      line_map;
+  std::vector<unsigned>      clean_ancilla;
+};
+
 void esop_synthesis_wrapper( const gia_graph& lut, circuit& circ, const std::vector<unsigned>& line_map, const lhrs_params& params, lhrs_stats& stats )
 {
   if ( !params.dumpfile.empty() )
@@ -439,7 +487,7 @@ void esop_synthesis_wrapper( const gia_graph& lut, circuit& circ, const std::vec
   {
     esop = [&esop, &lut, &params, &stats]() {
       increment_timer t( &stats.exorcism_runtime );
-      const auto em_settings = make_settings_from( std::make_pair( "progress", params.progress ), std::make_pair( "script", params.script ) );
+      const auto em_settings = make_settings_from( std::make_pair( "progress", params.progress ), std::make_pair( "script", params.script ), std::make_pair( "num_threads", params.exorcism_threads ) );
       return exorcism_minimization( esop, lut.num_inputs(), lut.num_outputs(), em_settings );
     }();
   }
@@ -467,23 +515,13 @@ void esop_synthesis_wrapper( const gia_graph& lut, circuit& circ, const std::vec
 class lut_partial_synthesizer
 {
 public:
-  explicit lut_partial_synthesizer( const gia_graph& gia, const lhrs_params& params, lhrs_stats& stats )
-    : _gia( gia ),
-      params( params ),
+  explicit lut_partial_synthesizer( const lhrs_params& params, lhrs_stats& stats )
+    : params( params ),
       stats( stats )
   {
   }
 
-  virtual bool compute( circuit& circ, int index, const std::vector<unsigned>& line_map, const std::vector<unsigned>& ancilas ) const = 0;
-
-protected:
-  inline const gia_graph& gia() const
-  {
-    return _gia;
-  }
-
-private:
-  const gia_graph& _gia;
+  virtual bool compute( circuit& circ, const lut_job& job ) const = 0;
 
 protected:
   const lhrs_params& params;
@@ -493,17 +531,15 @@ protected:
 class exorcism_lut_partial_synthesizer : public lut_partial_synthesizer
 {
 public:
-  explicit exorcism_lut_partial_synthesizer( const gia_graph& gia, const lhrs_params& params, lhrs_stats& stats )
-    : lut_partial_synthesizer( gia, params, stats )
+  explicit exorcism_lut_partial_synthesizer( const lhrs_params& params, lhrs_stats& stats )
+    : lut_partial_synthesizer( params, stats )
   {
   }
 
 public:
-  bool compute( circuit& circ, int index, const std::vector<unsigned>& line_map, const std::vector<unsigned>& ancillas ) const
+  bool compute( circuit& circ, const lut_job& job ) const
   {
-    const auto lut = gia().extract_lut( index );
-
-    esop_synthesis_wrapper( lut, circ, line_map, params, stats );
+    esop_synthesis_wrapper( *job.lut, circ, job.line_map, params, stats );
 
     return true;
   }
@@ -512,35 +548,66 @@ public:
 class lutdecomp_lut_partial_synthesizer : public lut_partial_synthesizer
 {
 public:
-  explicit lutdecomp_lut_partial_synthesizer( const gia_graph& gia, const lhrs_params& params, lhrs_stats& stats )
-    : lut_partial_synthesizer( gia, params, stats ),
+  explicit lutdecomp_lut_partial_synthesizer( const lhrs_params& params, lhrs_stats& stats )
+    : lut_partial_synthesizer( params, stats ),
       strategy( params.mapping_strategy ),
-      class_hash( 4u ),
-      lut_size_max( gia.max_lut_size() )
+      class_hash( 4u )
   {
-    gia.init_truth_tables();
   }
 
-  gia_graph compute_sub_lut_db( int index, const std::vector<unsigned>& ancillas ) const
+  /* maps the LUT network of job into k-LUTs; all candidates for the same job
+     share one mapping per configuration, until clear_mappings is called */
+  std::shared_ptr<gia_graph> map_lut( const lut_job& job, unsigned k, bool satlut ) const
+  {
+    const auto key = std::make_pair( k, satlut );
+    const auto it = mappings.find( key );
+    if ( it != mappings.end() )
+    {
+      ++stats.mapping_cache_hits;
+      return it->second;
+    }
+
+    ++stats.mapping_cache_misses;
+
+    increment_timer t( &stats.mapping_runtime );
+    const auto sub_lut = std::make_shared<gia_graph>( job.lut->if_mapping( make_settings_from( std::make_pair( "lut_size", k ),
+                                                                                         "area_mapping",
+                                                                                         std::make_pair( "area_iters", params.area_iters ),
+                                                                                         std::make_pair( "flow_iters", params.flow_iters ) ) ) );
+    if ( satlut )
+    {
+      sub_lut->satlut_mapping();
+    }
+    mappings.insert( std::make_pair( key, sub_lut ) );
+    return sub_lut;
+  }
+
+  /* removes a mapping from the cache before it is modified */
+  void release_mapping( const std::shared_ptr<gia_graph>& sub_lut ) const
+  {
+    for ( auto it = mappings.begin(); it != mappings.end(); ++it )
+    {
+      if ( it->second == sub_lut )
+      {
+        mappings.erase( it );
+        return;
+      }
+    }
+  }
+
+  void clear_mappings()
+  {
+    mappings.clear();
+  }
+
+  std::shared_ptr<gia_graph> compute_sub_lut_db( const lut_job& job, const std::vector<unsigned>& ancillas ) const
   {
     for ( auto k = 3; k <= max_cut_size; ++k )
     {
-      const auto sub_lut = [this, index]() {
-        increment_timer t( &stats.mapping_runtime );
-        const auto lut = gia().extract_lut( index );
-        const auto sub_lut = lut.if_mapping( make_settings_from( std::make_pair( "lut_size", static_cast<unsigned>( max_cut_size ) ),
-                                                                 "area_mapping",
-                                                                 std::make_pair( "area_iters", params.area_iters ),
-                                                                 std::make_pair( "flow_iters", params.flow_iters ) ) );
-        if ( params.satlut )
-        {
-          sub_lut.satlut_mapping();
-        }
-        return sub_lut;
-      }();
+      const auto sub_lut = map_lut( job, static_cast<unsigned>( max_cut_size ), params.satlut );
 
       if ( ( k == max_cut_size ) ||
-           ( sub_lut.lut_count() - 1 <= static_cast<int>( ancillas.size() ) ) )
+           ( sub_lut->lut_count() - 1 <= static_cast<int>( ancillas.size() ) ) )
       {
         return sub_lut;
       }
@@ -549,27 +616,15 @@ public:
     assert( false );
   }
 
-  gia_graph compute_sub_lut_best_fit( int index, const std::vector<unsigned>& ancillas, const unsigned num_inputs ) const
+  std::shared_ptr<gia_graph> compute_sub_lut_best_fit( const lut_job& job, const std::vector<unsigned>& ancillas, const unsigned num_inputs ) const
   {
     const auto max_cut_size = 4 ;
     for ( auto k = static_cast<unsigned>( max_cut_size ); k <= num_inputs; ++k )
     {
-      const auto sub_lut = [this, index, max_cut_size, k]() {
-        increment_timer t( &stats.mapping_runtime );
-        const auto lut = gia().extract_lut( index );
-        const auto sub_lut = lut.if_mapping( make_settings_from( std::make_pair( "lut_size", k  ),
-                                                                 "area_mapping",
-                                                                 std::make_pair( "area_iters", params.area_iters ),
-                                                                 std::make_pair( "flow_iters", params.flow_iters ) ) );
-        if ( k <= 6u && params.satlut )
-        {
-          sub_lut.satlut_mapping();
-        }
-        return sub_lut;
-      }();
+      const auto sub_lut = map_lut( job, k, k <= 6u && params.satlut );
 
       /* The condition imposes that it a*/
-      if ( sub_lut.lut_count() - 1 <= static_cast<int>( ancillas.size() )  )
+      if ( sub_lut->lut_count() - 1 <= static_cast<int>( ancillas.size() )  )
       {
         return sub_lut;
       }
@@ -578,12 +633,12 @@ public:
     assert( false );
   }
 
-  gia_graph compute_sub_lut_switch( int index, const std::vector<unsigned>& ancillas, int num_inputs ) const
+  std::shared_ptr<gia_graph> compute_sub_lut_switch( const lut_job& job, const std::vector<unsigned>& ancillas, int num_inputs ) const
   {
     switch ( strategy )
     {
-    case lhrs_mapping_strategy::lut_based_min_db: return compute_sub_lut_db( index, ancillas );
-    case lhrs_mapping_strategy::lut_based_best_fit: return compute_sub_lut_best_fit( index, ancillas, num_inputs );
+    case lhrs_mapping_strategy::lut_based_min_db: return compute_sub_lut_db( job, ancillas );
+    case lhrs_mapping_strategy::lut_based_best_fit: return compute_sub_lut_best_fit( job, ancillas, num_inputs );
 
     case lhrs_mapping_strategy::direct:
     default:
@@ -591,20 +646,22 @@ public:
     }
   }
 
-  bool compute( circuit& circ, int index, const std::vector<unsigned>& line_map, const std::vector<unsigned>& ancillas ) const
+  bool compute( circuit& circ, const lut_job& job ) const
   {
-    const auto num_inputs = gia().lut_size( index );
+    const auto num_inputs = job.num_inputs;
+    const auto& line_map = job.line_map;
+    const auto& ancillas = job.clean_ancilla;
 
     if ( num_inputs <= max_cut_size )
     {
-      const auto tt_spec = gia().lut_truth_table( index );
-      const auto affine_class = classify( tt_spec, num_inputs );
+      const auto affine_class = classify( job.truth_table, num_inputs );
 
-      append_stg_from_line_map( circ, tt_spec, affine_class, line_map );
+      append_stg_from_line_map( circ, job.truth_table, affine_class, line_map );
     }
     else
     {
-      const auto sub_lut = compute_sub_lut_switch( index, ancillas, num_inputs );
+      const auto sub_lut_ptr = compute_sub_lut_switch( job, ancillas, num_inputs );
+      const auto& sub_lut = *sub_lut_ptr;
       sub_lut.init_truth_tables();
 
       std::vector<unsigned> lut_to_line( sub_lut.size() );
@@ -621,6 +678,7 @@ public:
         }
         else
         {
+          release_mapping( sub_lut_ptr );
           while ( num_ancilla > static_cast<int>( ancillas.size() ) )
           {
             abc::Gia_ManMergeTopLuts( sub_lut );
@@ -739,7 +797,7 @@ private:
     const auto it = class_hash[num_vars - 2u].find( func );
     if ( it == class_hash[num_vars - 2u].end() )
     {
-      const auto idx = get_spectral_class( tt( 1 << num_vars, func ) );
+      const auto idx = get_spectral_class( func, num_vars );
       sfunc = optimal_quantum_circuits::spectral_classification_representative[num_vars - 2u][idx];
       class_hash[num_vars - 2u].insert( std::make_pair( func, sfunc ) );
     }
@@ -762,9 +820,171 @@ public:
 
 private:
   mutable std::vector<std::unordered_map<uint64_t, uint64_t>> class_hash;
+  mutable std::map<std::pair<unsigned, bool>, std::shared_ptr<gia_graph>> mappings; /* (LUT size, SAT-LUT) -> mapping of the current job */
+};
+
+/******************************************************************************
+ * LUT synthesis                                                              *
+ ******************************************************************************/
+
+inline void append_circuit_fast( circuit& dest, const circuit& src )
+{
+  auto& dest_s = boost::get<standard_circuit>( static_cast<circuit_variant&>( dest ) );
+  const auto& src_s = boost::get<standard_circuit>( static_cast<const circuit_variant&>( src ) );
+
+  dest_s.append_gates( src_s );
+}
+
+void add_lut_stats( lhrs_stats& stats, const lhrs_stats& other )
+{
+  stats.exorcism_runtime += other.exorcism_runtime;
+  stats.cover_runtime    += other.cover_runtime;
+  stats.mapping_runtime  += other.mapping_runtime;
+  stats.class_runtime    += other.class_runtime;
+
+  stats.mapping_cache_hits   += other.mapping_cache_hits;
+  stats.mapping_cache_misses += other.mapping_cache_misses;
+
+  for ( auto i = 0u; i < stats.class_counter.size(); ++i )
+  {
+    for ( auto j = 0u; j < stats.class_counter[i].size(); ++j )
+    {
+      stats.class_counter[i][j] += other.class_counter[i][j];
+    }
+  }
+}
+
+/* synthesizes single LUTs, owns the partial synthesizers and their caches;
+   one instance per thread */
+class lut_synthesizer
+{
+public:
+  lut_synthesizer( const lhrs_params& params, lhrs_stats& stats, const progress_line* pbar = nullptr )
+    : params( params ),
+      pbar( pbar ),
+      synthesizer( params, stats ),
+      decomp_synthesizer( params, stats )
+  {
+  }
+
+  /* appends the circuit for job to circ, returns true if LUT decomposition was used */
+  bool synthesize( circuit& circ, const lut_job& job )
+  {
+    const auto lut_based = synthesize_strategy( circ, job );
+
+    /* mappings are only shared by the candidates of a single job */
+    decomp_synthesizer.clear_mappings();
+
+    return lut_based;
+  }
 
 private:
-  int lut_size_max = 0;
+  bool synthesize_strategy( circuit& circ, const lut_job& job )
+  {
+    switch ( params.mapping_strategy )
+    {
+    case lhrs_mapping_strategy::direct:
+      return synthesize_direct( circ, job );
+    case lhrs_mapping_strategy::lut_based_min_db:
+    case lhrs_mapping_strategy::lut_based_best_fit:
+      return synthesize_lut_based( circ, job );
+    case lhrs_mapping_strategy::lut_based_pick_best:
+      return synthesize_pick_best( circ, job );
+    }
+
+    assert( false );
+    return false;
+  }
+
+  bool synthesize_direct( circuit& circ, const lut_job& job )
+  {
+    const auto sp = subprogress();
+    synthesizer.compute( circ, job );
+    return false;
+  }
+
+  bool synthesize_lut_based( circuit& circ, const lut_job& job )
+  {
+    if ( params.max_func_size == 0u )
+    {
+      decomp_synthesizer.max_cut_size = params.class_method == 0u ? 5 : 4;
+    }
+    else
+    {
+      decomp_synthesizer.max_cut_size = params.max_func_size;
+    }
+
+    if ( decomp_synthesizer.compute( circ, job ) )
+    {
+      return true;
+    }
+
+    return synthesize_direct( circ, job );
+  }
+
+  bool synthesize_pick_best( circuit& circ, const lut_job& job )
+  {
+    using candidate_t = std::pair<circuit, cost_t>;
+    std::vector<candidate_t> candidates;
+
+    for ( const auto& strategy : {lhrs_mapping_strategy::lut_based_min_db, lhrs_mapping_strategy::lut_based_best_fit} )
+    {
+      /* cut size 4 */
+      decomp_synthesizer.strategy = strategy;
+      {
+        circuit lcirc( job.lines );
+        decomp_synthesizer.max_cut_size = 4;
+        if ( decomp_synthesizer.compute( lcirc, job ) )
+        {
+          candidates.push_back( {lcirc, costs( lcirc, costs_by_gate_func( t_costs() ) )} );
+        }
+      }
+
+      /* cut size 5 */
+      if ( params.class_method == 0u )
+      {
+        circuit lcirc( job.lines );
+        decomp_synthesizer.max_cut_size = 5;
+        if ( decomp_synthesizer.compute( lcirc, job ) )
+        {
+          candidates.push_back( {lcirc, costs( lcirc, costs_by_gate_func( t_costs() ) )} );
+        }
+      }
+    }
+
+    decomp_synthesizer.strategy = params.mapping_strategy;
+
+    if ( !candidates.empty() )
+    {
+      const auto best_candidate = std::min_element( candidates.begin(), candidates.end(),
+                                                    []( const candidate_t& c1, const candidate_t& c2 ) {
+                                                      return c1.second < c2.second;
+                                                    } );
+
+      append_circuit_fast( circ, best_candidate->first );
+      return true;
+    }
+
+    {
+      const auto sp = subprogress();
+      circuit circ_direct( job.lines );
+      synthesizer.compute( circ_direct, job );
+      append_circuit_fast( circ, circ_direct );
+      return false;
+    }
+  }
+
+  inline std::unique_ptr<progress_line::subprogress_t> subprogress() const
+  {
+    return pbar ? pbar->subprogress() : nullptr;
+  }
+
+private:
+  const lhrs_params&                params;
+  const progress_line*              pbar;
+
+  exorcism_lut_partial_synthesizer  synthesizer;
+  lutdecomp_lut_partial_synthesizer decomp_synthesizer;
 };
 
 /******************************************************************************
@@ -780,10 +1000,18 @@ public:
       params( params ),
       stats( stats ),
       order_heuristic( std::make_shared<defer_lut_order_heuristic>( gia, params.additional_ancilla ) ),
-      synthesizer( gia, params, stats ),
-      decomp_synthesizer( gia, params, stats ),
-      pbar( "[i] step %5d/%5d   dd = %5d   ld = %5d   cvr = %6.2f   esop = %6.2f   map = %6.2f   clsfy = %6.2f   total = %6.2f", params.progress )
+      pbar( "[i] step %5d/%5d   dd = %5d   ld = %5d   hits = %5d   cvr = %6.2f   esop = %6.2f   map = %6.2f   clsfy = %6.2f   total = %6.2f", params.progress ),
+      synthesizer( params, stats, &pbar )
   {
+    gia.init_truth_tables();
+  }
+
+  ~lut_based_synthesis_manager()
+  {
+    /* when run() is left by an exception, queued jobs are executed by this
+       thread while the pool is destroyed and must not take a worker */
+    stopping = true;
+    pool.reset();
   }
 
   bool run()
@@ -800,6 +1028,23 @@ public:
 
     std::unordered_map<unsigned, lut_order_heuristic::step_type> orig_step_type; /* first step type of an output */
 
+    /* dump file names depend on the synthesis order */
+    stats.num_threads = params.num_threads == 0u ? std::max( 1u, std::thread::hardware_concurrency() ) : params.num_threads;
+    if ( params.onlylines || !params.dumpfile.empty() )
+    {
+      stats.num_threads = 1u;
+    }
+    if ( stats.num_threads > 1u )
+    {
+      start_pipeline( stats.num_threads );
+    }
+    if ( !params.onlylines && ( params.cache || !params.cache_file.empty() ) )
+    {
+      start_cache();
+    }
+
+    increment_wall_timer pt( &stats.pipeline_runtime );
+
     auto step_index = 0u;
     pbar.keep_last();
     for ( const auto& step : order_heuristic->steps() )
@@ -808,7 +1053,7 @@ public:
       {
         std::cout << step << std::endl;
       }
-      pbar( ++step_index, order_heuristic->steps().size(), stats.num_decomp_default, stats.num_decomp_lut, stats.cover_runtime, stats.exorcism_runtime, stats.mapping_runtime, stats.class_runtime, stats.synthesis_runtime );
+      pbar( ++step_index, order_heuristic->steps().size(), stats.num_decomp_default, stats.num_decomp_lut, stats.cache_hits, stats.cover_runtime, stats.exorcism_runtime, stats.mapping_runtime, stats.class_runtime, stats.synthesis_runtime );
       increment_timer t( &stats.synthesis_runtime );
 
       switch ( step.type )
@@ -858,21 +1103,18 @@ public:
         break;
 
       case lut_order_heuristic::compute:
-        if ( !params.onlylines )
-        {
-          synthesize_node( step.node, false, step.clean_ancilla );
-        }
-        break;
-
       case lut_order_heuristic::uncompute:
         if ( !params.onlylines )
         {
-          synthesize_node( step.node, true, step.clean_ancilla );
+          synthesize_node( step_index - 1u );
         }
         break;
       }
     }
 
+    stop_pipeline();
+    stop_cache();
+
     circ.set_inputs( inputs );
     circ.set_outputs( outputs );
     circ.set_constants( constants );
@@ -882,131 +1124,376 @@ public:
   }
 
 private:
-  inline void synthesize_node( int index, bool lookup, const std::vector<unsigned>& clean_ancilla )
+  lut_job make_job( unsigned step_index ) const
+  {
+    const auto& step = order_heuristic->steps()[step_index];
+
+    lut_job job;
+    job.step_index = step_index;
+    job.index = step.node;
+    job.num_inputs = gia.lut_size( step.node );
+    job.truth_table = 0u;
+    job.lines = circ.lines();
+    job.line_map = order_heuristic->compute_line_map( step.node );
+    job.clean_ancilla = step.clean_ancilla;
+
+    if ( needs_lut( job.num_inputs ) )
+    {
+      job.lut = std::make_shared<gia_graph>( abc::Gia_ManDupLUT( gia, step.node ) );
+    }
+    else
+    {
+      job.truth_table = gia.lut_truth_table( step.node );
+    }
+
+    return job;
+  }
+
+  /* whether synthesis may extract the LUT as network, otherwise the truth table suffices */
+  bool needs_lut( int num_inputs ) const
   {
     switch ( params.mapping_strategy )
     {
     case lhrs_mapping_strategy::direct:
-      synthesize_node_direct( index, lookup, clean_ancilla );
-      break;
+      return true;
     case lhrs_mapping_strategy::lut_based_min_db:
     case lhrs_mapping_strategy::lut_based_best_fit:
-      synthesize_node_lut_based( index, lookup, clean_ancilla );
-      break;
+      if ( params.max_func_size == 0u )
+      {
+        return num_inputs > ( params.class_method == 0u ? 5 : 4 );
+      }
+      return num_inputs > static_cast<int>( params.max_func_size );
     case lhrs_mapping_strategy::lut_based_pick_best:
-      synthesize_node_pick_best( index, lookup, clean_ancilla );
-      break;
+      return num_inputs > 4;
     }
+
+    return true;
   }
 
-  void synthesize_node_direct( int index, bool lookup, const std::vector<unsigned>& clean_ancilla )
+  void synthesize_node( unsigned step_index )
   {
-    /* map circuit */
-    const auto line_map = order_heuristic->compute_line_map( index );
+    if ( pool )
+    {
+      synthesize_node_pipelined( step_index );
+      return;
+    }
 
+    const auto job = make_job( step_index );
+
+    increment_wall_timer t( &stats.lut_runtime );
+
+    std::vector<unsigned> position;
+    const auto key = cache_key( job, position );
+    if ( key.empty() )
     {
-      const auto sp = pbar.subprogress();
-      synthesizer.compute( circ, index, line_map, clean_ancilla );
-      ++stats.num_decomp_default;
+      count_decomposition( synthesizer.synthesize( circ, job ) );
+      return;
     }
-  }
 
-  void synthesize_node_lut_based( int index, bool lookup, const std::vector<unsigned>& clean_ancilla )
-  {
-    if ( params.max_func_size == 0u )
+    auto entry = cache->lookup( key );
+    if ( entry )
     {
-      decomp_synthesizer.max_cut_size = params.class_method == 0u ? 5 : 4;
+      ++stats.cache_hits;
     }
     else
     {
-      decomp_synthesizer.max_cut_size = params.max_func_size;
+      ++stats.cache_misses;
+      entry = synthesize_entry( synthesizer, abstract_job( job, position ) );
+      cache->insert( key, entry );
     }
 
-    /* map circuit */
-    const auto line_map = order_heuristic->compute_line_map( index );
+    replay_entry( *entry, job, position );
+    count_decomposition( entry->lut_based );
+  }
 
-    if ( decomp_synthesizer.compute( circ, index, line_map, clean_ancilla ) )
+  inline void count_decomposition( bool lut_based )
+  {
+    if ( lut_based )
     {
       ++stats.num_decomp_lut;
-      return;
     }
-
+    else
     {
-      const auto sp = pbar.subprogress();
-      synthesizer.compute( circ, index, line_map, clean_ancilla );
       ++stats.num_decomp_default;
     }
   }
 
-  inline void append_circuit_fast( const circuit& src )
+  static lhrs_cache::entry_ptr synthesize_entry( lut_synthesizer& synthesizer, const lut_job& job )
   {
-    auto& dest_s = boost::get<standard_circuit>( static_cast<circuit_variant&>( circ ) );
-    const auto& src_s = boost::get<standard_circuit>( static_cast<const circuit_variant&>( src ) );
+    auto entry = std::make_shared<lhrs_cache::entry>();
+    entry->circ.set_lines( job.lines );
+    entry->lut_based = synthesizer.synthesize( entry->circ, job );
+    return entry;
+  }
+
+  /****************************************************************************
+   * Cache                                                                    *
+   ****************************************************************************/
 
-    boost::push_back( dest_s.gates, src_s.gates );
+  void start_cache()
+  {
+    std::stringstream signature;
+    signature << params.mapping_strategy << "," << params.cover_method << "," << params.script << ","
+              << params.optimize_postesop << "," << params.satlut << "," << params.area_iters << ","
+              << params.flow_iters << "," << params.class_method << "," << params.max_func_size;
+    cache.reset( new lhrs_cache( signature.str() ) );
+
+    if ( !params.cache_file.empty() && boost::filesystem::exists( params.cache_file ) && !cache->read( params.cache_file ) )
+    {
+      std::cout << "[w] could not read LUT cache from " << params.cache_file << ", it is outdated or was created with other parameters" << std::endl;
+    }
   }
 
-  inline circuit get_fast_circuit() const
+  void stop_cache()
   {
-    standard_circuit c;
-    c.lines = circ.lines();
-    return c;
+    if ( cache && !params.cache_file.empty() && !cache->write( params.cache_file ) )
+    {
+      std::cout << "[w] could not write LUT cache to " << params.cache_file << std::endl;
+    }
   }
 
-  void synthesize_node_pick_best( int index, bool lookup, const std::vector<unsigned>& clean_ancilla )
+  /* empty key if the LUT is not cached; LUTs that are synthesized from their
+     truth table only result in a single gate */
+  std::string cache_key( const lut_job& job, std::vector<unsigned>& position ) const
   {
-    /* map circuit */
-    const auto line_map = order_heuristic->compute_line_map( index );
+    if ( !cache || !job.lut ) { return std::string(); }
 
-    using candidate_t = std::pair<circuit, cost_t>;
-    std::vector<candidate_t> candidates;
+    tt func;
+    if ( job.num_inputs <= 6 )
+    {
+      func = tt( 1u << job.num_inputs, gia.lut_truth_table( job.index ) );
+      tt_extend( func, 6u );
+    }
+    else
+    {
+      func = simulate_lut( *job.lut );
+    }
+    const auto canon = lhrs_cache_canonize( func, job.num_inputs, position );
 
-    for ( const auto& strategy : {lhrs_mapping_strategy::lut_based_min_db, lhrs_mapping_strategy::lut_based_best_fit} )
+    auto key = boost::str( boost::format( "%d:%s" ) % job.num_inputs % tt_to_hex( canon ) );
+    if ( params.mapping_strategy != lhrs_mapping_strategy::direct )
     {
-      /* cut size 4 */
-      decomp_synthesizer.strategy = strategy;
+      key += boost::str( boost::format( ":%d" ) % job.clean_ancilla.size() );
+    }
+    if ( params.mapping_strategy == lhrs_mapping_strategy::lut_based_pick_best )
+    {
+      /* costs depend on the number of lines */
+      key += boost::str( boost::format( ":%d" ) % job.lines );
+    }
+    return key;
+  }
+
+  /* same job on abstract lines, see lhrs_cache.hpp */
+  lut_job abstract_job( const lut_job& job, const std::vector<unsigned>& position ) const
+  {
+    auto ajob = job;
+    for ( auto i = 0u; i < position.size(); ++i )
+    {
+      ajob.line_map[i] = position[i];
+    }
+    ajob.line_map.back() = position.size();
+    for ( auto a = 0u; a < ajob.clean_ancilla.size(); ++a )
+    {
+      ajob.clean_ancilla[a] = position.size() + 1u + a;
+    }
+    return ajob;
+  }
+
+  void replay_entry( const lhrs_cache::entry& entry, const lut_job& job, const std::vector<unsigned>& position )
+  {
+    std::vector<unsigned> line_map( job.line_map.size() + job.clean_ancilla.size() );
+    for ( auto i = 0u; i < position.size(); ++i )
+    {
+      line_map[position[i]] = job.line_map[i];
+    }
+    line_map[position.size()] = job.line_map.back();
+    std::copy( job.clean_ancilla.begin(), job.clean_ancilla.end(), line_map.begin() + position.size() + 1u );
+
+    for ( const auto& g : entry.circ )
+    {
+      auto& new_gate = circ.append_gate();
+      for ( const auto& c : g.controls() )
       {
-        auto lcirc = get_fast_circuit();
-        decomp_synthesizer.max_cut_size = 4;
-        if ( decomp_synthesizer.compute( lcirc, index, line_map, clean_ancilla ) )
+        assert( c.line() < line_map.size() );
+        new_gate.add_control( make_var( line_map[c.line()], c.polarity() ) );
+      }
+      for ( const auto& t : g.targets() )
+      {
+        assert( t < line_map.size() );
+        new_gate.add_target( line_map[t] );
+      }
+      new_gate.set_type( g.type() );
+
+      if ( const auto annotations = entry.circ.annotations( g ) )
+      {
+        for ( const auto& p : *annotations )
         {
-          candidates.push_back( {lcirc, costs( lcirc, costs_by_gate_func( t_costs() ) )} );
+          circ.annotate( new_gate, p.first, p.second );
         }
       }
+    }
+  }
 
-      /* cut size 5 */
-      if ( params.class_method == 0u )
+  /****************************************************************************
+   * Pipeline                                                                 *
+   *                                                                          *
+   * LUTs are extracted in this thread, since ABC keeps traversal data in the *
+   * mapped network, and synthesized by worker threads into separate         *
+   * circuits.  These are spliced into the result in step order, therefore   *
+   * the result is the same as in the serial mode.  With the cache, only the  *
+   * first LUT of each key is synthesized, later ones are replayed when they  *
+   * are spliced.                                                             *
+   ****************************************************************************/
+
+  struct lut_result
+  {
+    lhrs_cache::entry_ptr entry;
+    double                runtime = 0.0;
+  };
+
+  struct pending_job
+  {
+    lut_job                 job;
+    std::string             cache_key;   /* empty if not cached */
+    std::vector<unsigned>   position;    /* canonical input positions, if cached */
+    bool                    replay;      /* replay from cache instead of synthesis */
+    std::future<lut_result> result;
+  };
+
+  void start_pipeline( unsigned num_threads )
+  {
+    worker_params = params;
+    worker_params.progress = false;
+    worker_params.exorcism_threads = 1u; /* the pipeline already keeps all threads busy */
+
+    worker_stats.resize( num_threads );
+    for ( auto& ws : worker_stats )
+    {
+      workers.emplace_back( new lut_synthesizer( worker_params, ws ) );
+      idle_workers.push_back( workers.back().get() );
+    }
+
+    window = 4u * num_threads;
+    next_step = 0u;
+    pool.reset( new thread_pool( num_threads ) );
+  }
+
+  void stop_pipeline()
+  {
+    if ( !pool ) { return; }
+
+    stopping = true;
+    pool.reset();
+    for ( const auto& ws : worker_stats )
+    {
+      add_lut_stats( stats, ws );
+    }
+  }
+
+  /* submits jobs until window is full */
+  void fill_pipeline()
+  {
+    const auto& steps = order_heuristic->steps();
+    while ( next_step < steps.size() && pending.size() < window )
+    {
+      const auto type = steps[next_step].type;
+      if ( type == lut_order_heuristic::compute || type == lut_order_heuristic::uncompute )
       {
-        auto lcirc = get_fast_circuit();
-        decomp_synthesizer.max_cut_size = 5;
-        if ( decomp_synthesizer.compute( lcirc, index, line_map, clean_ancilla ) )
+        pending.emplace_back();
+        auto& p = pending.back();
+        p.job = make_job( next_step );
+        p.cache_key = cache_key( p.job, p.position );
+        p.replay = !p.cache_key.empty() && ( cache->lookup( p.cache_key ) || submitted_keys.count( p.cache_key ) );
+
+        if ( !p.replay )
         {
-          candidates.push_back( {lcirc, costs( lcirc, costs_by_gate_func( t_costs() ) )} );
+          if ( !p.cache_key.empty() )
+          {
+            submitted_keys.insert( p.cache_key );
+          }
+          const auto job = std::make_shared<lut_job>( p.cache_key.empty() ? p.job : abstract_job( p.job, p.position ) );
+          p.result = pool->enqueue( [this, job]() { return synthesize_job( *job ); } );
         }
+        p.job.lut.reset(); /* only used by the worker */
       }
+      ++next_step;
     }
+  }
 
-    decomp_synthesizer.strategy = params.mapping_strategy;
+  lut_result synthesize_job( const lut_job& job )
+  {
+    /* nobody waits for the result anymore */
+    if ( stopping ) { return lut_result(); }
 
-    if ( !candidates.empty() )
+    lut_synthesizer* worker{};
     {
-      const auto best_candidate = std::min_element( candidates.begin(), candidates.end(),
-                                                    []( const candidate_t& c1, const candidate_t& c2 ) {
-                                                      return c1.second < c2.second;
-                                                    } );
+      std::lock_guard<std::mutex> lock( idle_mutex );
+      if ( idle_workers.empty() ) { throw "Error: no idle LUT synthesizer in LHRS pipeline"; }
+      worker = idle_workers.back();
+      idle_workers.pop_back();
+    }
 
-      append_circuit_fast( best_candidate->first );
-      ++stats.num_decomp_lut;
-      return;
+    lut_result result;
+
+    try
+    {
+      increment_wall_timer t( &result.runtime );
+      result.entry = synthesize_entry( *worker, job );
+    }
+    catch ( ... )
+    {
+      std::lock_guard<std::mutex> lock( idle_mutex );
+      idle_workers.push_back( worker );
+      throw;
+    }
+
+    std::lock_guard<std::mutex> lock( idle_mutex );
+    idle_workers.push_back( worker );
+    return result;
+  }
+
+  void synthesize_node_pipelined( unsigned step_index )
+  {
+    fill_pipeline();
+
+    assert( !pending.empty() && pending.front().job.step_index == step_index );
+    auto p = std::move( pending.front() );
+    pending.pop_front();
+
+    lhrs_cache::entry_ptr entry;
+    if ( p.replay )
+    {
+      entry = cache->lookup( p.cache_key );
+      assert( entry );
+      ++stats.cache_hits;
     }
+    else
+    {
+      lut_result result;
+      {
+        increment_wall_timer t( &stats.wait_runtime );
+        result = p.result.get();
+      }
+      entry = result.entry;
+      stats.lut_runtime += result.runtime;
 
+      if ( !p.cache_key.empty() )
+      {
+        ++stats.cache_misses;
+        cache->insert( p.cache_key, entry );
+        submitted_keys.erase( p.cache_key );
+      }
+    }
+
+    if ( p.cache_key.empty() )
     {
-      const auto sp = pbar.subprogress();
-      circuit circ_direct( circ.lines() );
-      synthesizer.compute( circ_direct, index, line_map, clean_ancilla );
-      append_circuit_fast( circ_direct );
-      ++stats.num_decomp_default;
+      append_circuit_fast( circ, entry->circ );
     }
+    else
+    {
+      replay_entry( *entry, p.job, p.position );
+    }
+    count_decomposition( entry->lut_based );
   }
 
 private:
@@ -1016,13 +1503,25 @@ private:
   const lhrs_params& params;
   lhrs_stats& stats;
 
-  std::unordered_map<unsigned, circuit> computed_circuits;
-
   std::shared_ptr<lut_order_heuristic> order_heuristic;
-  exorcism_lut_partial_synthesizer synthesizer;
-  lutdecomp_lut_partial_synthesizer decomp_synthesizer;
 
   progress_line pbar;
+  lut_synthesizer synthesizer;
+
+  std::unique_ptr<lhrs_cache> cache;
+
+  /* pipeline */
+  lhrs_params                                   worker_params;
+  std::vector<lhrs_stats>                       worker_stats;
+  std::vector<std::unique_ptr<lut_synthesizer>> workers;
+  std::vector<lut_synthesizer*>                 idle_workers;
+  std::mutex                                    idle_mutex;
+  std::deque<pending_job>                       pending;
+  std::unordered_set<std::string>               submitted_keys; /* cache keys of jobs in the pipeline */
+  unsigned                                      window = 0u;
+  unsigned                                      next_step = 0u;
+  std::atomic<bool>                             stopping{false};
+  std::unique_ptr<thread_pool>                  pool; /* last member, joins before the workers are destroyed */
 };
 
 /******************************************************************************
@@ -78,7 +78,7 @@ gate::control_container get_control_lines_from_mask( const boost::dynamic_bitset
   boost::dynamic_bitset<>::size_type pos = mask.find_first();
   while ( pos != boost::dynamic_bitset<>::npos )
   {
-    controls += make_var( mask.size() - 1u - pos );
+    controls.push_back( make_var( mask.size() - 1u - pos ) );
     pos = mask.find_next( pos );
   }
   return controls;
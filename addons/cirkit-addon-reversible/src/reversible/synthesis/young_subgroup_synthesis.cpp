@@ -77,7 +77,7 @@ public:
     for ( unsigned i = 0u; i < circ.lines(); ++i )
     {
       if ( !cube.second[i] ) continue;
-      controls += make_var( i, cube.first[i] );
+      controls.push_back( make_var( i, cube.first[i] ) );
     }
 
     append_toffoli( gatecirc, controls, target );
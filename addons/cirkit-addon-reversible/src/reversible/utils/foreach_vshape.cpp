@@ -55,7 +55,7 @@ void foreach_vshape( unsigned n, const std::function<void(const circuit&)>& f )
         unsigned c = j < t ? j : j + 1u;
         if ( range[offset + j] )
         {
-          controls += make_var( c );
+          controls.push_back( make_var( c ) );
         }
       }
       append_toffoli( circ, controls, t );
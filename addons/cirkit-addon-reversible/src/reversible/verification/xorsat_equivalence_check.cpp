@@ -41,6 +41,7 @@
 #include <reversible/functions/add_gates.hpp>
 #include <reversible/functions/copy_circuit.hpp>
 #include <reversible/functions/reverse_circuit.hpp>
+#include <reversible/simulation/bitsliced_simulation.hpp>
 #include <reversible/utils/permutation.hpp>
 
 namespace cirkit
@@ -167,11 +168,14 @@ bool xorsat_equivalence_check( const circuit& circ1, const circuit& circ2,
                                const properties::ptr& statistics )
 {
   /* settings */
-  const auto name_mapping = get( settings, "name_mapping", false );
-  const auto tmpname      = get( settings, "tmpname", std::string( "/tmp/test.cnf" ) );
+  const auto name_mapping     = get( settings, "name_mapping", false );
+  const auto tmpname          = get( settings, "tmpname", std::string( "/tmp/test.cnf" ) );
+  const auto simulation_words = get( settings, "simulation_words", 64u );
+  const auto exhaustive_lines = get( settings, "exhaustive_lines", 16u );
 
   /* timing */
   properties_timer t( statistics );
+  set( statistics, "decided_by_simulation", false );
 
   if ( circ1.lines() != circ2.lines() )
   {
@@ -206,6 +210,24 @@ bool xorsat_equivalence_check( const circuit& circ1, const circuit& circ2,
     id_circ = create_identity_miter( circ1, circ2 );
   }
 
+  /* bit-sliced simulation of the miter before calling the SAT solver */
+  if ( bitsliced_simulator::is_supported( id_circ ) )
+  {
+    const bitsliced_simulator sim( id_circ );
+
+    if ( id_circ.lines() <= exhaustive_lines )
+    {
+      set( statistics, "decided_by_simulation", true );
+      return bitsliced_is_identity( sim );
+    }
+
+    if ( simulation_words > 0u && !bitsliced_is_identity_on_random_patterns( sim, simulation_words ) )
+    {
+      set( statistics, "decided_by_simulation", true );
+      return false;
+    }
+  }
+
   write_to_dimacs( id_circ, tmpname );
   return solve_identity_miter( tmpname );
 }
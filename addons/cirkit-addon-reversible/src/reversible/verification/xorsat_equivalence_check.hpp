@@ -44,6 +44,15 @@
 namespace cirkit
 {
 
+/*
+ * Settings:
+ *   name_mapping (bool)         : match outputs by name (false)
+ *   tmpname (std::string)       : filename for the CNF ("/tmp/test.cnf")
+ *   simulation_words (unsigned) : 64-bit words of random patterns simulated before SAT, 0 disables (64)
+ *   exhaustive_lines (unsigned) : circuits up to this many lines are decided by exhaustive simulation (16)
+ *
+ * Statistics: runtime, decided_by_simulation
+ */
 bool xorsat_equivalence_check( const circuit& circ1, const circuit& circ2,
                                const properties::ptr& settings = properties::ptr(),
                                const properties::ptr& statistics = properties::ptr() );
@@ -0,0 +1,97 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE bitsliced_simulation
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+
+#include <reversible/circuit.hpp>
+#include <reversible/functions/add_gates.hpp>
+#include <reversible/functions/circuit_to_truth_table.hpp>
+#include <reversible/simulation/bitsliced_simulation.hpp>
+#include <reversible/simulation/simple_simulation.hpp>
+
+BOOST_AUTO_TEST_CASE(simple)
+{
+  using namespace cirkit;
+
+  /* 8 lines, such that more than one word is simulated */
+  circuit circ( 8u );
+  append_toffoli( circ )( 0u, 1u )( 7u );
+  append_toffoli( circ, gate::control_container{make_var( 2u, false ), make_var( 7u )}, 3u );
+  append_fredkin( circ )( 4u )( 5u, 6u );
+  append_peres( circ, make_var( 1u ), 2u, 0u );
+  append_not( circ, 5u );
+
+  const bitsliced_simulator sim( circ );
+
+  auto num_patterns = 0u;
+  sim.foreach_pattern_block( [&]( std::uint64_t first, std::uint64_t count, const bitsliced_simulator::state_t&, const bitsliced_simulator::state_t& outputs, unsigned num_words ) {
+      for ( auto p = 0u; p < count; ++p )
+      {
+        boost::dynamic_bitset<> input( 8u, first + p ), output;
+        simple_simulation( output, circ, input );
+
+        for ( auto l = 0u; l < 8u; ++l )
+        {
+          BOOST_CHECK( output[l] == ( ( outputs[l * num_words + ( p >> 6u )] >> ( p & 63u ) ) & 1u ) );
+        }
+        ++num_patterns;
+      }
+      return true;
+    }, 1u );
+
+  BOOST_CHECK( num_patterns == 256u );
+  BOOST_CHECK( !bitsliced_is_identity( sim ) );
+
+  /* the truth tables of both simulators agree */
+  binary_truth_table spec1, spec2;
+  circuit_to_truth_table( circ, spec1, simple_simulation_func() );
+  circuit_to_truth_table( circ, spec2 );
+  std::stringstream s1, s2;
+  s1 << spec1;
+  s2 << spec2;
+  BOOST_CHECK( s1.str() == s2.str() );
+
+  /* Toffoli and Fredkin gates are self-inverse */
+  circuit id( 8u );
+  append_toffoli( id )( 0u, 1u )( 7u );
+  append_fredkin( id )( 4u )( 5u, 6u );
+  append_fredkin( id )( 4u )( 5u, 6u );
+  append_toffoli( id )( 0u, 1u )( 7u );
+
+  BOOST_CHECK( bitsliced_is_identity( bitsliced_simulator( id ) ) );
+  BOOST_CHECK( bitsliced_is_identity_on_random_patterns( bitsliced_simulator( id ), 4u ) );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,139 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE gate_storage
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+#include <core/utils/small_vector.hpp>
+#include <reversible/circuit.hpp>
+#include <reversible/functions/add_gates.hpp>
+
+using namespace cirkit;
+
+template<typename T, unsigned N>
+bool has_elements( const small_vector<T, N>& v, const std::vector<T>& expected )
+{
+  return std::vector<T>( v ) == expected;
+}
+
+BOOST_AUTO_TEST_CASE(small_vector_spill)
+{
+  small_vector<unsigned, 2u> v;
+  BOOST_CHECK( v.is_inline() );
+
+  for ( auto i = 0u; i < 5u; ++i )
+  {
+    v.push_back( i );
+  }
+  BOOST_CHECK( !v.is_inline() );
+  BOOST_CHECK( has_elements( v, std::vector<unsigned>{0u, 1u, 2u, 3u, 4u} ) );
+
+  v.erase( v.begin() + 1, v.begin() + 3 );
+  BOOST_CHECK( has_elements( v, std::vector<unsigned>{0u, 3u, 4u} ) );
+
+  v.insert( v.begin() + 1, 7u );
+  BOOST_CHECK( has_elements( v, std::vector<unsigned>{0u, 7u, 3u, 4u} ) );
+
+  const std::vector<unsigned> other = {8u, 9u};
+  v.insert( v.end(), other.begin(), other.end() );
+  BOOST_CHECK( has_elements( v, std::vector<unsigned>{0u, 7u, 3u, 4u, 8u, 9u} ) );
+}
+
+BOOST_AUTO_TEST_CASE(small_vector_aliasing_insert)
+{
+  /* the inserted range lies in the vector and the insertion reallocates it */
+  small_vector<unsigned, 2u> v( {1u, 2u, 3u, 4u} );
+  BOOST_CHECK( !v.is_inline() && v.capacity() == 4u );
+
+  v.insert( v.begin() + 1, v.begin(), v.end() );
+  BOOST_CHECK( v.capacity() >= 8u );
+  BOOST_CHECK( has_elements( v, std::vector<unsigned>{1u, 1u, 2u, 3u, 4u, 2u, 3u, 4u} ) );
+
+  /* value refers to an element and resize reallocates */
+  small_vector<unsigned, 2u> w( {5u, 6u} );
+  w.resize( 4u, w[1u] );
+  BOOST_CHECK( has_elements( w, std::vector<unsigned>{5u, 6u, 6u, 6u} ) );
+}
+
+BOOST_AUTO_TEST_CASE(gate_recycling)
+{
+  circuit circ( 3u );
+  append_toffoli( circ )( 0u, 1u )( 2u );
+  auto& g = append_cnot( circ, 0u, 1u );
+  append_not( circ, 2u );
+
+  circ.annotate( g, "name", "cnot" );
+  BOOST_CHECK( circ.annotation( g, "name" ) == "cnot" );
+
+  const auto* address = &g;
+  circ.remove_gate_at( 1u );
+  BOOST_CHECK( circ.num_gates() == 2u );
+
+  /* the released gate is reused, but without controls and annotations */
+  auto& h = append_not( circ, 1u );
+  BOOST_CHECK( &h == address );
+  BOOST_CHECK( h.controls().empty() );
+  BOOST_CHECK( h.targets().size() == 1u && h.targets().front() == 1u );
+  BOOST_CHECK( !circ.annotations( h ) );
+}
+
+BOOST_AUTO_TEST_CASE(copy_independence)
+{
+  circuit circ( 3u );
+  append_toffoli( circ )( 0u, 1u )( 2u );
+  append_cnot( circ, 0u, 1u );
+  circ.annotate( *circ.begin(), "name", "toffoli" );
+
+  circuit copy = circ;
+  BOOST_CHECK( copy.num_gates() == 2u );
+  BOOST_CHECK( &*copy.begin() != &*circ.begin() );
+  BOOST_CHECK( copy.annotation( *copy.begin(), "name" ) == "toffoli" );
+
+  copy.begin()->targets().front() = 0u;
+  copy.begin()->remove_control( make_var( 0u ) );
+  copy.annotate( *copy.begin(), "name", "changed" );
+  append_not( copy, 2u );
+
+  BOOST_CHECK( circ.num_gates() == 2u );
+  BOOST_CHECK( circ.begin()->targets().front() == 2u );
+  BOOST_CHECK( circ.begin()->controls().size() == 2u );
+  BOOST_CHECK( circ.annotation( *circ.begin(), "name" ) == "toffoli" );
+
+  /* removing gates from the copy leaves the original intact */
+  copy.remove_gate_at( 0u );
+  BOOST_CHECK( circ.annotation( *circ.begin(), "name" ) == "toffoli" );
+  BOOST_CHECK( circ.begin()->controls().size() == 2u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,183 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE lhrs_cache
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+#include <boost/any.hpp>
+
+#include <core/utils/temporary_filename.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <reversible/circuit.hpp>
+#include <reversible/target_tags.hpp>
+#include <reversible/functions/add_gates.hpp>
+#include <reversible/synthesis/lhrs/lhrs_cache.hpp>
+
+using namespace cirkit;
+
+/* threshold function 4x_0 + 3x_1 + 2x_2 + x_3 >= 5 with inputs in the given order */
+tt threshold_function( const std::vector<unsigned>& order )
+{
+  const unsigned weights[] = {4u, 3u, 2u, 1u};
+
+  tt func( 64u );
+  for ( auto m = 0u; m < 64u; ++m )
+  {
+    auto sum = 0u;
+    for ( auto i = 0u; i < 4u; ++i )
+    {
+      if ( ( m >> order[i] ) & 1u )
+      {
+        sum += weights[i];
+      }
+    }
+    func[m] = sum >= 5u;
+  }
+  return func;
+}
+
+BOOST_AUTO_TEST_CASE(canonize)
+{
+  std::vector<unsigned> order( 4u );
+  std::iota( order.begin(), order.end(), 0u );
+
+  const auto canon = lhrs_cache_canonize( threshold_function( order ), 4u, order );
+
+  do
+  {
+    const auto func = threshold_function( order );
+    std::vector<unsigned> position;
+    BOOST_CHECK( lhrs_cache_canonize( func, 4u, position ) == canon );
+
+    /* input i of func is input position[i] of canon */
+    for ( auto m = 0u; m < 64u; ++m )
+    {
+      auto cm = m & ~15u;
+      for ( auto i = 0u; i < 4u; ++i )
+      {
+        if ( ( m >> i ) & 1u )
+        {
+          cm |= 1u << position[i];
+        }
+      }
+      BOOST_CHECK( func[m] == canon[cm] );
+    }
+  } while ( std::next_permutation( order.begin(), order.end() ) );
+}
+
+BOOST_AUTO_TEST_CASE(read_write)
+{
+  auto e = std::make_shared<lhrs_cache::entry>();
+  e->circ.set_lines( 5u );
+  e->lut_based = true;
+  append_toffoli( e->circ, gate::control_container{make_var( 0u ), make_var( 1u, false )}, 4u );
+
+  auto& g = e->circ.append_gate();
+  g.add_control( make_var( 2u ) );
+  g.add_control( make_var( 3u ) );
+  g.add_target( 4u );
+  stg_tag stg;
+  stg.function = boost::dynamic_bitset<>( 4u, 6u );
+  stg.affine_class = boost::dynamic_bitset<>( 4u, 6u );
+  g.set_type( stg );
+  e->circ.annotate( g, "affine", tt_to_hex( stg.affine_class ) );
+
+  temporary_filename filename( "/tmp/lhrs-cache-%d.txt" );
+
+  lhrs_cache cache( "test" );
+  cache.insert( "2:6", e );
+  BOOST_CHECK( cache.write( filename.name() ) );
+
+  lhrs_cache other( "other" );
+  BOOST_CHECK( !other.read( filename.name() ) );
+
+  lhrs_cache same( "test" );
+  BOOST_CHECK( same.read( filename.name() ) );
+  BOOST_CHECK( same.size() == 1u );
+
+  const auto r = same.lookup( "2:6" );
+  BOOST_REQUIRE( r );
+  BOOST_CHECK( r->lut_based );
+  BOOST_CHECK( r->circ.lines() == 5u );
+  BOOST_REQUIRE( r->circ.num_gates() == 2u );
+
+  const auto& g0 = r->circ[0u];
+  BOOST_CHECK( is_toffoli( g0 ) );
+  BOOST_CHECK( g0.controls() == e->circ[0u].controls() );
+  BOOST_CHECK( g0.targets() == e->circ[0u].targets() );
+
+  const auto& g1 = r->circ[1u];
+  BOOST_CHECK( is_stg( g1 ) );
+  BOOST_CHECK( boost::any_cast<stg_tag>( g1.type() ).function == stg.function );
+  BOOST_CHECK( boost::any_cast<stg_tag>( g1.type() ).affine_class == stg.affine_class );
+  BOOST_CHECK( r->circ.annotation( g1, "affine" ) == tt_to_hex( stg.affine_class ) );
+}
+
+BOOST_AUTO_TEST_CASE(read_corrupt)
+{
+  temporary_filename filename( "/tmp/lhrs-cache-%d.txt" );
+
+  const auto write_file = [&filename]( const std::string& body ) {
+    std::ofstream os( filename.name().c_str(), std::ofstream::out );
+    os << "lhrs-cache 1" << std::endl << "signature test" << std::endl << body;
+  };
+
+  const std::string valid = "entry 2:6 1 3 1\nt 2 0 !1\n";
+  const std::string corrupt[] = {
+    "t 2 0 x1\n",                     /* control is not a number */
+    "t 2 0 99999999999999999999\n",   /* control out of range of unsigned */
+    "t 2 0 3\n",                      /* control exceeds the lines */
+    "t 3 0\n",                        /* target exceeds the lines */
+    "t 2 2\n",                        /* control on the target line */
+    "s 2 zz - 0\n"                    /* function is not hex */
+  };
+
+  for ( const auto& gate_line : corrupt )
+  {
+    write_file( valid + "entry 2:7 1 3 1\n" + gate_line );
+
+    lhrs_cache cache( "test" );
+    BOOST_CHECK( !cache.read( filename.name() ) );
+    BOOST_CHECK( cache.size() == 0u );
+  }
+
+  write_file( valid );
+  lhrs_cache cache( "test" );
+  BOOST_CHECK( cache.read( filename.name() ) );
+  BOOST_CHECK( cache.size() == 1u );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,118 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <fstream>
+
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <unistd.h>
+
+#include <core/utils/program_options.hpp>
+#include <classical/aig.hpp>
+#include <classical/aig_flat.hpp>
+#include <classical/generators/random_aig.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+using namespace cirkit;
+
+/* resident set size in bytes */
+std::size_t resident_memory()
+{
+  std::ifstream in( "/proc/self/statm" );
+  std::size_t size = 0u, resident = 0u;
+  in >> size >> resident;
+  return resident * sysconf( _SC_PAGESIZE );
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  auto num_inputs  = 1000u;
+  auto num_gates   = 1000000u;
+  auto num_outputs = 1000u;
+  auto seed        = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "inputs,i",  value_with_default( &num_inputs ),  "Number of inputs" )
+    ( "gates,g",   value_with_default( &num_gates ),   "Number of AND gates to create (before strashing)" )
+    ( "outputs,o", value_with_default( &num_outputs ), "Number of outputs" )
+    ( "seed,s",    value_with_default( &seed ),        "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_inputs == 0u || num_outputs > num_inputs + num_gates )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  /* aig_flat is measured first, its freed pages are only a small fraction of what aig_graph needs */
+  {
+    const auto mem_before = resident_memory();
+    boost::timer::cpu_timer t;
+
+    aig_flat aig;
+    generate_random_aig( aig, num_inputs, num_gates, num_outputs, seed );
+
+    t.stop();
+    const auto mem = resident_memory() - mem_before;
+    const auto nodes = aig.size();
+    const auto secs = t.elapsed().wall / 1.0e9;
+
+    std::cout << boost::format( "[i] aig_flat:  %10d nodes  %8.2f secs  %10.0f nodes/sec  %7.2f bytes/node (RSS), %7.2f bytes/node (allocated)" ) % nodes % secs % ( nodes / secs ) % ( static_cast<double>( mem ) / nodes ) % ( static_cast<double>( aig.memory() ) / nodes ) << std::endl;
+  }
+
+  {
+    const auto mem_before = resident_memory();
+    boost::timer::cpu_timer t;
+
+    aig_graph aig;
+    aig_initialize( aig );
+    generate_random_aig( aig, num_inputs, num_gates, num_outputs, seed );
+
+    t.stop();
+    const auto mem = resident_memory() - mem_before;
+    const auto nodes = num_vertices( aig );
+    const auto secs = t.elapsed().wall / 1.0e9;
+
+    std::cout << boost::format( "[i] aig_graph: %10d nodes  %8.2f secs  %10.0f nodes/sec  %7.2f bytes/node (RSS)" ) % nodes % secs % ( nodes / secs ) % ( static_cast<double>( mem ) / nodes ) << std::endl;
+  }
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,171 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <classical/aig.hpp>
+#include <classical/aig_flat.hpp>
+#include <classical/functions/simulate_aig.hpp>
+#include <classical/functions/simulate_aig_bitparallel.hpp>
+#include <classical/functions/strash.hpp>
+#include <classical/generators/random_aig.hpp>
+#include <classical/io/read_aiger.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+using namespace cirkit;
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  std::string filename;
+  auto num_inputs  = 256u;
+  auto num_gates   = 100000u;
+  auto num_outputs = 256u;
+  auto num_words   = 16u;
+  auto rounds      = 100u;
+  auto seed        = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "filename",          value( &filename ),                 "AIG filename (in binary AIGER format), if not given a random AIG is generated" )
+    ( "inputs,i",          value_with_default( &num_inputs ),  "Number of inputs of random AIG" )
+    ( "gates,g",           value_with_default( &num_gates ),   "Number of AND gates of random AIG" )
+    ( "outputs,o",         value_with_default( &num_outputs ), "Number of outputs of random AIG" )
+    ( "words,w",           value_with_default( &num_words ),   "Number of 64-bit words per node" )
+    ( "rounds,r",          value_with_default( &rounds ),      "Number of simulation rounds" )
+    ( "seed,s",            value_with_default( &seed ),        "Random seed" )
+    ( "skip_reference",                                        "Skip simulation with word_assignment_simulator" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_inputs == 0u || num_outputs > num_inputs + num_gates )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  aig_flat aig;
+  if ( opts.is_set( "filename" ) )
+  {
+    read_aiger_binary( aig, filename );
+  }
+  else
+  {
+    generate_random_aig( aig, num_inputs, num_gates, num_outputs, seed );
+  }
+  aig_print_stats( aig );
+
+  /* bit-parallel simulation for all available kernels */
+  std::vector<std::vector<std::uint64_t>> reference;
+  for ( auto level : {simd_level::scalar, simd_level::avx2, simd_level::avx512} )
+  {
+    if ( simd_select( level ) != level ) { continue; }
+
+    bitparallel_aig_simulator sim( aig, num_words, level );
+    sim.set_seed( seed );
+
+    std::vector<std::vector<std::uint64_t>> first;
+    boost::timer::cpu_timer t;
+    for ( auto r = 0u; r < rounds; ++r )
+    {
+      sim.randomize_inputs();
+      sim.simulate();
+
+      if ( r == 0u )
+      {
+        for ( auto i = 0u; i < sim.num_outputs(); ++i )
+        {
+          first.emplace_back( sim.output( i ), sim.output( i ) + sim.num_words() );
+        }
+      }
+    }
+    t.stop();
+
+    if ( reference.empty() )
+    {
+      reference = first;
+    }
+    else if ( reference != first )
+    {
+      std::cout << "[e] results of " << simd_level_name( level ) << " kernel differ from scalar kernel" << std::endl;
+      return 2;
+    }
+
+    const auto secs = t.elapsed().wall / 1.0e9;
+    const auto patterns = static_cast<double>( rounds ) * sim.num_patterns();
+    std::cout << boost::format( "[i] %-28s %8.2f secs  %14.0f patterns/sec  %14.0f gate evaluations/sec" )
+      % ( boost::format( "bitparallel (%s)" ) % simd_level_name( level ) ) % secs % ( patterns / secs ) % ( patterns * aig.num_gates() / secs ) << std::endl;
+  }
+
+  /* reference simulation with dynamic bitsets on aig_graph */
+  if ( !opts.is_set( "skip_reference" ) )
+  {
+    aig_graph graph;
+    aig_initialize( graph );
+    strash( aig, graph );
+
+    std::default_random_engine gen( seed );
+    std::bernoulli_distribution coin;
+
+    const auto num_patterns = num_words << 6u;
+    word_assignment_simulator::aig_name_value_map assignment;
+    for ( auto i = 0u; i < aig.num_inputs(); ++i )
+    {
+      boost::dynamic_bitset<> bs( num_patterns );
+      for ( auto p = 0u; p < num_patterns; ++p ) { bs[p] = coin( gen ); }
+      assignment[aig.input_name( i )] = bs;
+    }
+
+    boost::timer::cpu_timer t;
+    const auto reference_rounds = std::max( 1u, rounds / 10u );
+    for ( auto r = 0u; r < reference_rounds; ++r )
+    {
+      simulate_aig( graph, word_assignment_simulator( assignment ) );
+    }
+    t.stop();
+
+    const auto secs = t.elapsed().wall / 1.0e9;
+    const auto patterns = static_cast<double>( reference_rounds ) * num_patterns;
+    std::cout << boost::format( "[i] %-28s %8.2f secs  %14.0f patterns/sec  %14.0f gate evaluations/sec" )
+      % "word_assignment_simulator" % secs % ( patterns / secs ) % ( patterns * aig.num_gates() / secs ) << std::endl;
+  }
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,161 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <fstream>
+
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <core/utils/temporary_filename.hpp>
+#include <classical/aig_flat.hpp>
+#include <classical/generators/random_aig.hpp>
+#include <classical/io/read_aiger.hpp>
+#include <classical/io/write_aiger.hpp>
+
+using namespace cirkit;
+
+std::size_t file_size( const std::string& filename )
+{
+  std::ifstream in( filename.c_str(), std::ifstream::ate | std::ifstream::binary );
+  return in.tellg();
+}
+
+void report( const std::string& name, const boost::timer::cpu_timer& t, std::size_t bytes, std::size_t nodes )
+{
+  const auto secs = t.elapsed().wall / 1.0e9;
+  std::cout << boost::format( "[i] %-24s %8.2f secs  %9.2f MB/sec  %12.0f nodes/sec" ) % name % secs % ( bytes / secs / ( 1u << 20u ) ) % ( nodes / secs ) << std::endl;
+}
+
+bool same_structure( const aig_flat& a, const aig_flat& b )
+{
+  if ( a.size() != b.size() || a.num_inputs() != b.num_inputs() || a.num_outputs() != b.num_outputs() ) { return false; }
+
+  for ( auto n = 1u; n < a.size(); ++n )
+  {
+    if ( a.is_input( n ) != b.is_input( n ) ) { return false; }
+    if ( a.is_and( n ) && ( a.fanin0( n ) != b.fanin0( n ) || a.fanin1( n ) != b.fanin1( n ) ) ) { return false; }
+  }
+
+  for ( auto i = 0u; i < a.num_outputs(); ++i )
+  {
+    if ( a.outputs()[i] != b.outputs()[i] ) { return false; }
+  }
+
+  for ( auto i = 0u; i < a.num_inputs(); ++i )
+  {
+    if ( a.input_name( i ) != b.input_name( i ) ) { return false; }
+  }
+
+  return true;
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  auto num_inputs  = 1000u;
+  auto num_gates   = 10000000u;
+  auto num_outputs = 1000u;
+  auto seed        = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "inputs,i",  value_with_default( &num_inputs ),  "Number of inputs" )
+    ( "gates,g",   value_with_default( &num_gates ),   "Number of AND gates to create (before strashing)" )
+    ( "outputs,o", value_with_default( &num_outputs ), "Number of outputs" )
+    ( "seed,s",    value_with_default( &seed ),        "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_inputs == 0u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  aig_flat aig;
+  generate_random_aig( aig, num_inputs, num_gates, num_outputs, seed );
+  std::cout << boost::format( "[i] random AIG with %d inputs, %d gates, %d outputs" ) % aig.num_inputs() % aig.num_gates() % aig.num_outputs() << std::endl;
+
+  temporary_filename tmp( "/tmp/aiger_io_benchmark-%d.aig" );
+  const auto& filename = tmp.name();
+
+  {
+    boost::timer::cpu_timer t;
+    write_aiger_binary( aig, filename );
+    t.stop();
+    report( "write (buffered)", t, file_size( filename ), aig.size() );
+  }
+
+  const auto bytes = file_size( filename );
+  auto ok = true;
+
+  {
+    boost::timer::cpu_timer t;
+    aig_flat aig2;
+    std::ifstream in( filename.c_str(), std::ifstream::in );
+    read_aiger_binary( aig2, in, true );
+    t.stop();
+    report( "read (istream, noopt)", t, bytes, aig2.size() );
+    ok = ok && same_structure( aig, aig2 );
+  }
+
+  {
+    boost::timer::cpu_timer t;
+    aig_flat aig2;
+    aiger_binary_reader reader( filename );
+    reader.read( aig2, true );
+    t.stop();
+    report( "read (mapped, noopt)", t, bytes, aig2.size() );
+
+    reader.read_symbols( aig2 );
+    ok = ok && same_structure( aig, aig2 );
+  }
+
+  {
+    boost::timer::cpu_timer t;
+    aig_flat aig2;
+    read_aiger_binary( aig2, filename );
+    t.stop();
+    report( "read (mapped, strash)", t, bytes, aig2.size() );
+    ok = ok && same_structure( aig, aig2 );
+  }
+
+  std::cout << "[i] round trip: " << ( ok ? "ok" : "FAILED" ) << std::endl;
+
+  return ok ? 0 : 2;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
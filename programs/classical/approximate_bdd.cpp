@@ -56,6 +56,7 @@ int main( int argc, char ** argv )
   auto mode           = 0u;
   auto level          = 0u;
   auto maximum_method = 0u;
+  auto threads        = 1u;
 
   program_options opts;
   opts.add_options()
@@ -64,8 +65,10 @@ int main( int argc, char ** argv )
     ( "mode",           value_with_default( &mode ),           "Mode (0: round-down, 1: round-up, 2: round-closest, 3: co-factor 0, 4: co-factor 1, 5: copy)" )
     ( "level",          value_with_default( &level ),          "Round or co-factor at level (round is inclusive)" )
     ( "maximum_method", value_with_default( &maximum_method ), "Maximum method (0: shift, 1: chi)" )
+    ( "threads",        value_with_default( &threads ),        "Number of threads for BDD operations when reading an AIG" )
     ( "print,p",                                               "Print implicants of both functions" )
     ( "truthtable,t",                                          "Print truth table of both functions" )
+    ( "reorder,r",                                             "Enable dynamic variable reordering while reading" )
     ( "verbose,v",                                             "Be verbose" )
     ;
   opts.parse( argc, argv );
@@ -79,6 +82,8 @@ int main( int argc, char ** argv )
   /* read BDD */
   auto rib_settings = std::make_shared<properties>();
   rib_settings->set( "verbose", opts.is_set( "verbose" ) );
+  rib_settings->set( "reorder", opts.is_set( "reorder" ) );
+  rib_settings->set( "num_threads", threads );
   auto rib_statistics = std::make_shared<properties>();
 
   bdd_manager_ptr  manager;
@@ -165,6 +170,12 @@ int main( int argc, char ** argv )
   std::cout << format( "[i] run-time (wc):   %.2f" ) % wc_statistics->get<double>( "runtime" ) << std::endl;
   std::cout << format( "[i] run-time (ac):   %.2f" ) % ac_statistics->get<double>( "runtime" ) << std::endl;
 
+  if ( opts.is_set( "verbose" ) )
+  {
+    std::cout << "[i] BDD manager statistics:" << std::endl;
+    manager->dump_stats( std::cout );
+  }
+
   return 0;
 }
 
@@ -0,0 +1,220 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <core/utils/simd_utils.hpp>
+#include <classical/utils/cube2.hpp>
+#include <classical/utils/cube2_array.hpp>
+
+using namespace cirkit;
+
+/* results are accumulated here such that the compiler does not remove the kernels */
+std::size_t checksum = 0u;
+
+cube2 random_cube( unsigned num_vars, std::default_random_engine& gen )
+{
+  std::uniform_int_distribution<unsigned> lit( 0u, 2u );
+
+  cube2 c;
+  for ( auto v = 0u; v < num_vars; ++v )
+  {
+    switch ( lit( gen ) )
+    {
+    case 1u: c.mask |= 1u << v; break;
+    case 2u: c.mask |= 1u << v; c.bits |= 1u << v; break;
+    }
+  }
+  return c;
+}
+
+/* changes distance random positions of c to one of the two other values */
+cube2 random_neighbor( const cube2& c, unsigned num_vars, unsigned distance, std::default_random_engine& gen )
+{
+  std::vector<unsigned> vars( num_vars );
+  std::iota( vars.begin(), vars.end(), 0u );
+  std::shuffle( vars.begin(), vars.end(), gen );
+
+  std::uniform_int_distribution<unsigned> coin( 0u, 1u );
+
+  auto n = c;
+  for ( auto i = 0u; i < distance; ++i )
+  {
+    for ( auto r = coin( gen ); r <= 1u; ++r )
+    {
+      n.rotate( vars[i] );
+    }
+  }
+  return n;
+}
+
+void report( const std::string& name, const std::string& unit, std::size_t count, const std::function<void()>& f )
+{
+  boost::timer::cpu_timer t;
+  f();
+  const auto time = t.elapsed().wall / 1.0e9;
+  std::cout << boost::format( "[i] %-28s %14.0f %s/sec" ) % name % ( count / time ) % unit << std::endl;
+}
+
+int main( int argc, char ** argv )
+{
+  auto num_cubes   = 4096u;
+  auto num_queries = 2000u;
+  auto num_vars    = 16u;
+  auto seed        = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "cubes,c",   value_with_default( &num_cubes ),   "Number of cubes in the array" )
+    ( "queries,q", value_with_default( &num_queries ), "Number of query cubes" )
+    ( "vars,n",    value_with_default( &num_vars ),    "Number of variables (at most 32)" )
+    ( "seed,s",    value_with_default( &seed ),        "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_vars > 32u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  std::default_random_engine gen( seed );
+  std::vector<cube2> cubes, queries;
+  for ( auto i = 0u; i < num_cubes; ++i )   { cubes.push_back( random_cube( num_vars, gen ) ); }
+  for ( auto i = 0u; i < num_queries; ++i ) { queries.push_back( random_cube( num_vars, gen ) ); }
+
+  const cube2_array simd( cubes ), scalar( cubes, simd_level::scalar );
+  std::vector<unsigned char> dist( num_cubes );
+  const auto num_pairs = static_cast<std::size_t>( num_cubes ) * num_queries;
+
+  std::cout << boost::format( "[i] SIMD level: %s" ) % simd_level_name( simd.level() ) << std::endl;
+
+  /* distance */
+  report( "distance (cube2)", "pairs", num_pairs, [&]() {
+      for ( const auto& q : queries )
+      {
+        for ( auto i = 0u; i < num_cubes; ++i ) { dist[i] = q.distance( cubes[i] ); }
+        checksum += dist[q.bits % num_cubes];
+      }
+    } );
+
+  for ( const auto* arr : {&scalar, &simd} )
+  {
+    report( boost::str( boost::format( "distance (array, %s)" ) % simd_level_name( arr->level() ) ), "pairs", num_pairs, [&]() {
+        for ( const auto& q : queries )
+        {
+          arr->distances( q, dist );
+          checksum += dist[q.bits % num_cubes];
+        }
+      } );
+  }
+
+  for ( auto level : {simd_level::scalar, simd_level::avx2} )
+  {
+    report( boost::str( boost::format( "distance (cube2*, %s)" ) % simd_level_name( simd_select( level ) ) ), "pairs", num_pairs, [&]() {
+        for ( const auto& q : queries )
+        {
+          cube2_distances( q, cubes.data(), num_cubes, dist.data(), level );
+          checksum += dist[q.bits % num_cubes];
+        }
+      } );
+  }
+
+  /* find */
+  std::vector<unsigned> indexes;
+  for ( const auto* arr : {&scalar, &simd} )
+  {
+    report( boost::str( boost::format( "find distance 2 (%s)" ) % simd_level_name( arr->level() ) ), "pairs", num_pairs, [&]() {
+        for ( const auto& q : queries )
+        {
+          indexes.clear();
+          arr->find_distance( q, 2, indexes );
+          checksum += indexes.size();
+        }
+      } );
+  }
+
+  /* merge and EXORLINK, each query cube gets a batch of partners with the right distance */
+  const auto batch = std::max( 1u, num_cubes / std::max( 1u, num_queries ) );
+  std::vector<unsigned> partners( batch );
+  std::vector<cube2> out;
+
+  for ( auto distance = 1u; distance <= 3u; distance += 2u )
+  {
+    std::vector<cube2> neighbors;
+    for ( const auto& q : queries )
+    {
+      for ( auto i = 0u; i < batch; ++i )
+      {
+        neighbors.push_back( random_neighbor( q, num_vars, distance, gen ) );
+      }
+    }
+
+    for ( auto level : {simd_level::scalar, simd_level::avx2} )
+    {
+      const cube2_array arr( neighbors, level );
+      const auto name = boost::format( "%s (%s)" ) % ( distance == 1u ? "merge" : "exorlink distance 3" ) % simd_level_name( arr.level() );
+
+      report( boost::str( name ), "pairs", neighbors.size(), [&]() {
+          for ( auto k = 0u; k < num_queries; ++k )
+          {
+            std::iota( partners.begin(), partners.end(), k * batch );
+            if ( distance == 1u )
+            {
+              arr.merge( queries[k], partners, out );
+            }
+            else
+            {
+              arr.exorlink( queries[k], distance, partners, out );
+            }
+            checksum += out.back().value;
+          }
+        } );
+    }
+  }
+
+  std::cout << "[i] checksum: " << checksum << std::endl;
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,160 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <classical/aig.hpp>
+#include <classical/functions/cuts/priority.hpp>
+#include <classical/generators/random_aig.hpp>
+#include <classical/xmg/xmg_aig.hpp>
+#include <classical/xmg/xmg_cuts_paged.hpp>
+#include <classical/xmg/xmg_io.hpp>
+#include <classical/xmg/xmg_utils.hpp>
+
+using namespace cirkit;
+
+/* results are accumulated here such that the compiler does not remove the simulation */
+std::size_t checksum = 0u;
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  std::string filename;
+  auto num_inputs  = 128u;
+  auto num_gates   = 50000u;
+  auto num_outputs = 128u;
+  auto cut_size    = 6u;
+  auto priority    = 8u;
+  auto seed        = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "filename",          value( &filename ),                 "Verilog filename, if not given a random network is generated" )
+    ( "inputs,i",          value_with_default( &num_inputs ),  "Number of inputs of random network" )
+    ( "gates,g",           value_with_default( &num_gates ),   "Number of gates of random network" )
+    ( "outputs,o",         value_with_default( &num_outputs ), "Number of outputs of random network" )
+    ( "cut_size,k",        value_with_default( &cut_size ),    "Maximum number of leafs in a cut (at most 8)" )
+    ( "priority,p",        value_with_default( &priority ),    "Maximum number of cuts per node" )
+    ( "seed,s",            value_with_default( &seed ),        "Random seed" )
+    ( "verify",                                                "Compare the truth tables of priority cuts to simulation" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_inputs == 0u || cut_size < 3u || cut_size > 8u || priority == 0u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  xmg_graph xmg;
+  if ( opts.is_set( "filename" ) )
+  {
+    xmg = read_verilog( filename );
+  }
+  else
+  {
+    aig_graph aig;
+    aig_initialize( aig );
+    generate_random_aig( aig, num_inputs, num_gates, num_outputs, seed, 1024u );
+    xmg = xmg_from_aig( aig );
+  }
+  std::cout << boost::format( "[i] network with %d inputs, %d outputs, and %d gates" ) % xmg.inputs().size() % xmg.outputs().size() % xmg.num_gates() << std::endl;
+
+  /* paged cuts, truth tables are obtained by simulation */
+  {
+    auto settings = std::make_shared<properties>();
+    xmg_cuts_paged cuts( xmg, cut_size, settings );
+
+    boost::timer::cpu_timer t;
+    cuts.foreach_cut( [&cuts, &xmg]( xmg_node n, xmg_cuts_paged::cut& c ) {
+        if ( !xmg.is_input( n ) ) { checksum += cuts.simulate( n, c ).count(); }
+      } );
+    const auto sim_time = t.elapsed().wall / 1.0e9;
+
+    std::cout << boost::format( "[i] paged:    %9d cuts  %8d KB  enumeration %7.2f secs  simulation %7.2f secs" )
+      % cuts.total_cut_count() % ( cuts.memory() >> 10u ) % cuts.enumeration_time() % sim_time << std::endl;
+  }
+
+  /* priority cuts, truth tables are computed during enumeration */
+  for ( auto cost : {priority_cut_cost::depth, priority_cut_cost::area_flow} )
+  {
+    auto settings = std::make_shared<properties>();
+    settings->set( "priority", priority );
+    settings->set( "cost",     cost );
+    priority_cuts<xmg_graph, 8u> cuts( xmg, cut_size, settings );
+
+    for ( auto n = 0u; n < xmg.size(); ++n )
+    {
+      for ( const auto& c : cuts.cuts( n ) )
+      {
+        checksum += c.function().count();
+      }
+    }
+
+    std::cout << boost::format( "[i] priority: %9d cuts  %8d KB  enumeration %7.2f secs  (%s)" )
+      % cuts.total_cut_count() % ( cuts.memory() >> 10u ) % cuts.enumeration_time() % ( cost == priority_cut_cost::depth ? "depth" : "area flow" ) << std::endl;
+
+    if ( opts.is_set( "verify" ) )
+    {
+      for ( auto n = 0u; n < xmg.size(); ++n )
+      {
+        if ( xmg.is_input( n ) ) { continue; }
+
+        for ( const auto& c : cuts.cuts( n ) )
+        {
+          if ( c.size() == 0u ) { continue; }
+
+          if ( xmg_simulate_cut( xmg, n, std::vector<xmg_node>( c.begin(), c.end() ) ) != c.simulate() )
+          {
+            std::cout << boost::format( "[e] truth table of cut at node %d differs from simulation" ) % n << std::endl;
+            return 2;
+          }
+        }
+      }
+      std::cout << "[i] truth tables verified" << std::endl;
+    }
+  }
+
+  std::cout << "[i] checksum: " << checksum << std::endl;
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,210 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <core/cube.hpp>
+#include <core/properties.hpp>
+#include <core/utils/program_options.hpp>
+#include <core/utils/string_utils.hpp>
+#include <classical/optimization/exorcism2.hpp>
+#include <classical/optimization/exorcism_parallel.hpp>
+#include <classical/utils/cube2.hpp>
+
+using namespace cirkit;
+
+using cover_t = std::vector<cube2>;
+
+/* for functions with up to 16 variables */
+boost::dynamic_bitset<> cover_to_truth_table( const cover_t& cover, unsigned num_vars )
+{
+  boost::dynamic_bitset<> tt( 1u << num_vars );
+
+  for ( const auto& c : cover )
+  {
+    /* enumerate all minterms of c */
+    const auto free = ~c.mask & ( ( 1u << num_vars ) - 1u );
+    auto m = 0u;
+    do
+    {
+      tt.flip( c.bits | m );
+      m = ( m - free ) & free;
+    } while ( m );
+  }
+
+  return tt;
+}
+
+unsigned num_literals( const cover_t& cover )
+{
+  auto lits = 0u;
+  for ( const auto& c : cover )
+  {
+    lits += c.num_literals();
+  }
+  return lits;
+}
+
+bool benchmark( const std::string& name, const cover_t& cover, unsigned num_vars, unsigned num_threads )
+{
+  const auto verify = num_vars <= 16u;
+  boost::dynamic_bitset<> func;
+  if ( verify )
+  {
+    func = cover_to_truth_table( cover, num_vars );
+  }
+
+  std::cout << boost::format( "[i] %s  vars = %d  cubes = %d" ) % name % num_vars % cover.size() << std::endl;
+
+  const auto run = [&]( const std::string& approach, const std::function<cover_t()>& f, cover_t& result ) {
+    boost::timer::cpu_timer t;
+    result = f();
+    const auto time = t.elapsed().wall / 1.0e9;
+
+    std::cout << boost::format( "[i]   %-22s cubes = %6d  literals = %7d  time = %8.3f secs" ) % approach % result.size() % num_literals( result ) % time << std::endl;
+
+    if ( verify && cover_to_truth_table( result, num_vars ) != func )
+    {
+      std::cout << boost::format( "[e] %s computes a wrong cover for %s" ) % approach % name << std::endl;
+      return false;
+    }
+    return true;
+  };
+
+  const auto parallel = [&]( unsigned threads, bool deterministic ) {
+    return [&cover, num_vars, threads, deterministic]() {
+      auto settings = std::make_shared<properties>();
+      settings->set( "num_threads", threads );
+      settings->set( "deterministic", deterministic );
+      return exorcism_parallel( cover, num_vars, settings );
+    };
+  };
+
+  cover_t r_exorcism2, r_single, r_det, r_nondet;
+  auto ok = run( "exorcism2", [&cover, num_vars]() { return exorcism2( cover, num_vars ); }, r_exorcism2 ) &&
+            run( "parallel (1 thread)", parallel( 1u, true ), r_single ) &&
+            run( "parallel (det.)", parallel( num_threads, true ), r_det ) &&
+            run( "parallel (non-det.)", parallel( num_threads, false ), r_nondet );
+
+  if ( ok && r_single != r_det )
+  {
+    std::cout << boost::format( "[e] deterministic mode depends on number of threads for %s" ) % name << std::endl;
+    ok = false;
+  }
+
+  return ok;
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  std::string filenames;
+  auto num_random  = 5u;
+  auto num_vars    = 10u;
+  auto num_threads = 0u;
+  auto seed        = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "filenames,f", value( &filenames ),                "PLA files (comma separated), each output is read as ESOP" )
+    ( "random,r",    value_with_default( &num_random ),  "Number of random functions, given as ESOP of their minterms" )
+    ( "vars,n",      value_with_default( &num_vars ),    "Number of variables in random functions (at most 16)" )
+    ( "threads,t",   value_with_default( &num_threads ), "Number of threads (0: one per core)" )
+    ( "seed,s",      value_with_default( &seed ),        "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_vars > 16u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  auto ok = true;
+
+  if ( opts.is_set( "filenames" ) )
+  {
+    foreach_string( filenames, ",", [&]( const std::string& filename ) {
+        const auto outputs = common_pla_read( filename );
+        for ( auto o = 0u; o < outputs.size() && ok; ++o )
+        {
+          if ( outputs[o].empty() ) continue;
+
+          const auto n = outputs[o].front().length();
+          if ( n > 32u )
+          {
+            std::cout << boost::format( "[w] skip %s, too many inputs" ) % filename << std::endl;
+            return;
+          }
+
+          cover_t cover;
+          for ( const auto& c : outputs[o] )
+          {
+            cover.push_back( cube2( ( c.bits() & c.care() ).to_ulong(), c.care().to_ulong() ) );
+          }
+
+          ok = benchmark( boost::str( boost::format( "%s:%d" ) % filename % o ), cover, n, num_threads );
+        }
+      } );
+  }
+
+  /* random functions, the initial cover consists of all minterms */
+  std::default_random_engine gen( seed );
+  std::uniform_int_distribution<unsigned> bit( 0u, 1u );
+  for ( auto k = 0u; k < num_random && ok; ++k )
+  {
+    cover_t cover;
+    for ( auto m = 0u; m < ( 1u << num_vars ); ++m )
+    {
+      if ( bit( gen ) )
+      {
+        cover.push_back( cube2( m, ( 1u << num_vars ) - 1u ) );
+      }
+    }
+
+    ok = benchmark( boost::str( boost::format( "random%d" ) % k ), cover, num_vars, num_threads );
+  }
+
+  return ok ? 0 : 2;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
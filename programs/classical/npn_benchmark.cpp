@@ -0,0 +1,154 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <array>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <classical/functions/npn_canonization.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+using namespace cirkit;
+
+/* results are accumulated here such that the compiler does not remove the canonization */
+std::size_t checksum = 0u;
+
+using npn_func_t = std::function<tt(const tt&, boost::dynamic_bitset<>&, std::vector<unsigned>&)>;
+
+double time_approach( const npn_func_t& func, const std::vector<tt>& funcs, unsigned count )
+{
+  boost::dynamic_bitset<> phase;
+  std::vector<unsigned>   perm;
+
+  boost::timer::cpu_timer t;
+  for ( auto k = 0u; k < count; ++k )
+  {
+    checksum += func( funcs[k], phase, perm ).count();
+  }
+  return t.elapsed().wall / 1.0e9;
+}
+
+bool benchmark( unsigned num_vars, unsigned num_funcs, unsigned num_exact_funcs, unsigned num_threads, std::default_random_engine& gen )
+{
+  std::vector<tt>       funcs;
+  std::vector<uint64_t> words;
+
+  std::uniform_int_distribution<uint64_t> dist;
+  const auto mask = num_vars == 6u ? ~UINT64_C( 0 ) : ( UINT64_C( 1 ) << ( 1u << num_vars ) ) - 1u;
+  for ( auto k = 0u; k < num_funcs; ++k )
+  {
+    words.push_back( dist( gen ) & mask );
+    funcs.push_back( tt( 1u << num_vars, words.back() ) );
+  }
+  num_exact_funcs = std::min( num_exact_funcs, num_funcs );
+
+  /* both exact approaches must find the same representative */
+  for ( auto k = 0u; k < num_exact_funcs; ++k )
+  {
+    boost::dynamic_bitset<> phase;
+    std::vector<unsigned>   perm;
+
+    if ( exact_npn_canonization( funcs[k], phase, perm ) != exact_npn_canonization_fast( funcs[k], phase, perm ) )
+    {
+      std::cout << boost::format( "[e] exact approaches differ for %s" ) % tt_to_hex( funcs[k] ) << std::endl;
+      return false;
+    }
+  }
+
+  const auto report = [num_vars]( const std::string& name, unsigned count, double time ) {
+    std::cout << boost::format( "[i] %d vars  %-12s %12.0f funcs/sec" ) % num_vars % name % ( count / time ) << std::endl;
+  };
+
+  report( "exact", num_exact_funcs, time_approach( []( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) { return exact_npn_canonization( t, phase, perm ); }, funcs, num_exact_funcs ) );
+  report( "exact_fast", num_funcs, time_approach( []( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) { return exact_npn_canonization_fast( t, phase, perm ); }, funcs, num_funcs ) );
+
+  {
+    std::vector<uint64_t> npns;
+    std::vector<unsigned> phases;
+    std::vector<std::array<unsigned char, 6u>> perms;
+
+    boost::timer::cpu_timer t;
+    exact_npn_canonization6_batch( words, num_vars, npns, phases, perms, num_threads );
+    report( "exact_batch", num_funcs, t.elapsed().wall / 1.0e9 );
+
+    for ( auto npn : npns ) { checksum += npn; }
+  }
+
+  report( "flip_swap", num_funcs, time_approach( []( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) { return npn_canonization_flip_swap( t, phase, perm ); }, funcs, num_funcs ) );
+  report( "sifting", num_funcs, time_approach( []( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) { return npn_canonization_sifting( t, phase, perm ); }, funcs, num_funcs ) );
+  report( "lucky", num_funcs, time_approach( []( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) { return npn_canonization_lucky( t, phase, perm ); }, funcs, num_funcs ) );
+
+  return true;
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  auto num_funcs       = 10000u;
+  auto num_exact_funcs = 20u;
+  auto num_threads     = 0u;
+  auto seed            = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "funcs,f",       value_with_default( &num_funcs ),       "Number of random functions per size" )
+    ( "exact_funcs,e", value_with_default( &num_exact_funcs ), "Number of random functions for exact_npn_canonization (slow)" )
+    ( "threads,t",     value_with_default( &num_threads ),     "Number of threads for batched canonization (0: one per core)" )
+    ( "seed,s",        value_with_default( &seed ),            "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  std::default_random_engine gen( seed );
+  const auto ok = benchmark( 4u, num_funcs, num_exact_funcs, num_threads, gen ) &&
+                  benchmark( 5u, num_funcs, num_exact_funcs, num_threads, gen ) &&
+                  benchmark( 6u, num_funcs, num_exact_funcs, num_threads, gen );
+
+  std::cout << "[i] checksum: " << checksum << std::endl;
+
+  return ok ? 0 : 2;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
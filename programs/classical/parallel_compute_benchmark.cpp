@@ -0,0 +1,145 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <algorithm>
+#include <thread>
+
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <classical/aig.hpp>
+#include <classical/functions/parallel_compute.hpp>
+#include <classical/generators/random_aig.hpp>
+#include <classical/io/read_aiger.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+using namespace cirkit;
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  std::string filename;
+  auto num_inputs  = 256u;
+  auto num_gates   = 1000000u;
+  auto num_outputs = 256u;
+  auto max_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  auto work        = 16u;
+  auto seed        = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "filename",          value( &filename ),                 "AIG filename (in binary AIGER format), if not given a random AIG is generated" )
+    ( "inputs,i",          value_with_default( &num_inputs ),  "Number of inputs of random AIG" )
+    ( "gates,g",           value_with_default( &num_gates ),   "Number of AND gates of random AIG" )
+    ( "outputs,o",         value_with_default( &num_outputs ), "Number of outputs of random AIG" )
+    ( "threads,t",         value_with_default( &max_threads ), "Maximum number of threads" )
+    ( "work,w",            value_with_default( &work ),        "Artificial work per node (number of mixing rounds)" )
+    ( "seed,s",            value_with_default( &seed ),        "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() || num_inputs == 0u || max_threads == 0u )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  aig_graph aig;
+  aig_initialize( aig );
+  if ( opts.is_set( "filename" ) )
+  {
+    read_aiger_binary( aig, filename );
+  }
+  else
+  {
+    generate_random_aig( aig, num_inputs, num_gates, num_outputs, seed );
+  }
+  aig_print_stats( aig );
+
+  /* 64-bit simulation with some artificial work to mimic expensive callbacks */
+  const std::function<std::uint64_t( unsigned )> on_input = [seed]( unsigned index ) {
+    return ( index + 1u ) * UINT64_C( 0x9e3779b97f4a7c15 ) ^ seed;
+  };
+  const std::function<std::uint64_t( const std::uint64_t&, bool, const std::uint64_t&, bool )> on_and = [work]( const std::uint64_t& v1, bool c1, const std::uint64_t& v2, bool c2 ) {
+    auto v = ( c1 ? ~v1 : v1 ) & ( c2 ? ~v2 : v2 );
+    auto h = v;
+    for ( auto i = 0u; i < work; ++i )
+    {
+      h ^= h >> 33u;
+      h *= UINT64_C( 0xff51afd7ed558ccd );
+    }
+    /* keeps the compiler from removing the artificial work */
+    return h == 0u ? ~v : v;
+  };
+
+  std::vector<std::uint64_t> reference;
+  auto base_time = 0.0;
+
+  std::vector<unsigned> thread_counts;
+  for ( auto threads = 1u; threads < max_threads; threads <<= 1u )
+  {
+    thread_counts.push_back( threads );
+  }
+  thread_counts.push_back( max_threads );
+
+  for ( auto threads : thread_counts )
+  {
+    std::vector<std::uint64_t> values;
+
+    boost::timer::cpu_timer t;
+    parallel_compute<std::uint64_t>( aig, 0u, on_input, on_and, values, threads );
+    t.stop();
+
+    if ( reference.empty() )
+    {
+      reference = values;
+    }
+    else if ( reference != values )
+    {
+      std::cout << "[e] results with " << threads << " threads differ from sequential results" << std::endl;
+      return 2;
+    }
+
+    const auto secs = t.elapsed().wall / 1.0e9;
+    if ( threads == 1u ) { base_time = secs; }
+
+    std::cout << boost::format( "[i] threads: %3d  time: %8.2f secs  speedup: %5.2f" ) % threads % secs % ( base_time / secs ) << std::endl;
+  }
+
+  return 0;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
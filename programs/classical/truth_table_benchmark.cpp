@@ -0,0 +1,176 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @author Mathias Soeken
+ */
+
+#include <random>
+#include <vector>
+
+#include <boost/format.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <core/utils/program_options.hpp>
+#include <classical/utils/static_truth_table.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+using namespace cirkit;
+
+/* results are accumulated here such that the compiler does not remove the operations */
+std::size_t checksum = 0u;
+
+enum class tt_operation { cof0, cof1, flip, permute, exists };
+
+const char* operation_name( tt_operation op )
+{
+  switch ( op )
+  {
+  case tt_operation::cof0:    return "cof0";
+  case tt_operation::cof1:    return "cof1";
+  case tt_operation::flip:    return "flip";
+  case tt_operation::permute: return "permute";
+  case tt_operation::exists:  return "exists";
+  }
+  return "unknown";
+}
+
+template<typename TT>
+TT apply_operation( tt_operation op, const TT& t, unsigned i, unsigned j )
+{
+  switch ( op )
+  {
+  case tt_operation::cof0:    return tt_cof0( t, i );
+  case tt_operation::cof1:    return tt_cof1( t, i );
+  case tt_operation::flip:    return tt_flip( t, i );
+  case tt_operation::permute: return tt_permute( t, i, j );
+  case tt_operation::exists:  return tt_exists( t, i );
+  }
+  return t;
+}
+
+template<typename TT>
+double time_operation( tt_operation op, const std::vector<TT>& funcs, unsigned rounds, unsigned num_vars )
+{
+  boost::timer::cpu_timer t;
+  for ( auto r = 0u; r < rounds; ++r )
+  {
+    const auto i = r % num_vars, j = ( 7u * r + 3u ) % num_vars;
+    for ( const auto& f : funcs )
+    {
+      checksum += apply_operation( op, f, i, j ).count();
+    }
+  }
+  return t.elapsed().wall / 1.0e9;
+}
+
+template<unsigned N>
+bool benchmark( unsigned num_funcs, unsigned rounds, std::default_random_engine& gen )
+{
+  std::vector<tt> dfuncs;
+  std::vector<static_tt<N>> sfuncs;
+
+  std::bernoulli_distribution coin;
+  for ( auto k = 0u; k < num_funcs; ++k )
+  {
+    tt f( 1u << N );
+    for ( auto p = 0u; p < f.size(); ++p ) { f[p] = coin( gen ); }
+    dfuncs.push_back( f );
+    sfuncs.push_back( to_static_tt<N>( f ) );
+  }
+
+  /* larger functions get fewer rounds */
+  rounds = std::max( 1u, rounds >> ( N > 6u ? N - 6u : 0u ) );
+
+  for ( auto op : {tt_operation::cof0, tt_operation::cof1, tt_operation::flip, tt_operation::permute, tt_operation::exists} )
+  {
+    /* results must agree before timing */
+    for ( auto k = 0u; k < num_funcs; ++k )
+    {
+      for ( auto i = 0u; i < N; ++i )
+      {
+        const auto j = ( 7u * i + 3u ) % N;
+        if ( to_static_tt<N>( apply_operation( op, dfuncs[k], i, j ) ) != apply_operation( op, sfuncs[k], i, j ) )
+        {
+          std::cout << boost::format( "[e] %s differs for %d variables" ) % operation_name( op ) % N << std::endl;
+          return false;
+        }
+      }
+    }
+
+    const auto dtime = time_operation( op, dfuncs, rounds, N );
+    const auto stime = time_operation( op, sfuncs, rounds, N );
+    const auto num_ops = static_cast<double>( rounds ) * num_funcs;
+
+    std::cout << boost::format( "[i] %2d vars  %-8s  tt %12.0f ops/sec  static_tt %12.0f ops/sec  speedup %6.1fx" )
+      % N % operation_name( op ) % ( num_ops / dtime ) % ( num_ops / stime ) % ( dtime / stime ) << std::endl;
+  }
+
+  return true;
+}
+
+int main( int argc, char ** argv )
+{
+  using boost::program_options::value;
+
+  auto num_funcs = 64u;
+  auto rounds    = 20000u;
+  auto seed      = 42u;
+
+  program_options opts;
+  opts.add_options()
+    ( "funcs,f",  value_with_default( &num_funcs ), "Number of random functions per size" )
+    ( "rounds,r", value_with_default( &rounds ),    "Number of rounds for 6-variable functions (halved for each additional variable)" )
+    ( "seed,s",   value_with_default( &seed ),      "Random seed" )
+    ;
+  opts.parse( argc, argv );
+
+  if ( !opts.good() )
+  {
+    std::cout << opts << std::endl;
+    return 1;
+  }
+
+  std::cout << "[i] SIMD level: " << simd_level_name( simd_detect() ) << std::endl;
+
+  std::default_random_engine gen( seed );
+  const auto ok = benchmark<4u>( num_funcs, rounds, gen ) &&
+                  benchmark<6u>( num_funcs, rounds, gen ) &&
+                  benchmark<8u>( num_funcs, rounds, gen ) &&
+                  benchmark<10u>( num_funcs, rounds, gen ) &&
+                  benchmark<12u>( num_funcs, rounds, gen ) &&
+                  benchmark<16u>( num_funcs, rounds, gen );
+
+  std::cout << "[i] checksum: " << checksum << std::endl;
+
+  return ok ? 0 : 2;
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
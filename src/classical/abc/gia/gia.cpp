@@ -143,6 +143,15 @@ gia_graph::gia_graph( const aig_graph& aig )
 {
 }
 
+gia_graph::gia_graph( gia_graph&& other )
+  : p_gia( other.p_gia ),
+    p_truths( other.p_truths ),
+    p_cudd_mgr( std::move( other.p_cudd_mgr ) )
+{
+  other.p_gia = nullptr;
+  other.p_truths = nullptr;
+}
+
 gia_graph::~gia_graph()
 {
   if ( p_truths )
@@ -64,6 +64,9 @@ public:
   /** construct GIA from aig_graph */
   explicit gia_graph( const aig_graph& aig );
 
+  /** takes ownership of the network of other */
+  gia_graph( gia_graph&& other );
+
   ~gia_graph();
 
   /// CONSISTENCY AND CONVERSION
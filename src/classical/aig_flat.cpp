@@ -0,0 +1,276 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "aig_flat.hpp"
+
+#include <cassert>
+
+#include <boost/format.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+constexpr aig_flat::literal_t aig_flat::input_marker;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+aig_flat::node_t aig_flat::strash_lookup( literal_t a, literal_t b ) const
+{
+  const auto mask = _strash.size() - 1u;
+  auto slot = strash_slot( a, b );
+
+  while ( true )
+  {
+    const auto& e = _strash[slot];
+    if ( e.node == 0u ) { return 0u; }
+    if ( e.left == a && e.right == b ) { return e.node; }
+    slot = ( slot + 1u ) & mask;
+  }
+}
+
+void aig_flat::strash_insert( literal_t a, literal_t b, node_t n )
+{
+  if ( ( _strash_count + 1u ) << 1u > _strash.size() )
+  {
+    strash_grow();
+  }
+
+  const auto mask = _strash.size() - 1u;
+  auto slot = strash_slot( a, b );
+
+  while ( _strash[slot].node != 0u )
+  {
+    slot = ( slot + 1u ) & mask;
+  }
+
+  _strash[slot] = {a, b, n};
+  ++_strash_count;
+}
+
+void aig_flat::strash_grow()
+{
+  std::vector<strash_entry> old( std::size_t( 1u ) << ( _strash_log + 1u ) );
+  std::swap( old, _strash );
+  ++_strash_log;
+
+  const auto mask = _strash.size() - 1u;
+  for ( const auto& e : old )
+  {
+    if ( e.node == 0u ) { continue; }
+
+    auto slot = strash_slot( e.left, e.right );
+    while ( _strash[slot].node != 0u )
+    {
+      slot = ( slot + 1u ) & mask;
+    }
+    _strash[slot] = e;
+  }
+}
+
+/******************************************************************************
+ * aig_flat                                                                   *
+ ******************************************************************************/
+
+aig_flat::aig_flat( const std::string& model_name )
+  : _model_name( model_name ),
+    _fanins( 2u, 0u ),
+    _strash( std::size_t( 1u ) << _strash_log, strash_entry{0u, 0u, 0u} )
+{
+}
+
+void aig_flat::reserve( unsigned num_nodes )
+{
+  _fanins.reserve( num_nodes << 1u );
+
+  while ( _enable_strashing && ( std::size_t( 1u ) << _strash_log ) < ( std::size_t( num_nodes ) << 1u ) )
+  {
+    strash_grow();
+  }
+}
+
+aig_flat::literal_t aig_flat::get_constant( bool value )
+{
+  _constant_used = true;
+  return make_literal( 0u, value );
+}
+
+aig_flat::literal_t aig_flat::create_pi( const std::string& name )
+{
+  const node_t n = size();
+
+  _fanins.push_back( input_marker );
+  _fanins.push_back( _inputs.size() );
+  _inputs.push_back( n );
+  _input_names.push_back( name );
+
+  return make_literal( n );
+}
+
+void aig_flat::create_po( literal_t f, const std::string& name )
+{
+  if ( literal_node( f ) == 0u )
+  {
+    _constant_used = true;
+  }
+  _outputs.push_back( {f, name} );
+}
+
+aig_flat::literal_t aig_flat::create_and( literal_t a, literal_t b )
+{
+  /* constants */
+  if ( _enable_local_optimization )
+  {
+    if ( a == 0u || b == 0u ) { return get_constant( false ); }
+    if ( a == 1u )            { return b; }
+    if ( b == 1u )            { return a; }
+    if ( a == b )             { return a; }
+    if ( ( a ^ b ) == 1u )    { return get_constant( false ); }
+  }
+
+  /* structural hashing */
+  if ( a > b ) { std::swap( a, b ); }
+  if ( _enable_strashing )
+  {
+    const auto n = strash_lookup( a, b );
+    if ( n != 0u )
+    {
+      return make_literal( n );
+    }
+  }
+
+  /* create node */
+  const node_t n = size();
+  assert( n < ( 1u << 31u ) && "too many nodes for 32-bit literals" );
+
+  _fanins.push_back( a );
+  _fanins.push_back( b );
+
+  if ( _enable_strashing )
+  {
+    strash_insert( a, b, n );
+  }
+
+  return make_literal( n );
+}
+
+aig_flat::literal_t* aig_flat::append_ands( unsigned count )
+{
+  assert( !_enable_strashing && "appended nodes are not hashed" );
+  assert( size() + count < ( 1u << 31u ) && "too many nodes for 32-bit literals" );
+
+  const auto offset = _fanins.size();
+  _fanins.resize( offset + ( std::size_t( count ) << 1u ) );
+  return _fanins.data() + offset;
+}
+
+std::size_t aig_flat::memory() const
+{
+  return sizeof( aig_flat ) +
+    _fanins.capacity() * sizeof( literal_t ) +
+    _inputs.capacity() * sizeof( node_t ) +
+    _outputs.capacity() * sizeof( output_vec_t::value_type ) +
+    _strash.capacity() * sizeof( strash_entry );
+}
+
+/******************************************************************************
+ * aig_graph compatible interface                                             *
+ ******************************************************************************/
+
+void aig_initialize( aig_flat& aig, const std::string& model_name )
+{
+  assert( aig.size() == 1u );
+  aig.set_model_name( model_name );
+}
+
+aig_function aig_get_constant( aig_flat& aig, bool value )
+{
+  return aig_flat_to_function( aig.get_constant( value ) );
+}
+
+aig_function aig_create_pi( aig_flat& aig, const std::string& name )
+{
+  return aig_flat_to_function( aig.create_pi( name ) );
+}
+
+void aig_create_po( aig_flat& aig, const aig_function& f, const std::string& name )
+{
+  aig.create_po( aig_flat_to_literal( f ), name );
+}
+
+aig_function aig_create_and( aig_flat& aig, const aig_function& left, const aig_function& right )
+{
+  return aig_flat_to_function( aig.create_and( aig_flat_to_literal( left ), aig_flat_to_literal( right ) ) );
+}
+
+aig_function aig_create_nand( aig_flat& aig, const aig_function& left, const aig_function& right )
+{
+  return !aig_create_and( aig, left, right );
+}
+
+aig_function aig_create_or( aig_flat& aig, const aig_function& left, const aig_function& right )
+{
+  return !aig_create_and( aig, !left, !right );
+}
+
+aig_function aig_create_nor( aig_flat& aig, const aig_function& left, const aig_function& right )
+{
+  return aig_create_and( aig, !left, !right );
+}
+
+aig_function aig_create_xor( aig_flat& aig, const aig_function& left, const aig_function& right )
+{
+  return aig_create_or( aig, aig_create_and( aig, !left, right ), aig_create_and( aig, left, !right ) );
+}
+
+aig_function aig_create_ite( aig_flat& aig, const aig_function& cond, const aig_function& t, const aig_function& e )
+{
+  return aig_create_or( aig, aig_create_and( aig, cond, t ), aig_create_and( aig, !cond, e ) );
+}
+
+aig_function aig_create_maj( aig_flat& aig, const aig_function& a, const aig_function& b, const aig_function& c )
+{
+  return aig_create_or( aig, aig_create_or( aig, aig_create_and( aig, a, b ), aig_create_and( aig, a, c ) ), aig_create_and( aig, b, c ) );
+}
+
+void aig_print_stats( const aig_flat& aig, std::ostream& os )
+{
+  const auto name = aig.model_name().empty() ? "(unnamed)" : aig.model_name();
+  os << boost::format( "[i] %20s: i/o = %7d / %7d  and = %7d  mem = %.2f MB" ) % name % aig.num_inputs() % aig.num_outputs() % aig.num_gates() % ( aig.memory() / ( 1024.0 * 1024.0 ) ) << std::endl;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
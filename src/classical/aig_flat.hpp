@@ -0,0 +1,219 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file aig_flat.hpp
+ *
+ * @brief Flat AIG package
+ *
+ * Compact alternative to aig_graph for very large AIGs.  Nodes are
+ * stored in topological order, each AND node by two packed 32-bit
+ * literals, and structural hashing uses an open-addressing table
+ * instead of a std::map.  Node indexes correspond to aig_function::node
+ * such that the free functions below can be used as a drop-in for the
+ * corresponding aig_graph functions.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef AIG_FLAT_HPP
+#define AIG_FLAT_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <core/properties.hpp>
+#include <classical/aig.hpp>
+
+namespace cirkit
+{
+
+class aig_flat
+{
+public:
+  using node_t    = std::uint32_t;
+  using literal_t = std::uint32_t;
+
+  using output_vec_t = std::vector<std::pair<literal_t, std::string>>;
+
+public:
+  explicit aig_flat( const std::string& model_name = std::string() );
+
+  /* literals */
+  inline static literal_t make_literal( node_t n, bool complemented = false ) { return ( n << 1u ) | ( complemented ? 1u : 0u ); }
+  inline static node_t    literal_node( literal_t l )                         { return l >> 1u; }
+  inline static bool      literal_complemented( literal_t l )                 { return ( l & 1u ) == 1u; }
+
+  /* construction */
+  void reserve( unsigned num_nodes );
+  literal_t get_constant( bool value );
+  literal_t create_pi( const std::string& name );
+  void create_po( literal_t f, const std::string& name );
+  literal_t create_and( literal_t a, literal_t b );
+
+  /* appends count AND nodes without structural hashing and returns their
+     fanin array (two literals per node, smaller literal first), which the
+     caller must fill; used by readers that decode directly into the AIG */
+  literal_t* append_ands( unsigned count );
+
+  /* structure */
+  inline std::size_t size() const                 { return _fanins.size() >> 1u; }
+  inline unsigned num_inputs() const              { return _inputs.size(); }
+  inline unsigned num_outputs() const             { return _outputs.size(); }
+  inline unsigned num_gates() const               { return size() - _inputs.size() - 1u; }
+
+  inline bool is_constant( node_t n ) const       { return n == 0u; }
+  inline bool is_input( node_t n ) const          { return n != 0u && _fanins[n << 1u] == input_marker; }
+  inline bool is_and( node_t n ) const            { return n != 0u && _fanins[n << 1u] != input_marker; }
+
+  inline literal_t fanin0( node_t n ) const       { return _fanins[n << 1u]; }
+  inline literal_t fanin1( node_t n ) const       { return _fanins[( n << 1u ) + 1u]; }
+  inline unsigned input_index( node_t n ) const   { return _fanins[( n << 1u ) + 1u]; }
+
+  inline const std::vector<node_t>& inputs() const      { return _inputs; }
+  inline const output_vec_t& outputs() const            { return _outputs; }
+  inline output_vec_t& outputs()                        { return _outputs; }
+  inline const std::string& input_name( unsigned index ) const { return _input_names[index]; }
+  inline void set_input_name( unsigned index, const std::string& name ) { _input_names[index] = name; }
+
+  inline const std::string& model_name() const           { return _model_name; }
+  inline void set_model_name( const std::string& name )  { _model_name = name; }
+
+  inline bool is_constant_used() const                   { return _constant_used; }
+
+  /* number of bytes allocated for structure and structural hashing (names excluded) */
+  std::size_t memory() const;
+
+  /* iterators (nodes are visited in topological order) */
+  template<typename Fn>
+  void foreach_input( Fn&& f ) const
+  {
+    for ( auto i = 0u; i < _inputs.size(); ++i )
+    {
+      f( _inputs[i], i );
+    }
+  }
+
+  template<typename Fn>
+  void foreach_and( Fn&& f ) const
+  {
+    const auto n = size();
+    for ( node_t i = 1u; i < n; ++i )
+    {
+      if ( _fanins[i << 1u] != input_marker )
+      {
+        f( i, _fanins[i << 1u], _fanins[( i << 1u ) + 1u] );
+      }
+    }
+  }
+
+  template<typename Fn>
+  void foreach_output( Fn&& f ) const
+  {
+    for ( auto i = 0u; i < _outputs.size(); ++i )
+    {
+      f( _outputs[i].first, i );
+    }
+  }
+
+public: /* properties */
+  inline void set_structural_hashing( bool enabled )   { _enable_strashing = enabled; }
+  inline bool has_structural_hashing() const           { return _enable_strashing; }
+
+  inline void set_local_optimization( bool enabled )   { _enable_local_optimization = enabled; }
+  inline bool has_local_optimization() const           { return _enable_local_optimization; }
+
+private:
+  struct strash_entry
+  {
+    literal_t left;
+    literal_t right;
+    node_t    node;  /* 0 marks an empty slot, since the constant is never an AND */
+  };
+
+  node_t strash_lookup( literal_t a, literal_t b ) const;
+  void strash_insert( literal_t a, literal_t b, node_t n );
+  void strash_grow();
+
+  inline std::size_t strash_slot( literal_t a, literal_t b ) const
+  {
+    const auto key = ( static_cast<std::uint64_t>( a ) << 32u ) | b;
+    return static_cast<std::size_t>( ( key * UINT64_C( 0x9e3779b97f4a7c15 ) ) >> ( 64u - _strash_log ) );
+  }
+
+  static constexpr literal_t input_marker = 0xffffffffu;
+
+private:
+  std::string               _model_name;
+
+  /* two literals per node; inputs store (input_marker, input index) */
+  std::vector<literal_t>    _fanins;
+  std::vector<node_t>       _inputs;
+  std::vector<std::string>  _input_names;
+  output_vec_t              _outputs;
+
+  unsigned                  _strash_log = 10u;
+  std::size_t               _strash_count = 0u;
+  std::vector<strash_entry> _strash;
+
+  bool                      _constant_used = false;
+  bool                      _enable_strashing = true;
+  bool                      _enable_local_optimization = true;
+};
+
+/******************************************************************************
+ * aig_graph compatible interface                                             *
+ ******************************************************************************/
+
+inline aig_function aig_flat_to_function( aig_flat::literal_t l ) { return { aig_flat::literal_node( l ), aig_flat::literal_complemented( l ) }; }
+inline aig_flat::literal_t aig_flat_to_literal( const aig_function& f ) { return aig_flat::make_literal( static_cast<aig_flat::node_t>( f.node ), f.complemented ); }
+
+void aig_initialize( aig_flat& aig, const std::string& model_name = std::string() );
+aig_function aig_get_constant( aig_flat& aig, bool value );
+aig_function aig_create_pi( aig_flat& aig, const std::string& name );
+void aig_create_po( aig_flat& aig, const aig_function& f, const std::string& name );
+aig_function aig_create_and( aig_flat& aig, const aig_function& left, const aig_function& right );
+aig_function aig_create_nand( aig_flat& aig, const aig_function& left, const aig_function& right );
+aig_function aig_create_or( aig_flat& aig, const aig_function& left, const aig_function& right );
+aig_function aig_create_nor( aig_flat& aig, const aig_function& left, const aig_function& right );
+aig_function aig_create_xor( aig_flat& aig, const aig_function& left, const aig_function& right );
+aig_function aig_create_ite( aig_flat& aig, const aig_function& cond, const aig_function& t, const aig_function& e );
+aig_function aig_create_maj( aig_flat& aig, const aig_function& a, const aig_function& b, const aig_function& c );
+
+void aig_print_stats( const aig_flat& aig, std::ostream& os = std::cout );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
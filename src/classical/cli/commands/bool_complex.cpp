@@ -492,7 +492,7 @@ void bool_complex_command::compute_maj( bool length, bool npn )
                 {
                   boost::dynamic_bitset<> phase;
                   std::vector<unsigned> perm;
-                  auto tt_npn = exact_npn_canonization( tt( 1u << numvars, f ), phase, perm );
+                  auto tt_npn = exact_npn_canonization_fast( tt( 1u << numvars, f ), phase, perm );
 
                   length_to_npn.back().insert( tt_npn.to_ulong() );
                 }
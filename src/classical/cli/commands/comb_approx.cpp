@@ -70,6 +70,7 @@ comb_approx_command::comb_approx_command( const environment::ptr& env )
     ( "mode,m",         value_with_default( &mode ),           "Approximation mode:\n0: round-down\n1: round-up\n2: round-closest\n3: co-factor 0\n4: co-factor 1\n5: copy" )
     ( "level,l",        value_with_default( &level ),          "Round or co-factor at level (round is inclusive)" )
     ( "maximum_method", value_with_default( &maximum_method ), "Maximum method:\n0: shift\n1: chi" )
+    ( "threads",        value_with_default( &threads ),        "Number of threads for BDD operations" )
     ( "print,p",                                               "Print implicants of both functions" )
     ( "truthtable,t",                                          "Print truth table of both functions" )
     ( "new,n",                                                 "Create new store element for result" )
@@ -101,7 +102,7 @@ bool comb_approx_command::execute()
   /* read from AIG or BDD */
   if ( is_set( "aig" ) )
   {
-    cirkit_bdd_simulator sim( aigs.current(), 24u );
+    cirkit_bdd_simulator sim( aigs.current(), 16u, false, threads );
     auto map = simulate_aig( aigs.current(), sim );
     manager = sim.mgr;
 
@@ -219,6 +220,12 @@ bool comb_approx_command::execute()
   std::cout << format( "[i] run-time (wc):   %.2f" ) % wc_statistics->get<double>( "runtime" ) << std::endl;
   std::cout << format( "[i] run-time (ac):   %.2f" ) % ac_statistics->get<double>( "runtime" ) << std::endl;
 
+  if ( is_verbose() )
+  {
+    std::cout << "[i] BDD manager statistics:" << std::endl;
+    manager->dump_stats( std::cout );
+  }
+
   return true;
 }
 
@@ -35,6 +35,7 @@
 #include <core/utils/program_options.hpp>
 #include <core/utils/range_utils.hpp>
 #include <classical/functions/cuts/paged.hpp>
+#include <classical/functions/cuts/priority.hpp>
 #include <classical/mig/mig_cuts_paged.hpp>
 #include <classical/functions/cuts/traits.hpp>
 #include <classical/utils/cut_enumeration.hpp>
@@ -54,6 +55,39 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+template<typename Ntk>
+void enumerate_priority_cuts( const Ntk& ntk, unsigned node_count, unsigned priority, bool verbose, bool print_depth, bool print_tt )
+{
+  auto settings = std::make_shared<properties>();
+  settings->set( "priority", priority );
+
+  priority_cuts<Ntk, 8u> cuts( ntk, node_count, settings );
+  std::cout << boost::format( "[i] found %d cuts in %.2f secs (%d KB)" ) % cuts.total_cut_count() % cuts.enumeration_time() % ( cuts.memory() >> 10u ) << std::endl;
+
+  if ( !verbose ) { return; }
+
+  for ( const auto& p : boost::make_iterator_range( vertices( ntk ) ) )
+  {
+    std::cout << boost::format( "[i] node %d has %d cuts" ) % p % cuts.count( p ) << std::endl;
+    for ( const auto& cut : cuts.cuts( p ) )
+    {
+      std::cout << "[i] - {" << any_join( cut, ", " ) << "}";
+
+      if ( print_depth )
+      {
+        std::cout << format( " (depth: %d)" ) % cut.depth();
+      }
+
+      if ( print_tt )
+      {
+        std::cout << " " << tt_to_hex( cut.simulate() );
+      }
+
+      std::cout << std::endl;
+    }
+  }
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -66,12 +100,19 @@ cuts_command::cuts_command( const environment::ptr& env ) : aig_mig_command( env
     ( "cone_count,c",                                    "Prints nodes in cut cone when verbose" )
     ( "depth,d",                                         "Prints depth of cut when verbose " )
     ( "parallel",                                        "Parallel cut enumeration for AIGs" )
+    ( "priority,p",   value( &priority ),                "Keep at most this many cuts per node (priority cuts with truth tables)" )
     ;
   be_verbose();
 }
 
 bool cuts_command::execute_aig()
 {
+  if ( is_set( "priority" ) )
+  {
+    enumerate_priority_cuts( aig(), node_count, priority, is_verbose(), is_set( "depth" ), is_set( "truthtable" ) );
+    return true;
+  }
+
   paged_aig_cuts cuts( aig(), node_count, is_set( "parallel" ) );
   std::cout << boost::format( "[i] found %d cuts in %.2f secs (%d KB)" ) % cuts.total_cut_count() % cuts.enumeration_time() % ( cuts.memory() >> 10u ) << std::endl;
 
@@ -104,6 +145,12 @@ bool cuts_command::execute_aig()
 
 bool cuts_command::execute_mig()
 {
+  if ( is_set( "priority" ) )
+  {
+    enumerate_priority_cuts( mig(), node_count, priority, is_verbose(), is_set( "depth" ), is_set( "truthtable" ) );
+    return true;
+  }
+
   mig_cuts_paged cuts( mig(), node_count );
   std::cout << boost::format( "[i] found %d cuts in %.2f secs (%d KB)" ) % cuts.total_cut_count() % cuts.enumeration_time() % ( cuts.memory() >> 10u ) << std::endl;
 
@@ -54,6 +54,7 @@ protected:
 
 private:
   unsigned node_count = 6u;
+  unsigned priority   = 8u;
 };
 
 }
@@ -26,6 +26,8 @@
 
 #include "migfh.hpp"
 
+#include <iostream>
+
 #include <boost/format.hpp>
 
 #include <core/utils/program_options.hpp>
@@ -60,6 +62,8 @@ migfh_command::migfh_command( const environment::ptr& env ) : mig_base_command(
     ( "allow_area_inc",                                          "allow area increase for candidates (only bottom-up)" )
     ( "allow_depth_inc",                                         "allow depth increase for candidates (only bottom-up)" )
     ( "sort_area_first", value_with_default( &sort_area_first ), "sort candidates by area, then depth (only bottom-up)" )
+    ( "threads,t",       value_with_default( &threads ),         "number of threads to analyze FFRs (only with --ffrs, 0: one per core)" )
+    ( "npn_cache",       value( &npn_cache ),                    "persistent NPN cache file (created if it does not exist, shared with npn --approach 4)" )
     ;
   be_verbose();
 }
@@ -76,7 +80,21 @@ bool migfh_command::execute()
   settings->set( "allow_area_inc",      is_set( "allow_area_inc" ) );
   settings->set( "allow_depth_inc",     is_set( "allow_depth_inc" ) );
   settings->set( "sort_area_first",     sort_area_first );
-  mig() = mig_functional_hashing( mig(), settings, statistics );
+  settings->set( "num_threads",         threads );
+  if ( is_set( "npn_cache" ) )
+  {
+    settings->set( "npn_cache",         npn_cache );
+  }
+
+  try
+  {
+    mig() = mig_functional_hashing( mig(), settings, statistics );
+  }
+  catch ( const char* e )
+  {
+    std::cerr << e << std::endl;
+    return true;
+  }
 
   auto cache_hit  = statistics->get<unsigned long>( "cache_hit" );
   auto cache_miss = statistics->get<unsigned long>( "cache_miss" );
@@ -91,6 +109,11 @@ bool migfh_command::execute()
             << boost::format( "[i] cache hit:       %u (%.2f %%)" ) % cache_hit % ( hit_rate * 100.0) << std::endl
             << boost::format( "[i] cache miss:      %u (%.2f %%)" ) % cache_miss % ( miss_rate * 100.0 ) << std::endl;
 
+  if ( is_set( "npn_cache" ) )
+  {
+    std::cout << boost::format( "[i] NPN cache hit:   %u" ) % statistics->get<unsigned long>( "persistent_cache_hit" ) << std::endl;
+  }
+
   return true;
 }
 
@@ -57,6 +57,8 @@ private:
   unsigned hash            = 1u << 13u;
   unsigned max_candidates  = 10u;
   bool     sort_area_first = true;
+  unsigned threads         = 1u;
+  std::string npn_cache;
 };
 
 }
@@ -39,6 +39,7 @@
 #include <core/utils/timer.hpp>
 #include <classical/cli/stores.hpp>
 #include <classical/functions/npn_canonization.hpp>
+#include <classical/utils/npn_cache.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 
 using namespace boost::program_options;
@@ -65,11 +66,12 @@ npn_command::npn_command( const environment::ptr& env )
   : cirkit_command( env, "NPN classification" )
 {
   opts.add_options()
-    ( "approach",     value( &approach ),   "0: Exact\n1: Heuristic (based on number of 1s)\n2: Heuristic (flip-swap)\n3: Heuristic (sifting)" )
+    ( "approach",     value( &approach ),   "0: Exact\n1: Heuristic (based on number of 1s)\n2: Heuristic (flip-swap)\n3: Heuristic (sifting)\n4: Exact (64-bit, at most 6 variables)" )
     ( "enumerate,m",  value( &enumerate ),  "Computes NPN classes for all functions with given number of variables" )
     ( "truthtable,t",                       "Computes NPN class for the current truth table in the store" )
     ( "logname,l",    value( &logname ),    "If enumerate is set, write all classes to this file" )
     ( "store,n",                            "Copy the result to the store (only for truth tables)" )
+    ( "cache,c",      value( &cache ),      "Persistent NPN cache file (created if it does not exist, one file per approach)" )
     ;
 }
 
@@ -80,15 +82,54 @@ command::rules_t npn_command::validity_rules() const
         "either truth table or enumeration can be performed" },
     {[&]() { return !is_set( "truthtable" ) || env->store<tt>().current_index() >= 0; },
         "no current truth table available" },
-    {[&]() { return approach <= 3u; },
-        "approach must be value from 0 to 3" }
+    {[&]() { return approach <= 4u; },
+        "approach must be value from 0 to 4" },
+    {[&]() { return approach != 4u || !is_set( "enumerate" ) || enumerate <= 6u; },
+        "approach 4 supports at most 6 variables" },
+    {[&]() { return approach != 4u || !is_set( "truthtable" ) || env->store<tt>().current_index() < 0 || tt_num_vars( env->store<tt>().current() ) <= 6u; },
+        "approach 4 supports at most 6 variables" }
   };
 }
 
 bool npn_command::execute()
 {
-  std::vector<npn_func_t> approaches{ &exact_npn_canonization, &npn_canonization, &npn_canonization_flip_swap, &npn_canonization_sifting };
-  const auto& func = approaches[approach];
+  std::vector<npn_func_t> approaches{ &exact_npn_canonization, &npn_canonization, &npn_canonization_flip_swap, &npn_canonization_sifting, &exact_npn_canonization_fast };
+  auto func = approaches[approach];
+
+  /* wrap the approach with the persistent cache */
+  npn_cache::ptr persistent_cache;
+  auto cache_hits = 0ul, cache_misses = 0ul;
+  if ( is_set( "cache" ) )
+  {
+    try
+    {
+      persistent_cache = std::make_shared<npn_cache>( cache, approach );
+    }
+    catch ( const char* e )
+    {
+      std::cerr << e << std::endl;
+      return true;
+    }
+
+    const auto uncached = func;
+    func = [&persistent_cache, &cache_hits, &cache_misses, uncached]( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm,
+                                                              const properties::ptr& settings, const properties::ptr& statistics ) {
+      tt npn;
+      {
+        properties_timer tim( statistics );
+        if ( persistent_cache->lookup( t, npn, phase, perm ) )
+        {
+          ++cache_hits;
+          return npn;
+        }
+      }
+
+      ++cache_misses;
+      npn = uncached( t, phase, perm, settings, statistics );
+      persistent_cache->insert( t, npn, phase, perm );
+      return npn;
+    };
+  }
 
   if ( is_set( "enumerate" ) )
   {
@@ -153,6 +194,11 @@ bool npn_command::execute()
     }
   }
 
+  if ( persistent_cache )
+  {
+    std::cout << format( "[i] NPN cache: %d hits, %d misses, %d/%d entries" ) % cache_hits % cache_misses % persistent_cache->size() % persistent_cache->capacity() << std::endl;
+  }
+
   return true;
 }
 
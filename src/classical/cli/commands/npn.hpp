@@ -63,6 +63,7 @@ private:
   unsigned                approach = 1u;
   unsigned                enumerate;
   std::string             logname;
+  std::string             cache;
 
   boost::dynamic_bitset<> phase;
   std::vector<unsigned>   perm;
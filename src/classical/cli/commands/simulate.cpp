@@ -38,6 +38,7 @@
 #include <core/utils/program_options.hpp>
 #include <classical/cli/stores.hpp>
 #include <classical/functions/simulate_aig.hpp>
+#include <classical/functions/simulate_aig_bitparallel.hpp>
 #include <classical/mig/mig_simulate.hpp>
 
 using namespace boost::program_options;
@@ -65,6 +66,9 @@ simulate_command::simulate_command( const environment::ptr& env )
     ( "assignment,s",    value( &assignment ), "Simulates an input assignment, e.g. \"x1=0 x2=1 x3=1 y=1010 z=01\"" )
     ( "tt,t",                                  "Simulates a truth table" )
     ( "bdd,b",                                 "Simulates a BDD" )
+    ( "random,r",        value( &random_patterns ), "Simulates the given number of random patterns bit-parallel (AIG only)" )
+    ( "seed",            value_with_default( &seed ), "Random seed for random simulation" )
+    ( "block_size",      value_with_default( &block_size ), "Number of 64-bit words per node in random simulation" )
     ( "little_endian,l",                       "Change bit endianness to little-endian in assignment method (default: big-endian)" )
     ( "quiet,q",                               "Don't print simulation results" )
     ;
@@ -84,7 +88,7 @@ command::rule_t simulate_command::one_simulation_method() const
   const auto assertion = [&]() {
     auto total = 0u;
 
-    for ( const auto& o : {"pattern","assignment","tt","bdd"} )
+    for ( const auto& o : {"pattern","assignment","tt","bdd","random"} )
     {
       if ( is_set( o ) ) { ++total; }
     }
@@ -233,6 +237,45 @@ bool simulate_command::execute_aig()
 
     store<bdd_function_t>( {mgr, bdds} );
   }
+  else if ( is_set( "random" ) )
+  {
+    properties_timer t( statistics );
+
+    bitparallel_aig_simulator sim( aig(), block_size );
+    sim.set_seed( seed );
+
+    std::vector<std::uint64_t> ones( sim.num_outputs(), 0u );
+    auto remaining = random_patterns;
+
+    while ( remaining > 0u )
+    {
+      if ( remaining < sim.num_patterns() )
+      {
+        sim.set_num_words( ( remaining + 63u ) >> 6u );
+      }
+
+      sim.randomize_inputs();
+      sim.simulate();
+
+      for ( auto i = 0u; i < sim.num_outputs(); ++i )
+      {
+        ones[i] += sim.output_ones( i );
+      }
+
+      remaining -= std::min( remaining, sim.num_patterns() );
+    }
+
+    const auto total = ( ( random_patterns + 63u ) >> 6u ) << 6u;
+    if ( !is_set( "quiet" ) )
+    {
+      for ( auto i = 0u; i < aig_info().outputs.size(); ++i )
+      {
+        std::cout << boost::format( "[i] %s : %d / %d" ) % aig_info().outputs[i].second % ones[i] % total << std::endl;
+      }
+    }
+
+    std::cout << boost::format( "[i] kernel: %s, simulated patterns: %d" ) % simd_level_name( sim.level() ) % total << std::endl;
+  }
 
   if ( statistics->has_key( "runtime" ) )
   {
@@ -246,6 +289,12 @@ bool simulate_command::execute_mig()
 {
   tts.clear();
 
+  if ( is_set( "random" ) )
+  {
+    std::cout << "[w] random simulation is only supported for AIGs" << std::endl;
+    return true;
+  }
+
   if ( is_set( "pattern" ) )
   {
     mig_simple_assignment_simulator::mig_name_value_map m;
@@ -78,6 +78,9 @@ public:
 private:
   std::string pattern;
   std::string assignment;
+  unsigned    random_patterns = 0u;
+  unsigned    seed = 0u;
+  unsigned    block_size = 16u;
 
   std::vector<std::string> tts;
 };
@@ -47,9 +47,11 @@ namespace cirkit
  * Public functions                                                           *
  ******************************************************************************/
 
-cirkit_bdd_simulator::cirkit_bdd_simulator( const aig_graph& aig, unsigned log_max_objs )
+cirkit_bdd_simulator::cirkit_bdd_simulator( const aig_graph& aig, unsigned log_max_objs, bool reorder, unsigned num_threads )
     : mgr( bdd_manager::create( aig_info( aig ).inputs.size(), log_max_objs ) )
 {
+  mgr->set_auto_reorder( reorder );
+  mgr->set_num_threads( num_threads );
 }
 
 cirkit_bdd_simulator::cirkit_bdd_simulator( const bdd_manager_ptr& mgr )
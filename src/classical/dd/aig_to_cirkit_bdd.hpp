@@ -47,7 +47,7 @@ namespace cirkit
 class cirkit_bdd_simulator : public aig_simulator<bdd>
 {
 public:
-  cirkit_bdd_simulator( const aig_graph& aig, unsigned log_max_objs = 20u );
+  cirkit_bdd_simulator( const aig_graph& aig, unsigned log_max_objs = 20u, bool reorder = false, unsigned num_threads = 1u );
   cirkit_bdd_simulator( const bdd_manager_ptr& mgr );
 
   bdd get_input( const aig_node& node, const std::string& name, unsigned pos, const aig_graph& aig ) const;
@@ -26,6 +26,7 @@
 
 #include "bdd.hpp"
 
+#include <algorithm>
 #include <vector>
 
 #include <boost/assign/std/vector.hpp>
@@ -35,6 +36,7 @@
 
 #include <core/utils/bitset_utils.hpp>
 #include <core/utils/range_utils.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <classical/dd/count_solutions.hpp>
 
 using namespace boost::assign;
@@ -55,12 +57,118 @@ enum class bdd_operation {
  * Private functions                                                          *
  ******************************************************************************/
 
+unsigned bdd_manager::apply_sequential( unsigned op, unsigned f, unsigned g )
+{
+  switch ( static_cast<bdd_operation>( op ) )
+  {
+  case bdd_operation::_and: return bdd_and( f, g );
+  case bdd_operation::_or:  return bdd_or( f, g );
+  case bdd_operation::_xor: return bdd_xor( f, g );
+  default: assert( false ); return 0u;
+  }
+}
+
+unsigned bdd_manager::apply_parallel( unsigned op, unsigned f, unsigned g, unsigned depth )
+{
+  if ( depth >= parallel_cutoff ) { return apply_sequential( op, f, g ); }
+
+  /* terminating cases, as in bdd_and, bdd_or, and bdd_xor */
+  switch ( static_cast<bdd_operation>( op ) )
+  {
+  case bdd_operation::_and:
+    if ( f == 0u || g == 0u ) { return 0u; }
+    if ( f == 1u )            { return g; }
+    if ( g == 1u || f == g )  { return f; }
+    break;
+  case bdd_operation::_or:
+    if ( f == 1u || g == 1u ) { return 1u; }
+    if ( f == 0u )            { return g; }
+    if ( g == 0u || f == g )  { return f; }
+    break;
+  case bdd_operation::_xor:
+    if ( f == 0u ) { return g; }
+    if ( g == 0u ) { return f; }
+    if ( f == g )  { return 0u; }
+    break;
+  default:
+    assert( false );
+  }
+
+  /* commutativity */
+  if ( f > g ) { std::swap( f, g ); }
+
+  const auto r = cache.lookup( f, g, op );
+  if ( r >= 0 ) { return r; }
+
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
+  const auto level1 = var_to_level( node1.var );
+  const auto level2 = var_to_level( node2.var );
+
+  const auto f0 = level1 <= level2 ? node1.low  : f;
+  const auto f1 = level1 <= level2 ? node1.high : f;
+  const auto g0 = level2 <= level1 ? node2.low  : g;
+  const auto g1 = level2 <= level1 ? node2.high : g;
+
+  unsigned rlow, rhigh;
+  task_group group;
+  pool->submit( group, [&]() { rlow = apply_parallel( op, f0, g0, depth + 1u ); } );
+  rhigh = apply_parallel( op, f1, g1, depth + 1u );
+  pool->wait( group );
+
+  auto idx = unique_create( top_var( node1.var, node2.var ), rhigh, rlow );
+  return cache.insert( f, g, op, idx );
+}
+
+unsigned bdd_manager::exists_parallel( unsigned f, unsigned g, unsigned depth )
+{
+  if ( depth >= parallel_cutoff ) { return bdd_exists( f, g ); }
+
+  /* terminating cases */
+  if ( g == 1u || f <= 1u ) { return f; }
+
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
+
+  if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
+  {
+    return exists_parallel( f, node2.high, depth );
+  }
+
+  const auto r = cache.lookup( f, g, (unsigned)bdd_operation::exists );
+  if ( r >= 0 ) { return r; }
+
+  const auto g1 = node1.var == node2.var ? node2.high : g;
+
+  unsigned rlow, rhigh;
+  task_group group;
+  pool->submit( group, [&]() { rlow = exists_parallel( node1.low, g1, depth + 1u ); } );
+  rhigh = exists_parallel( node1.high, g1, depth + 1u );
+  pool->wait( group );
+
+  unsigned idx;
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
+  {
+    idx = unique_create( node1.var, rhigh, rlow );
+  }
+  else
+  {
+    idx = apply_parallel( (unsigned)bdd_operation::_or, rlow, rhigh, depth + 1u );
+  }
+
+  return cache.insert( f, g, (unsigned)bdd_operation::exists, idx );
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
 
 bdd_manager::bdd_manager( unsigned nvars, unsigned log_max_objs, bool verbose )
-  : dd_manager( nvars, log_max_objs, verbose ) {}
+  : dd_manager( nvars, log_max_objs, verbose )
+{
+  cache.set_operation_names( {"AND", "OR", "XOR", "NOT", "COF0", "COF1", "EXISTS",
+                              "CONSTRAIN", "RESTRICT", "ROUND_DOWN", "ROUND_UP", "ROUND"} );
+}
 
 bdd_manager::~bdd_manager() {}
 
@@ -79,15 +187,15 @@ unsigned bdd_manager::bdd_and( unsigned f, unsigned g )
   const auto r = cache.lookup( f, g, (unsigned)bdd_operation::_and );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
   unsigned rlow, rhigh;
-  if ( node1.var < node2.var )
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
   {
     rlow = bdd_and( node1.low, g );
     rhigh = bdd_and( node1.high, g );
   }
-  else if ( node1.var > node2.var )
+  else if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     rlow = bdd_and( f, node2.low );
     rhigh = bdd_and( f, node2.high );
@@ -98,7 +206,7 @@ unsigned bdd_manager::bdd_and( unsigned f, unsigned g )
     rhigh = bdd_and( node1.high, node2.high );
   }
 
-  auto idx = unique_create( std::min( node1.var, node2.var ), rhigh, rlow );
+  auto idx = unique_create( top_var( node1.var, node2.var ), rhigh, rlow );
   return cache.insert( f, g, (unsigned)bdd_operation::_and, idx );
 }
 
@@ -117,15 +225,15 @@ unsigned bdd_manager::bdd_or( unsigned f, unsigned g )
   const auto r = cache.lookup( f, g, (unsigned)bdd_operation::_or );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
   unsigned rlow, rhigh;
-  if ( node1.var < node2.var )
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
   {
     rlow = bdd_or( node1.low, g );
     rhigh = bdd_or( node1.high, g );
   }
-  else if ( node1.var > node2.var )
+  else if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     rlow = bdd_or( f, node2.low );
     rhigh = bdd_or( f, node2.high );
@@ -136,7 +244,7 @@ unsigned bdd_manager::bdd_or( unsigned f, unsigned g )
     rhigh = bdd_or( node1.high, node2.high );
   }
 
-  auto idx = unique_create( std::min( node1.var, node2.var ), rhigh, rlow );
+  auto idx = unique_create( top_var( node1.var, node2.var ), rhigh, rlow );
   return cache.insert( f, g, (unsigned)bdd_operation::_or, idx );
 }
 
@@ -153,15 +261,15 @@ unsigned bdd_manager::bdd_xor( unsigned f, unsigned g )
   const auto r = cache.lookup( f, g, (unsigned)bdd_operation::_xor );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
   unsigned rlow, rhigh;
-  if ( node1.var < node2.var )
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
   {
     rlow = bdd_xor( node1.low, g );
     rhigh = bdd_xor( node1.high, g );
   }
-  else if ( node1.var > node2.var )
+  else if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     rlow = bdd_xor( f, node2.low );
     rhigh = bdd_xor( f, node2.high );
@@ -172,7 +280,7 @@ unsigned bdd_manager::bdd_xor( unsigned f, unsigned g )
     rhigh = bdd_xor( node1.high, node2.high );
   }
 
-  auto idx = unique_create( std::min( node1.var, node2.var ), rhigh, rlow );
+  auto idx = unique_create( top_var( node1.var, node2.var ), rhigh, rlow );
   return cache.insert( f, g, (unsigned)bdd_operation::_xor, idx );
 }
 
@@ -185,7 +293,7 @@ unsigned bdd_manager::bdd_not( unsigned f )
   const auto r = cache.lookup( f, f, (unsigned)bdd_operation::_not );
   if ( r >= 0 ) { return r; }
 
-  const auto& node = nodes.at( f );
+  const auto node = nodes.at( f );
 
   auto rlow = bdd_not( node.low );
   auto rhigh = bdd_not( node.high );
@@ -199,14 +307,14 @@ unsigned bdd_manager::bdd_cof0( unsigned f, unsigned v )
   /* terminating cases */
   if ( f <= 1u ) { return f; }
 
-  const auto& node = nodes.at( f );
-  if ( node.var > v ) { return f; }
+  const auto node = nodes.at( f );
+  if ( var_to_level( node.var ) > var_to_level( v ) ) { return f; }
 
   const auto r = cache.lookup( f, v, (unsigned)bdd_operation::cof0 );
   if ( r >= 0 ) { return r; }
 
   unsigned idx;
-  if ( node.var < v )
+  if ( var_to_level( node.var ) < var_to_level( v ) )
   {
     const auto rlow  = bdd_cof0( node.low, v );
     const auto rhigh = bdd_cof0( node.high, v );
@@ -224,14 +332,14 @@ unsigned bdd_manager::bdd_cof1( unsigned f, unsigned v )
   /* terminating cases */
   if ( f <= 1u ) { return f; }
 
-  const auto& node = nodes.at( f );
-  if ( node.var > v ) { return f; }
+  const auto node = nodes.at( f );
+  if ( var_to_level( node.var ) > var_to_level( v ) ) { return f; }
 
   const auto r = cache.lookup( f, v, (unsigned)bdd_operation::cof1 );
   if ( r >= 0 ) { return r; }
 
   unsigned idx;
-  if ( node.var < v )
+  if ( var_to_level( node.var ) < var_to_level( v ) )
   {
     const auto rlow  = bdd_cof1( node.low, v );
     const auto rhigh = bdd_cof1( node.high, v );
@@ -249,10 +357,10 @@ unsigned bdd_manager::bdd_exists( unsigned f, unsigned g )
   /* terminating cases */
   if ( g == 1u || f <= 1u ) { return f; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
 
-  if ( node1.var > node2.var )
+  if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     return bdd_exists( f, node2.high );
   }
@@ -271,7 +379,7 @@ unsigned bdd_manager::bdd_exists( unsigned f, unsigned g )
   {
     auto rhigh = bdd_exists( node1.high, node1.var == node2.var ? node2.high : g );
 
-    if ( node1.var < node2.var )
+    if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
     {
       idx = unique_create( node1.var, rhigh, rlow );
     }
@@ -294,15 +402,15 @@ unsigned bdd_manager::bdd_constrain( unsigned f, unsigned g )
   const auto r = cache.lookup( f, g, (unsigned)bdd_operation::constrain );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
 
   unsigned idx;
 
   do {
     unsigned v;
 
-    if ( node1.var < node2.var )
+    if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
     {
       v = node1.var;
     }
@@ -339,15 +447,15 @@ unsigned bdd_manager::bdd_restrict( unsigned f, unsigned g )
   const auto r = cache.lookup( f, g, (unsigned)bdd_operation::restrict );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( f );
-  const auto& node2 = nodes.at( g );
+  const auto node1 = nodes.at( f );
+  const auto node2 = nodes.at( g );
 
   unsigned idx;
 
   do {
     unsigned v;
 
-    if ( node1.var < node2.var )
+    if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
     {
       v = node1.var;
     }
@@ -399,10 +507,10 @@ unsigned bdd_manager::bdd_round_to( unsigned f, unsigned level, unsigned cop, un
   const auto r = cache.lookup( f, level, cop );
   if ( r >= 0 ) { return r; }
 
-  const auto& node = nodes.at( f );
+  const auto node = nodes.at( f );
 
   auto idx = 0u;
-  if ( node.var < level )
+  if ( var_to_level( node.var ) < level )
   {
     auto rlow = bdd_round_to( node.low, level, cop, to, count_map );
     auto rhigh = bdd_round_to( node.high, level, cop, to, count_map );
@@ -446,10 +554,10 @@ unsigned bdd_manager::bdd_round( unsigned f, unsigned level )
   const auto r = cache.lookup( f, level, (unsigned)bdd_operation::round );
   if ( r >= 0 ) { return r; }
 
-  const auto& node = nodes.at( f );
+  const auto node = nodes.at( f );
 
   auto idx = 0u;
-  if ( node.var < level )
+  if ( var_to_level( node.var ) < level )
   {
     auto rlow = bdd_round( node.low, level );
     auto rhigh = bdd_round( node.high, level );
@@ -458,8 +566,8 @@ unsigned bdd_manager::bdd_round( unsigned f, unsigned level )
   }
   else
   {
-    auto onset = count_solutions( bdd( this, f ) ) / ( 1ull << node.var );
-    auto all   = 1ull << ( nvars - node.var );
+    auto onset = count_solutions( bdd( this, f ) ) / ( 1ull << var_to_level( node.var ) );
+    auto all   = 1ull << ( nvars - var_to_level( node.var ) );
 
     if ( ( onset << 1u ) > all ) /* if onset / all > .5 */
     {
@@ -474,6 +582,54 @@ bdd_manager_ptr bdd_manager::create( unsigned nvars, unsigned log_max_objs, bool
   return std::make_shared<bdd_manager>( nvars, log_max_objs, verbose );
 }
 
+unsigned bdd_manager::bdd_and_parallel( unsigned f, unsigned g )
+{
+  if ( !pool ) { return bdd_and( f, g ); }
+
+  begin_concurrent();
+  const auto r = apply_parallel( (unsigned)bdd_operation::_and, f, g, 0u );
+  end_concurrent();
+  return r;
+}
+
+unsigned bdd_manager::bdd_or_parallel( unsigned f, unsigned g )
+{
+  if ( !pool ) { return bdd_or( f, g ); }
+
+  begin_concurrent();
+  const auto r = apply_parallel( (unsigned)bdd_operation::_or, f, g, 0u );
+  end_concurrent();
+  return r;
+}
+
+unsigned bdd_manager::bdd_xor_parallel( unsigned f, unsigned g )
+{
+  if ( !pool ) { return bdd_xor( f, g ); }
+
+  begin_concurrent();
+  const auto r = apply_parallel( (unsigned)bdd_operation::_xor, f, g, 0u );
+  end_concurrent();
+  return r;
+}
+
+unsigned bdd_manager::bdd_exists_parallel( unsigned f, unsigned g )
+{
+  if ( !pool ) { return bdd_exists( f, g ); }
+
+  begin_concurrent();
+  const auto r = exists_parallel( f, g, 0u );
+  end_concurrent();
+  return r;
+}
+
+void bdd_manager::set_num_threads( unsigned num_threads )
+{
+  this->num_threads = std::max( 1u, num_threads );
+
+  /* the calling thread works as well while waiting for tasks */
+  pool.reset( num_threads > 1u ? new thread_pool( num_threads - 1u ) : nullptr );
+}
+
 unsigned bdd_manager::unique_create( unsigned var, unsigned high, unsigned low )
 {
   if ( verbose )
@@ -481,8 +637,8 @@ unsigned bdd_manager::unique_create( unsigned var, unsigned high, unsigned low )
     //std::cout << boost::format( "[i] attempt to create (%d, %d, %d)" ) % var % high % low << std::endl;
   }
   assert( var < nvars );
-  assert( var < nodes[high].var );
-  assert( var < nodes[low].var );
+  assert( var_to_level( var ) < var_to_level( nodes[high].var ) );
+  assert( var_to_level( var ) < var_to_level( nodes[low].var ) );
 
   if ( high == low ) { return high; }
 
@@ -491,37 +647,25 @@ unsigned bdd_manager::unique_create( unsigned var, unsigned high, unsigned low )
 
 std::ostream& operator<<( std::ostream& os, const bdd_manager& mgr )
 {
-  for ( auto i : boost::counting_range( 0u, mgr.nvars + 2u ) )
-  {
-    os << i << ": " << mgr.nodes[i] << std::endl;
-  }
-
-  auto * q = mgr.unique;
-
-  while ( q != mgr.unique + mgr.nodes.size() )
+  for ( auto z : boost::counting_range( 0u, mgr.nnodes ) )
   {
-    if ( *q )
+    if ( mgr.nodes[z].var != -1u ) /* skip free nodes */
     {
-      os << *q << ": " << mgr.nodes[*q] << std::endl;
+      os << z << ": " << mgr.nodes[z] << std::endl;
     }
-    ++q;
   }
 
   return os;
 }
 
-bdd& bdd::operator=( const bdd& other )
+unsigned bdd::var() const
 {
-  if ( this == &other ) { return *this; }
-  assert( !manager || manager == other.manager );
-  manager = other.manager;
-  index   = other.index;
-  return *this;
+  return manager->get_var( index );
 }
 
-unsigned bdd::var() const
+unsigned bdd::level() const
 {
-  return manager->get_var( index );
+  return manager->var_to_level( manager->get_var( index ) );
 }
 
 bdd bdd::high() const
@@ -537,66 +681,78 @@ bdd bdd::low() const
 bdd bdd::operator&&( const bdd& other ) const
 {
   assert( manager == other.manager );
-  return bdd( manager, manager->bdd_and( index, other.index ) );
+  manager->gc_point();
+  return bdd( manager, manager->bdd_and_parallel( index, other.index ) );
 }
 
 bdd bdd::operator||( const bdd& other ) const
 {
   assert( manager == other.manager );
-  return bdd( manager, manager->bdd_or( index, other.index ) );
+  manager->gc_point();
+  return bdd( manager, manager->bdd_or_parallel( index, other.index ) );
 }
 
 bdd bdd::operator^( const bdd& other ) const
 {
   assert( manager == other.manager );
-  return bdd( manager, manager->bdd_xor( index, other.index ) );
+  manager->gc_point();
+  return bdd( manager, manager->bdd_xor_parallel( index, other.index ) );
 }
 
 bdd bdd::operator!() const
 {
+  manager->gc_point();
   return bdd( manager, manager->bdd_not( index ) );
 }
 
 bdd bdd::cof0( unsigned v ) const
 {
+  manager->gc_point();
   return bdd( manager, manager->bdd_cof0( index, v ) );
 }
 
 bdd bdd::cof1( unsigned v ) const
 {
+  manager->gc_point();
   return bdd( manager, manager->bdd_cof1( index, v ) );
 }
 
 bdd bdd::exists( const bdd& other ) const
 {
   assert( manager == other.manager );
-  return bdd( manager, manager->bdd_exists( index, other.index ) );
+  manager->gc_point();
+  return bdd( manager, manager->bdd_exists_parallel( index, other.index ) );
 }
 
 bdd bdd::constrain( const bdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return bdd( manager, manager->bdd_constrain( index, other.index ) );
 }
 
 bdd bdd::restrict( const bdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return bdd( manager, manager->bdd_restrict( index, other.index ) );
 }
 
 bdd bdd::round_down( unsigned level ) const
 {
+  manager->gc_point();
   return bdd( manager, manager->bdd_round_down( index, level ) );
 }
 
 bdd bdd::round_up( unsigned level ) const
 {
+  manager->gc_point();
   return bdd( manager, manager->bdd_round_up( index, level ) );
 }
 
 bdd bdd::round( unsigned level ) const
 {
+  manager->gc_point();
   return bdd( manager, manager->bdd_round( index, level ) );
 }
 
@@ -50,20 +50,23 @@ namespace cirkit
 {
 
 class bdd_manager;
+class thread_pool;
 
 struct bdd
 {
   using const_param_ref = boost::call_traits < bdd >::const_reference;
 
   bdd() : manager( nullptr ), index( 0u ) {}
-  bdd( bdd_manager* manager, unsigned index )
-    : manager( manager ),
-      index( index ) {}
-  bdd( const bdd& other ) : manager( other.manager ), index( other.index ) {}
+  bdd( bdd_manager* manager, unsigned index );
+  bdd( const bdd& other );
+  bdd( bdd&& other ) : manager( other.manager ), index( other.index ) { other.manager = nullptr; }
+  ~bdd();
 
   bdd& operator=( const bdd& other );
+  bdd& operator=( bdd&& other );
 
   unsigned var() const;
+  unsigned level() const; /* position of var() in the current order */
   bdd high() const;
   bdd low() const;
 
@@ -118,6 +121,26 @@ public:
   unsigned bdd_round_up( unsigned f, unsigned level );
   unsigned bdd_round( unsigned f, unsigned level );
 
+  /**
+   * Parallel variants of bdd_and, bdd_or, bdd_xor, and bdd_exists
+   *
+   * Up to the parallel cutoff depth, the two cofactor subproblems are solved
+   * as tasks in a thread pool, deeper subproblems are solved by the
+   * sequential operations.  All threads share the unique table and the
+   * computed table (see dd_manager::begin_concurrent).  These operations are
+   * used by the DD handles and fall back to the sequential ones if only one
+   * thread is used.
+   */
+  unsigned bdd_and_parallel( unsigned f, unsigned g );
+  unsigned bdd_or_parallel( unsigned f, unsigned g );
+  unsigned bdd_xor_parallel( unsigned f, unsigned g );
+  unsigned bdd_exists_parallel( unsigned f, unsigned g );
+
+  /* number of threads including the calling one, 1 disables parallel operations */
+  void set_num_threads( unsigned num_threads );
+  inline unsigned get_num_threads() const { return num_threads; }
+  inline void set_parallel_cutoff( unsigned depth ) { parallel_cutoff = depth; }
+
   unsigned unique_create( unsigned var, unsigned high, unsigned low );
 
   static bdd_manager_ptr create( unsigned nvars, unsigned log_max_objs, bool verbose = false );
@@ -126,10 +149,60 @@ private:
   unsigned bdd_round_to( unsigned f, unsigned level, unsigned cop, unsigned to );
   unsigned bdd_round_to( unsigned f, unsigned level, unsigned cop, unsigned to, const std::map<unsigned, boost::multiprecision::uint256_t>& count_map );
 
+  unsigned apply_sequential( unsigned op, unsigned f, unsigned g );
+  unsigned apply_parallel( unsigned op, unsigned f, unsigned g, unsigned depth );
+  unsigned exists_parallel( unsigned f, unsigned g, unsigned depth );
+
+  std::unique_ptr<thread_pool> pool;
+  unsigned                     num_threads = 1u;
+  unsigned                     parallel_cutoff = 8u;
+
 public:
   friend std::ostream& operator<<( std::ostream& os, const bdd_manager& mgr );
 };
 
+/* handles keep an external reference to their node, see dd_manager */
+inline bdd::bdd( bdd_manager* manager, unsigned index )
+  : manager( manager ),
+    index( index )
+{
+  if ( manager ) { manager->ref( index ); }
+}
+
+inline bdd::bdd( const bdd& other )
+  : manager( other.manager ),
+    index( other.index )
+{
+  if ( manager ) { manager->ref( index ); }
+}
+
+inline bdd::~bdd()
+{
+  if ( manager ) { manager->deref( index ); }
+}
+
+inline bdd& bdd::operator=( const bdd& other )
+{
+  if ( this == &other ) { return *this; }
+  assert( !manager || !other.manager || manager == other.manager );
+  if ( other.manager ) { other.manager->ref( other.index ); }
+  if ( manager ) { manager->deref( index ); }
+  manager = other.manager;
+  index   = other.index;
+  return *this;
+}
+
+inline bdd& bdd::operator=( bdd&& other )
+{
+  if ( this == &other ) { return *this; }
+  assert( !manager || !other.manager || manager == other.manager );
+  if ( manager ) { manager->deref( index ); }
+  manager = other.manager;
+  index   = other.index;
+  other.manager = nullptr;
+  return *this;
+}
+
 }
 
 #endif
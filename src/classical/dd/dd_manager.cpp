@@ -26,12 +26,15 @@
 
 #include "dd_manager.hpp"
 
-#include <cstring>
+#include <algorithm>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 
 #include <boost/format.hpp>
 
+#include <core/utils/timer.hpp>
+
 namespace cirkit
 {
 
@@ -39,49 +42,113 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
-hash_cache::hash_cache( size_type log_size )
-  : data( 1 << log_size ),
-    mask( ( 1 << log_size ) - 1u )
-  , nhit( 0u )
-  , nmiss( 0 ) {}
+constexpr unsigned hash_cache::invalid_op;
+constexpr unsigned hash_cache::max_ops;
+constexpr unsigned hash_cache::num_locks;
+
+hash_cache::hash_cache( size_type log_size, unsigned associativity )
+  : associativity( associativity ),
+    locks( new std::atomic<bool>[num_locks]() ),
+    stats( max_ops )
+{
+  assert( associativity == 1u || associativity == 2u || associativity == 4u );
+  allocate( log_size );
+}
+
+void hash_cache::allocate( size_type log_size )
+{
+  num_entries = std::max( size_type( 1u ) << log_size, size_type( associativity ) );
+
+  /* over-allocate by one cache line to align the data */
+  const auto per_line = 64u / sizeof( entry );
+  storage.assign( num_entries + per_line, entry{0u, 0u, invalid_op, 0u} );
+  const auto addr = reinterpret_cast<std::uintptr_t>( storage.data() );
+  data = storage.data() + ( ( 64u - addr % 64u ) % 64u ) / sizeof( entry );
+
+  set_mask = num_entries / associativity - 1u;
+}
 
-int hash_cache::lookup( unsigned arg0, unsigned arg1, unsigned arg2 )
+void hash_cache::resize( size_type log_size )
 {
-  auto& ent = entry( arg0, arg1, arg2 );
-  bool hit = std::get<0>( ent ) == arg0 && std::get<1>( ent ) == arg1 && std::get<2>( ent ) == arg2;
+  assert( !concurrent );
+
+  container_type old( data, data + num_entries );
+  allocate( log_size );
 
-  if ( hit ) {
-    ++nhit;
-  } else {
-    ++nmiss;
+  for ( const auto& ent : old )
+  {
+    if ( ent.op != invalid_op )
+    {
+      auto* set = find_set( ent.arg0, ent.arg1, ent.op );
+      for ( auto i = associativity - 1u; i > 0u; --i ) { set[i] = set[i - 1u]; }
+      set[0] = ent;
+    }
   }
+}
 
-  return hit ? std::get<3>( ent ) : -1;
+void hash_cache::set_associativity( unsigned value )
+{
+  assert( value == 1u || value == 2u || value == 4u );
+  associativity = value;
+  allocate( log_size() );
 }
 
-int hash_cache::insert( unsigned arg0, unsigned arg1, unsigned arg2, int res )
+void hash_cache::clear()
 {
-  auto& ent = entry( arg0, arg1, arg2 );
-  std::get<0>( ent ) = arg0;
-  std::get<1>( ent ) = arg1;
-  std::get<2>( ent ) = arg2;
-  std::get<3>( ent ) = res;
-  return res;
+  std::fill( data, data + num_entries, entry{0u, 0u, invalid_op, 0u} );
+}
+
+void hash_cache::set_operation_names( const std::vector<std::string>& names )
+{
+  assert( names.size() <= max_ops );
+  this->names = names;
 }
 
 std::size_t hash_cache::cache_size() const
 {
-  return data.size();
+  return num_entries;
+}
+
+std::size_t hash_cache::log_size() const
+{
+  std::size_t l = 0u;
+  while ( ( 1ul << l ) < num_entries ) { ++l; }
+  return l;
 }
 
 std::size_t hash_cache::hit() const
 {
-  return nhit;
+  std::size_t n = 0u;
+  for ( const auto& s : stats ) { n += s.hits; }
+  return n;
 }
 
 std::size_t hash_cache::miss() const
 {
-  return nmiss;
+  std::size_t n = 0u;
+  for ( const auto& s : stats ) { n += s.misses; }
+  return n;
+}
+
+std::size_t hash_cache::evictions() const
+{
+  std::size_t n = 0u;
+  for ( const auto& s : stats ) { n += s.evictions; }
+  return n;
+}
+
+void hash_cache::print_statistics( std::ostream& os ) const
+{
+  os << boost::format( "-- %-12s %12s %12s %12s %8s\n" ) % "Operation" % "Hits" % "Misses" % "Evictions" % "Hit-rate";
+  for ( auto op = 0u; op < max_ops; ++op )
+  {
+    const auto& s = stats[op];
+    if ( s.hits + s.misses + s.evictions == 0ul ) { continue; }
+
+    const auto name = op < names.size() ? names[op] : std::to_string( op );
+    const auto rate = s.hits + s.misses == 0ul ? 0.0 : ( 100.0 * s.hits ) / ( s.hits + s.misses );
+    os << boost::format( "-- %-12s %12d %12d %12d %7.2f%%\n" ) % name % s.hits % s.misses % s.evictions % rate;
+  }
 }
 
 std::ostream& operator<<( std::ostream& os, const dd_node& z )
@@ -93,6 +160,250 @@ std::ostream& operator<<( std::ostream& os, const dd_node& z )
  * Private functions                                                          *
  ******************************************************************************/
 
+unsigned dd_manager::allocate_node()
+{
+  std::unique_lock<std::mutex> lock( alloc_mutex, std::defer_lock );
+  if ( concurrent ) { lock.lock(); }
+
+  if ( free_list )
+  {
+    const auto z = free_list;
+    free_list = nexts[z];
+    --nfree;
+    return z;
+  }
+
+  if ( nnodes == nodes.size() )
+  {
+    grow_nodes();
+  }
+
+  ++nnodes;
+  peak_nodes = std::max( peak_nodes, size() );
+  return nnodes - 1u;
+}
+
+void dd_manager::free_node( unsigned z )
+{
+  nodes[z] = {-1u, -1u, -1u};
+  nexts[z] = free_list;
+  free_list = z;
+  ++nfree;
+}
+
+void dd_manager::grow_nodes()
+{
+  const auto _nobjs = nodes.size() << 1u;
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] dd: grow node table to %d nodes" ) % _nobjs << std::endl;
+  }
+
+  nodes.resize( _nobjs, {-1u, -1u, -1u} );
+  refs.resize( _nobjs, 0u );
+  nexts.resize( _nobjs, 0u );
+  if ( !iref.empty() )
+  {
+    iref.resize( _nobjs, 0u );
+  }
+  ++num_node_resizes;
+
+  /* keep computed table as large as the node table */
+  if ( !concurrent )
+  {
+    adjust_cache_size();
+  }
+}
+
+void dd_manager::adjust_cache_size()
+{
+  auto log_size = 0u;
+  while ( ( 1ul << log_size ) < nodes.size() ) { ++log_size; }
+  if ( log_size > cache.log_size() )
+  {
+    cache.resize( log_size );
+  }
+}
+
+void dd_manager::subtable_insert( unsigned z )
+{
+  auto& table = unique[nodes[z].var];
+  if ( table.count >= table.buckets.size() )
+  {
+    subtable_resize( table, table.buckets.size() << 1u );
+  }
+
+  auto& bucket = table.buckets[unique_hash( nodes[z].high, nodes[z].low ) & table.mask];
+  nexts[z] = bucket;
+  bucket = z;
+  ++table.count;
+}
+
+void dd_manager::subtable_remove( unsigned z )
+{
+  auto& table = unique[nodes[z].var];
+  auto* q = &table.buckets[unique_hash( nodes[z].high, nodes[z].low ) & table.mask];
+  while ( *q != z )
+  {
+    assert( *q );
+    q = &nexts[*q];
+  }
+  *q = nexts[z];
+  --table.count;
+}
+
+void dd_manager::subtable_resize( subtable& table, unsigned num_buckets )
+{
+  std::vector<unsigned> zs;
+  zs.reserve( table.count );
+  for ( auto bucket : table.buckets )
+  {
+    for ( auto z = bucket; z; z = nexts[z] )
+    {
+      zs.push_back( z );
+    }
+  }
+
+  table.buckets.assign( num_buckets, 0u );
+  table.mask = num_buckets - 1u;
+
+  for ( auto z : zs )
+  {
+    auto& bucket = table.buckets[unique_hash( nodes[z].high, nodes[z].low ) & table.mask];
+    nexts[z] = bucket;
+    bucket = z;
+  }
+}
+
+void dd_manager::gc_and_adjust_threshold()
+{
+  const auto live = nnodes - nfree;
+  garbage_collect();
+
+  /* if less than half of the nodes could be freed, collect less often */
+  if ( ( nnodes - nfree ) << 1u > live )
+  {
+    gc_threshold <<= 1u;
+  }
+}
+
+/* During reordering, iref[z] counts the references to z from parents and
+ * handles.  Nodes are freed as soon as their count drops to 0, such that
+ * size() reflects the size of the current order after every swap. */
+void dd_manager::begin_reorder()
+{
+  garbage_collect();
+
+  iref.assign( nodes.size(), 0u );
+  for ( auto z = nvars + 2u; z < nnodes; ++z )
+  {
+    const auto& n = nodes[z];
+    if ( n.var == -1u ) { continue; } /* free */
+
+    iref[z] += refs[z];
+    ++iref[n.high];
+    ++iref[n.low];
+  }
+}
+
+void dd_manager::end_reorder()
+{
+  std::vector<unsigned>().swap( iref );
+
+  /* node indexes are stable, but freed nodes may be reused */
+  cache.clear();
+}
+
+/* returns a node for (var, high, low) and increments its reference counter */
+unsigned dd_manager::reorder_node( unsigned var, unsigned high, unsigned low )
+{
+  unsigned z;
+
+  if ( zero_suppressed ? high == 0u : high == low )
+  {
+    z = low;
+  }
+  else if ( high == 1u && low == 0u )
+  {
+    z = var + 2u;
+  }
+  else
+  {
+    const auto& table = unique[var];
+    for ( z = table.buckets[unique_hash( high, low ) & table.mask]; z; z = nexts[z] )
+    {
+      if ( nodes[z].high == high && nodes[z].low == low ) { break; }
+    }
+
+    if ( !z )
+    {
+      z = allocate_node();
+      nodes[z] = {var, high, low};
+      subtable_insert( z );
+      ++iref[high];
+      ++iref[low];
+    }
+  }
+
+  ++iref[z];
+  return z;
+}
+
+void dd_manager::reorder_deref( unsigned z )
+{
+  /* terminals and variable nodes are never freed */
+  if ( z < nvars + 2u ) { return; }
+
+  assert( iref[z] > 0u );
+  if ( --iref[z] == 0u )
+  {
+    const auto n = nodes[z];
+    subtable_remove( z );
+    free_node( z );
+    reorder_deref( n.high );
+    reorder_deref( n.low );
+  }
+}
+
+void dd_manager::sift_variable( unsigned var )
+{
+  auto best_size = size();
+  auto best_level = var2level[var];
+
+  const auto move = [&]( bool down ) {
+    while ( down ? var2level[var] + 1u < nvars : var2level[var] > 0u )
+    {
+      swap_levels( down ? var2level[var] : var2level[var] - 1u );
+
+      const auto s = size();
+      if ( s < best_size )
+      {
+        best_size = s;
+        best_level = var2level[var];
+      }
+      else if ( 5u * s > 6u * best_size ) /* stop if size grows by more than 20% */
+      {
+        break;
+      }
+    }
+  };
+
+  /* move to the closer end first */
+  const auto down_first = ( var2level[var] << 1u ) >= nvars;
+  move( down_first );
+  move( !down_first );
+
+  while ( var2level[var] < best_level ) { swap_levels( var2level[var] ); }
+  while ( var2level[var] > best_level ) { swap_levels( var2level[var] - 1u ); }
+}
+
+void dd_manager::reorder_and_adjust_threshold()
+{
+  sift();
+  reorder_threshold = std::max( reorder_threshold, size() << 1u );
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -102,14 +413,37 @@ dd_manager::dd_manager( unsigned nvars, unsigned log_max_objs, bool verbose )
 {
   assert( log_max_objs > 0u );
 
-  const auto _nobjs = 1 << log_max_objs;
+  auto _nobjs = 1u << log_max_objs;
+
+  /* terminals and variable nodes must fit */
+  while ( _nobjs < nvars + 2u )
+  {
+    _nobjs <<= 1u;
+    cache.resize( cache.log_size() + 1u );
+  }
+
   nodes.resize( _nobjs, {-1u, -1u, -1u } );
-  mask   = _nobjs - 1u;
-  unique = new unsigned[_nobjs];
-  nexts  = new unsigned[_nobjs];
+  refs.resize( _nobjs, 0u );
+  nexts.resize( _nobjs, 0u );
+
+  /* unique tables, initially distribute capacity uniformly */
+  auto num_buckets = 16u;
+  while ( num_buckets * std::max( 1u, nvars ) < _nobjs ) { num_buckets <<= 1u; }
+  unique.resize( nvars );
+  unique_mutexes.reset( new std::mutex[nvars] );
+  for ( auto& table : unique )
+  {
+    table.buckets.assign( num_buckets, 0u );
+    table.mask = num_buckets - 1u;
+    table.count = 0u;
+  }
 
-  memset( unique, 0, sizeof( unsigned ) * _nobjs );
-  memset( nexts,  0, sizeof( unsigned ) * _nobjs );
+  /* identity order */
+  for ( auto i = 0u; i <= nvars; ++i )
+  {
+    var2level.push_back( i );
+  }
+  level2var.assign( var2level.begin(), var2level.begin() + nvars );
 
   /* terminals, value is determined by index */
   nodes[0] = {nvars, -1u, -1u};
@@ -121,18 +455,17 @@ dd_manager::dd_manager( unsigned nvars, unsigned log_max_objs, bool verbose )
     nodes[i + 2u] = {i, 1u, 0u};
   }
 
-  nnodes = 2u + nvars;
+  nnodes = peak_nodes = 2u + nvars;
+  gc_threshold = std::max( _nobjs >> 1u, nnodes << 1u );
 }
 
 dd_manager::~dd_manager()
 {
-  delete[] unique;
-  delete[] nexts;
 }
 
 unsigned dd_manager::size() const
 {
-  return nnodes;
+  return nnodes - nfree;
 }
 
 unsigned dd_manager::get_var( unsigned z ) const
@@ -150,13 +483,226 @@ unsigned dd_manager::get_low( unsigned z ) const
   return nodes.at( z ).low;
 }
 
+std::vector<unsigned> dd_manager::get_order() const
+{
+  return level2var;
+}
+
+void dd_manager::set_order( const std::vector<unsigned>& order )
+{
+  assert( order.size() == nvars );
+
+  increment_timer t( &reorder_time );
+  begin_reorder();
+
+  for ( auto l = 0u; l < nvars; ++l )
+  {
+    const auto var = order[l];
+    assert( var2level[var] >= l );
+    while ( var2level[var] > l )
+    {
+      swap_levels( var2level[var] - 1u );
+    }
+  }
+
+  end_reorder();
+}
+
+void dd_manager::swap_levels( unsigned level )
+{
+  assert( level + 1u < nvars );
+
+  const auto own = iref.empty();
+  if ( own ) { begin_reorder(); }
+
+  const auto x = level2var[level];
+  const auto y = level2var[level + 1u];
+
+  /* nodes labeled with x that depend on y; others just move one level down */
+  std::vector<unsigned> moved;
+  for ( auto bucket : unique[x].buckets )
+  {
+    for ( auto z = bucket; z; z = nexts[z] )
+    {
+      if ( nodes[nodes[z].high].var == y || nodes[nodes[z].low].var == y )
+      {
+        moved.push_back( z );
+      }
+    }
+  }
+
+  for ( auto z : moved )
+  {
+    subtable_remove( z );
+  }
+
+  /* (x, (y, f11, f10), (y, f01, f00)) becomes (y, (x, f11, f01), (x, f10, f00)) in place */
+  for ( auto z : moved )
+  {
+    const auto f1 = nodes[z].high;
+    const auto f0 = nodes[z].low;
+    const auto n1 = nodes[f1];
+    const auto n0 = nodes[f0];
+
+    /* in a ZDD a missing variable means that the 1-cofactor is empty */
+    const auto f11 = n1.var == y ? n1.high : ( zero_suppressed ? 0u : f1 );
+    const auto f10 = n1.var == y ? n1.low  : f1;
+    const auto f01 = n0.var == y ? n0.high : ( zero_suppressed ? 0u : f0 );
+    const auto f00 = n0.var == y ? n0.low  : f0;
+
+    const auto g1 = reorder_node( x, f11, f01 );
+    const auto g0 = reorder_node( x, f10, f00 );
+
+    nodes[z] = {y, g1, g0};
+    subtable_insert( z );
+
+    reorder_deref( f1 );
+    reorder_deref( f0 );
+  }
+
+  std::swap( level2var[level], level2var[level + 1u] );
+  var2level[x] = level + 1u;
+  var2level[y] = level;
+  ++num_swaps;
+
+  if ( own ) { end_reorder(); }
+}
+
+unsigned dd_manager::sift()
+{
+  increment_timer t( &reorder_time );
+
+  const auto before = size();
+  begin_reorder();
+
+  /* largest variables first */
+  std::vector<unsigned> vars( nvars );
+  for ( auto i = 0u; i < nvars; ++i ) { vars[i] = i; }
+  std::stable_sort( vars.begin(), vars.end(), [this]( unsigned a, unsigned b ) { return unique[a].count > unique[b].count; } );
+
+  for ( auto var : vars )
+  {
+    sift_variable( var );
+  }
+
+  end_reorder();
+  ++num_reorder;
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] dd: sifting reduced %d nodes to %d nodes" ) % before % size() << std::endl;
+  }
+
+  return size();
+}
+
+unsigned dd_manager::garbage_collect()
+{
+  increment_timer t( &gc_time );
+
+  /* mark */
+  std::vector<bool> marked( nnodes, false );
+  std::vector<unsigned> stack;
+
+  for ( auto z = 0u; z < nvars + 2u; ++z )
+  {
+    marked[z] = true;
+  }
+
+  for ( auto z = nvars + 2u; z < nnodes; ++z )
+  {
+    if ( refs[z] == 0u || marked[z] ) { continue; }
+
+    marked[z] = true;
+    stack.push_back( z );
+
+    while ( !stack.empty() )
+    {
+      const auto& n = nodes[stack.back()];
+      stack.pop_back();
+
+      if ( !marked[n.high] ) { marked[n.high] = true; stack.push_back( n.high ); }
+      if ( !marked[n.low] )  { marked[n.low] = true;  stack.push_back( n.low );  }
+    }
+  }
+
+  /* sweep, rebuilds unique tables and free list */
+  const auto nfree_before = nfree;
+  for ( auto& table : unique )
+  {
+    std::fill( table.buckets.begin(), table.buckets.end(), 0u );
+    table.count = 0u;
+  }
+  free_list = 0u;
+  nfree = 0u;
+
+  for ( auto z = nnodes - 1u; z >= nvars + 2u; --z )
+  {
+    if ( !marked[z] )
+    {
+      free_node( z );
+    }
+    else
+    {
+      subtable_insert( z );
+    }
+  }
+
+  /* computed table may refer to freed nodes */
+  cache.clear();
+
+  const auto collected = nfree - nfree_before;
+  ++num_gc;
+  num_collected += collected;
+
+  if ( verbose )
+  {
+    std::cout << boost::format( "[i] dd: garbage collection freed %d nodes, %d nodes alive" ) % collected % size() << std::endl;
+  }
+
+  return collected;
+}
+
+std::size_t dd_manager::memory() const
+{
+  auto buckets = 0ul;
+  for ( const auto& table : unique )
+  {
+    buckets += table.buckets.capacity();
+  }
+
+  return nodes.capacity() * sizeof( dd_node ) +
+         ( refs.capacity() + nexts.capacity() + iref.capacity() + buckets ) * sizeof( unsigned ) +
+         cache.cache_size() * sizeof( hash_cache::entry );
+}
+
 void dd_manager::dump_stats(std::ostream &stream) const
 {
+  auto buckets = 0ul;
+  for ( const auto& table : unique )
+  {
+    buckets += table.buckets.size();
+  }
+
   stream << boost::format ("-- Variables:   %9d\n") % nvars;
-  stream << boost::format ("-- Nodes:       %9d\n") % nnodes;
+  stream << boost::format ("-- Nodes:       %9d\n") % size();
+  stream << boost::format ("-- Peak-nodes:  %9d\n") % peak_nodes;
+  stream << boost::format ("-- Capacity:    %9d\n") % nodes.size();
+  stream << boost::format ("-- Unique-size: %9d\n") % buckets;
   stream << boost::format ("-- Cache-size:  %9d\n") % cache.cache_size();
   stream << boost::format ("-- Cache-miss:  %9d\n") % cache.miss();
   stream << boost::format ("-- Cache-hit:   %9d\n") % cache.hit();
+  stream << boost::format ("-- Cache-evict: %9d\n") % cache.evictions();
+  stream << boost::format ("-- Cache-assoc: %9d\n") % cache.get_associativity();
+  stream << boost::format ("-- GC-runs:     %9d\n") % num_gc;
+  stream << boost::format ("-- GC-freed:    %9d\n") % num_collected;
+  stream << boost::format ("-- GC-time:     %9.2f\n") % gc_time;
+  stream << boost::format ("-- Reorderings: %9d\n") % num_reorder;
+  stream << boost::format ("-- Swaps:       %9d\n") % num_swaps;
+  stream << boost::format ("-- Reord-time:  %9.2f\n") % reorder_time;
+  stream << boost::format ("-- Resizes:     %9d\n") % num_node_resizes;
+  stream << boost::format ("-- Memory (KB): %9d\n") % ( memory() >> 10u );
+  cache.print_statistics( stream );
 }
 
 unsigned dd_manager::unique_lookup( unsigned var, unsigned high, unsigned low )
@@ -167,36 +713,42 @@ unsigned dd_manager::unique_lookup( unsigned var, unsigned high, unsigned low )
     return var + 2u;
   }
 
-  const auto hash  = ( 12582917 * (int)var + 4256249 * (int)high + 741457 * (int)low );
-  const auto index = hash & mask;
-  auto*      q     = unique + index;
+  std::unique_lock<std::mutex> lock( unique_mutexes[var], std::defer_lock );
+  if ( concurrent ) { lock.lock(); }
 
-  while ( *q )
+  const auto& table = unique[var];
+  for ( auto z = table.buckets[unique_hash( high, low ) & table.mask]; z; z = nexts[z] )
   {
-    if ( nodes.at( *q ).var == var && nodes.at( *q ).high == high && nodes.at( *q ).low == low )
+    const auto& n = nodes[z];
+    if ( n.high == high && n.low == low )
     {
-      return *q;
+      return z;
     }
-    q = nexts + *q;
   }
 
-  if ( nnodes == nodes.size() )
-  {
-    std::cerr << "[e] dd capacity exceeded" << std::endl;
-    assert( false );
-  }
+  /* may resize node and unique table */
+  const auto z = allocate_node();
+  nodes[z] = {var, high, low};
+  subtable_insert( z );
 
-  *q = nnodes++;
-  nodes[*q].var  = var;
-  nodes[*q].high = high;
-  nodes[*q].low  = low;
+  return z;
+}
 
-  if ( verbose )
-  {
-    // std::cout << boost::format( "[i] created entry (%d, %d, %d) at index %d" ) % var % high % low % *q << std::endl;
-  }
+void dd_manager::begin_concurrent()
+{
+  assert( iref.empty() );
+
+  concurrent = true;
+  cache.set_concurrent( true );
+}
+
+void dd_manager::end_concurrent()
+{
+  concurrent = false;
+  cache.set_concurrent( false );
 
-  return *q;
+  /* node table may have grown */
+  adjust_cache_size();
 }
 
 }
@@ -37,41 +37,261 @@
 #ifndef DD_MANAGER_HPP
 #define DD_MANAGER_HPP
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <memory>
+#include <mutex>
 #include <ostream>
+#include <string>
 #include <vector>
 
 namespace cirkit
 {
 
+/**
+ * Computed table
+ *
+ * Entries are tagged with the operation and grouped into sets of
+ * `associativity' (1, 2, or 4) entries that lie in the same cache line.
+ * Within a set, entries are kept in most-recently-used order.  Hits, misses,
+ * and evictions are counted per operation.
+ *
+ * In concurrent mode, every set is protected by one of a fixed number of
+ * spin locks.  Statistics are then only approximate.
+ */
 class hash_cache
 {
 public:
-  using value_type     = std::tuple<unsigned, unsigned, unsigned, int>;
-  using container_type = std::vector<value_type>;
+  struct entry
+  {
+    unsigned arg0;
+    unsigned arg1;
+    unsigned op;
+    unsigned res;
+  };
+
+  using container_type = std::vector<entry>;
   using size_type      = container_type::size_type;
 
+  static constexpr unsigned invalid_op = -1u;
+  static constexpr unsigned max_ops    = 32u;
+
+  /* counters are relaxed atomics, such that concurrent updates are not data races (but may be lost) */
+  struct counter
+  {
+    inline void operator++() { value.store( value.load( std::memory_order_relaxed ) + 1ul, std::memory_order_relaxed ); }
+    inline operator unsigned long() const { return value.load( std::memory_order_relaxed ); }
+
+    std::atomic<unsigned long> value{0ul};
+  };
+
+  struct op_statistics
+  {
+    counter hits;
+    counter misses;
+    counter evictions;
+  };
+
 public:
-  hash_cache( size_type log_size );
-  int lookup( unsigned arg0, unsigned arg1, unsigned arg2 );
-  int insert( unsigned arg0, unsigned arg1, unsigned arg2, int res );
+  hash_cache( size_type log_size, unsigned associativity = 2u );
+
+  inline int lookup( unsigned arg0, unsigned arg1, unsigned op )
+  {
+    assert( op < max_ops );
+
+    set_lock lock( *this, arg0, arg1, op );
+    auto* set = lock.set;
+    for ( auto i = 0u; i < associativity; ++i )
+    {
+      if ( set[i].arg0 == arg0 && set[i].arg1 == arg1 && set[i].op == op )
+      {
+        const auto res = set[i].res;
+        /* move to front */
+        for ( ; i > 0u; --i ) { set[i] = set[i - 1u]; }
+        set[0] = {arg0, arg1, op, res};
+        ++stats[op].hits;
+        return res;
+      }
+    }
+
+    ++stats[op].misses;
+    return -1;
+  }
+
+  inline int insert( unsigned arg0, unsigned arg1, unsigned op, int res )
+  {
+    set_lock lock( *this, arg0, arg1, op );
+    auto* set = lock.set;
+
+    /* replace the entry with the same key or the least recently used one */
+    auto i = 0u;
+    while ( i + 1u < associativity && !( set[i].arg0 == arg0 && set[i].arg1 == arg1 && set[i].op == op ) ) { ++i; }
+    if ( set[i].op != invalid_op && !( set[i].arg0 == arg0 && set[i].arg1 == arg1 && set[i].op == op ) )
+    {
+      ++stats[set[i].op].evictions;
+    }
+
+    for ( ; i > 0u; --i ) { set[i] = set[i - 1u]; }
+    set[0] = {arg0, arg1, op, static_cast<unsigned>( res )};
+    return res;
+  }
+
+  /* enables locking of sets, the table must not be resized in concurrent mode */
+  inline void set_concurrent( bool enabled ) { concurrent = enabled; }
+  inline bool is_concurrent() const { return concurrent; }
+
+  /* changes the size to 2^log_size entries and rehashes all valid entries */
+  void resize( size_type log_size );
+
+  /* changes the associativity (1, 2, or 4), invalidates all entries */
+  void set_associativity( unsigned value );
+  inline unsigned get_associativity() const { return associativity; }
+
+  /* invalidates all entries, e.g., after garbage collection */
+  void clear();
+
+  /* names are used for printing statistics, index is the operation tag */
+  void set_operation_names( const std::vector<std::string>& names );
+  inline const op_statistics& operation_statistics( unsigned op ) const { return stats[op]; }
 
   std::size_t cache_size() const;
+  std::size_t log_size() const;
 
   std::size_t hit () const;
   std::size_t miss () const;
+  std::size_t evictions () const;
+
+  void print_statistics( std::ostream& os ) const;
+
 private:
-  inline container_type::reference entry( unsigned arg0, unsigned arg1, unsigned arg2 )
+  static constexpr unsigned num_locks = 4096u;
+
+  inline unsigned find_set_index( unsigned arg0, unsigned arg1, unsigned op ) const
   {
-    return data[( 12582917 * (int)arg0 + 4256249 * (int)arg1 + 741457 * (int)arg2 ) & mask];
+    const auto h = 12582917u * arg0 + 4256249u * arg1 + 741457u * op;
+    return ( h ^ ( h >> 16u ) ) & set_mask;
   }
 
+  inline entry* find_set( unsigned arg0, unsigned arg1, unsigned op )
+  {
+    return data + find_set_index( arg0, arg1, op ) * associativity;
+  }
+
+  /* finds the set and locks it in concurrent mode */
+  struct set_lock
+  {
+    inline set_lock( hash_cache& cache, unsigned arg0, unsigned arg1, unsigned op )
+    {
+      const auto index = cache.find_set_index( arg0, arg1, op );
+      set = cache.data + index * cache.associativity;
+      flag = cache.concurrent ? &cache.locks[index & ( num_locks - 1u )] : nullptr;
+      if ( flag )
+      {
+        while ( flag->exchange( true, std::memory_order_acquire ) )
+        {
+          while ( flag->load( std::memory_order_relaxed ) ) {}
+        }
+      }
+    }
+
+    inline ~set_lock()
+    {
+      if ( flag ) { flag->store( false, std::memory_order_release ); }
+    }
+
+    entry*             set;
+    std::atomic<bool>* flag;
+  };
+
+  void allocate( size_type log_size );
+
 private:
-  container_type data;
-  unsigned mask;
+  container_type                       storage;
+  entry*                               data;      /* cache line aligned begin of storage */
+  size_type                            num_entries;
+  unsigned                             associativity;
+  unsigned                             set_mask;
+
+  bool                                 concurrent = false;
+  std::unique_ptr<std::atomic<bool>[]> locks;
 
-  unsigned nhit;
-  unsigned nmiss;
+  std::vector<op_statistics>           stats;
+  std::vector<std::string>             names;
+};
+
+/**
+ * Array whose elements never move when it grows.  The first block holds
+ * 2^base_log elements, every further block as many elements as all previous
+ * blocks together.  Elements can therefore be accessed by other threads
+ * while the array grows, which is required for parallel operations.
+ */
+template<typename T>
+class dd_array
+{
+public:
+  static constexpr unsigned base_log   = 10u;
+  static constexpr unsigned max_blocks = 32u - base_log + 1u;
+
+  inline T& operator[]( std::size_t i )
+  {
+    const auto b = block_of( i );
+    return blocks[b][i - block_begin( b )];
+  }
+
+  inline const T& operator[]( std::size_t i ) const
+  {
+    const auto b = block_of( i );
+    return blocks[b][i - block_begin( b )];
+  }
+
+  inline T& at( std::size_t i )
+  {
+    assert( i < size() );
+    return operator[]( i );
+  }
+
+  inline const T& at( std::size_t i ) const
+  {
+    assert( i < size() );
+    return operator[]( i );
+  }
+
+  inline std::size_t size() const { return _size.load( std::memory_order_relaxed ); }
+  inline std::size_t capacity() const { return num_blocks ? block_begin( num_blocks ) : 0u; }
+
+  /* only growing is supported, new elements are initialized to value */
+  void resize( std::size_t n, const T& value )
+  {
+    assert( n >= size() );
+    while ( capacity() < n )
+    {
+      assert( num_blocks < max_blocks );
+      const auto block_size = block_begin( num_blocks + 1u ) - block_begin( num_blocks );
+      blocks[num_blocks].reset( new T[block_size] );
+      std::fill( blocks[num_blocks].get(), blocks[num_blocks].get() + block_size, value );
+      ++num_blocks;
+    }
+    _size.store( n, std::memory_order_relaxed );
+  }
+
+private:
+  static inline unsigned block_of( std::size_t i )
+  {
+    const auto hi = i >> base_log;
+    return hi ? 64u - __builtin_clzll( hi ) : 0u;
+  }
+
+  static inline std::size_t block_begin( unsigned b )
+  {
+    return b ? std::size_t( 1u ) << ( base_log + b - 1u ) : 0u;
+  }
+
+private:
+  std::array<std::unique_ptr<T[]>, max_blocks> blocks;
+  unsigned                                     num_blocks = 0u;
+  std::atomic<std::size_t>                     _size{0u};
 };
 
 struct dd_node
@@ -88,6 +308,28 @@ struct dd_node
 
 std::ostream& operator<<( std::ostream& os, const dd_node& z );
 
+/**
+ * Nodes are stored in a growable array.  The unique table consists of one
+ * chained hash table per variable, each is rehashed when its load exceeds 1.
+ *
+ * DD handles (bdd, zdd) keep external reference counts.  Nodes that are not
+ * reachable from a referenced node are collected by mark-and-sweep.  Garbage
+ * collection and reordering are only triggered between top-level operations
+ * (see gc_point), such that intermediate results of recursive operations are
+ * never freed.  Indexes obtained from the low-level interface (e.g.,
+ * bdd_manager::bdd_and) are therefore only valid until the next operation on
+ * a DD handle.
+ *
+ * Node indexes are stable under reordering, only the variable order changes.
+ * Algorithms that depend on the order of variables must compare levels
+ * (var_to_level), not variable indexes.
+ *
+ * In concurrent mode (see begin_concurrent), unique_lookup can be called from
+ * several threads.  Each unique subtable and the node allocator is protected
+ * by a lock, the computed table locks its sets.  Node arrays never move when
+ * they grow, such that nodes can be read without locks.  The computed table
+ * is not resized while in concurrent mode but in end_concurrent.
+ */
 class dd_manager
 {
 public:
@@ -96,26 +338,147 @@ public:
 
   inline unsigned num_vars() const { return nvars; }
 
+  /* number of live (allocated and not freed) nodes */
   unsigned size() const;
 
   unsigned get_var( unsigned z ) const;
   unsigned get_high( unsigned z ) const;
   unsigned get_low( unsigned z ) const;
 
+  /* variable order, the terminal level is num_vars() */
+  inline unsigned var_to_level( unsigned var ) const   { return var2level[var]; }
+  inline unsigned level_to_var( unsigned level ) const { return level2var[level]; }
+
+  /* order[l] is the variable at level l */
+  std::vector<unsigned> get_order() const;
+  void set_order( const std::vector<unsigned>& order );
+
+  /* swaps the variables at level and level + 1 */
+  void swap_levels( unsigned level );
+
+  /* Rudell's sifting, returns the number of nodes after reordering */
+  unsigned sift();
+
+  /* sifts when the number of live nodes exceeds the current threshold (checked in gc_point) */
+  inline void set_auto_reorder( bool enabled ) { auto_reorder = enabled; }
+  inline bool is_auto_reorder() const { return auto_reorder; }
+  inline void set_reorder_threshold( unsigned threshold ) { reorder_threshold = threshold; }
+
+  /* external reference counting, used by the DD handles */
+  inline void ref( unsigned z )   { ++refs[z]; }
+  inline void deref( unsigned z ) { assert( refs[z] > 0u ); --refs[z]; }
+
+  /* frees all nodes that are not reachable from referenced nodes, returns the number of freed nodes */
+  unsigned garbage_collect();
+
+  /* collects garbage and reorders if the number of live nodes exceeds the current thresholds */
+  inline void gc_point()
+  {
+    if ( auto_reorder && nnodes - nfree >= reorder_threshold )
+    {
+      reorder_and_adjust_threshold();
+    }
+    if ( gc_enabled && nnodes - nfree >= gc_threshold )
+    {
+      gc_and_adjust_threshold();
+    }
+  }
+
+  /* associativity of the computed table (1, 2, or 4), invalidates the table */
+  inline void set_cache_associativity( unsigned value ) { cache.set_associativity( value ); }
+  inline const hash_cache& computed_table() const { return cache; }
+
+  inline void set_gc_enabled( bool enabled ) { gc_enabled = enabled; }
+  inline bool is_gc_enabled() const { return gc_enabled; }
+
+  /* approximate memory usage in bytes */
+  std::size_t memory() const;
+
   void dump_stats ( std::ostream& stream ) const;
 
 protected:
   unsigned unique_lookup( unsigned var, unsigned high, unsigned low );
 
+  /* operations between these calls may call unique_lookup and access the cache concurrently */
+  void begin_concurrent();
+  void end_concurrent();
+
+  /* the variable of var1 and var2 that comes first in the order */
+  inline unsigned top_var( unsigned var1, unsigned var2 ) const
+  {
+    return var2level[var1] < var2level[var2] ? var1 : var2;
+  }
+
+private:
+  struct subtable
+  {
+    std::vector<unsigned> buckets;
+    unsigned              mask;
+    unsigned              count;
+  };
+
+  unsigned allocate_node();
+  void free_node( unsigned z );
+  void grow_nodes();
+  void subtable_insert( unsigned z );
+  void subtable_remove( unsigned z );
+  void subtable_resize( subtable& table, unsigned num_buckets );
+  void gc_and_adjust_threshold();
+  void adjust_cache_size();
+
+  /* reordering, see dd_manager.cpp */
+  void begin_reorder();
+  void end_reorder();
+  unsigned reorder_node( unsigned var, unsigned high, unsigned low );
+  void reorder_deref( unsigned z );
+  void sift_variable( unsigned var );
+  void reorder_and_adjust_threshold();
+
+  static inline unsigned unique_hash( unsigned high, unsigned low )
+  {
+    return 4256249u * high + 741457u * low;
+  }
+
 protected:
-  unsigned             nvars;
-  unsigned             nnodes = 0u;
-  unsigned             mask = 0u;
-  hash_cache           cache;
-  std::vector<dd_node> nodes;
-  bool                 verbose;
-  unsigned *           unique;
-  unsigned *           nexts;
+  unsigned              nvars;
+  unsigned              nnodes = 0u;   /* used slots in nodes (live + free) */
+  unsigned              nfree = 0u;    /* slots in free list */
+  unsigned              free_list = 0u;
+  hash_cache            cache;
+  dd_array<dd_node>     nodes;
+  std::vector<unsigned> refs;
+  bool                  verbose;
+  std::vector<subtable> unique;        /* one table per variable */
+  dd_array<unsigned>    nexts;
+  bool                  zero_suppressed = false;
+
+  /* concurrent mode */
+  bool                  concurrent = false;
+  std::mutex            alloc_mutex;
+  std::unique_ptr<std::mutex[]> unique_mutexes; /* one per subtable */
+
+  /* variable order */
+  std::vector<unsigned> var2level;
+  std::vector<unsigned> level2var;
+
+  /* garbage collection */
+  bool                  gc_enabled = true;
+  unsigned              gc_threshold;
+
+  /* reordering */
+  bool                  auto_reorder = false;
+  unsigned              reorder_threshold = 4096u;
+  std::vector<unsigned> iref;          /* internal + external references, only valid while reordering */
+
+  /* statistics */
+  unsigned              peak_nodes = 0u;
+  unsigned              num_gc = 0u;
+  unsigned long         num_collected = 0ul;
+  unsigned              num_node_resizes = 0u;
+  double                gc_time = 0.0;
+  unsigned              num_reorder = 0u;
+  unsigned long         num_swaps = 0ul;
+  double                reorder_time = 0.0;
 };
 
 }
@@ -86,10 +86,12 @@ void visit_solutions_rec( unsigned level, const bdd& n, boost::dynamic_bitset<>&
   {
     return;
   }
-  if ( n.var() > level )
+  /* x is indexed by variables, recursion is over levels */
+  const auto var = level < n.manager->num_vars() ? n.manager->level_to_var( level ) : level;
+  if ( n.level() > level )
   {
-    x.reset( level ); visit_solutions_rec( level + 1u, n, x, f );
-    x.set( level );   visit_solutions_rec( level + 1u, n, x, f );
+    x.reset( var ); visit_solutions_rec( level + 1u, n, x, f );
+    x.set( var );   visit_solutions_rec( level + 1u, n, x, f );
   }
   else if ( n.index == 1u )
   {
@@ -99,11 +101,11 @@ void visit_solutions_rec( unsigned level, const bdd& n, boost::dynamic_bitset<>&
   {
     if ( n.low().index != 0u )
     {
-      x.reset( level ); visit_solutions_rec( level + 1u, n.low(), x, f );
+      x.reset( var ); visit_solutions_rec( level + 1u, n.low(), x, f );
     }
     if ( n.high().index != 0u )
     {
-      x.set( level );   visit_solutions_rec( level + 1u, n.high(), x, f );
+      x.set( var );   visit_solutions_rec( level + 1u, n.high(), x, f );
     }
   }
 }
@@ -119,7 +121,10 @@ void visit_paths_rec( const bdd& n, std::vector<tribool>& x, const visit_paths_f
     break;
   default:
     x[n.var()] = false; visit_paths_rec( n.low(), x, f );
-    std::fill( x.begin() + n.var(), x.end(), dontcare );
+    for ( auto l = n.level(); l < n.manager->num_vars(); ++l )
+    {
+      x[n.manager->level_to_var( l )] = dontcare;
+    }
     x[n.var()] = true;  visit_paths_rec( n.high(), x, f );
   }
 }
@@ -31,6 +31,7 @@
 #include <boost/assign/std/vector.hpp>
 #include <boost/format.hpp>
 #include <boost/range/algorithm.hpp>
+#include <boost/range/counting_range.hpp>
 
 #include <core/utils/bitset_utils.hpp>
 #include <core/utils/range_utils.hpp>
@@ -56,7 +57,12 @@ enum class zdd_operation { diff, _union, intersection, symmetric_difference, joi
  ******************************************************************************/
 
 zdd_manager::zdd_manager( unsigned nvars, unsigned log_max_objs, bool verbose )
-  : dd_manager( nvars, log_max_objs, verbose ) {}
+  : dd_manager( nvars, log_max_objs, verbose )
+{
+  zero_suppressed = true;
+  cache.set_operation_names( {"DIFF", "UNION", "INTERSECTION", "SYMDIFF", "JOIN", "MEET",
+                              "DELTA", "NONSUB", "NONSUP", "MINHIT"} );
+}
 
 zdd_manager::~zdd_manager() {}
 
@@ -70,15 +76,15 @@ unsigned zdd_manager::zdd_diff( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::diff );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
   unsigned rlow, rhigh, idx;
-  if ( node1.var < node2.var )
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
   {
     rlow = zdd_diff( node1.low, z2 );
     idx = unique_create( node1.var, node1.high, rlow );
   }
-  else if ( node1.var > node2.var )
+  else if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     idx = zdd_diff( z1, node2.low );
   }
@@ -104,15 +110,15 @@ unsigned zdd_manager::zdd_union( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::_union );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
   unsigned rlow, rhigh;
-  if ( node1.var < node2.var )
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
   {
     rlow = zdd_union( node1.low, z2 );
     rhigh = node1.high;
   }
-  else if ( node1.var > node2.var )
+  else if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     rlow = zdd_union( z1, node2.low );
     rhigh = node2.high;
@@ -122,7 +128,7 @@ unsigned zdd_manager::zdd_union( unsigned z1, unsigned z2 )
     rlow = zdd_union( node1.low, node2.low );
     rhigh = zdd_union( node1.high, node2.high );
   }
-  const auto idx = unique_create( std::min( node1.var, node2.var ), rhigh, rlow );
+  const auto idx = unique_create( top_var( node1.var, node2.var ), rhigh, rlow );
   return cache.insert( z1, z2, (unsigned)zdd_operation::_union, idx );
 }
 
@@ -136,13 +142,13 @@ unsigned zdd_manager::zdd_intersection( unsigned z1, unsigned z2 )
   /* commutativity */
   if ( z1 > z2 ) { return zdd_intersection( z2, z1 ); }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
-  if ( node1.var < node2.var )
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
   {
     return zdd_intersection( node1.low, z2 );
   }
-  if ( node1.var > node2.var )
+  if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     return zdd_intersection( z1, node2.low );
   }
@@ -170,15 +176,15 @@ unsigned zdd_manager::zdd_symmetric_difference( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::symmetric_difference );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
   unsigned rlow, rhigh;
-  if ( node1.var < node2.var )
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
   {
     rlow = zdd_symmetric_difference( node1.low, z2 );
     rhigh = node1.high;
   }
-  else if ( node1.var > node2.var )
+  else if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     rlow = zdd_symmetric_difference( z1, node2.low );
     rhigh = node2.high;
@@ -188,18 +194,18 @@ unsigned zdd_manager::zdd_symmetric_difference( unsigned z1, unsigned z2 )
     rlow = zdd_symmetric_difference( node1.low, node2.low );
     rhigh = zdd_symmetric_difference( node1.high, node2.high );
   }
-  const auto idx = unique_create( std::min( node1.var, node2.var ), rhigh, rlow );
+  const auto idx = unique_create( top_var( node1.var, node2.var ), rhigh, rlow );
   return cache.insert( z1, z2, (unsigned)zdd_operation::symmetric_difference, idx );
 }
 
 unsigned zdd_manager::zdd_join( unsigned z1, unsigned z2 )
 {
   /* swapping */
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   /* commutativity */
-  if ( node1.var < node2.var || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_join( z2, z1 ); }
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_join( z2, z1 ); }
 
   /* terminating cases */
   if ( z1 == 0u ) { return 0u; }
@@ -209,7 +215,7 @@ unsigned zdd_manager::zdd_join( unsigned z1, unsigned z2 )
   if ( r >= 0 ) { return r; }
 
   unsigned rlow, rhigh;
-  if ( node1.var > node2.var )
+  if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     rlow = zdd_join( z1, node2.low );
     rhigh = zdd_join( z1, node2.high );
@@ -230,11 +236,11 @@ unsigned zdd_manager::zdd_join( unsigned z1, unsigned z2 )
 unsigned zdd_manager::zdd_meet( unsigned z1, unsigned z2 )
 {
   /* swapping */
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   /* commutativity */
-  if ( node1.var < node2.var || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_join( z2, z1 ); }
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_join( z2, z1 ); }
 
   /* terminating cases */
   if ( z1 <= 1u ) { return z1; }
@@ -242,7 +248,7 @@ unsigned zdd_manager::zdd_meet( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::meet );
   if ( r >= 0 ) { return r; }
 
-  if ( node1.var > node2.var )
+  if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     auto idx = zdd_meet( z1, zdd_union( node2.low, node2.high ) );
     return cache.insert( z1, z2, (unsigned)zdd_operation::join, idx );
@@ -263,11 +269,11 @@ unsigned zdd_manager::zdd_meet( unsigned z1, unsigned z2 )
 unsigned zdd_manager::zdd_delta( unsigned z1, unsigned z2 )
 {
   /* swapping */
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   /* commutativity */
-  if ( node1.var < node2.var || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_delta( z2, z1 ); }
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) || ( ( node1.var == node2.var ) && ( z1 > z2 ) ) ) { return zdd_delta( z2, z1 ); }
 
   /* terminating cases */
   if ( z1 == 0u ) { return 0u; }
@@ -277,7 +283,7 @@ unsigned zdd_manager::zdd_delta( unsigned z1, unsigned z2 )
   if ( r >= 0 ) { return r; }
 
   unsigned rlow, rhigh;
-  if ( node1.var > node2.var )
+  if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     rlow = zdd_delta( z1, node2.low );
     rhigh = zdd_delta( z1, node2.high );
@@ -303,12 +309,12 @@ unsigned zdd_manager::zdd_nonsub( unsigned z1, unsigned z2 )
   const auto r = cache.lookup( z1, z2, (unsigned)zdd_operation::nonsub );
   if ( r >= 0 ) { return r; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
   unsigned rlow, rhigh;
 
-  if ( node1.var > node2.var )
+  if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     rlow = zdd_nonsub( node1.low, z2 );
     rhigh = node1.high;
@@ -333,10 +339,10 @@ unsigned zdd_manager::zdd_nonsup( unsigned z1, unsigned z2 )
   if ( z2 == 0u ) { return z1; }
   if ( z1 == z2 ) { return 0u; }
 
-  const auto& node1 = nodes.at( z1 );
-  const auto& node2 = nodes.at( z2 );
+  const auto node1 = nodes.at( z1 );
+  const auto node2 = nodes.at( z2 );
 
-  if ( node1.var > node2.var )
+  if ( var_to_level( node1.var ) > var_to_level( node2.var ) )
   {
     return zdd_nonsup( z1, node2.low );
   }
@@ -346,7 +352,7 @@ unsigned zdd_manager::zdd_nonsup( unsigned z1, unsigned z2 )
 
   unsigned rlow, rhigh;
 
-  if ( node1.var < node2.var )
+  if ( var_to_level( node1.var ) < var_to_level( node2.var ) )
   {
     rlow = zdd_nonsup( node1.low, z2 );
     rhigh = zdd_nonsup( node1.high, z2 );
@@ -371,7 +377,7 @@ unsigned zdd_manager::zdd_minhit( unsigned z )
   const auto r = cache.lookup( z, z, (unsigned)zdd_operation::minhit );
   if ( r >= 0 ) { return r; }
 
-  const auto& node = nodes.at( z );
+  const auto node = nodes.at( z );
   auto rtmp = zdd_union( node.low, node.high );
   auto rlow = zdd_minhit( rtmp );
   rtmp = zdd_minhit( node.low );
@@ -388,8 +394,8 @@ unsigned zdd_manager::unique_create( unsigned var, unsigned high, unsigned low )
     std::cout << boost::format( "[i] attempt to create (%d, %d, %d)" ) % var % high % low << std::endl;
   }
   assert( var < nvars );
-  assert( var < nodes[high].var );
-  assert( var < nodes[low].var );
+  assert( var_to_level( var ) < var_to_level( nodes[high].var ) );
+  assert( var_to_level( var ) < var_to_level( nodes[low].var ) );
 
   if ( high == 0u ) { return low; }
 
@@ -398,25 +404,24 @@ unsigned zdd_manager::unique_create( unsigned var, unsigned high, unsigned low )
 
 std::ostream& operator<<( std::ostream& os, const zdd_manager& mgr )
 {
-  for ( auto node : index( mgr.nodes ) )
+  for ( auto z : boost::counting_range( 0u, mgr.nnodes ) )
   {
-    os << node.index << ": " << node.value << std::endl;
+    if ( mgr.nodes[z].var != -1u ) /* skip free nodes */
+    {
+      os << z << ": " << mgr.nodes[z] << std::endl;
+    }
   }
   return os;
 }
 
-zdd& zdd::operator=( const zdd& other )
+unsigned zdd::var() const
 {
-  if ( this == &other ) { return *this; }
-  assert( !manager || manager == other.manager );
-  manager = other.manager;
-  index   = other.index;
-  return *this;
+  return manager->get_var( index );
 }
 
-unsigned zdd::var() const
+unsigned zdd::level() const
 {
-  return manager->get_var( index );
+  return manager->var_to_level( manager->get_var( index ) );
 }
 
 zdd zdd::high() const
@@ -432,59 +437,69 @@ zdd zdd::low() const
 zdd zdd::operator-( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_diff( index, other.index ) );
 }
 
 zdd zdd::operator||( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_union( index, other.index ) );
 }
 
 zdd zdd::operator&&( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_intersection( index, other.index ) );
 }
 
 zdd zdd::operator^( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_symmetric_difference( index, other.index ) );
 }
 
 zdd zdd::operator+( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_join( index, other.index ) );
 }
 
 zdd zdd::operator*( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_meet( index, other.index ) );
 }
 
 zdd zdd::delta( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_delta( index, other.index ) );
 }
 
 zdd zdd::nonsub( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_nonsub( index, other.index ) );
 }
 
 zdd zdd::nonsup( const zdd& other ) const
 {
   assert( manager == other.manager );
+  manager->gc_point();
   return zdd( manager, manager->zdd_nonsup( index, other.index ) );
 }
 
 zdd zdd::minhit() const
 {
+  manager->gc_point();
   return zdd( manager, manager->zdd_minhit( index ) );
 }
 
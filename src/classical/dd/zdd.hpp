@@ -51,14 +51,16 @@ class zdd_manager;
 struct zdd
 {
   zdd() : manager( nullptr ), index( 0u ) {}
-  zdd( zdd_manager* manager, unsigned index )
-    : manager( manager ),
-      index( index ) {}
-  zdd( const zdd& other ) : manager( other.manager ), index( other.index ) {}
+  zdd( zdd_manager* manager, unsigned index );
+  zdd( const zdd& other );
+  zdd( zdd&& other ) : manager( other.manager ), index( other.index ) { other.manager = nullptr; }
+  ~zdd();
 
   zdd& operator=( const zdd& other );
+  zdd& operator=( zdd&& other );
 
   unsigned var() const;
+  unsigned level() const; /* position of var() in the current order */
   zdd high() const;
   zdd low() const;
 
@@ -112,6 +114,48 @@ public:
   friend std::ostream& operator<<( std::ostream& os, const zdd_manager& mgr );
 };
 
+/* handles keep an external reference to their node, see dd_manager */
+inline zdd::zdd( zdd_manager* manager, unsigned index )
+  : manager( manager ),
+    index( index )
+{
+  if ( manager ) { manager->ref( index ); }
+}
+
+inline zdd::zdd( const zdd& other )
+  : manager( other.manager ),
+    index( other.index )
+{
+  if ( manager ) { manager->ref( index ); }
+}
+
+inline zdd::~zdd()
+{
+  if ( manager ) { manager->deref( index ); }
+}
+
+inline zdd& zdd::operator=( const zdd& other )
+{
+  if ( this == &other ) { return *this; }
+  assert( !manager || !other.manager || manager == other.manager );
+  if ( other.manager ) { other.manager->ref( other.index ); }
+  if ( manager ) { manager->deref( index ); }
+  manager = other.manager;
+  index   = other.index;
+  return *this;
+}
+
+inline zdd& zdd::operator=( zdd&& other )
+{
+  if ( this == &other ) { return *this; }
+  assert( !manager || !other.manager || manager == other.manager );
+  if ( manager ) { manager->deref( index ); }
+  manager = other.manager;
+  index   = other.index;
+  other.manager = nullptr;
+  return *this;
+}
+
 }
 
 #endif
@@ -0,0 +1,195 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "priority.hpp"
+
+#include <iterator>
+
+#include <boost/graph/topological_sort.hpp>
+#include <boost/range/iterator_range.hpp>
+
+#include <classical/mig/mig_utils.hpp>
+#include <classical/utils/aig_utils.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/* AIGs and MIGs are both Boost graphs with edges from gates to their fanins */
+template<typename Graph>
+std::vector<unsigned> graph_topological_nodes( const Graph& g )
+{
+  std::vector<unsigned> nodes;
+  nodes.reserve( boost::num_vertices( g ) );
+  boost::topological_sort( g, std::back_inserter( nodes ) );
+  return nodes;
+}
+
+template<typename Graph>
+std::vector<unsigned> graph_fanout_counts( const Graph& g )
+{
+  std::vector<unsigned> fanout( boost::num_vertices( g ), 0u );
+  for ( const auto& e : boost::make_iterator_range( boost::edges( g ) ) )
+  {
+    ++fanout[boost::target( e, g )];
+  }
+  return fanout;
+}
+
+template<typename Graph>
+unsigned graph_fanins( const Graph& g, unsigned n, unsigned* nodes, bool* complements )
+{
+  const auto complement = boost::get( boost::edge_complement, g );
+
+  auto i = 0u;
+  for ( const auto& e : boost::make_iterator_range( boost::out_edges( n, g ) ) )
+  {
+    nodes[i] = boost::target( e, g );
+    complements[i] = complement[e];
+    ++i;
+  }
+  return i;
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+namespace detail
+{
+
+unsigned priority_cuts_network_traits<aig_graph>::num_nodes( const aig_graph& aig )
+{
+  return boost::num_vertices( aig );
+}
+
+std::vector<unsigned> priority_cuts_network_traits<aig_graph>::topological_nodes( const aig_graph& aig )
+{
+  return graph_topological_nodes( aig );
+}
+
+bool priority_cuts_network_traits<aig_graph>::is_constant( const aig_graph& aig, unsigned n )
+{
+  return n == aig_info( aig ).constant;
+}
+
+std::vector<unsigned> priority_cuts_network_traits<aig_graph>::fanout_counts( const aig_graph& aig )
+{
+  return graph_fanout_counts( aig );
+}
+
+unsigned priority_cuts_network_traits<aig_graph>::fanins( const aig_graph& aig, unsigned n, unsigned* nodes, bool* complements )
+{
+  return graph_fanins( aig, n, nodes, complements );
+}
+
+unsigned priority_cuts_network_traits<mig_graph>::num_nodes( const mig_graph& mig )
+{
+  return boost::num_vertices( mig );
+}
+
+std::vector<unsigned> priority_cuts_network_traits<mig_graph>::topological_nodes( const mig_graph& mig )
+{
+  return graph_topological_nodes( mig );
+}
+
+bool priority_cuts_network_traits<mig_graph>::is_constant( const mig_graph& mig, unsigned n )
+{
+  return n == mig_info( mig ).constant;
+}
+
+std::vector<unsigned> priority_cuts_network_traits<mig_graph>::fanout_counts( const mig_graph& mig )
+{
+  return graph_fanout_counts( mig );
+}
+
+unsigned priority_cuts_network_traits<mig_graph>::fanins( const mig_graph& mig, unsigned n, unsigned* nodes, bool* complements )
+{
+  return graph_fanins( mig, n, nodes, complements );
+}
+
+unsigned priority_cuts_network_traits<xmg_graph>::num_nodes( const xmg_graph& xmg )
+{
+  return xmg.size();
+}
+
+std::vector<unsigned> priority_cuts_network_traits<xmg_graph>::topological_nodes( const xmg_graph& xmg )
+{
+  /* nodes are created in topological order */
+  std::vector<unsigned> nodes( xmg.size() );
+  for ( auto n = 0u; n < nodes.size(); ++n )
+  {
+    nodes[n] = n;
+  }
+  return nodes;
+}
+
+bool priority_cuts_network_traits<xmg_graph>::is_constant( const xmg_graph& xmg, unsigned n )
+{
+  return n == 0u;
+}
+
+std::vector<unsigned> priority_cuts_network_traits<xmg_graph>::fanout_counts( const xmg_graph& xmg )
+{
+  std::vector<unsigned> fanout( xmg.size(), 0u );
+  for ( auto n = 0u; n < xmg.size(); ++n )
+  {
+    for ( auto i = 0u; i < xmg.fanin_count( n ); ++i )
+    {
+      ++fanout[xmg.child_literal( n, i ) >> 1u];
+    }
+  }
+  return fanout;
+}
+
+unsigned priority_cuts_network_traits<xmg_graph>::fanins( const xmg_graph& xmg, unsigned n, unsigned* nodes, bool* complements )
+{
+  const auto count = xmg.fanin_count( n );
+  for ( auto i = 0u; i < count; ++i )
+  {
+    const auto lit = xmg.child_literal( n, i );
+    nodes[i] = lit >> 1u;
+    complements[i] = lit & 1u;
+  }
+  return count;
+}
+
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
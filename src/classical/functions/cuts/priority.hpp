@@ -0,0 +1,532 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file priority.hpp
+ *
+ * @brief Priority cut enumeration with truth tables
+ *
+ * Keeps at most C cuts per node, ranked by a cost function (depth, area
+ * flow, or size).  A cut stores its leafs in a fixed-size sorted array,
+ * a 64-bit signature for fast dominance filtering, and the truth table of
+ * the node in terms of the leafs, which is computed while merging the
+ * cuts of the fanins.  Hence no separate simulation step is required.
+ *
+ * The engine works on AIGs, MIGs, and XMGs through
+ * detail::priority_cuts_network_traits.  The last cut of every node is the
+ * trivial cut that only contains the node itself.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef CUTS_PRIORITY_HPP
+#define CUTS_PRIORITY_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <boost/range/iterator_range.hpp>
+
+#include <core/properties.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/aig.hpp>
+#include <classical/mig/mig.hpp>
+#include <classical/utils/static_truth_table.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+#include <classical/xmg/xmg.hpp>
+
+namespace cirkit
+{
+
+enum class priority_cut_cost { depth, area_flow, size };
+
+template<typename Ntk, unsigned MaxLeafs>
+class priority_cuts;
+
+template<unsigned MaxLeafs>
+class priority_cut final
+{
+public:
+  using value_type     = unsigned;
+  using iterator       = const unsigned*;
+  using const_iterator = const unsigned*;
+  using function_t     = static_tt<MaxLeafs>;
+
+  inline const_iterator begin() const { return _leafs.data(); }
+  inline const_iterator end() const   { return _leafs.data() + _size; }
+  inline unsigned size() const        { return _size; }
+  inline unsigned operator[]( unsigned i ) const { return _leafs[i]; }
+
+  inline uint64_t signature() const          { return _signature; }
+  inline const function_t& function() const { return _function; }
+  inline unsigned depth() const              { return _depth; }
+  inline float area_flow() const             { return _area_flow; }
+
+  /* truth table with 2^size() bits */
+  tt simulate() const
+  {
+    auto t = to_tt( _function );
+    tt_shrink( t, _size );
+    return t;
+  }
+
+  /* true, if the leafs of this cut are a subset of the leafs of other */
+  bool dominates( const priority_cut& other ) const
+  {
+    if ( _size > other._size || ( _signature & other._signature ) != _signature ) { return false; }
+
+    auto j = 0u;
+    for ( auto i = 0u; i < _size; ++i )
+    {
+      while ( j < other._size && other._leafs[j] < _leafs[i] ) { ++j; }
+      if ( j == other._size || other._leafs[j] != _leafs[i] ) { return false; }
+    }
+    return true;
+  }
+
+private:
+  template<typename, unsigned> friend class priority_cuts;
+
+  std::array<unsigned, MaxLeafs> _leafs;
+  unsigned                       _size = 0u;
+  uint64_t                       _signature = 0u;
+  function_t                     _function;
+  unsigned                       _depth = 0u;
+  float                          _area_flow = 0.0f;
+};
+
+namespace detail
+{
+
+/**
+ * Specializations provide the structure of the network as node indexes:
+ *
+ *   num_nodes( ntk ), topological_nodes( ntk ) (fanins first),
+ *   is_constant( ntk, n ), is_xor( ntk, n ), fanout_counts( ntk ), and
+ *   fanins( ntk, n, nodes, complements ) which returns the number of
+ *   fanins (0, 2, or 3); gates with two fanins are AND gates, unless
+ *   is_xor returns true, and gates with three fanins are MAJ gates.
+ */
+template<typename Ntk>
+struct priority_cuts_network_traits;
+
+template<>
+struct priority_cuts_network_traits<aig_graph>
+{
+  static unsigned num_nodes( const aig_graph& aig );
+  static std::vector<unsigned> topological_nodes( const aig_graph& aig );
+  static bool is_constant( const aig_graph& aig, unsigned n );
+  static inline bool is_xor( const aig_graph& aig, unsigned n ) { return false; }
+  static std::vector<unsigned> fanout_counts( const aig_graph& aig );
+  static unsigned fanins( const aig_graph& aig, unsigned n, unsigned* nodes, bool* complements );
+};
+
+template<>
+struct priority_cuts_network_traits<mig_graph>
+{
+  static unsigned num_nodes( const mig_graph& mig );
+  static std::vector<unsigned> topological_nodes( const mig_graph& mig );
+  static bool is_constant( const mig_graph& mig, unsigned n );
+  static inline bool is_xor( const mig_graph& mig, unsigned n ) { return false; }
+  static std::vector<unsigned> fanout_counts( const mig_graph& mig );
+  static unsigned fanins( const mig_graph& mig, unsigned n, unsigned* nodes, bool* complements );
+};
+
+template<>
+struct priority_cuts_network_traits<xmg_graph>
+{
+  static unsigned num_nodes( const xmg_graph& xmg );
+  static std::vector<unsigned> topological_nodes( const xmg_graph& xmg );
+  static bool is_constant( const xmg_graph& xmg, unsigned n );
+  static inline bool is_xor( const xmg_graph& xmg, unsigned n ) { return xmg.is_xor( n ); }
+  static std::vector<unsigned> fanout_counts( const xmg_graph& xmg );
+  static unsigned fanins( const xmg_graph& xmg, unsigned n, unsigned* nodes, bool* complements );
+};
+
+}
+
+/**
+ * Settings:
+ *   priority         (unsigned)          : maximum number of cuts per node without the trivial cut (8)
+ *   cost             (priority_cut_cost) : ranking of cuts (priority_cut_cost::depth)
+ *   minimize_support (bool)              : removes leafs the function does not depend on (false)
+ */
+template<typename Ntk, unsigned MaxLeafs = 6u>
+class priority_cuts final
+{
+public:
+  using network_traits = detail::priority_cuts_network_traits<Ntk>;
+  using cut            = priority_cut<MaxLeafs>;
+  using cut_range      = boost::iterator_range<const cut*>;
+
+  priority_cuts( const Ntk& ntk, unsigned k, const properties::ptr& settings = properties::ptr() )
+    : _ntk( ntk ),
+      _k( k )
+  {
+    _priority         = get( settings, "priority",         _priority );
+    _cost             = get( settings, "cost",             _cost );
+    _minimize_support = get( settings, "minimize_support", _minimize_support );
+
+    if ( _k > MaxLeafs )
+    {
+      throw "cut size exceeds the maximum number of leafs";
+    }
+    if ( _priority == 0u )
+    {
+      throw "priority must be at least 1";
+    }
+
+    enumerate();
+  }
+
+  inline unsigned total_cut_count() const { return _total_cut_count; }
+  inline double enumeration_time() const  { return _enumeration_time; }
+
+  unsigned memory() const
+  {
+    return _cuts.capacity() * sizeof( cut ) +
+      ( _count.capacity() + _depths.capacity() + _fanout.capacity() ) * sizeof( unsigned ) +
+      _area_flows.capacity() * sizeof( float );
+  }
+
+  inline unsigned count( unsigned node ) const { return _count[node]; }
+
+  inline cut_range cuts( unsigned node ) const
+  {
+    const auto* first = _cuts.data() + node * ( _priority + 1u );
+    return boost::make_iterator_range( first, first + _count[node] );
+  }
+
+  /* best cut according to the cost function, trivial cut for inputs */
+  inline const cut& best_cut( unsigned node ) const { return _cuts[node * ( _priority + 1u )]; }
+
+  /* depth and area flow of the best cut */
+  inline unsigned depth( unsigned node ) const   { return _depths[node]; }
+  inline float area_flow( unsigned node ) const  { return _area_flows[node]; }
+
+private:
+  void enumerate()
+  {
+    reference_timer t( &_enumeration_time );
+
+    const auto num_nodes = network_traits::num_nodes( _ntk );
+    _cuts.resize( num_nodes * ( _priority + 1u ) );
+    _count.assign( num_nodes, 0u );
+    _depths.assign( num_nodes, 0u );
+    _area_flows.assign( num_nodes, 0.0f );
+    _fanout = network_traits::fanout_counts( _ntk );
+    _local.reserve( _priority + 1u );
+
+    for ( auto n : network_traits::topological_nodes( _ntk ) )
+    {
+      unsigned nodes[3];
+      bool complements[3];
+      const auto num_fanins = network_traits::fanins( _ntk, n, nodes, complements );
+
+      if ( num_fanins == 0u )
+      {
+        auto& c = _cuts[n * ( _priority + 1u )];
+        if ( network_traits::is_constant( _ntk, n ) )
+        {
+          c = cut();
+        }
+        else
+        {
+          c = trivial_cut( n );
+        }
+        _count[n] = 1u;
+      }
+      else
+      {
+        if ( num_fanins > _k )
+        {
+          throw "cut size must be at least the number of fanins";
+        }
+        enumerate_node( n, num_fanins, nodes, complements );
+      }
+
+      _total_cut_count += _count[n];
+    }
+  }
+
+  void enumerate_node( unsigned n, unsigned num_fanins, const unsigned* nodes, const bool* complements )
+  {
+    _local.clear();
+
+    const auto r0 = cuts( nodes[0u] );
+    const auto r1 = cuts( nodes[1u] );
+
+    cut c01;
+    for ( const auto& c0 : r0 )
+    {
+      for ( const auto& c1 : r1 )
+      {
+        if ( !merge_leafs( c0, c1, c01 ) ) { continue; }
+
+        if ( num_fanins == 2u )
+        {
+          const cut* fanin_cuts[] = {&c0, &c1};
+          add_cut( n, c01, num_fanins, fanin_cuts, complements );
+        }
+        else
+        {
+          cut c012;
+          for ( const auto& c2 : cuts( nodes[2u] ) )
+          {
+            if ( !merge_leafs( c01, c2, c012 ) ) { continue; }
+
+            const cut* fanin_cuts[] = {&c0, &c1, &c2};
+            add_cut( n, c012, num_fanins, fanin_cuts, complements );
+          }
+        }
+      }
+    }
+
+    assert( !_local.empty() );
+
+    _depths[n] = _local.front()._depth;
+    _area_flows[n] = _local.front()._area_flow / std::max( 1u, _fanout[n] );
+
+    auto* first = &_cuts[n * ( _priority + 1u )];
+    std::copy( _local.begin(), _local.end(), first );
+    first[_local.size()] = trivial_cut( n );
+    _count[n] = _local.size() + 1u;
+  }
+
+  /* merges leafs and signatures, returns false if the cut gets too large */
+  bool merge_leafs( const cut& c1, const cut& c2, cut& res ) const
+  {
+    res._signature = c1._signature | c2._signature;
+    if ( __builtin_popcountll( res._signature ) > static_cast<int>( _k ) ) { return false; }
+
+    auto i = 0u, j = 0u, k = 0u;
+    while ( i < c1._size || j < c2._size )
+    {
+      if ( k == _k ) { return false; }
+
+      if ( j == c2._size || ( i < c1._size && c1._leafs[i] < c2._leafs[j] ) )
+      {
+        res._leafs[k++] = c1._leafs[i++];
+      }
+      else if ( i == c1._size || c2._leafs[j] < c1._leafs[i] )
+      {
+        res._leafs[k++] = c2._leafs[j++];
+      }
+      else
+      {
+        res._leafs[k++] = c1._leafs[i++];
+        ++j;
+      }
+    }
+    res._size = k;
+    return true;
+  }
+
+  void add_cut( unsigned n, cut& c, unsigned num_fanins, const cut* const* fanin_cuts, const bool* complements )
+  {
+    if ( _minimize_support )
+    {
+      compute_function( n, c, num_fanins, fanin_cuts, complements );
+      minimize_support( c );
+    }
+    compute_costs( c );
+
+    /* dominated by (or equal to) a cut we already have? */
+    for ( const auto& other : _local )
+    {
+      if ( other.dominates( c ) ) { return; }
+    }
+
+    if ( _local.size() == _priority && !is_better( c, _local.back() ) ) { return; }
+
+    if ( !_minimize_support )
+    {
+      compute_function( n, c, num_fanins, fanin_cuts, complements );
+    }
+
+    /* remove cuts that are dominated by the new one */
+    _local.erase( std::remove_if( _local.begin(), _local.end(), [&c]( const cut& other ) { return c.dominates( other ); } ), _local.end() );
+
+    const auto it = std::upper_bound( _local.begin(), _local.end(), c, [this]( const cut& a, const cut& b ) { return is_better( a, b ); } );
+    _local.insert( it, c );
+    if ( _local.size() > _priority )
+    {
+      _local.pop_back();
+    }
+  }
+
+  void compute_costs( cut& c ) const
+  {
+    c._depth = 0u;
+    c._area_flow = 1.0f;
+    for ( auto i = 0u; i < c._size; ++i )
+    {
+      c._depth = std::max( c._depth, _depths[c._leafs[i]] );
+      c._area_flow += _area_flows[c._leafs[i]];
+    }
+    ++c._depth;
+  }
+
+  /* computes the function of c from the functions of the fanin cuts */
+  void compute_function( unsigned n, cut& c, unsigned num_fanins, const cut* const* fanin_cuts, const bool* complements ) const
+  {
+    typename cut::function_t fs[3];
+
+    for ( auto i = 0u; i < num_fanins; ++i )
+    {
+      fs[i] = expand_function( *fanin_cuts[i], c );
+      if ( complements[i] )
+      {
+        fs[i].flip();
+      }
+    }
+
+    if ( num_fanins == 3u )
+    {
+      c._function = ( fs[0u] & fs[1u] ) | ( fs[0u] & fs[2u] ) | ( fs[1u] & fs[2u] );
+    }
+    else if ( network_traits::is_xor( _ntk, n ) )
+    {
+      c._function = fs[0u] ^ fs[1u];
+    }
+    else
+    {
+      c._function = fs[0u] & fs[1u];
+    }
+  }
+
+  /* moves the variables of the function of sub to the positions of its leafs in super */
+  static typename cut::function_t expand_function( const cut& sub, const cut& super )
+  {
+    auto f = sub._function;
+    if ( sub._size == super._size ) { return f; }
+
+    unsigned pos[MaxLeafs];
+    auto j = 0u;
+    for ( auto i = 0u; i < sub._size; ++i )
+    {
+      while ( super._leafs[j] != sub._leafs[i] ) { ++j; }
+      pos[i] = j;
+    }
+
+    for ( int i = static_cast<int>( sub._size ) - 1; i >= 0; --i )
+    {
+      if ( pos[i] != static_cast<unsigned>( i ) )
+      {
+        f.swap( i, pos[i] );
+      }
+    }
+    return f;
+  }
+
+  void minimize_support( cut& c ) const
+  {
+    auto i = 0u;
+    while ( i < c._size )
+    {
+      if ( c._function.has_var( i ) )
+      {
+        ++i;
+        continue;
+      }
+
+      for ( auto j = i + 1u; j < c._size; ++j )
+      {
+        c._function.swap( j - 1u, j );
+        c._leafs[j - 1u] = c._leafs[j];
+      }
+      --c._size;
+    }
+
+    c._signature = 0u;
+    for ( auto i = 0u; i < c._size; ++i )
+    {
+      c._signature |= UINT64_C( 1 ) << ( c._leafs[i] & 63u );
+    }
+  }
+
+  bool is_better( const cut& a, const cut& b ) const
+  {
+    switch ( _cost )
+    {
+    case priority_cut_cost::depth:
+      if ( a._depth != b._depth ) { return a._depth < b._depth; }
+      if ( a._size != b._size ) { return a._size < b._size; }
+      return a._area_flow < b._area_flow;
+    case priority_cut_cost::area_flow:
+      if ( a._area_flow != b._area_flow ) { return a._area_flow < b._area_flow; }
+      if ( a._depth != b._depth ) { return a._depth < b._depth; }
+      return a._size < b._size;
+    case priority_cut_cost::size:
+      if ( a._size != b._size ) { return a._size < b._size; }
+      if ( a._depth != b._depth ) { return a._depth < b._depth; }
+      return a._area_flow < b._area_flow;
+    }
+    return false;
+  }
+
+  cut trivial_cut( unsigned n ) const
+  {
+    cut c;
+    c._leafs[0u] = n;
+    c._size = 1u;
+    c._signature = UINT64_C( 1 ) << ( n & 63u );
+    c._function = cut::function_t::nth_var( 0u );
+    c._depth = _depths[n];
+    c._area_flow = _area_flows[n];
+    return c;
+  }
+
+private:
+  const Ntk&            _ntk;
+  unsigned              _k;
+  unsigned              _priority = 8u;
+  priority_cut_cost     _cost = priority_cut_cost::depth;
+  bool                  _minimize_support = false;
+
+  std::vector<cut>      _cuts;       /* ( _priority + 1 ) slots per node */
+  std::vector<unsigned> _count;
+  std::vector<unsigned> _depths;
+  std::vector<float>    _area_flows;
+  std::vector<unsigned> _fanout;
+  std::vector<cut>      _local;      /* cuts of the current node */
+
+  unsigned              _total_cut_count = 0u;
+  double                _enumeration_time = 0.0;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
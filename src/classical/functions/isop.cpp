@@ -33,15 +33,24 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
-/******************************************************************************
- * Private functions                                                          *
- ******************************************************************************/
+struct isop_static_fn
+{
+  const tt& on;
+  const tt& ondc;
+  std::vector<int>& cover;
+
+  template<unsigned N>
+  tt run() const
+  {
+    return to_tt( tt_isop( to_static_tt<N>( on ), to_static_tt<N>( ondc ), cover ) );
+  }
+};
 
 /******************************************************************************
- * Public functions                                                           *
+ * Private functions                                                          *
  ******************************************************************************/
 
-tt tt_isop( const tt& on, const tt& ondc, std::vector<int>& cover )
+tt tt_isop_dynamic( const tt& on, const tt& ondc, std::vector<int>& cover )
 {
   assert( on.size() == ondc.size() );
   assert( ( on & ~ondc ).none() );
@@ -71,11 +80,11 @@ tt tt_isop( const tt& on, const tt& ondc, std::vector<int>& cover )
   auto ondc1 = tt_cof1( ondc, var ); tt_shrink( ondc1, num_vars );
 
   auto beg0 = cover.size();
-  auto res0 = tt_isop( on0 & ~ondc1, ondc0, cover );
+  auto res0 = tt_isop_dynamic( on0 & ~ondc1, ondc0, cover );
   auto end0 = cover.size();
-  auto res1 = tt_isop( on1 & ~ondc0, ondc1, cover );
+  auto res1 = tt_isop_dynamic( on1 & ~ondc0, ondc1, cover );
   auto end1 = cover.size();
-  auto res2 = tt_isop( ( on0 & ~res0 ) | ( on1 & ~res1 ), ondc0 & ondc1, cover );
+  auto res2 = tt_isop_dynamic( ( on0 & ~res0 ) | ( on1 & ~res1 ), ondc0 & ondc1, cover );
 
   auto tv = tt_nth_var( var );
   if ( num_vars < 6u )
@@ -103,6 +112,23 @@ tt tt_isop( const tt& on, const tt& ondc, std::vector<int>& cover )
   return res2;
 }
 
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+tt tt_isop( const tt& on, const tt& ondc, std::vector<int>& cover )
+{
+  assert( on.size() == ondc.size() );
+
+  const auto num_vars = tt_num_vars( on );
+  if ( num_vars <= 16u )
+  {
+    return static_tt_dispatch( num_vars, isop_static_fn{on, ondc, cover} );
+  }
+
+  return tt_isop_dynamic( on, ondc, cover );
+}
+
 std::vector<int> tt_cnf( const tt& f )
 {
   std::vector<int> cover;
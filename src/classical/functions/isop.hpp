@@ -39,6 +39,7 @@
 #include <vector>
 
 #include <core/cube.hpp>
+#include <classical/utils/static_truth_table.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 
 namespace cirkit
@@ -47,6 +48,61 @@ namespace cirkit
 /* based on ABC's Abc_Tt6IsopCover */
 tt tt_isop( const tt& on, const tt& ondc, std::vector<int>& cover );
 
+/* same as above on static truth tables, top is the largest variable that may be in the support */
+template<unsigned N>
+static_tt<N> tt_isop( const static_tt<N>& on, const static_tt<N>& ondc, std::vector<int>& cover, int top = static_cast<int>( N ) - 1 )
+{
+  assert( ( on & ~ondc ).none() );
+
+  /* terminal cases */
+  if ( on.none() ) { return on; }
+  if ( ondc.all() )
+  {
+    cover.push_back( 0 );
+    return ondc;
+  }
+
+  int var = top;
+  for ( ; var >= 0; --var )
+  {
+    if ( on.has_var( var ) || ondc.has_var( var ) )
+    {
+      break;
+    }
+  }
+  assert( var >= 0 );
+
+  const auto on0   = tt_cof0( on, var );
+  const auto on1   = tt_cof1( on, var );
+  const auto ondc0 = tt_cof0( ondc, var );
+  const auto ondc1 = tt_cof1( ondc, var );
+
+  /* cofactors do not depend on var and above */
+  auto beg0 = cover.size();
+  auto res0 = tt_isop( on0 & ~ondc1, ondc0, cover, var - 1 );
+  auto end0 = cover.size();
+  auto res1 = tt_isop( on1 & ~ondc0, ondc1, cover, var - 1 );
+  auto end1 = cover.size();
+  auto res2 = tt_isop( ( on0 & ~res0 ) | ( on1 & ~res1 ), ondc0 & ondc1, cover, var - 1 );
+
+  const auto tv = static_tt<N>::nth_var( var );
+  res2 |= ( res0 & ~tv ) | ( res1 & tv );
+
+  for ( auto c = beg0; c < end0; ++c )
+  {
+    cover[c] |= 1u << ( var << 1u );
+  }
+  for ( auto c = end0; c < end1; ++c )
+  {
+    cover[c] |= 1u << ( ( var << 1u ) + 1 );
+  }
+
+  assert( ( on & ~res2 ).none() );
+  assert( ( res2 & ~ondc ).none() );
+
+  return res2;
+}
+
 /* based on ABC's Abc_Tt6Cnf */
 std::vector<int> tt_cnf( const tt& f );
 void tt_cnf( const tt& f, std::vector<int>& cover );
@@ -35,8 +35,10 @@
 #include <boost/range/algorithm_ext/iota.hpp>
 
 #include <core/utils/range_utils.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/abc/abc_api.hpp>
+#include <classical/utils/static_truth_table.hpp>
 
 #include <misc/util/utilTruth.h>
 #include <bool/lucky/lucky.h>
@@ -48,10 +50,37 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+/* x_i as 64-bit truth table */
+const uint64_t npn6_var_masks[] = {
+  UINT64_C( 0xaaaaaaaaaaaaaaaa ), UINT64_C( 0xcccccccccccccccc ), UINT64_C( 0xf0f0f0f0f0f0f0f0 ),
+  UINT64_C( 0xff00ff00ff00ff00 ), UINT64_C( 0xffff0000ffff0000 ), UINT64_C( 0xffffffff00000000 )
+};
+
+/* swapping x_i and x_{i+1}: bits that stay, bits that move up, bits that move down */
+const uint64_t npn6_swap_masks[][3] = {
+  { UINT64_C( 0x9999999999999999 ), UINT64_C( 0x2222222222222222 ), UINT64_C( 0x4444444444444444 ) },
+  { UINT64_C( 0xc3c3c3c3c3c3c3c3 ), UINT64_C( 0x0c0c0c0c0c0c0c0c ), UINT64_C( 0x3030303030303030 ) },
+  { UINT64_C( 0xf00ff00ff00ff00f ), UINT64_C( 0x00f000f000f000f0 ), UINT64_C( 0x0f000f000f000f00 ) },
+  { UINT64_C( 0xff0000ffff0000ff ), UINT64_C( 0x0000ff000000ff00 ), UINT64_C( 0x00ff000000ff0000 ) },
+  { UINT64_C( 0xffff00000000ffff ), UINT64_C( 0x00000000ffff0000 ), UINT64_C( 0x0000ffff00000000 ) }
+};
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
+inline uint64_t npn6_flip( uint64_t t, unsigned i )
+{
+  const auto s = 1u << i;
+  return ( ( t & npn6_var_masks[i] ) >> s ) | ( ( t & ~npn6_var_masks[i] ) << s );
+}
+
+inline uint64_t npn6_swap_adjacent( uint64_t t, unsigned i )
+{
+  const auto s = 1u << i;
+  return ( t & npn6_swap_masks[i][0] ) | ( ( t & npn6_swap_masks[i][1] ) << s ) | ( ( t & npn6_swap_masks[i][2] ) >> s );
+}
+
 std::vector<unsigned> compute_swaps( unsigned n )
 {
   const unsigned N = static_cast<unsigned>( boost::math::factorial<double>( n ) );
@@ -113,7 +142,8 @@ inline void bitset_swap( boost::dynamic_bitset<>& bs, unsigned i, unsigned j )
   bs[j] = t;
 }
 
-void npn_canonization_sifting_loop( tt& npn, unsigned n, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+template<typename TT>
+void npn_canonization_sifting_loop( TT& npn, unsigned n, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
 {
   auto improvement = true;
   auto forward = true;
@@ -177,6 +207,176 @@ void npn_canonization_sifting_loop( tt& npn, unsigned n, boost::dynamic_bitset<>
   }
 }
 
+struct npn_heuristic_impl
+{
+  template<typename TT>
+  static void run( TT& npn, unsigned n, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+  {
+    auto old_count = npn.size() + 1u;
+
+    while ( old_count != npn.count() )
+    {
+      old_count = npn.count();
+
+      /* output negation */
+      if ( npn.count() > ( npn.size() >> 1u ) )
+      {
+        phase.flip( n );
+        npn.flip();
+      }
+
+      /* input negation */
+      for ( unsigned i = 0u; i < n; ++i )
+      {
+        if ( tt_cof1( npn, i ).count() > tt_cof0( npn, i ).count() )
+        {
+          phase.flip( i );
+          npn = tt_flip( npn, i );
+        }
+      }
+
+      /* permute inputs */
+      for ( unsigned d = 1u; d < n - 1; ++d )
+      {
+        for ( unsigned i = 0u; i < n - d; ++i )
+        {
+          unsigned j = i + d;
+
+          if ( tt_cof1( npn, i ).count() > tt_cof1( npn, j ).count() )
+          {
+            npn = tt_permute( npn, i, j );
+            std::swap( perm[i], perm[j] );
+          }
+        }
+      }
+    }
+  }
+};
+
+struct npn_flip_swap_impl
+{
+  template<typename TT>
+  static void run( TT& npn, unsigned n, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+  {
+    auto improvement = true;
+
+    while ( improvement )
+    {
+      improvement = false;
+
+      /* input inversion */
+      for ( auto i = 0u; i < n; ++i )
+      {
+        const auto flipped = tt_flip( npn, i );
+        if ( flipped < npn )
+        {
+          npn = flipped;
+          phase.flip( i );
+          improvement = true;
+        }
+      }
+
+      /* output inversion */
+      const auto flipped = ~npn;
+      if ( flipped < npn )
+      {
+        npn = flipped;
+        phase.flip( n );
+        improvement = true;
+      }
+
+      /* permute inputs */
+      for ( auto d = 1u; d < n - 1; ++d )
+      {
+        for ( auto i = 0u; i < n - d; ++i )
+        {
+          auto j = i + d;
+
+          const auto permuted = tt_permute( npn, i, j );
+          if ( permuted < npn )
+          {
+            npn = permuted;
+            std::swap( perm[i], perm[j] );
+            bitset_swap( phase, i, j );
+            improvement = true;
+          }
+        }
+      }
+    }
+  }
+};
+
+struct npn_sifting_impl
+{
+  template<typename TT>
+  static void run( TT& npn, unsigned n, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+  {
+    if ( n < 2u )
+    {
+      return;
+    }
+
+    const auto t = npn;
+
+    npn_canonization_sifting_loop( npn, n, phase, perm );
+
+    const auto best_perm = perm;
+    const auto best_phase = phase;
+    const auto best_npn = npn;
+
+    npn = ~t;
+    phase.reset();
+    phase.flip( n );
+    boost::iota( perm, 0u );
+
+    npn_canonization_sifting_loop( npn, n, phase, perm );
+
+    if ( best_npn < npn )
+    {
+      perm = best_perm;
+      phase = best_phase;
+      npn = best_npn;
+    }
+  }
+};
+
+template<typename Impl>
+struct npn_static_fn
+{
+  const tt& t;
+  boost::dynamic_bitset<>& phase;
+  std::vector<unsigned>& perm;
+
+  template<unsigned N>
+  tt run() const
+  {
+    auto npn = to_static_tt<N>( t );
+    Impl::run( npn, N, phase, perm );
+    return to_tt( npn );
+  }
+};
+
+/* functions with up to 16 variables are canonized on static truth tables */
+template<typename Impl>
+tt npn_canonization_generic( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+{
+  /* initialize */
+  auto n = tt_num_vars( t );
+  phase.resize( n + 1u );
+  phase.reset();
+  perm.resize( n );
+  boost::iota( perm, 0u );
+
+  if ( n <= 16u )
+  {
+    return static_tt_dispatch( n, npn_static_fn<Impl>{t, phase, perm} );
+  }
+
+  tt npn = t;
+  Impl::run( npn, n, phase, perm );
+  return npn;
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -277,186 +477,151 @@ tt exact_npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vec
   return min;
 }
 
-tt npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
+uint64_t exact_npn_canonization6( uint64_t func, unsigned num_vars, unsigned& phase, std::array<unsigned char, 6u>& perm )
 {
-  properties_timer tim( statistics );
-
-  typedef tt::size_type size_type;
-
-  /* initialize */
-  auto n = tt_num_vars( t );
-  phase.resize( n + 1u );
-  phase.reset();
-  perm.resize( n );
-  boost::iota( perm, 0u );
-
-  tt npn = t;
+  if ( num_vars > 6u )
+  {
+    throw "Error: 64-bit NPN canonization supports at most 6 variables";
+  }
 
-  auto old_count = npn.size() + 1u;
+  const auto mask = num_vars == 6u ? ~UINT64_C( 0 ) : ( UINT64_C( 1 ) << ( 1u << num_vars ) ) - 1u;
+  func &= mask;
 
-  while ( old_count != npn.count() )
+  /* flipping x_i does not change { f, ~f }, if the cofactors w.r.t. x_i are
+     equal or complementary, such variables are not flipped */
+  unsigned vars[6u];
+  auto num_flip_vars = 0u;
+  for ( auto i = 0u; i < num_vars; ++i )
   {
-    old_count = npn.count();
-
-    /* output negation */
-    if ( npn.count() > ( npn.size() >> (size_type)1 ) )
+    const auto cof0 = func & ~npn6_var_masks[i];
+    const auto cof1 = ( func & npn6_var_masks[i] ) >> ( 1u << i );
+    if ( cof0 != cof1 && cof0 != ( ~cof1 & ~npn6_var_masks[i] & mask ) )
     {
-      phase.flip( n );
-      npn.flip();
+      vars[num_flip_vars++] = i;
     }
+  }
+
+  /* current transformation */
+  auto t1 = func;
+  auto t2 = ~func & mask;
+  auto cur_phase = 0u;
+  std::array<unsigned char, 6u> cur_perm = {{0u, 1u, 2u, 3u, 4u, 5u}};
+
+  /* best transformation */
+  auto best = t1;
+  phase = 0u;
+  perm = cur_perm;
 
-    /* input negation */
-    for ( unsigned i = 0u; i < n; ++i )
+  const auto update = [&]() {
+    if ( t1 < best )
     {
-      if ( tt_cof1( npn, i ).count() > tt_cof0( npn, i ).count() )
-      {
-        phase.flip( i );
-        npn = tt_flip( npn, i );
-      }
+      best = t1;
+      phase = cur_phase;
+      perm = cur_perm;
     }
-
-    /* permute inputs */
-    for ( unsigned d = 1u; d < n - 1; ++d )
+    if ( t2 < best )
     {
-      for ( unsigned i = 0u; i < n - d; ++i )
-      {
-        unsigned j = i + d;
-
-        if ( tt_cof1( npn, i ).count() > tt_cof1( npn, j ).count() )
-        {
-          npn = tt_permute( npn, i, j );
-          std::swap( perm[i], perm[j] );
-        }
-      }
+      best = t2;
+      phase = cur_phase | ( 1u << num_vars );
+      perm = cur_perm;
     }
-  }
+  };
 
-  if ( tt_num_vars( npn ) > n )
-  {
-    tt_shrink( npn, n );
-  }
+  update();
 
-  return npn;
-}
-
-tt npn_canonization_flip_swap( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
-{
-  properties_timer tim( statistics );
-
-  /* initialize */
-  auto n = tt_num_vars( t );
-  phase.resize( n + 1u );
-  phase.reset();
-  perm.resize( n );
-  boost::iota( perm, 0u );
+  /* Gray code over input phases, for each phase all permutations by
+     adjacent swaps (the swaps end one swap of x_0 and x_1 away from the
+     identity) */
+  const auto* swaps = num_vars >= 2u ? &tt_store::i().swaps( num_vars ) : nullptr;
 
-  tt npn = t;
-
-  auto improvement = true;
-
-  //auto round = 0u;
-
-  while ( improvement )
+  for ( auto g = 0u; g < ( 1u << num_flip_vars ); ++g )
   {
-    //std::cout << "[i] round " << ++round << std::endl;
-
-    improvement = false;
-
-    /* input inversion */
-    for ( auto i = 0u; i < n; ++i )
+    if ( g != 0u )
     {
-      const auto flipped = tt_flip( npn, i );
-      if ( flipped < npn )
-      {
-        //std::cout << "[i]   flip input " << i << std::endl;
-        npn = flipped;
-        phase.flip( i );
-        improvement = true;
-      }
+      const auto v = vars[__builtin_ctz( g )];
+      t1 = npn6_flip( t1, v );
+      t2 = npn6_flip( t2, v );
+      cur_phase ^= 1u << v;
+      update();
     }
 
-    /* output inversion */
-    const auto flipped = ~npn;
-    if ( flipped < npn )
-    {
-      //std::cout << "[i]   flip output" << std::endl;
-      npn = flipped;
-      phase.flip( n );
-      improvement = true;
-    }
+    if ( !swaps ) { continue; }
 
-    /* permute inputs */
-    for ( auto d = 1u; d < n - 1; ++d )
+    for ( int i = swaps->size() - 1; i >= 0; --i )
     {
-      for ( auto i = 0u; i < n - d; ++i )
-      {
-        auto j = i + d;
-
-        const auto permuted = tt_permute( npn, i, j );
-        if ( permuted < npn )
-        {
-          //std::cout << "[i]   swap inputs " << i << " and " << j << std::endl;
-          npn = permuted;
-          std::swap( perm[i], perm[j] );
-          bitset_swap( phase, i, j );
-          improvement = true;
-        }
-      }
+      const auto pos = ( *swaps )[i];
+      t1 = npn6_swap_adjacent( t1, pos );
+      t2 = npn6_swap_adjacent( t2, pos );
+      std::swap( cur_perm[pos], cur_perm[pos + 1u] );
+      update();
     }
+
+    t1 = npn6_swap_adjacent( t1, 0u );
+    t2 = npn6_swap_adjacent( t2, 0u );
+    std::swap( cur_perm[0u], cur_perm[1u] );
   }
 
-  if ( tt_num_vars( npn ) > n )
+  return best;
+}
+
+void exact_npn_canonization6_batch( const std::vector<uint64_t>& funcs, unsigned num_vars,
+                                    std::vector<uint64_t>& npns, std::vector<unsigned>& phases,
+                                    std::vector<std::array<unsigned char, 6u>>& perms,
+                                    unsigned num_threads )
+{
+  if ( num_vars > 6u )
   {
-    tt_shrink( npn, n );
+    throw "Error: 64-bit NPN canonization supports at most 6 variables";
   }
 
-  return npn;
+  npns.resize( funcs.size() );
+  phases.resize( funcs.size() );
+  perms.resize( funcs.size() );
+
+  /* swaps are shared by all threads, make sure they are initialized */
+  tt_store::i();
+
+  thread_pool pool( num_threads == 0u ? std::max( 1u, std::thread::hardware_concurrency() ) : num_threads );
+  pool.parallel_for( std::size_t( 0u ), funcs.size(), [&]( std::size_t i ) {
+      npns[i] = exact_npn_canonization6( funcs[i], num_vars, phases[i], perms[i] );
+    } );
 }
 
-tt npn_canonization_sifting( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
+tt exact_npn_canonization_fast( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
 {
   properties_timer tim( statistics );
 
-  /* initialize */
-  auto n = tt_num_vars( t );
-  phase.resize( n + 1u );
-  phase.reset();
-  perm.resize( n );
-  boost::iota( perm, 0u );
+  const auto n = tt_num_vars( t );
 
-  tt npn = t;
+  unsigned npn_phase;
+  std::array<unsigned char, 6u> npn_perm;
+  const auto npn = exact_npn_canonization6( t.to_ulong(), n, npn_phase, npn_perm );
 
-  if ( n < 2u )
-  {
-    return npn;
-  }
+  phase = boost::dynamic_bitset<>( n + 1u, npn_phase );
+  perm.assign( npn_perm.begin(), npn_perm.begin() + n );
 
-  npn_canonization_sifting_loop( npn, n, phase, perm );
+  return tt( t.size(), npn );
+}
 
-  const auto best_perm = perm;
-  const auto best_phase = phase;
-  const auto best_npn = npn;
+tt npn_canonization( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  properties_timer tim( statistics );
 
-  npn = ~t;
-  phase.reset();
-  phase.flip( n );
-  boost::iota( perm, 0u );
+  return npn_canonization_generic<npn_heuristic_impl>( t, phase, perm );
+}
 
-  npn_canonization_sifting_loop( npn, n, phase, perm );
+tt npn_canonization_flip_swap( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  properties_timer tim( statistics );
 
-  if ( best_npn < npn )
-  {
-    perm = best_perm;
-    phase = best_phase;
-    npn = best_npn;
-  }
+  return npn_canonization_generic<npn_flip_swap_impl>( t, phase, perm );
+}
 
-  if ( tt_num_vars( npn ) > n )
-  {
-    tt_shrink( npn, n );
-  }
+tt npn_canonization_sifting( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  properties_timer tim( statistics );
 
-  return npn;
+  return npn_canonization_generic<npn_sifting_impl>( t, phase, perm );
 }
 
 tt tt_from_npn( const tt& npn, const boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
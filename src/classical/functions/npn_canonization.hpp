@@ -36,6 +36,10 @@
 #ifndef NPN_CANONIZATION_HPP
 #define NPN_CANONIZATION_HPP
 
+#include <array>
+#include <cstdint>
+#include <vector>
+
 #include <boost/dynamic_bitset.hpp>
 
 #include <core/properties.hpp>
@@ -64,6 +68,32 @@ tt npn_canonization_sifting( const tt& t, boost::dynamic_bitset<>& phase,
                              const properties::ptr& settings = properties::ptr(),
                              const properties::ptr& statistics = properties::ptr() );
 
+/**
+ * @brief Exact NPN canonization on 64-bit truth tables (at most 6 variables)
+ *
+ * Computes the same representative as exact_npn_canonization, phase and
+ * perm follow the same convention (bit num_vars of phase is the output
+ * phase).  Bits of func above 2^num_vars are ignored.  Throws a string
+ * if num_vars is larger than 6.
+ */
+uint64_t exact_npn_canonization6( uint64_t func, unsigned num_vars, unsigned& phase, std::array<unsigned char, 6u>& perm );
+
+/**
+ * @brief Canonizes many functions with the same number of variables at once
+ *
+ * Uses num_threads threads, or one thread per core if num_threads is 0.
+ */
+void exact_npn_canonization6_batch( const std::vector<uint64_t>& funcs, unsigned num_vars,
+                                    std::vector<uint64_t>& npns, std::vector<unsigned>& phases,
+                                    std::vector<std::array<unsigned char, 6u>>& perms,
+                                    unsigned num_threads = 0u );
+
+/* same interface as exact_npn_canonization, based on exact_npn_canonization6 */
+tt exact_npn_canonization_fast( const tt& t, boost::dynamic_bitset<>& phase,
+                                std::vector<unsigned>& perm,
+                                const properties::ptr& settings = properties::ptr(),
+                                const properties::ptr& statistics = properties::ptr() );
+
 tt tt_from_npn( const tt& npn, const boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
 
 /* ABC methods */
@@ -36,103 +36,191 @@
 #ifndef PARALLEL_COMPUTE_HPP
 #define PARALLEL_COMPUTE_HPP
 
-#include <condition_variable>
 #include <functional>
 #include <iostream>
-#include <mutex>
-#include <thread>
 #include <vector>
 
 #include <boost/dynamic_bitset.hpp>
-#include <boost/graph/topological_sort.hpp>
+#include <boost/range/iterator_range.hpp>
 
+#include <core/utils/parallel_dag.hpp>
 #include <classical/aig.hpp>
+#include <classical/mig/mig.hpp>
 #include <classical/utils/aig_utils.hpp>
+#include <classical/xmg/xmg.hpp>
 
 namespace cirkit
 {
 
+/******************************************************************************
+ * Scheduling                                                                 *
+ ******************************************************************************/
+
+/* edges in AIG, MIG, and XMG graphs point from a gate to its children */
+template<typename Graph>
+dag_schedule make_dag_schedule( const Graph& g )
+{
+  dag_schedule schedule( num_vertices( g ) );
+  for ( const auto& e : boost::make_iterator_range( edges( g ) ) )
+  {
+    schedule.add_edge( target( e, g ), source( e, g ) );
+  }
+  schedule.finalize();
+  return schedule;
+}
+
+namespace detail
+{
+
+/* wrapper such that std::vector<bool> does not pack concurrently written values */
+template<typename T>
+struct parallel_value
+{
+  T value;
+};
+
+template<typename T>
+void copy_parallel_values( const std::vector<parallel_value<T>>& values, std::vector<T>& computed_values )
+{
+  computed_values.clear();
+  computed_values.reserve( values.size() );
+  for ( const auto& v : values )
+  {
+    computed_values.push_back( v.value );
+  }
+}
+
+}
+
+/******************************************************************************
+ * AIG                                                                        *
+ ******************************************************************************/
+
+/**
+ * @brief Computes values for all AIG nodes in parallel
+ *
+ * Each node is processed once all its children are computed, using a
+ * fixed number of worker threads (0 means number of cores).  Callbacks
+ * are called concurrently and must therefore be thread-safe.
+ */
 template<typename T>
 void parallel_compute(
     const aig_graph& aig, const T& constant_result,
     const std::function<T( unsigned )>& on_input,
     const std::function<T( const T&, bool, const T&, bool )>& on_and,
-    std::vector<T>& computed_values )
+    std::vector<T>& computed_values,
+    unsigned num_threads = 0u )
 {
-  /* topological order */
-  std::vector<aig_node> topsort( num_vertices( aig ) );
-  boost::topological_sort( aig, topsort.begin() );
-
   const auto& info = aig_info( aig );
 
-  computed_values.resize( num_vertices( aig ) );
-  boost::dynamic_bitset<>              computed( num_vertices( aig ) );
-  std::mutex                           vector_mutex;
-  std::vector<std::thread>             workers;
-  std::vector<std::condition_variable> guards( num_vertices( aig ) );
-  std::vector<std::mutex>              guard_locks( num_vertices( aig ) );
-  computed.set( 0u );
-  computed_values[0u] = constant_result;
-
-  for ( auto n : topsort )
+  /* input indexes, computed in advance to avoid a search in each worker */
+  std::vector<unsigned> input_index( num_vertices( aig ), 0u );
+  for ( auto i = 0u; i < info.inputs.size(); ++i )
   {
-    /* primary input */
-    if ( out_degree( n, aig ) == 0u )
-    {
-      if ( n == 0u ) { continue; }
-
-      const auto index = aig_input_index( info, n );
-      workers.emplace_back( [&vector_mutex, &computed_values, &computed, n, &on_input, index, &guards, &guard_locks]() {
-          const auto v = on_input( index );
-          vector_mutex.lock();
-          computed_values[n] = v;
-          computed.set( n );
-          vector_mutex.unlock();
-
-          std::unique_lock<std::mutex> lck( guard_locks[n] );
-          guards[n].notify_all();
-        } );
-    }
-    else
-    {
-      const auto children = get_children( aig, n );
-
-      workers.emplace_back( [&vector_mutex, &computed_values, &computed, n, &on_and, children, &guards, &guard_locks]() {
-          {
-            std::unique_lock<std::mutex> lck( guard_locks[children[0].node] );
-            while ( !computed[children[0].node] ) { guards[children[0].node].wait( lck ); }
-          }
-          {
-            std::unique_lock<std::mutex> lck( guard_locks[children[1].node] );
-            while ( !computed[children[1].node] ) { guards[children[1].node].wait( lck ); }
-          }
-
-          const auto v = on_and( computed_values[children[0].node], children[0].complemented,
-                                 computed_values[children[1].node], children[1].complemented );
-          vector_mutex.lock();
-          computed_values[n] = v;
-          computed.set( n );
-          vector_mutex.unlock();
-
-          std::unique_lock<std::mutex> lck( guard_locks[n] );
-          guards[n].notify_all();
-        } );
-    }
+    input_index[info.inputs[i]] = i;
   }
 
-  for ( auto& worker : workers )
-  {
-    worker.join();
-  }
+  std::vector<detail::parallel_value<T>> values( num_vertices( aig ) );
+
+  parallel_dag_process( make_dag_schedule( aig ), [&]( unsigned n ) {
+      if ( out_degree( n, aig ) == 0u )
+      {
+        values[n].value = ( n == info.constant ) ? constant_result : on_input( input_index[n] );
+      }
+      else
+      {
+        const auto it = out_edges( n, aig ).first;
+        const auto left = aig_to_function( aig, *it ), right = aig_to_function( aig, *( it + 1 ) );
+        values[n].value = on_and( values[left.node].value, left.complemented, values[right.node].value, right.complemented );
+      }
+    }, num_threads );
+
+  detail::copy_parallel_values( values, computed_values );
 }
 
 void parallel_process(
     const aig_graph& aig,
     const std::function<void( aig_node )>& on_input,
-    const std::function<void( aig_node, const aig_function&, const aig_function& )>& on_and );
+    const std::function<void( aig_node, const aig_function&, const aig_function& )>& on_and,
+    unsigned num_threads = 0u );
 
 /* this is a usage demo */
-void parallel_simulate( const aig_graph& aig, const boost::dynamic_bitset<>& pattern );
+void parallel_simulate( const aig_graph& aig, const boost::dynamic_bitset<>& pattern, unsigned num_threads = 0u );
+
+/******************************************************************************
+ * MIG                                                                        *
+ ******************************************************************************/
+
+template<typename T>
+void parallel_compute(
+    const mig_graph& mig, const T& constant_result,
+    const std::function<T( unsigned )>& on_input,
+    const std::function<T( const T&, bool, const T&, bool, const T&, bool )>& on_maj,
+    std::vector<T>& computed_values,
+    unsigned num_threads = 0u )
+{
+  const auto& info = boost::get_property( mig, boost::graph_name );
+
+  std::vector<unsigned> input_index( num_vertices( mig ), 0u );
+  for ( auto i = 0u; i < info.inputs.size(); ++i )
+  {
+    input_index[info.inputs[i]] = i;
+  }
+
+  std::vector<detail::parallel_value<T>> values( num_vertices( mig ) );
+
+  parallel_dag_process( make_dag_schedule( mig ), [&]( unsigned n ) {
+      if ( out_degree( n, mig ) == 0u )
+      {
+        values[n].value = ( n == info.constant ) ? constant_result : on_input( input_index[n] );
+      }
+      else
+      {
+        const auto it = out_edges( n, mig ).first;
+        const auto a = mig_to_function( mig, *it ), b = mig_to_function( mig, *( it + 1 ) ), c = mig_to_function( mig, *( it + 2 ) );
+        values[n].value = on_maj( values[a.node].value, a.complemented, values[b.node].value, b.complemented, values[c.node].value, c.complemented );
+      }
+    }, num_threads );
+
+  detail::copy_parallel_values( values, computed_values );
+}
+
+/******************************************************************************
+ * XMG                                                                        *
+ ******************************************************************************/
+
+template<typename T>
+void parallel_compute(
+    const xmg_graph& xmg, const T& constant_result,
+    const std::function<T( unsigned )>& on_input,
+    const std::function<T( const T&, bool, const T&, bool, const T&, bool )>& on_maj,
+    const std::function<T( const T&, bool, const T&, bool )>& on_xor,
+    std::vector<T>& computed_values,
+    unsigned num_threads = 0u )
+{
+  std::vector<detail::parallel_value<T>> values( xmg.size() );
+
+  parallel_dag_process( make_dag_schedule( xmg.graph() ), [&]( unsigned n ) {
+      if ( xmg.is_input( n ) )
+      {
+        values[n].value = ( n == 0u ) ? constant_result : on_input( xmg.input_index( n ) );
+      }
+      else
+      {
+        const auto c = xmg.children( n );
+        if ( xmg.is_xor( n ) )
+        {
+          values[n].value = on_xor( values[c[0].node].value, c[0].complemented, values[c[1].node].value, c[1].complemented );
+        }
+        else
+        {
+          values[n].value = on_maj( values[c[0].node].value, c[0].complemented, values[c[1].node].value, c[1].complemented, values[c[2].node].value, c[2].complemented );
+        }
+      }
+    }, num_threads );
+
+  detail::copy_parallel_values( values, computed_values );
+}
 
 }
 
@@ -0,0 +1,227 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "simulate_aig_bitparallel.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include <classical/functions/strash.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/* node blocks are padded to 8 words, such that kernels do not need tail handling */
+constexpr unsigned block_alignment = 8u;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/* complement mask for a literal */
+inline std::uint64_t literal_mask( std::uint32_t l )
+{
+  return -static_cast<std::uint64_t>( l & 1u );
+}
+
+template<typename Gate>
+void sweep_scalar( const std::vector<Gate>& gates, std::uint64_t* values, std::size_t stride )
+{
+  for ( const auto& g : gates )
+  {
+    auto       out = values + g.node * stride;
+    const auto a   = values + ( g.left >> 1u ) * stride;
+    const auto b   = values + ( g.right >> 1u ) * stride;
+    const auto ma  = literal_mask( g.left );
+    const auto mb  = literal_mask( g.right );
+
+    for ( auto w = 0u; w < stride; ++w )
+    {
+      out[w] = ( a[w] ^ ma ) & ( b[w] ^ mb );
+    }
+  }
+}
+
+#if CIRKIT_SIMD_X86
+template<typename Gate>
+CIRKIT_TARGET_AVX2 void sweep_avx2( const std::vector<Gate>& gates, std::uint64_t* values, std::size_t stride )
+{
+  for ( const auto& g : gates )
+  {
+    auto       out = values + g.node * stride;
+    const auto a   = values + ( g.left >> 1u ) * stride;
+    const auto b   = values + ( g.right >> 1u ) * stride;
+    const auto ma  = _mm256_set1_epi64x( static_cast<long long>( literal_mask( g.left ) ) );
+    const auto mb  = _mm256_set1_epi64x( static_cast<long long>( literal_mask( g.right ) ) );
+
+    for ( auto w = 0u; w < stride; w += 4u )
+    {
+      const auto va = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( a + w ) ), ma );
+      const auto vb = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( b + w ) ), mb );
+      _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + w ), _mm256_and_si256( va, vb ) );
+    }
+  }
+}
+
+template<typename Gate>
+CIRKIT_TARGET_AVX512 void sweep_avx512( const std::vector<Gate>& gates, std::uint64_t* values, std::size_t stride )
+{
+  for ( const auto& g : gates )
+  {
+    auto       out = values + g.node * stride;
+    const auto a   = values + ( g.left >> 1u ) * stride;
+    const auto b   = values + ( g.right >> 1u ) * stride;
+    const auto ma  = _mm512_set1_epi64( static_cast<long long>( literal_mask( g.left ) ) );
+    const auto mb  = _mm512_set1_epi64( static_cast<long long>( literal_mask( g.right ) ) );
+
+    for ( auto w = 0u; w < stride; w += 8u )
+    {
+      const auto va = _mm512_xor_si512( _mm512_loadu_si512( a + w ), ma );
+      const auto vb = _mm512_xor_si512( _mm512_loadu_si512( b + w ), mb );
+      _mm512_storeu_si512( out + w, _mm512_and_si512( va, vb ) );
+    }
+  }
+}
+#endif
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+bitparallel_aig_simulator::bitparallel_aig_simulator( const aig_flat& aig, unsigned num_words, simd_level level )
+  : _num_words( std::max( num_words, 1u ) ),
+    _level( simd_select( level ) )
+{
+  compile( aig );
+  allocate();
+}
+
+bitparallel_aig_simulator::bitparallel_aig_simulator( const aig_graph& aig, unsigned num_words, simd_level level )
+  : _num_words( std::max( num_words, 1u ) ),
+    _level( simd_select( level ) )
+{
+  aig_flat flat;
+  strash( aig, flat );
+  compile( flat );
+  allocate();
+}
+
+void bitparallel_aig_simulator::set_num_words( unsigned num_words )
+{
+  _num_words = std::max( num_words, 1u );
+  allocate();
+}
+
+void bitparallel_aig_simulator::randomize_inputs()
+{
+  for ( auto i = 0u; i < _inputs.size(); ++i )
+  {
+    std::generate( input( i ), input( i ) + _num_words, std::ref( _gen ) );
+  }
+}
+
+void bitparallel_aig_simulator::simulate()
+{
+  switch ( _level )
+  {
+#if CIRKIT_SIMD_X86
+  case simd_level::avx512:
+    sweep_avx512( _gates, _values.data(), _stride );
+    break;
+  case simd_level::avx2:
+    sweep_avx2( _gates, _values.data(), _stride );
+    break;
+#endif
+  default:
+    sweep_scalar( _gates, _values.data(), _stride );
+    break;
+  }
+
+  for ( auto i = 0u; i < _outputs.size(); ++i )
+  {
+    const auto f    = _outputs[i];
+    const auto mask = literal_mask( f );
+    const auto src  = node( f >> 1u );
+    auto       dst  = &_output_values[i * _stride];
+
+    for ( auto w = 0u; w < _num_words; ++w )
+    {
+      dst[w] = src[w] ^ mask;
+    }
+  }
+}
+
+std::uint64_t bitparallel_aig_simulator::output_ones( unsigned index ) const
+{
+  std::uint64_t ones = 0u;
+  const auto words = output( index );
+  for ( auto w = 0u; w < _num_words; ++w )
+  {
+    ones += __builtin_popcountll( words[w] );
+  }
+  return ones;
+}
+
+void bitparallel_aig_simulator::compile( const aig_flat& aig )
+{
+  _num_nodes = aig.size();
+
+  _gates.reserve( aig.num_gates() );
+  aig.foreach_and( [this]( aig_flat::node_t n, aig_flat::literal_t a, aig_flat::literal_t b ) {
+      _gates.push_back( {n, a, b} );
+    } );
+
+  _inputs.assign( aig.inputs().begin(), aig.inputs().end() );
+
+  _outputs.reserve( aig.num_outputs() );
+  aig.foreach_output( [this]( aig_flat::literal_t f, unsigned ) { _outputs.push_back( f ); } );
+}
+
+void bitparallel_aig_simulator::allocate()
+{
+  const auto stride = ( ( _num_words + block_alignment - 1u ) / block_alignment ) * block_alignment;
+
+  if ( stride != _stride )
+  {
+    _stride = stride;
+
+    /* constant node and padding words stay zero */
+    _values.assign( _num_nodes * _stride, 0u );
+    _output_values.assign( _outputs.size() * _stride, 0u );
+  }
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,126 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file simulate_aig_bitparallel.hpp
+ *
+ * @brief Bit-parallel AIG simulation
+ *
+ * Simulates 64 patterns per machine word in a single topological sweep
+ * over a flat gate array.  Values are stored in one contiguous buffer
+ * with a fixed number of words per node which is reused across calls.
+ * The AND kernel is selected at runtime (AVX-512, AVX2, or scalar).
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef SIMULATE_AIG_BITPARALLEL_HPP
+#define SIMULATE_AIG_BITPARALLEL_HPP
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <core/utils/simd_utils.hpp>
+#include <classical/aig.hpp>
+#include <classical/aig_flat.hpp>
+
+namespace cirkit
+{
+
+class bitparallel_aig_simulator
+{
+public:
+  /**
+   * @param num_words Number of 64-bit words per node, i.e., the simulator
+   *                  processes 64 * num_words patterns in each call to simulate()
+   * @param level     Requested SIMD level (falls back if not supported by the CPU)
+   */
+  explicit bitparallel_aig_simulator( const aig_flat& aig, unsigned num_words = 16u, simd_level level = simd_level::avx512 );
+  explicit bitparallel_aig_simulator( const aig_graph& aig, unsigned num_words = 16u, simd_level level = simd_level::avx512 );
+
+  inline unsigned num_words() const       { return _num_words; }
+  inline unsigned num_patterns() const    { return _num_words << 6u; }
+  inline unsigned num_inputs() const      { return _inputs.size(); }
+  inline unsigned num_outputs() const     { return _outputs.size(); }
+  inline simd_level level() const         { return _level; }
+
+  /* changes the block size, buffers are only reallocated if the padded block size changes */
+  void set_num_words( unsigned num_words );
+
+  /* input patterns, each input has num_words() words */
+  inline std::uint64_t* input( unsigned index )             { return &_values[_inputs[index] * _stride]; }
+  inline const std::uint64_t* input( unsigned index ) const { return &_values[_inputs[index] * _stride]; }
+  void randomize_inputs();
+  inline void set_seed( unsigned seed )                    { _gen.seed( seed ); }
+
+  /* one sweep over all gates followed by computing the outputs */
+  void simulate();
+
+  /* results, valid after simulate() */
+  inline const std::uint64_t* output( unsigned index ) const { return &_output_values[index * _stride]; }
+  inline bool output_value( unsigned index, unsigned pattern ) const { return ( output( index )[pattern >> 6u] >> ( pattern & 63u ) ) & 1u; }
+  inline const std::uint64_t* node( aig_flat::node_t n ) const { return &_values[n * _stride]; }
+
+  /* number of patterns for which the output evaluates to 1 */
+  std::uint64_t output_ones( unsigned index ) const;
+
+private:
+  void compile( const aig_flat& aig );
+  void allocate();
+
+private:
+  struct gate_t
+  {
+    std::uint32_t node;
+    std::uint32_t left;   /* literals */
+    std::uint32_t right;
+  };
+
+  std::vector<gate_t>          _gates;
+  std::vector<std::uint32_t>   _inputs;
+  std::vector<std::uint32_t>   _outputs;
+  std::size_t                  _num_nodes = 0u;
+
+  unsigned                     _num_words;
+  std::size_t                  _stride = 0u;
+  simd_level                   _level;
+
+  std::vector<std::uint64_t>   _values;
+  std::vector<std::uint64_t>   _output_values;
+  std::mt19937_64              _gen;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -33,6 +33,7 @@
 
 #include <core/utils/range_utils.hpp>
 #include <core/utils/timer.hpp>
+#include <classical/utils/static_truth_table.hpp>
 
 namespace cirkit
 {
@@ -59,9 +60,60 @@ tt make_sum( const boost::dynamic_bitset<>& mask )
   return sum;
 }
 
+/* spectra are computed in Gray code order such that each row differs from the previous one in one variable */
+template<unsigned N>
+std::vector<int> rademacher_walsh_spectrum( const static_tt<N>& func )
+{
+  std::vector<int> spectrum( 1u << N );
+
+  static_tt<N> row;
+  spectrum[0u] = ( 1 << N ) - 2 * func.count();
+  for ( auto i = 1u; i < spectrum.size(); ++i )
+  {
+    row ^= static_tt<N>::nth_var( __builtin_ctz( i ) );
+    spectrum[i ^ ( i >> 1u )] = ( 1 << N ) - 2 * ( row ^ func ).count();
+  }
+
+  return spectrum;
+}
+
+template<unsigned N>
+std::vector<int> autocorrelation_spectrum( const static_tt<N>& func )
+{
+  std::vector<int> spectrum( 1u << N );
+
+  auto fs = func;
+  spectrum[0u] = 1 << N;
+  for ( auto i = 1u; i < spectrum.size(); ++i )
+  {
+    fs.flip( __builtin_ctz( i ) );
+    spectrum[i ^ ( i >> 1u )] = ( 1 << N ) - 2 * ( fs ^ func ).count();
+  }
+
+  return spectrum;
+}
+
+struct spectrum_static_fn
+{
+  const tt& func;
+  bool autocorrelation;
+
+  template<unsigned N>
+  std::vector<int> run() const
+  {
+    const auto sfunc = to_static_tt<N>( func );
+    return autocorrelation ? autocorrelation_spectrum( sfunc ) : rademacher_walsh_spectrum( sfunc );
+  }
+};
+
 std::vector<int> rademacher_walsh_spectrum( const tt& func )
 {
   const auto n = tt_num_vars( func );
+  if ( n <= 16u )
+  {
+    return static_tt_dispatch( n, spectrum_static_fn{func, false} );
+  }
+
   std::vector<int> spectrum;
 
   foreach_bitset( n, [n, &func, &spectrum]( const boost::dynamic_bitset<>& bs ) {
@@ -75,6 +127,11 @@ std::vector<int> rademacher_walsh_spectrum( const tt& func )
 std::vector<int> autocorrelation_spectrum( const tt& func )
 {
   const auto n = tt_num_vars( func );
+  if ( n <= 16u )
+  {
+    return static_tt_dispatch( n, spectrum_static_fn{func, true} );
+  }
+
   std::vector<int> spectrum;
 
   foreach_bitset( n, [n, &func, &spectrum]( const boost::dynamic_bitset<>& bs ) {
@@ -469,7 +526,8 @@ tt spectral_canonization( const tt& func, const properties::ptr& settings, const
   return cfunc;
 }
 
-unsigned get_spectral_class( const tt& func )
+template<typename TT>
+unsigned get_spectral_class_generic( const TT& func )
 {
   const auto nvars = tt_num_vars( func );
 
@@ -598,6 +656,28 @@ unsigned get_spectral_class( const tt& func )
   return 0u;
 }
 
+unsigned get_spectral_class( const tt& func )
+{
+  assert( func.size() <= 64u );
+
+  return get_spectral_class( func.to_ulong(), tt_num_vars( func ) );
+}
+
+unsigned get_spectral_class( uint64_t func, unsigned num_vars )
+{
+  assert( num_vars >= 2u && num_vars <= 5u );
+
+  switch ( num_vars )
+  {
+  case 2u: return get_spectral_class_generic( static_tt<2u>( func ) );
+  case 3u: return get_spectral_class_generic( static_tt<3u>( func ) );
+  case 4u: return get_spectral_class_generic( static_tt<4u>( func ) );
+  case 5u: return get_spectral_class_generic( static_tt<5u>( func ) );
+  }
+
+  return 0u;
+}
+
 }
 
 // Local Variables:
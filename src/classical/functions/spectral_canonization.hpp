@@ -36,6 +36,8 @@
 #ifndef SPECTRAL_CANONIZATION_HPP
 #define SPECTRAL_CANONIZATION_HPP
 
+#include <cstdint>
+
 #include <core/properties.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 
@@ -45,6 +47,7 @@ namespace cirkit
 tt spectral_canonization( const tt& func, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
 unsigned get_spectral_class( const tt& func );
+unsigned get_spectral_class( uint64_t func, unsigned num_vars );
 
 }
 
@@ -70,6 +70,60 @@ aig_function strash_simulator::and_op( const aig_node& node, const aig_function&
   return aig_create_and( aig_new, v1, v2 );
 }
 
+strash_flat_simulator::strash_flat_simulator( aig_flat& aig_new, unsigned offset,
+                                              const std::map<unsigned, unsigned>& reorder,
+                                              const boost::dynamic_bitset<>& invert )
+  : aig_new( aig_new ),
+    offset( offset ),
+    reorder( reorder ),
+    _invert( invert ) {}
+
+aig_function strash_flat_simulator::get_input( const aig_node& node, const std::string& name, unsigned pos, const aig_graph& aig ) const
+{
+  const auto it = reorder.find( pos );
+  return { aig_new.inputs().at( offset + ( it == reorder.end() ? pos : it->second ) ), _invert[pos] };
+}
+
+aig_function strash_flat_simulator::get_constant() const
+{
+  return aig_get_constant( aig_new, false );
+}
+
+aig_function strash_flat_simulator::invert( const aig_function& v ) const
+{
+  return !v;
+}
+
+aig_function strash_flat_simulator::and_op( const aig_node& node, const aig_function& v1, const aig_function& v2 ) const
+{
+  return aig_create_and( aig_new, v1, v2 );
+}
+
+/* sweeps a flat AIG in topological order into any destination that supports aig_create_and */
+template<typename Dest>
+void strash_from_flat( const aig_flat& aig, Dest& aig_dest, const std::vector<aig_node>& dest_inputs,
+                       unsigned offset, const std::map<unsigned, unsigned>& reorder, const boost::dynamic_bitset<>& invert )
+{
+  std::vector<aig_function> values( aig.size() );
+  values[0u] = aig_get_constant( aig_dest, false );
+
+  aig.foreach_input( [&]( aig_flat::node_t n, unsigned pos ) {
+      const auto it = reorder.find( pos );
+      values[n] = { dest_inputs.at( offset + ( it == reorder.end() ? pos : it->second ) ), invert[pos] };
+    } );
+
+  aig.foreach_and( [&]( aig_flat::node_t n, aig_flat::literal_t a, aig_flat::literal_t b ) {
+      values[n] = aig_create_and( aig_dest,
+                                  values[aig_flat::literal_node( a )] ^ aig_flat::literal_complemented( a ),
+                                  values[aig_flat::literal_node( b )] ^ aig_flat::literal_complemented( b ) );
+    } );
+
+  for ( const auto& output : aig.outputs() )
+  {
+    aig_create_po( aig_dest, values[aig_flat::literal_node( output.first )] ^ aig_flat::literal_complemented( output.first ), output.second );
+  }
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -128,6 +182,100 @@ void strash( const aig_graph& aig,
   }
 }
 
+void strash( const aig_graph& aig,
+             aig_flat& aig_dest,
+             const properties::ptr& settings,
+             const properties::ptr& statistics )
+{
+  const auto& info = aig_info( aig );
+
+  /* settings */
+  const auto reorder      = get( settings, "reorder",      std::map<unsigned, unsigned>() );
+  const auto invert       = get( settings, "invert",       boost::dynamic_bitset<>( info.inputs.size() ) );
+  const auto reuse_inputs = get( settings, "reuse_inputs", false );
+
+  const auto offset = !reuse_inputs ? aig_dest.num_inputs() : 0u;
+
+  /* copy inputs */
+  if ( !reuse_inputs )
+  {
+    for ( const auto& input : info.inputs )
+    {
+      aig_dest.create_pi( info.node_names.at( input ) );
+    }
+  }
+
+  /* copy other info */
+  aig_dest.set_model_name( info.model_name );
+
+  auto result = simulate_aig( aig, strash_flat_simulator( aig_dest, offset, reorder, invert ) );
+
+  for ( const auto& output : info.outputs )
+  {
+    aig_create_po( aig_dest, result[output.first], output.second );
+  }
+}
+
+void strash( const aig_flat& aig,
+             aig_graph& aig_dest,
+             const properties::ptr& settings,
+             const properties::ptr& statistics )
+{
+  /* settings */
+  const auto reorder      = get( settings, "reorder",      std::map<unsigned, unsigned>() );
+  const auto invert       = get( settings, "invert",       boost::dynamic_bitset<>( aig.num_inputs() ) );
+  const auto reuse_inputs = get( settings, "reuse_inputs", false );
+
+  auto& info_dest  = aig_info( aig_dest );
+  const auto offset = !reuse_inputs ? info_dest.inputs.size() : 0u;
+
+  /* copy inputs */
+  if ( !reuse_inputs )
+  {
+    aig.foreach_input( [&]( aig_flat::node_t n, unsigned pos ) { aig_create_pi( aig_dest, aig.input_name( pos ) ); } );
+  }
+
+  /* copy other info */
+  info_dest.model_name = aig.model_name();
+
+  strash_from_flat( aig, aig_dest, info_dest.inputs, offset, reorder, invert );
+}
+
+aig_flat strash( const aig_flat& aig,
+                 const properties::ptr& settings,
+                 const properties::ptr& statistics )
+{
+  aig_flat aig_new;
+  strash( aig, aig_new, settings, statistics );
+  return aig_new;
+}
+
+void strash( const aig_flat& aig,
+             aig_flat& aig_dest,
+             const properties::ptr& settings,
+             const properties::ptr& statistics )
+{
+  /* settings */
+  const auto reorder      = get( settings, "reorder",      std::map<unsigned, unsigned>() );
+  const auto invert       = get( settings, "invert",       boost::dynamic_bitset<>( aig.num_inputs() ) );
+  const auto reuse_inputs = get( settings, "reuse_inputs", false );
+
+  const auto offset = !reuse_inputs ? aig_dest.num_inputs() : 0u;
+
+  /* copy inputs */
+  if ( !reuse_inputs )
+  {
+    aig_dest.reserve( aig_dest.size() + aig.size() );
+    aig.foreach_input( [&]( aig_flat::node_t n, unsigned pos ) { aig_dest.create_pi( aig.input_name( pos ) ); } );
+  }
+
+  /* copy other info */
+  aig_dest.set_model_name( aig.model_name() );
+
+  const std::vector<aig_node> dest_inputs( aig_dest.inputs().begin(), aig_dest.inputs().end() );
+  strash_from_flat( aig, aig_dest, dest_inputs, offset, reorder, invert );
+}
+
 }
 
 // Local Variables:
@@ -43,6 +43,7 @@
 
 #include <core/properties.hpp>
 #include <classical/aig.hpp>
+#include <classical/aig_flat.hpp>
 #include <classical/functions/simulate_aig.hpp>
 
 namespace cirkit
@@ -68,6 +69,25 @@ private:
   const boost::dynamic_bitset<>& _invert;
 };
 
+class strash_flat_simulator : public aig_simulator<aig_function>
+{
+public:
+  strash_flat_simulator( aig_flat& aig_new, unsigned offset,
+                         const std::map<unsigned, unsigned>& reorder,
+                         const boost::dynamic_bitset<>& invert );
+
+  aig_function get_input( const aig_node& node, const std::string& name, unsigned pos, const aig_graph& aig ) const;
+  aig_function get_constant() const;
+  aig_function invert( const aig_function& v ) const;
+  aig_function and_op( const aig_node& node, const aig_function& v1, const aig_function& v2 ) const;
+
+private:
+  aig_flat& aig_new;
+  unsigned offset;
+  const std::map<unsigned, unsigned>& reorder;
+  const boost::dynamic_bitset<>& _invert;
+};
+
 aig_graph strash( const aig_graph& aig,
                   const properties::ptr& settings = properties::ptr(),
                   const properties::ptr& statistics = properties::ptr() );
@@ -77,6 +97,26 @@ void strash( const aig_graph& aig,
              const properties::ptr& settings = properties::ptr(),
              const properties::ptr& statistics = properties::ptr() );
 
+/* conversion from and to aig_flat, settings are the same as above */
+void strash( const aig_graph& aig,
+             aig_flat& dest,
+             const properties::ptr& settings = properties::ptr(),
+             const properties::ptr& statistics = properties::ptr() );
+
+void strash( const aig_flat& aig,
+             aig_graph& dest,
+             const properties::ptr& settings = properties::ptr(),
+             const properties::ptr& statistics = properties::ptr() );
+
+aig_flat strash( const aig_flat& aig,
+                 const properties::ptr& settings = properties::ptr(),
+                 const properties::ptr& statistics = properties::ptr() );
+
+void strash( const aig_flat& aig,
+             aig_flat& dest,
+             const properties::ptr& settings = properties::ptr(),
+             const properties::ptr& statistics = properties::ptr() );
+
 }
 
 #endif
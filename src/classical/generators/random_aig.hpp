@@ -0,0 +1,91 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file random_aig.hpp
+ *
+ * @brief Generates random AIGs (e.g., for benchmarking)
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef RANDOM_AIG_HPP
+#define RANDOM_AIG_HPP
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <boost/format.hpp>
+
+#include <classical/aig.hpp>
+
+namespace cirkit
+{
+
+/**
+ * @brief Random AIG with num_gates AND operations
+ *
+ * Works for every AIG type that supports the aig_create_* interface (e.g.,
+ * aig_graph and aig_flat).  Fanins are chosen from a window of recently
+ * created nodes to obtain deep networks.  Due to structural hashing the
+ * number of gates can be slightly smaller than num_gates.
+ */
+template<typename AIG>
+void generate_random_aig( AIG& aig, unsigned num_inputs, unsigned num_gates, unsigned num_outputs, unsigned seed = 0u, unsigned window = 65536u )
+{
+  std::default_random_engine gen( seed );
+  std::bernoulli_distribution coin;
+
+  std::vector<aig_function> fs;
+  fs.reserve( num_inputs + num_gates );
+  for ( auto i = 0u; i < num_inputs; ++i )
+  {
+    fs.push_back( aig_create_pi( aig, boost::str( boost::format( "x%d" ) % i ) ) );
+  }
+
+  for ( auto i = 0u; i < num_gates; ++i )
+  {
+    std::uniform_int_distribution<unsigned> dist( fs.size() > window ? fs.size() - window : 0u, fs.size() - 1u );
+    fs.push_back( aig_create_and( aig, fs[dist( gen )] ^ coin( gen ), fs[dist( gen )] ^ coin( gen ) ) );
+  }
+
+  for ( auto i = 0u; i < num_outputs && i < fs.size(); ++i )
+  {
+    aig_create_po( aig, fs[fs.size() - 1u - i], boost::str( boost::format( "y%d" ) % i ) );
+  }
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
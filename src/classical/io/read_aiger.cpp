@@ -37,6 +37,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/range/counting_range.hpp>
 
+#include <cstring>
 #include <fstream>
 #include <sstream>
 
@@ -435,6 +436,420 @@ void read_aiger_binary( aig_graph& aig, const std::string& filename, bool noopt
   in.close();
 }
 
+/******************************************************************************
+ * aig_flat                                                                   *
+ ******************************************************************************/
+
+void read_aiger_symbols( aig_flat& aig, std::istream& in )
+{
+  std::string line;
+  while ( std::getline( in, line ) )
+  {
+    if ( line.size() != 0u && line[0] == 'c' ) { break; }
+    if ( line.size() == 0u ) { continue; }
+    if ( line[0] == 'l' ) { throw "Error: latches are not supported by aig_flat"; }
+    if ( line[0] != 'i' && line[0] != 'o' ) { continue; }
+
+    std::vector<std::string> list;
+    split_string( list, line, " " );
+
+    unsigned pos;
+    try
+    {
+      pos = boost::lexical_cast<unsigned>( list[0u].substr( 1u ) );
+    }
+    catch ( boost::bad_lexical_cast& )
+    {
+      throw "Error: could not parse symbol table entry";
+    }
+    std::string name = list.size() == 1u ? "unknown" : list[1u];
+
+    if ( list[0][0] == 'i' )
+    {
+      if ( pos >= aig.num_inputs() ) { throw "Error: invalid input index in symbol table"; }
+      aig.set_input_name( pos, name );
+    }
+    else
+    {
+      if ( pos >= aig.outputs().size() ) { throw "Error: invalid output index in symbol table"; }
+      aig.outputs()[pos].second = name;
+    }
+  }
+}
+
+void read_aiger( aig_flat& aig, std::istream& in )
+{
+  std::string line;
+
+  /* read header */
+  std::getline( in, line );
+  if ( in.fail() ) { throw "Error: could not read input file (check path and permissions)"; }
+
+  std::vector<std::string> header;
+  split_string( header, line, " " );
+
+  if ( header.size() != 6u || header[0u] != "aag" ) { throw "Error: expect 'aag M I L O A' as header"; }
+  if ( header[3u] != "0" ) { throw "Error: latches are not supported by aig_flat"; }
+
+  const auto num_ids     = boost::lexical_cast<unsigned>( header[1u] );
+  const auto num_inputs  = boost::lexical_cast<unsigned>( header[2u] );
+  const auto num_outputs = boost::lexical_cast<unsigned>( header[4u] );
+  const auto num_ands    = boost::lexical_cast<unsigned>( header[5u] );
+
+  if ( num_ids != num_inputs + num_ands ) { throw "Error: broken AAG header"; }
+
+  aig.reserve( num_ids + 1u );
+
+  /* literal of each AIGER variable in aig_flat */
+  std::vector<aig_flat::literal_t> lits( num_ids + 1u, 0u );
+  std::vector<bool> done( num_ids + 1u, false );
+  done[0u] = true;
+  std::vector<std::pair<unsigned, unsigned>> gates( num_ids + 1u, {0u, 0u} );
+
+  for ( auto u = 0u; u < num_inputs; ++u )
+  {
+    std::getline( in, line );
+    const auto lit = boost::lexical_cast<unsigned>( boost::trim_copy( line ) );
+    if ( lit % 2u != 0u ) { throw "Error: negated inputs are not permitted in definition"; }
+    lits[aiger_lit2var( lit )] = aig.create_pi( "" );
+    done[aiger_lit2var( lit )] = true;
+  }
+
+  std::vector<unsigned> oids;
+  ntimes( num_outputs, [&]() {
+      std::getline( in, line );
+      oids += boost::lexical_cast<unsigned>( boost::trim_copy( line ) );
+    } );
+
+  std::vector<unsigned> order;
+  order.reserve( num_ands );
+  for ( auto u = 0u; u < num_ands; ++u )
+  {
+    std::getline( in, line );
+    std::istringstream is( line );
+
+    unsigned lit_out, lit_le, lit_re;
+    is >> lit_out >> lit_le >> lit_re;
+    if ( is.fail() ) { throw "Error: could not parse gate definition"; }
+    if ( lit_out % 2u != 0u ) { throw "Error: negated gates are not permitted in definition"; }
+
+    gates[aiger_lit2var( lit_out )] = {lit_le, lit_re};
+    order.push_back( aiger_lit2var( lit_out ) );
+  }
+
+  /* ASCII AIGER does not require gates in topological order */
+  const auto to_literal = [&lits]( unsigned lit ) {
+    return lits[aiger_lit2var( lit )] ^ ( lit % 2u );
+  };
+
+  std::vector<unsigned> stack;
+  for ( auto var : order )
+  {
+    stack.push_back( var );
+    while ( !stack.empty() )
+    {
+      const auto v = stack.back();
+      if ( done[v] ) { stack.pop_back(); continue; }
+
+      const auto& g = gates[v];
+      const auto v1 = aiger_lit2var( g.first ), v2 = aiger_lit2var( g.second );
+      if ( !done[v1] ) { stack.push_back( v1 ); continue; }
+      if ( !done[v2] ) { stack.push_back( v2 ); continue; }
+
+      lits[v] = aig.create_and( to_literal( g.first ), to_literal( g.second ) );
+      done[v] = true;
+      stack.pop_back();
+    }
+  }
+
+  for ( const auto& oid : oids )
+  {
+    aig.create_po( to_literal( oid ), "" );
+  }
+
+  read_aiger_symbols( aig, in );
+}
+
+void read_aiger( aig_flat& aig, const std::string& filename )
+{
+  std::ifstream in( filename.c_str(), std::ifstream::in );
+  read_aiger( aig, in );
+
+  aig.set_model_name( boost::filesystem::path( filename ).stem().string() );
+  in.close();
+}
+
+void read_aiger_binary( aig_flat& aig, std::istream& in, bool noopt )
+{
+  std::string line;
+
+  /* read header */
+  std::getline( in, line );
+  if ( in.fail() ) { throw "Error: could not read input file (check path and permissions)"; }
+
+  std::vector<std::string> header;
+  split_string( header, line, " " );
+
+  if ( header.size() != 6u || header[0u] != "aig" ) { throw "Error: expect 'aig M I L O A' as header"; }
+  if ( header[3u] != "0" ) { throw "Error: latches are not supported by aig_flat"; }
+
+  const auto num_inputs  = boost::lexical_cast<unsigned>( header[2u] );
+  const auto num_outputs = boost::lexical_cast<unsigned>( header[4u] );
+  const auto num_ands    = boost::lexical_cast<unsigned>( header[5u] );
+
+  if ( noopt )
+  {
+    aig.set_structural_hashing( false );
+    aig.set_local_optimization( false );
+  }
+  aig.reserve( num_inputs + num_ands + 1u );
+
+  /* literal of each AIGER variable in aig_flat */
+  std::vector<aig_flat::literal_t> lits( num_inputs + num_ands + 1u, 0u );
+  for ( auto i = 1u; i <= num_inputs; ++i )
+  {
+    lits[i] = aig.create_pi( "" );
+  }
+
+  std::vector<unsigned> oids;
+  ntimes( num_outputs, [&]() {
+      std::getline( in, line );
+      oids += boost::lexical_cast<unsigned>( boost::trim_copy( line ) );
+    } );
+
+  for ( auto i = num_inputs + 1u; i <= num_inputs + num_ands; ++i )
+  {
+    const auto g  = i << 1u;
+    const auto o1 = g - aiger_decode( in );
+    const auto o2 = o1 - aiger_decode( in );
+
+    lits[i] = aig.create_and( lits[o1 >> 1u] ^ ( o1 & 1u ), lits[o2 >> 1u] ^ ( o2 & 1u ) );
+  }
+
+  for ( const auto& oid : oids )
+  {
+    aig.create_po( lits[oid >> 1u] ^ ( oid & 1u ), "" );
+  }
+
+  read_aiger_symbols( aig, in );
+}
+
+void read_aiger_binary( aig_flat& aig, const std::string& filename, bool noopt )
+{
+  aiger_binary_reader reader( filename );
+  reader.read( aig, noopt );
+  reader.read_symbols( aig );
+
+  aig.set_model_name( boost::filesystem::path( filename ).stem().string() );
+}
+
+/******************************************************************************
+ * aiger_binary_reader                                                        *
+ ******************************************************************************/
+
+namespace
+{
+
+using byte_t = unsigned char;
+
+inline const byte_t* aiger_line_end( const byte_t* p, const byte_t* end )
+{
+  const auto* eol = static_cast<const byte_t*>( std::memchr( p, '\n', end - p ) );
+  return eol ? eol : end;
+}
+
+inline const byte_t* aiger_next_line( const byte_t* p, const byte_t* end )
+{
+  const auto* eol = aiger_line_end( p, end );
+  return eol == end ? end : eol + 1;
+}
+
+/* parses a decimal number, returns false if there is none */
+inline bool aiger_parse_unsigned( const byte_t*& p, const byte_t* end, unsigned& value )
+{
+  if ( p == end || *p < '0' || *p > '9' ) { return false; }
+
+  value = 0u;
+  while ( p != end && *p >= '0' && *p <= '9' )
+  {
+    value = 10u * value + ( *p++ - '0' );
+  }
+  return true;
+}
+
+/* one delta of the AND section, 32-bit values take at most 5 bytes */
+inline unsigned aiger_decode( const byte_t*& p, const byte_t* end )
+{
+  auto res = 0u;
+
+  for ( auto shift = 0u; shift < 35u; shift += 7u )
+  {
+    if ( p == end ) { throw "Error: unexpected end of AIGER file"; }
+
+    const auto c = *p++;
+    res |= ( c & 0x7fu ) << shift;
+    if ( !( c & 0x80u ) ) { return res; }
+  }
+
+  throw "Error: invalid delta encoding in AIGER file";
+}
+
+}
+
+aiger_binary_reader::aiger_binary_reader( const std::string& filename )
+  : _file( filename ),
+    _begin( reinterpret_cast<const byte_t*>( _file.data() ) ),
+    _end( _begin + _file.size() )
+{
+  const auto* eol = aiger_line_end( _begin, _end );
+
+  std::vector<std::string> header;
+  split_string( header, std::string( _begin, eol ), " " );
+
+  if ( header.size() != 6u || header[0u] != "aig" ) { throw "Error: expect 'aig M I L O A' as header"; }
+  if ( header[3u] != "0" ) { throw "Error: latches are not supported by aig_flat"; }
+
+  _num_inputs  = boost::lexical_cast<unsigned>( header[2u] );
+  _num_outputs = boost::lexical_cast<unsigned>( header[4u] );
+  _num_ands    = boost::lexical_cast<unsigned>( header[5u] );
+
+  _body = eol == _end ? _end : eol + 1;
+}
+
+void aiger_binary_reader::read( aig_flat& aig, bool noopt )
+{
+  const auto num_vars = _num_inputs + _num_ands;
+
+  if ( noopt )
+  {
+    aig.set_structural_hashing( false );
+    aig.set_local_optimization( false );
+  }
+  aig.reserve( aig.size() + num_vars );
+
+  /* the AIG may already contain inputs and outputs, symbols refer to the new ones */
+  _input_offset  = aig.num_inputs();
+  _output_offset = aig.outputs().size();
+
+  /* without optimization, AIGER variable i is node i of an empty AIG */
+  const auto direct = noopt && aig.size() == 1u;
+
+  std::vector<aig_flat::literal_t> lits;
+  if ( !direct )
+  {
+    lits.resize( num_vars + 1u, 0u );
+  }
+
+  for ( auto i = 1u; i <= _num_inputs; ++i )
+  {
+    const auto f = aig.create_pi( "" );
+    if ( !direct ) { lits[i] = f; }
+  }
+
+  const auto to_literal = [direct, &lits]( unsigned lit ) {
+    return direct ? lit : lits[lit >> 1u] ^ ( lit & 1u );
+  };
+
+  /* outputs are defined before the AND section */
+  auto p = _body;
+  std::vector<unsigned> oids;
+  oids.reserve( _num_outputs );
+  for ( auto i = 0u; i < _num_outputs; ++i )
+  {
+    unsigned oid;
+    if ( !aiger_parse_unsigned( p, _end, oid ) || ( oid >> 1u ) > num_vars ) { throw "Error: could not parse output literal"; }
+    oids.push_back( oid );
+    p = aiger_next_line( p, _end );
+  }
+
+  if ( direct )
+  {
+    auto* fanins = aig.append_ands( _num_ands );
+    for ( auto i = _num_inputs + 1u; i <= num_vars; ++i )
+    {
+      const auto g  = i << 1u;
+      const auto d0 = aiger_decode( p, _end );
+      const auto d1 = aiger_decode( p, _end );
+      if ( d0 == 0u || d0 > g || d1 > g - d0 ) { throw "Error: invalid AND gate in AIGER file"; }
+
+      *fanins++ = g - d0 - d1;
+      *fanins++ = g - d0;
+    }
+  }
+  else
+  {
+    for ( auto i = _num_inputs + 1u; i <= num_vars; ++i )
+    {
+      const auto g  = i << 1u;
+      const auto d0 = aiger_decode( p, _end );
+      const auto d1 = aiger_decode( p, _end );
+      if ( d0 == 0u || d0 > g || d1 > g - d0 ) { throw "Error: invalid AND gate in AIGER file"; }
+
+      lits[i] = aig.create_and( to_literal( g - d0 ), to_literal( g - d0 - d1 ) );
+    }
+  }
+
+  for ( const auto& oid : oids )
+  {
+    aig.create_po( to_literal( oid ), "" );
+  }
+
+  _symbols = p;
+}
+
+void aiger_binary_reader::read_symbols( aig_flat& aig ) const
+{
+  if ( !_symbols ) { throw "Error: symbols can only be read after the AIG"; }
+
+  for ( auto p = _symbols; p != _end; p = aiger_next_line( p, _end ) )
+  {
+    const auto type = *p;
+
+    if ( type == 'c' ) { break; }
+    if ( type == 'l' ) { throw "Error: latches are not supported by aig_flat"; }
+    if ( type != 'i' && type != 'o' ) { continue; }
+
+    auto q = p + 1;
+    unsigned pos;
+    if ( !aiger_parse_unsigned( q, _end, pos ) ) { throw "Error: could not parse symbol table entry"; }
+
+    /* name is the next word, as in read_aiger_symbols */
+    const auto* eol = aiger_line_end( q, _end );
+    while ( q != eol && *q == ' ' ) { ++q; }
+    auto* name_end = q;
+    while ( name_end != eol && *name_end != ' ' && *name_end != '\r' ) { ++name_end; }
+
+    const auto name = q == name_end ? std::string( "unknown" ) : std::string( q, name_end );
+
+    if ( type == 'i' )
+    {
+      if ( pos >= _num_inputs || _input_offset + pos >= aig.num_inputs() ) { throw "Error: invalid input index in symbol table"; }
+      aig.set_input_name( _input_offset + pos, name );
+    }
+    else
+    {
+      if ( pos >= _num_outputs || _output_offset + pos >= aig.outputs().size() ) { throw "Error: invalid output index in symbol table"; }
+      aig.outputs()[_output_offset + pos].second = name;
+    }
+  }
+}
+
+std::string aiger_binary_reader::comment() const
+{
+  if ( !_symbols ) { throw "Error: comment can only be read after the AIG"; }
+
+  for ( auto p = _symbols; p != _end; p = aiger_next_line( p, _end ) )
+  {
+    if ( *p == 'c' )
+    {
+      const auto* start = aiger_next_line( p, _end );
+      return std::string( start, _end );
+    }
+  }
+
+  return std::string();
+}
+
 }
 
 // Local Variables:
@@ -36,7 +36,9 @@
 #ifndef READ_AIGER_HPP
 #define READ_AIGER_HPP
 
+#include <core/utils/mapped_file.hpp>
 #include <classical/aig.hpp>
+#include <classical/aig_flat.hpp>
 #include <iostream>
 #include <string>
 
@@ -53,6 +55,52 @@ void read_aiger( aig_graph& aig, std::string& comment, const std::string& filena
 void read_aiger_binary( aig_graph& aig, std::istream& in, bool noopt = false );
 void read_aiger_binary( aig_graph& aig, const std::string& filename, bool noopt = false );
 
+/* aig_flat does not support latches */
+void read_aiger( aig_flat& aig, std::istream& in );
+void read_aiger( aig_flat& aig, const std::string& filename );
+
+void read_aiger_binary( aig_flat& aig, std::istream& in, bool noopt = false );
+void read_aiger_binary( aig_flat& aig, const std::string& filename, bool noopt = false );
+
+/**
+ * @brief Binary AIGER file mapped into memory
+ *
+ * The AND section is decoded directly from the mapped file.  With noopt
+ * and an empty AIG, the gates are written into the fanin array of the
+ * AIG without any intermediate buffer.  The symbol table and the comment
+ * are only parsed on request, after read.  If read appended to a
+ * non-empty AIG, read_symbols names the inputs and outputs added by read.
+ */
+class aiger_binary_reader
+{
+public:
+  explicit aiger_binary_reader( const std::string& filename );
+
+  inline unsigned num_inputs() const  { return _num_inputs; }
+  inline unsigned num_outputs() const { return _num_outputs; }
+  inline unsigned num_ands() const    { return _num_ands; }
+
+  void read( aig_flat& aig, bool noopt = false );
+  void read_symbols( aig_flat& aig ) const;
+  std::string comment() const;
+
+private:
+  using byte_t = unsigned char;
+
+  mapped_file   _file;
+  const byte_t* _begin;
+  const byte_t* _end;
+  const byte_t* _body    = nullptr; /* after the header */
+  const byte_t* _symbols = nullptr; /* after the AND section, known after read */
+
+  unsigned      _num_inputs;
+  unsigned      _num_outputs;
+  unsigned      _num_ands;
+
+  unsigned      _input_offset  = 0u; /* inputs and outputs of the AIG before read */
+  unsigned      _output_offset = 0u;
+};
+
 }
 
 #endif
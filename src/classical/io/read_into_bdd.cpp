@@ -57,7 +57,9 @@ std::pair<bdd_manager_ptr, std::vector<bdd>> read_into_bdd( const std::string& f
                                                             const properties::ptr& statistics )
 {
   /* settings */
-  auto log_max_objs = get( settings, "log_max_objs", 24u );
+  auto log_max_objs = get( settings, "log_max_objs", 16u );
+  auto reorder      = get( settings, "reorder",      false );
+  auto num_threads  = get( settings, "num_threads",  1u );
 
   /* timing */
   properties_timer t( statistics );
@@ -82,7 +84,7 @@ std::pair<bdd_manager_ptr, std::vector<bdd>> read_into_bdd( const std::string& f
     read_aiger( aig, filename );
 
     std::vector<bdd> fs;
-    cirkit_bdd_simulator sim( aig, log_max_objs );
+    cirkit_bdd_simulator sim( aig, log_max_objs, reorder, num_threads );
     auto map = simulate_aig( aig, sim );
 
     for ( const auto& m : map )
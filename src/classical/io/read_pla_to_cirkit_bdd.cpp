@@ -44,8 +44,9 @@ namespace
 class from_bdd_pla_processor : public pla_processor
 {
 public:
-  explicit from_bdd_pla_processor( unsigned log_max_objs, bool verbose )
+  explicit from_bdd_pla_processor( unsigned log_max_objs, bool reorder, bool verbose )
     : m_log_max_objs( log_max_objs  ),
+      m_reorder( reorder ),
       m_verbose( verbose )
     {}
 
@@ -133,6 +134,7 @@ public:
           m_inputs, m_log_max_objs, m_verbose
         );
         m_function.reset ( function );
+        m_function->manager()->set_auto_reorder( m_reorder );
 
         initializeInputPorts();
         initializeOutputPorts( m_function->manager() );
@@ -214,6 +216,7 @@ public:
 
 private:
   unsigned         m_log_max_objs;
+  bool             m_reorder;
   bool             m_verbose;
   bdd_function_ptr m_function;
   unsigned         m_inputs;
@@ -291,11 +294,11 @@ void bdd_function::setOutputName(unsigned index, const std::string &name)
   m_outputNames.emplace ( index, name );
 }
 
-bdd_function_cptr read_pla_into_cirkit_bdd_job( boost::filesystem::ifstream& stream, unsigned log_max_objs, bool verbose )
+bdd_function_cptr read_pla_into_cirkit_bdd_job( boost::filesystem::ifstream& stream, unsigned log_max_objs, bool reorder, bool verbose )
 {
   assert ( stream );
 
-  from_bdd_pla_processor processor ( log_max_objs, verbose );
+  from_bdd_pla_processor processor ( log_max_objs, reorder, verbose );
   try {
     pla_parser ( stream, processor );
   } catch ( std::exception const& e ) {
@@ -311,7 +314,8 @@ bdd_function_cptr read_pla_into_cirkit_bdd( const boost::filesystem::path &filen
 {
   assert ( !filename.empty() );
 
-  auto log_max_objs = get( settings, "log_max_objs", 24u );
+  auto log_max_objs = get( settings, "log_max_objs", 16u );
+  auto reorder      = get( settings, "reorder",      false );
   auto verbose      = get( settings, "verbose",      false );
 
   boost::filesystem::ifstream stream( filename );
@@ -320,7 +324,7 @@ bdd_function_cptr read_pla_into_cirkit_bdd( const boost::filesystem::path &filen
     return bdd_function_ptr();
   }
 
-  return read_pla_into_cirkit_bdd_job( stream, log_max_objs, verbose );
+  return read_pla_into_cirkit_bdd_job( stream, log_max_objs, reorder, verbose );
 }
 
 std::vector<std::string> bdd_function::input_labels() const { 
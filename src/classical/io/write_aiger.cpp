@@ -148,6 +148,220 @@ void write_aiger( const aig_graph& aig, const std::string& filename, const bool
   fb.close();
 }
 
+void write_aiger( const aig_flat& aig, std::ostream& os, const bool fill_sym_table )
+{
+  /* AIGER requires inputs before gates, but aig_flat allows to create them interleaved */
+  std::vector<unsigned> var( aig.size(), 0u );
+  auto next = 1u;
+  aig.foreach_input( [&]( aig_flat::node_t n, unsigned ) { var[n] = next++; } );
+  aig.foreach_and( [&]( aig_flat::node_t n, aig_flat::literal_t, aig_flat::literal_t ) { var[n] = next++; } );
+
+  const auto to_literal = [&var]( aig_flat::literal_t l ) {
+    return ( var[aig_flat::literal_node( l )] << 1u ) | ( l & 1u );
+  };
+
+  os << boost::format( "aag %d %d 0 %d %d" ) % ( aig.num_inputs() + aig.num_gates() ) % aig.num_inputs() % aig.num_outputs() % aig.num_gates() << std::endl;
+
+  /* inputs */
+  for ( auto i = 1u; i <= aig.num_inputs(); ++i )
+  {
+    os << ( i << 1u ) << std::endl;
+  }
+
+  /* outputs */
+  aig.foreach_output( [&]( aig_flat::literal_t f, unsigned ) { os << to_literal( f ) << std::endl; } );
+
+  /* AND gates */
+  aig.foreach_and( [&]( aig_flat::node_t n, aig_flat::literal_t a, aig_flat::literal_t b ) {
+      os << ( var[n] << 1u ) << " " << to_literal( a ) << " " << to_literal( b ) << std::endl;
+    } );
+
+  /* input names */
+  for ( auto i = 0u; i < aig.num_inputs(); ++i )
+  {
+    if ( !aig.input_name( i ).empty() )
+    {
+      os << "i" << i << " " << aig.input_name( i ) << std::endl;
+    }
+    else if ( fill_sym_table )
+    {
+      os << "i" << i << " input" << i << std::endl;
+    }
+  }
+
+  /* output names */
+  for ( auto i = 0u; i < aig.num_outputs(); ++i )
+  {
+    const auto& name = aig.outputs()[i].second;
+    if ( !name.empty() )
+    {
+      os << "o" << i << " " << name << std::endl;
+    }
+    else if ( fill_sym_table )
+    {
+      os << "o" << i << " output" << i << std::endl;
+    }
+  }
+}
+
+void write_aiger( const aig_flat& aig, const std::string& filename, const bool fill_sym_table )
+{
+  std::filebuf fb;
+  fb.open( filename.c_str(), std::ios::out );
+  std::ostream os( &fb );
+  write_aiger( aig, os, fill_sym_table );
+  fb.close();
+}
+
+
+/******************************************************************************
+ * binary AIGER                                                               *
+ ******************************************************************************/
+
+namespace
+{
+
+/* collects output in a fixed buffer that is passed to the stream in large blocks */
+class aiger_output_buffer
+{
+public:
+  explicit aiger_output_buffer( std::ostream& os ) : os( os ) {}
+  ~aiger_output_buffer() { flush(); }
+
+  inline void put( char c )
+  {
+    if ( pos == sizeof( buffer ) ) { flush(); }
+    buffer[pos++] = c;
+  }
+
+  inline void put( const std::string& s )
+  {
+    for ( auto c : s ) { put( c ); }
+  }
+
+  inline void put_unsigned( unsigned value )
+  {
+    char digits[10];
+    auto n = 0u;
+    do
+    {
+      digits[n++] = '0' + value % 10u;
+      value /= 10u;
+    } while ( value );
+
+    while ( n ) { put( digits[--n] ); }
+  }
+
+  inline void put_delta( unsigned value )
+  {
+    while ( value & ~0x7fu )
+    {
+      put( static_cast<char>( ( value & 0x7fu ) | 0x80u ) );
+      value >>= 7u;
+    }
+    put( static_cast<char>( value ) );
+  }
+
+  void flush()
+  {
+    os.write( buffer, pos );
+    pos = 0u;
+  }
+
+private:
+  std::ostream& os;
+  char          buffer[1u << 16u];
+  std::size_t   pos = 0u;
+};
+
+}
+
+void write_aiger_binary( const aig_flat& aig, std::ostream& os, const bool fill_sym_table )
+{
+  /* binary AIGER requires inputs to be variables 1, ..., I; renumber
+     only if aig_flat has created inputs and gates interleaved */
+  auto direct = true;
+  aig.foreach_input( [&direct]( aig_flat::node_t n, unsigned i ) { direct = direct && n == i + 1u; } );
+
+  std::vector<unsigned> var;
+  if ( !direct )
+  {
+    var.resize( aig.size(), 0u );
+    auto next = 1u;
+    aig.foreach_input( [&]( aig_flat::node_t n, unsigned ) { var[n] = next++; } );
+    aig.foreach_and( [&]( aig_flat::node_t n, aig_flat::literal_t, aig_flat::literal_t ) { var[n] = next++; } );
+  }
+
+  const auto to_literal = [direct, &var]( aig_flat::literal_t l ) {
+    return direct ? l : ( var[aig_flat::literal_node( l )] << 1u ) | ( l & 1u );
+  };
+
+  aiger_output_buffer buf( os );
+
+  /* header */
+  buf.put( "aig " );
+  buf.put_unsigned( aig.num_inputs() + aig.num_gates() ); buf.put( ' ' );
+  buf.put_unsigned( aig.num_inputs() );                   buf.put( " 0 " );
+  buf.put_unsigned( aig.num_outputs() );                  buf.put( ' ' );
+  buf.put_unsigned( aig.num_gates() );                    buf.put( '\n' );
+
+  /* outputs */
+  aig.foreach_output( [&]( aig_flat::literal_t f, unsigned ) {
+      buf.put_unsigned( to_literal( f ) );
+      buf.put( '\n' );
+    } );
+
+  /* AND gates */
+  auto lhs = ( aig.num_inputs() + 1u ) << 1u;
+  aig.foreach_and( [&]( aig_flat::node_t, aig_flat::literal_t a, aig_flat::literal_t b ) {
+      auto r0 = to_literal( a ), r1 = to_literal( b );
+      if ( r0 < r1 ) { std::swap( r0, r1 ); }
+
+      buf.put_delta( lhs - r0 );
+      buf.put_delta( r0 - r1 );
+      lhs += 2u;
+    } );
+
+  /* symbol table */
+  for ( auto i = 0u; i < aig.num_inputs(); ++i )
+  {
+    if ( !aig.input_name( i ).empty() )
+    {
+      buf.put( 'i' ); buf.put_unsigned( i ); buf.put( ' ' ); buf.put( aig.input_name( i ) ); buf.put( '\n' );
+    }
+    else if ( fill_sym_table )
+    {
+      buf.put( 'i' ); buf.put_unsigned( i ); buf.put( " input" ); buf.put_unsigned( i ); buf.put( '\n' );
+    }
+  }
+
+  for ( auto i = 0u; i < aig.num_outputs(); ++i )
+  {
+    const auto& name = aig.outputs()[i].second;
+    if ( !name.empty() )
+    {
+      buf.put( 'o' ); buf.put_unsigned( i ); buf.put( ' ' ); buf.put( name ); buf.put( '\n' );
+    }
+    else if ( fill_sym_table )
+    {
+      buf.put( 'o' ); buf.put_unsigned( i ); buf.put( " output" ); buf.put_unsigned( i ); buf.put( '\n' );
+    }
+  }
+}
+
+void write_aiger_binary( const aig_flat& aig, const std::string& filename, const bool fill_sym_table )
+{
+  std::filebuf fb;
+  if ( !fb.open( filename.c_str(), std::ios::out | std::ios::binary ) )
+  {
+    throw "Error: could not open file for writing (check path and permissions)";
+  }
+
+  std::ostream os( &fb );
+  write_aiger_binary( aig, os, fill_sym_table );
+  fb.close();
+}
+
 }
 
 // Local Variables:
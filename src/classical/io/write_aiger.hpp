@@ -38,6 +38,7 @@
 #define WRITE_AIGER_HPP
 
 #include <classical/aig.hpp>
+#include <classical/aig_flat.hpp>
 
 #include <iostream>
 #include <string>
@@ -48,6 +49,13 @@ namespace cirkit
 void write_aiger( const aig_graph& aig, std::ostream& os, const bool fill_sym_table = false );
 void write_aiger( const aig_graph& aig, const std::string& filename, const bool fill_sym_table = false );
 
+void write_aiger( const aig_flat& aig, std::ostream& os, const bool fill_sym_table = false );
+void write_aiger( const aig_flat& aig, const std::string& filename, const bool fill_sym_table = false );
+
+/* binary AIGER, the output is collected in a buffer and written in large blocks */
+void write_aiger_binary( const aig_flat& aig, std::ostream& os, const bool fill_sym_table = false );
+void write_aiger_binary( const aig_flat& aig, const std::string& filename, const bool fill_sym_table = false );
+
 }
 
 #endif
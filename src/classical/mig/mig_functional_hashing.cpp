@@ -26,7 +26,10 @@
 
 #include "mig_functional_hashing.hpp"
 
+#include <atomic>
 #include <iostream>
+#include <memory>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
@@ -41,6 +44,7 @@
 #include <core/utils/graph_utils.hpp>
 #include <core/utils/range_utils.hpp>
 #include <core/utils/terminal.hpp>
+#include <core/utils/thread_pool.hpp>
 #include <core/utils/timer.hpp>
 #include <classical/functions/cuts/stack.hpp>
 #include <classical/functions/cuts/traits.hpp>
@@ -51,6 +55,7 @@
 #include <classical/mig/mig_functional_hashing_constants.hpp>
 #include <classical/utils/cut_enumeration.hpp>
 #include <classical/utils/cut_enumeration_traits.hpp>
+#include <classical/utils/npn_cache.hpp>
 #include <classical/mig/mig_utils.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 
@@ -175,30 +180,75 @@ struct npn_hash_table_entry_t
 
 using npn_hash_table_t = std::vector<npn_hash_table_entry_t>;
 
+/* best cut of a node inside an FFR, chosen before the node is rebuilt (top-down) */
+struct cut_decision_t
+{
+  bool                    replace = false;
+  mig_node_vec_t          leafs;
+  boost::dynamic_bitset<> phase;
+  std::vector<unsigned>   perm;
+  std::string             expr;
+};
+
+/* NPN cache, scratch memory, and statistics of one worker thread */
+struct worker_state_t
+{
+  worker_state_t( unsigned npn_hash_table_size, unsigned num_nodes )
+    : npn_table( npn_hash_table_size ),
+      local_index( num_nodes, 0u ) {}
+
+  npn_hash_table_t      npn_table;
+  std::vector<unsigned> local_index; /* node to position in the local topological order (bottom-up) */
+  double                runtime_cut = 0.0;
+  double                runtime_npn = 0.0;
+  unsigned long         cache_hit   = 0ul;
+  unsigned long         cache_miss  = 0ul;
+  unsigned long         persistent_cache_hit = 0ul;
+};
+
+/* temporary MIG computed for a region (bottom-up), copied into the new MIG afterwards */
+struct region_result_t
+{
+  mig_graph                                      mig_tmp;
+  std::vector<std::pair<mig_node, mig_node>>     leafs; /* node in mig_tmp and node in mig */
+  std::vector<std::pair<mig_node, mig_function>> roots; /* node in mig and function in mig_tmp */
+};
+
 class mig_functional_hashing_manager
 {
 public:
-  mig_functional_hashing_manager( const mig_graph& mig, bool use_ffrs, bool top_down, unsigned npn_hash_table_size, bool verbose );
+  mig_functional_hashing_manager( const mig_graph& mig, bool use_ffrs, bool top_down, unsigned npn_hash_table_size, unsigned num_threads, bool verbose );
 
   void run();
 
 private:
   int find_best_cut( const mig_node& node, const std::map<aig_node, structural_cut>& cuts,
-                     boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, std::string& expr );
+                     boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, std::string& expr,
+                     worker_state_t& state );
 
-  mig_function optimize_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
-                              const std::map<aig_node, structural_cut>& cuts );
+  void analyze_ffr( const mig_node& root, worker_state_t& state );
+  void analyze_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
+                     const std::map<aig_node, structural_cut>& cuts, worker_state_t& state );
+
+  mig_function optimize_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node );
 
   mig_function optimize_node( const mig_node& node,
                               const std::map<aig_node, structural_cut>& cuts );
 
-  tt compute_npn( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
+  tt compute_npn( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, worker_state_t& state );
+  tt canonize( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, worker_state_t& state );
 
   bool is_fanout_free_cut( const mig_node& node, const boost::dynamic_bitset<>& cut ) const;
 
+  /* analyzes the FFRs in batches, in parallel if possible, and commits them in topological order */
+  template<typename Analyze, typename Commit>
+  void process_ffrs( Analyze&& analyze, Commit&& commit );
+
   // bottom-up
-  void depth_preserving_functional_hashing( const opt_ffr_t& ffr = boost::none );
-  mig_function copy_tmp_to_new( const mig_node& node, const mig_graph& mig_tmp, std::map<mig_node, mig_function>& visited );
+  void depth_preserving_functional_hashing( const opt_ffr_t& ffr, worker_state_t& state, region_result_t& result );
+  void commit_region( const region_result_t& result );
+  mig_function copy_tmp_to_new( const mig_node& node, const mig_graph& mig_tmp,
+                                std::vector<mig_function>& tmp_to_new, boost::dynamic_bitset<>& visited );
 
 private:
   inline std::vector<unsigned> inv( const std::vector<unsigned>& perm ) const
@@ -208,20 +258,31 @@ private:
     return invperm;
   }
 
+  inline void map_node( const mig_node& node, const mig_function& f )
+  {
+    old_to_new[node] = f;
+    has_new.set( node );
+  }
+
 public:
   const mig_graph&                   mig;
   mig_graph                          mig_new;
   const mig_graph_info&              info;
-  std::map<mig_node, mig_function>   old_to_new;
+  std::vector<mig_function>          old_to_new;
+  boost::dynamic_bitset<>            has_new;
   bool                               use_ffrs;
   bool                               top_down;
   mig_node_vec_t                     topsort;
-  std::map<mig_node, mig_node_vec_t> ffrs;
+  std::vector<mig_node_vec_t>        ffrs;         /* leafs of the FFR rooted at a node */
   mig_node_vec_t                     ffrs_topsort;
-  std::map<mig_node, mig_edge_vec_t> ingoing;
+  std::vector<mig_edge_vec_t>        ingoing;
+  std::vector<cut_decision_t>        decisions;
   std::vector<unsigned>              depths;
   unsigned                           max_depth;
-  npn_hash_table_t                   npn_table;
+  unsigned                           npn_hash_table_size;
+  unsigned                           num_threads;
+  std::vector<worker_state_t>        workers;
+  std::unique_ptr<thread_pool>       pool;
   bool                               progress;
   bool                               depth_heuristic;
   unsigned                           max_candidates = 10u;
@@ -234,6 +295,8 @@ public:
   double                             runtime_npn = 0.0;
   unsigned long                      cache_hit = 0ul;
   unsigned long                      cache_miss = 0ul;
+  unsigned long                      persistent_cache_hit = 0ul;
+  npn_cache::ptr                     persistent_cache; /* shared by all workers, approach 4 of the npn command */
   properties::ptr                    ffr_statistics;
 };
 
@@ -241,13 +304,16 @@ public:
  * Private functions                                                          *
  ******************************************************************************/
 
-mig_functional_hashing_manager::mig_functional_hashing_manager( const mig_graph& mig, bool use_ffrs, bool top_down, unsigned npn_hash_table_size, bool verbose )
+mig_functional_hashing_manager::mig_functional_hashing_manager( const mig_graph& mig, bool use_ffrs, bool top_down, unsigned npn_hash_table_size, unsigned num_threads, bool verbose )
   : mig( mig ),
     info( mig_info( mig ) ),
+    old_to_new( boost::num_vertices( mig ) ),
+    has_new( boost::num_vertices( mig ) ),
     use_ffrs( use_ffrs ),
     top_down( top_down ),
     topsort( boost::num_vertices( mig ) ),
-    npn_table( npn_hash_table_size ),
+    npn_hash_table_size( npn_hash_table_size ),
+    num_threads( std::max( 1u, num_threads ) ),
     verbose( verbose )
 {
   mig_initialize( mig_new, info.model_name );
@@ -256,11 +322,11 @@ mig_functional_hashing_manager::mig_functional_hashing_manager( const mig_graph&
   info_new.constant_used = info.constant_used;
 
   /* node to node mapping from old to new mig */
-  old_to_new.insert( {info.constant, {info_new.constant, false}} );
+  map_node( info.constant, {info_new.constant, false} );
 
   for ( const auto& input : info.inputs )
   {
-    old_to_new.insert( {input, mig_create_pi( mig_new, info.node_names.at( input ) )} );
+    map_node( input, mig_create_pi( mig_new, info.node_names.at( input ) ) );
   }
 
   /* outputs */
@@ -282,19 +348,41 @@ mig_functional_hashing_manager::mig_functional_hashing_manager( const mig_graph&
     ffr_settings->set( "verbose",      verbose );
     ffr_settings->set( "relabel",      true );
     ffr_settings->set( "has_constant", true );
-    ffrs = fanout_free_regions( mig, ffr_settings, ffr_statistics );
+    const auto ffr_map = fanout_free_regions( mig, ffr_settings, ffr_statistics );
     runtime_ffr = ffr_statistics->get<double>( "runtime" );
 
     /* sort FFRs in topoplogical order */
-    ffrs_topsort = topological_sort_ffrs<mig_graph>( ffrs, topsort );
+    ffrs_topsort = topological_sort_ffrs<mig_graph>( ffr_map, topsort );
+
+    ffrs.resize( boost::num_vertices( mig ) );
+    for ( const auto& p : ffr_map )
+    {
+      ffrs[p.first] = p.second;
+    }
+
+    if ( top_down )
+    {
+      decisions.resize( boost::num_vertices( mig ) );
+    }
   }
   else
   {
-    ingoing = precompute_ingoing_edges( mig );
+    ingoing.resize( boost::num_vertices( mig ) );
+    for ( const auto& e : boost::make_iterator_range( boost::edges( mig ) ) )
+    {
+      ingoing[boost::target( e, mig )] += e;
+    }
   }
 
   /* compute depths */
   max_depth = compute_depth( mig, outputs, depths );
+
+  /* the FFRs are analyzed in parallel; the caller thread also works while waiting */
+  workers.assign( use_ffrs ? this->num_threads : 1u, worker_state_t( npn_hash_table_size, boost::num_vertices( mig ) ) );
+  if ( use_ffrs && this->num_threads > 1u )
+  {
+    pool.reset( new thread_pool( this->num_threads - 1u ) );
+  }
 }
 
 void mig_functional_hashing_manager::run()
@@ -307,33 +395,21 @@ void mig_functional_hashing_manager::run()
       std::ostream null_out( &ns );
       boost::progress_display show_progress( ffrs_topsort.size(), progress ? std::cout : null_out );
 
-      for ( const auto& id : ffrs_topsort )
-      {
-        ++show_progress;
-
-        L( "[i] optimize ffr at " << id );
+      process_ffrs( [this]( unsigned i, worker_state_t& state ) {
+          analyze_ffr( ffrs_topsort[i], state );
+        },
+        [&]( unsigned i ) {
+          ++show_progress;
 
-        /* already computed? */
-        if ( old_to_new.find( id ) != old_to_new.end() ) { continue; }
+          const auto id = ffrs_topsort[i];
 
-        /* perform cut enumeration */
-        boost::dynamic_bitset<> boundary( boost::num_vertices( mig ) );
-        for ( const auto& ffr_leaf : ffrs.at( id ) )
-        {
-          boundary.set( ffr_leaf );
-        }
+          L( "[i] optimize ffr at " << id );
 
-        auto sce_settings = std::make_shared<properties>();
-        auto sce_statistics = std::make_shared<properties>();
-        sce_settings->set( "boundary", boundary );
-        sce_settings->set( "start_nodes", std::vector<mig_node>( {id} ) );
-        auto cuts = structural_cut_enumeration( mig, 5u, sce_settings, sce_statistics );
+          /* already computed? */
+          if ( has_new.test( id ) ) { return; }
 
-        runtime_cut += sce_statistics->get<double>( "runtime" );
-
-        const auto f = optimize_node( ffrs.at( id ), id, cuts );
-        old_to_new.insert( {id, f} );
-      }
+          map_node( id, optimize_node( ffrs[id], id ) );
+        } );
     }
     else
     {
@@ -361,28 +437,92 @@ void mig_functional_hashing_manager::run()
   {
     if ( use_ffrs )
     {
-      for ( const auto& id : ffrs_topsort )
-      {
-        L( "[i] optimize ffr at " << id );
-
-        depth_preserving_functional_hashing( opt_ffr_t( *ffrs.find( id ) ) );
-      }
+      std::vector<std::unique_ptr<region_result_t>> results( ffrs_topsort.size() );
+
+      process_ffrs( [this, &results]( unsigned i, worker_state_t& state ) {
+          const auto id = ffrs_topsort[i];
+          results[i].reset( new region_result_t );
+          depth_preserving_functional_hashing( opt_ffr_t( std::make_pair( id, ffrs[id] ) ), state, *results[i] );
+        },
+        [this, &results]( unsigned i ) {
+          L( "[i] optimize ffr at " << ffrs_topsort[i] );
+
+          commit_region( *results[i] );
+          results[i].reset();
+        } );
     }
     else
     {
-      depth_preserving_functional_hashing();
+      region_result_t result;
+      depth_preserving_functional_hashing( boost::none, workers.front(), result );
+      commit_region( result );
     }
   }
 
   for ( const auto& output : info.outputs )
   {
-    const auto& f = old_to_new.at( output.first.node );
+    assert( has_new.test( output.first.node ) );
+    const auto& f = old_to_new[output.first.node];
     mig_create_po( mig_new, output.first.complemented ? !f : f, output.second );
   }
+
+  for ( const auto& state : workers )
+  {
+    runtime_cut += state.runtime_cut;
+    runtime_npn += state.runtime_npn;
+    cache_hit   += state.cache_hit;
+    cache_miss  += state.cache_miss;
+    persistent_cache_hit += state.persistent_cache_hit;
+  }
+}
+
+template<typename Analyze, typename Commit>
+void mig_functional_hashing_manager::process_ffrs( Analyze&& analyze, Commit&& commit )
+{
+  /* the analysis only reads the original MIG, while the commit step
+     creates nodes in the new MIG in a fixed order; hence the result
+     does not depend on the number of threads */
+  const auto batch_size = pool ? 16u * num_threads : 1u;
+
+  for ( auto first = 0u; first < ffrs_topsort.size(); first += batch_size )
+  {
+    const auto last = std::min<unsigned>( first + batch_size, ffrs_topsort.size() );
+
+    if ( pool )
+    {
+      std::atomic<unsigned> next( first );
+      task_group group;
+
+      for ( auto& state : workers )
+      {
+        auto* state_ptr = &state;
+        pool->submit( group, [&analyze, &next, last, state_ptr]() {
+            for ( auto i = next++; i < last; i = next++ )
+            {
+              analyze( i, *state_ptr );
+            }
+          } );
+      }
+      pool->wait( group );
+    }
+    else
+    {
+      for ( auto i = first; i < last; ++i )
+      {
+        analyze( i, workers.front() );
+      }
+    }
+
+    for ( auto i = first; i < last; ++i )
+    {
+      commit( i );
+    }
+  }
 }
 
 int mig_functional_hashing_manager::find_best_cut( const mig_node& node, const std::map<mig_node, structural_cut>& cuts,
-                                                   boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, std::string& expr )
+                                                   boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, std::string& expr,
+                                                   worker_state_t& state )
 {
   auto best_gain  = 0u;
   auto best_index = -1;
@@ -404,7 +544,7 @@ int mig_functional_hashing_manager::find_best_cut( const mig_node& node, const s
 
     boost::dynamic_bitset<> local_phase;
     std::vector<unsigned>   local_perm;
-    const auto npn = compute_npn( tt, local_phase, local_perm );
+    const auto npn = compute_npn( tt, local_phase, local_perm, state );
 
     /* better result? */
     const auto best_area  = std::get<0>( mig_functional_hashing_constants::min_depth_mig_sizes.at( npn.to_ulong() ) );
@@ -435,51 +575,103 @@ int mig_functional_hashing_manager::find_best_cut( const mig_node& node, const s
   return best_index;
 }
 
-mig_function mig_functional_hashing_manager::optimize_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
-                                                            const std::map<aig_node, structural_cut>& cuts )
+void mig_functional_hashing_manager::analyze_ffr( const mig_node& root, worker_state_t& state )
+{
+  /* already computed? */
+  if ( has_new.test( root ) ) { return; }
+
+  /* perform cut enumeration */
+  boost::dynamic_bitset<> boundary( boost::num_vertices( mig ) );
+  for ( const auto& ffr_leaf : ffrs[root] )
+  {
+    boundary.set( ffr_leaf );
+  }
+
+  auto sce_settings = std::make_shared<properties>();
+  auto sce_statistics = std::make_shared<properties>();
+  sce_settings->set( "boundary", boundary );
+  sce_settings->set( "start_nodes", std::vector<mig_node>( {root} ) );
+  auto cuts = structural_cut_enumeration( mig, 5u, sce_settings, sce_statistics );
+
+  state.runtime_cut += sce_statistics->get<double>( "runtime" );
+
+  analyze_node( ffrs[root], root, cuts, state );
+}
+
+void mig_functional_hashing_manager::analyze_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node,
+                                                   const std::map<aig_node, structural_cut>& cuts, worker_state_t& state )
+{
+  L( "[i]  analyze node " << node );
+
+  /* node is leaf of the FFR */
+  if ( boost::find( ffr_leafs, node ) != ffr_leafs.end() ) { return; }
+
+  /* nodes are inside exactly one FFR, therefore no other thread writes this entry */
+  auto& decision = decisions[node];
+  const auto best_cut = find_best_cut( node, cuts, decision.phase, decision.perm, decision.expr, state );
+
+  /* there is no better realization */
+  if ( best_cut == -1 )
+  {
+    decision.replace = false;
+    for ( const auto& child : get_children( mig, node ) )
+    {
+      analyze_node( ffr_leafs, child.node, cuts, state );
+    }
+    return;
+  }
+
+  decision.replace = true;
+  decision.leafs.clear();
+  foreach_bit( cuts.at( node ).at( best_cut ), [&]( unsigned child ) {
+      if ( child != 0u )
+      {
+        decision.leafs += child;
+        analyze_node( ffr_leafs, child, cuts, state );
+      }
+    } );
+}
+
+mig_function mig_functional_hashing_manager::optimize_node( const std::vector<mig_node>& ffr_leafs, const mig_node& node )
 {
   L( "[i]  optimize node " << node );
 
   /* node is leaf of the FFR */
   if ( boost::find( ffr_leafs, node ) != ffr_leafs.end() )
   {
-    return old_to_new.at( node );
+    assert( has_new.test( node ) );
+    return old_to_new[node];
   }
 
-  boost::dynamic_bitset<> phase;
-  std::vector<unsigned>   perm;
-  std::string             expr;
-  auto best_cut = find_best_cut( node, cuts, phase, perm, expr );
+  const auto& decision = decisions[node];
 
   /* there is no better realization */
-  if ( best_cut == -1 )
+  if ( !decision.replace )
   {
     auto children = get_children( mig, node );
     return mig_create_maj( mig_new,
-                           optimize_node( ffr_leafs, children[0].node, cuts ) ^ children[0].complemented,
-                           optimize_node( ffr_leafs, children[1].node, cuts ) ^ children[1].complemented,
-                           optimize_node( ffr_leafs, children[2].node, cuts ) ^ children[2].complemented );
+                           optimize_node( ffr_leafs, children[0].node ) ^ children[0].complemented,
+                           optimize_node( ffr_leafs, children[1].node ) ^ children[1].complemented,
+                           optimize_node( ffr_leafs, children[2].node ) ^ children[2].complemented );
   }
 
   std::map<char, mig_function> var_to_function;
   const auto vars = std::string( "abcd" );
   auto index = 0u;
 
-  const auto invperm = inv( perm );
+  const auto invperm = inv( decision.perm );
 
-  foreach_bit( cuts.at( node ).at( best_cut ), [&]( unsigned child ) {
-      if ( child != 0u )
-      {
-        const auto childf = optimize_node( ffr_leafs, child, cuts );
-        var_to_function.insert( {vars[invperm[index]], phase.test( index ) ? !childf : childf} );
-        ++index;
-      }
-    } );
+  for ( const auto& child : decision.leafs )
+  {
+    const auto childf = optimize_node( ffr_leafs, child );
+    var_to_function.insert( {vars[invperm[index]], decision.phase.test( index ) ? !childf : childf} );
+    ++index;
+  }
 
   auto mfs_settings = std::make_shared<properties>();
   mfs_settings->set( "variable_map", var_to_function );
 
-  return make_function( mig_from_string( mig_new, expr, mfs_settings ), phase.test( phase.size() - 1u ) );
+  return make_function( mig_from_string( mig_new, decision.expr, mfs_settings ), decision.phase.test( decision.phase.size() - 1u ) );
 }
 
 mig_function mig_functional_hashing_manager::optimize_node( const mig_node& node,
@@ -488,13 +680,12 @@ mig_function mig_functional_hashing_manager::optimize_node( const mig_node& node
   L( "[i]  optimize node " << node );
 
   /* already computed? */
-  const auto it = old_to_new.find( node );
-  if ( it != old_to_new.end() ) { return it->second; }
+  if ( has_new.test( node ) ) { return old_to_new[node]; }
 
   boost::dynamic_bitset<> phase;
   std::vector<unsigned>   perm;
   std::string             expr;
-  auto best_cut = find_best_cut( node, cuts, phase, perm, expr );
+  auto best_cut = find_best_cut( node, cuts, phase, perm, expr, workers.front() );
 
   /* there is no better realization */
   if ( best_cut == -1 )
@@ -505,7 +696,7 @@ mig_function mig_functional_hashing_manager::optimize_node( const mig_node& node
                              make_function( optimize_node( children[1].node, cuts ), children[1].complemented ),
                              make_function( optimize_node( children[2].node, cuts ), children[2].complemented ) );
 
-    old_to_new.insert( {node, f} );
+    map_node( node, f );
     return f;
   }
 
@@ -534,14 +725,15 @@ mig_function mig_functional_hashing_manager::optimize_node( const mig_node& node
     f = !f;
   }
 
-  old_to_new.insert( {node, f} );
+  map_node( node, f );
 
   return f;
 }
 
-tt mig_functional_hashing_manager::compute_npn( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+tt mig_functional_hashing_manager::compute_npn( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, worker_state_t& state )
 {
   boost::dynamic_bitset<> npn;
+  auto& npn_table = state.npn_table;
 
   /* compute NPN and use hash table if possible */
   if ( !npn_table.empty() )
@@ -552,16 +744,15 @@ tt mig_functional_hashing_manager::compute_npn( const tt& tt, boost::dynamic_bit
 
     if ( static_cast<unsigned long>( entry.tt ) == ttu )
     {
-      ++cache_hit;
+      ++state.cache_hit;
       npn = boost::dynamic_bitset<>( 16u, entry.npn );
       perm = std::vector<unsigned>( entry.perm );
       phase = boost::dynamic_bitset<>( entry.phase );
     }
     else
     {
-      ++cache_miss;
-      increment_timer t( &runtime_npn );
-      npn = exact_npn_canonization( tt, phase, perm );
+      ++state.cache_miss;
+      npn = canonize( tt, phase, perm, state );
 
       entry.tt    = ttu;
       entry.npn   = npn.to_ulong();
@@ -571,13 +762,31 @@ tt mig_functional_hashing_manager::compute_npn( const tt& tt, boost::dynamic_bit
   }
   else
   {
-    increment_timer t( &runtime_npn );
-    npn = exact_npn_canonization( tt, phase, perm );
+    npn = canonize( tt, phase, perm, state );
   }
 
   return npn;
 }
 
+tt mig_functional_hashing_manager::canonize( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm, worker_state_t& state )
+{
+  increment_timer t( &state.runtime_npn );
+
+  boost::dynamic_bitset<> npn;
+  if ( persistent_cache && persistent_cache->lookup( tt, npn, phase, perm ) )
+  {
+    ++state.persistent_cache_hit;
+    return npn;
+  }
+
+  npn = exact_npn_canonization_fast( tt, phase, perm );
+  if ( persistent_cache )
+  {
+    persistent_cache->insert( tt, npn, phase, perm );
+  }
+  return npn;
+}
+
 bool mig_functional_hashing_manager::is_fanout_free_cut( const mig_node& node, const boost::dynamic_bitset<>& cut ) const
 {
   const auto cone = cut_cone( node, cut, mig );
@@ -588,7 +797,7 @@ bool mig_functional_hashing_manager::is_fanout_free_cut( const mig_node& node, c
   {
     if ( pos != node && !cut.test( pos ) )
     {
-      for ( const auto& in : ingoing.at( pos ) )
+      for ( const auto& in : ingoing[pos] )
       {
         if ( !cone.test( boost::target( in, mig ) ) )
         {
@@ -603,18 +812,15 @@ bool mig_functional_hashing_manager::is_fanout_free_cut( const mig_node& node, c
   return true;
 }
 
-void mig_functional_hashing_manager::depth_preserving_functional_hashing( const opt_ffr_t& ffr )
+void mig_functional_hashing_manager::depth_preserving_functional_hashing( const opt_ffr_t& ffr, worker_state_t& state, region_result_t& result )
 {
   /* size of the MIG */
   const auto n = boost::num_vertices( mig );
 
   /* a temporary MIG */
-  mig_graph mig_tmp;
+  auto& mig_tmp = result.mig_tmp;
   mig_initialize( mig_tmp, info.model_name );
 
-  /* map nodes from mig to candidates in mig_tmp */
-  std::vector<visited_entry_t> node_map( n );
-
   /* topological sort */
   std::vector<mig_node> topsort;
 
@@ -633,6 +839,14 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
                               [&]( const mig_node& n, const mig_graph& mig ) { return boost::find( ffr->second, n ) != ffr->second.end(); } );
   }
 
+  /* map nodes from mig to candidates in mig_tmp, indexed by position in topsort */
+  std::vector<visited_entry_t> node_map( topsort.size() );
+  auto& local_index = state.local_index;
+  for ( auto i = 0u; i < topsort.size(); ++i )
+  {
+    local_index[topsort[i]] = i;
+  }
+
   /* iterate through the vertices */
   for ( const auto& node : topsort )
   {
@@ -645,13 +859,13 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
       if ( node == info.constant )
       {
         candidate_t candidate{ mig_get_constant( mig_tmp, false ), 0u, 0u };
-        node_map[node] = {{candidate}, {{boost::dynamic_bitset<>( n )}}};
+        node_map[local_index[node]] = {{candidate}, {{boost::dynamic_bitset<>( n )}}};
       }
       else
       {
         //candidate_t candidate{ mig_create_pi( mig_tmp, info.node_names.at( node ) ), 0u, 0u };
         candidate_t candidate{ mig_create_pi( mig_tmp, boost::str( boost::format( "PI_%d" ) % node ) ), 0u, 0u };
-        node_map[node] = {{candidate}, {{onehot_bitset( n, node )}}};
+        node_map[local_index[node]] = {{candidate}, {{onehot_bitset( n, node )}}};
       }
     }
     else
@@ -661,11 +875,11 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
 
       const auto children = get_children( mig, node );
 
-      for ( const auto& c1 : node_map[children[0u].node].cuts )
+      for ( const auto& c1 : node_map[local_index[children[0u].node]].cuts )
       {
-        for ( const auto& c2 : node_map[children[1u].node].cuts )
+        for ( const auto& c2 : node_map[local_index[children[1u].node]].cuts )
         {
-          for ( const auto& c3 : node_map[children[2u].node].cuts )
+          for ( const auto& c3 : node_map[local_index[children[2u].node]].cuts )
           {
             const auto new_cut = c1 | c2 | c3;
             if ( new_cut.count() >= 5u ) continue;
@@ -680,9 +894,9 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
 
       /* default substitution */
       std::vector<unsigned> a( 4u, 0u );
-      std::vector<unsigned> m{ 2u, (unsigned)node_map[children[0u].node].candidates.size(),
-                                   (unsigned)node_map[children[1u].node].candidates.size(),
-                                   (unsigned)node_map[children[2u].node].candidates.size() };
+      std::vector<unsigned> m{ 2u, (unsigned)node_map[local_index[children[0u].node]].candidates.size(),
+                                   (unsigned)node_map[local_index[children[1u].node]].candidates.size(),
+                                   (unsigned)node_map[local_index[children[2u].node]].candidates.size() };
 
       mixed_radix( a, m, [&]( const std::vector<unsigned>& a ) {
           std::vector<mig_function> fs( 3u );
@@ -690,7 +904,7 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
 
           for ( auto i = 0u; i < 3u; ++i )
           {
-            const auto& cand = node_map[children[i].node].candidates[a[i + 1u]];
+            const auto& cand = node_map[local_index[children[i].node]].candidates[a[i + 1u]];
             fs[i] = make_function( cand.f, children[i].complemented );
             max_depth = std::max( max_depth, cand.depth );
           }
@@ -719,7 +933,7 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
 
         boost::dynamic_bitset<> phase;
         std::vector<unsigned>   perm;
-        const auto npn = compute_npn( tt, phase, perm );
+        const auto npn = compute_npn( tt, phase, perm, state );
 
         const auto best_area = std::get<0>( mig_functional_hashing_constants::min_depth_mig_sizes.at( npn.to_ulong() ) );
 
@@ -737,7 +951,7 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
 
         for ( auto i = 0u; i < leafs.size(); ++i )
         {
-          m[i + 1u] = node_map[leafs[i]].candidates.size();
+          m[i + 1u] = node_map[local_index[leafs[i]]].candidates.size();
           assert( m[i + 1u] > 0u );
         }
 
@@ -751,7 +965,7 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
             auto index = 0u;
             for ( auto i = 0u; i < leafs.size(); ++i )
             {
-              const auto& cand  = node_map[leafs[i]].candidates[a[i + 1u]];
+              const auto& cand  = node_map[local_index[leafs[i]]].candidates[a[i + 1u]];
               const auto childf = cand.f;
 
               const auto key = 'a' + invperm[index];
@@ -782,7 +996,7 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
           } );
       }
 
-      node_map[node] = {candidates, cuts};
+      node_map[local_index[node]] = {candidates, cuts};
 
       L( boost::format( "[i] found %d candidates" ) % candidates.size() );
     }
@@ -790,64 +1004,66 @@ void mig_functional_hashing_manager::depth_preserving_functional_hashing( const
 
   if ( ffr == boost::none )
   {
-    std::map<mig_node, mig_function> tmp_to_new;
-
-    for ( const auto& p : old_to_new )
+    for ( auto pos = has_new.find_first(); pos != boost::dynamic_bitset<>::npos; pos = has_new.find_next( pos ) )
     {
-      assert( node_map[p.first].candidates.size() == 1u );
-      tmp_to_new.insert( {node_map[p.first].candidates.front().f.node, p.second} );
+      assert( node_map[local_index[pos]].candidates.size() == 1u );
+      result.leafs.push_back( {node_map[local_index[pos]].candidates.front().f.node, pos} );
     }
 
     for ( const auto& output : info.outputs )
     {
-      const auto tmp_f = node_map[output.first.node].min_element( max_candidates, sort_area_first ).f;
-      const auto f = make_function( copy_tmp_to_new( tmp_f.node, mig_tmp, tmp_to_new ), tmp_f.complemented );
-      old_to_new.insert( {output.first.node, f} );
+      result.roots.push_back( {output.first.node, node_map[local_index[output.first.node]].min_element( max_candidates, sort_area_first ).f} );
     }
   }
   else
   {
-    std::map<mig_node, mig_function> tmp_to_new;
-
     for ( const auto& child : ffr->second )
     {
-      assert( node_map[child].candidates.size() == 1u );
-      tmp_to_new.insert( {node_map[child].candidates.front().f.node, old_to_new.at( child )} );
+      assert( node_map[local_index[child]].candidates.size() == 1u );
+      result.leafs.push_back( {node_map[local_index[child]].candidates.front().f.node, child} );
     }
 
-    const auto tmp_f = node_map[ffr->first].min_element( max_candidates, sort_area_first ).f;
+    result.roots.push_back( {ffr->first, node_map[local_index[ffr->first]].min_element( max_candidates, sort_area_first ).f} );
+  }
+}
 
-    // std::cout << "candidates for " << ffr->first << std::endl;
+void mig_functional_hashing_manager::commit_region( const region_result_t& result )
+{
+  const auto n = boost::num_vertices( result.mig_tmp );
+  std::vector<mig_function> tmp_to_new( n );
+  boost::dynamic_bitset<>   visited( n );
 
-    // for ( const auto& c : node_map[ffr->first].candidates )
-    // {
-    //   std::cout << "  " << c.f.node << " " << c.area << " " << c.depth << std::endl;
-    // }
+  for ( const auto& leaf : result.leafs )
+  {
+    assert( has_new.test( leaf.second ) );
+    tmp_to_new[leaf.first] = old_to_new[leaf.second];
+    visited.set( leaf.first );
+  }
 
-    const auto f = make_function( copy_tmp_to_new( tmp_f.node, mig_tmp, tmp_to_new ), tmp_f.complemented );
-    old_to_new.insert( {ffr->first, f} );
+  for ( const auto& root : result.roots )
+  {
+    const auto f = make_function( copy_tmp_to_new( root.second.node, result.mig_tmp, tmp_to_new, visited ), root.second.complemented );
+    if ( !has_new.test( root.first ) )
+    {
+      map_node( root.first, f );
+    }
   }
 }
 
-mig_function mig_functional_hashing_manager::copy_tmp_to_new( const mig_node& node, const mig_graph& mig_tmp, std::map<mig_node, mig_function>& visited )
+mig_function mig_functional_hashing_manager::copy_tmp_to_new( const mig_node& node, const mig_graph& mig_tmp,
+                                                              std::vector<mig_function>& tmp_to_new, boost::dynamic_bitset<>& visited )
 {
-  const auto it = visited.find( node );
-  if ( it != visited.end() ) { return it->second; }
-
-  // if ( boost::out_degree( node, mig_tmp ) == 0u )
-  // {
-  //   std::cout << "vertex " << node << " should not be a termimal." << std::endl;
-  //   assert( false );
-  // }
+  if ( visited.test( node ) ) { return tmp_to_new[node]; }
 
   const auto children = get_children( mig_tmp, node );
 
   auto f = mig_create_maj( mig_new,
-                           make_function( copy_tmp_to_new( children[0u].node, mig_tmp, visited ), children[0u].complemented ),
-                           make_function( copy_tmp_to_new( children[1u].node, mig_tmp, visited ), children[1u].complemented ),
-                           make_function( copy_tmp_to_new( children[2u].node, mig_tmp, visited ), children[2u].complemented ) );
+                           make_function( copy_tmp_to_new( children[0u].node, mig_tmp, tmp_to_new, visited ), children[0u].complemented ),
+                           make_function( copy_tmp_to_new( children[1u].node, mig_tmp, tmp_to_new, visited ), children[1u].complemented ),
+                           make_function( copy_tmp_to_new( children[2u].node, mig_tmp, tmp_to_new, visited ), children[2u].complemented ) );
 
-  visited.insert( {node, f} );
+  tmp_to_new[node] = f;
+  visited.set( node );
   return f;
 }
 
@@ -869,19 +1085,28 @@ mig_graph mig_functional_hashing( const mig_graph& mig,
   const auto allow_area_inc      = get( settings, "allow_area_inc",      false );
   const auto allow_depth_inc     = get( settings, "allow_depth_inc",     false );
   const auto sort_area_first     = get( settings, "sort_area_first",     true );
+  const auto num_threads         = get( settings, "num_threads",         1u );
+  const auto npn_cache_file      = get( settings, "npn_cache",           std::string() );
   const auto verbose             = get( settings, "verbose",             false );
 
   /* timing */
   properties_timer t( statistics );
 
   /* new graph */
-  mig_functional_hashing_manager mgr( mig, use_ffrs, top_down, npn_hash_table_size, verbose );
+  /* log messages of different FFRs would interleave */
+  const auto threads = verbose ? 1u : ( num_threads == 0u ? std::thread::hardware_concurrency() : num_threads );
+
+  mig_functional_hashing_manager mgr( mig, use_ffrs, top_down, npn_hash_table_size, threads, verbose );
   mgr.depth_heuristic = depth_heuristic;
   mgr.progress        = progress;
   mgr.max_candidates  = max_candidates;
   mgr.allow_area_inc  = allow_area_inc;
   mgr.allow_depth_inc = allow_depth_inc;
   mgr.sort_area_first = sort_area_first;
+  if ( !npn_cache_file.empty() )
+  {
+    mgr.persistent_cache = std::make_shared<npn_cache>( npn_cache_file, 4u );
+  }
 
   mgr.run();
 
@@ -890,6 +1115,7 @@ mig_graph mig_functional_hashing( const mig_graph& mig,
   set( statistics, "runtime_npn", mgr.runtime_npn );
   set( statistics, "cache_hit",   mgr.cache_hit );
   set( statistics, "cache_miss",  mgr.cache_miss );
+  set( statistics, "persistent_cache_hit", mgr.persistent_cache_hit );
 
   return mgr.mig_new;
 }
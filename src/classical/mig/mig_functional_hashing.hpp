@@ -42,6 +42,19 @@
 namespace cirkit
 {
 
+/**
+ * @brief Functional hashing
+ *
+ * If use_ffrs is set, num_threads threads (0 for one per core) analyze
+ * the fanout-free regions concurrently.  The new MIG is built in
+ * topological order afterwards, hence the result is the same for any
+ * number of threads.
+ *
+ * If npn_cache is the name of a persistent NPN cache file (see
+ * npn_cache.hpp), canonizations missing in the in-process hash table are
+ * looked up in and added to that file.  It is shared with approach 4 of
+ * the `npn' command.
+ */
 mig_graph mig_functional_hashing( const mig_graph& mig,
                                   const properties::ptr& settings = properties::ptr(),
                                   const properties::ptr& statistics = properties::ptr() );
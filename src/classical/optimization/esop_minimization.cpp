@@ -45,6 +45,7 @@
 #include <core/utils/range_utils.hpp>
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
+#include <classical/utils/cube2_array.hpp>
 
 using namespace boost::assign;
 
@@ -77,6 +78,11 @@ std::ostream& operator<<( std::ostream& os, const cube_t& cube )
   return os;
 }
 
+cube2 to_cube2( const cube_t& cube )
+{
+  return cube2( ( cube.first & cube.second ).to_ulong(), cube.second.to_ulong() );
+}
+
 boost::dynamic_bitset<> diff_cube( const cube_t& c1, const cube_t& c2 )
 {
   return ((c1.second ^ c2.second) | ((c1.second & c1.first) ^ (c2.second & c2.first)));
@@ -144,19 +150,44 @@ public:
   void add_cube( cube_t cube )
   {
     unsigned cubeid = 0u;
-    std::vector<char> distances( _cubes.size() );
+    std::vector<unsigned char> distances( _cubes.size() );
     int bit_pos = -1;
 
-    for ( ; cubeid < _cubes.size(); ++cubeid )
+    if ( _cubes.empty() )
     {
-      const cube_t& c = _cubes.at( cubeid );
+      packed = cube.first.size() <= 32u;
+    }
 
+    if ( packed )
+    {
       /* distance-0 */
-      if ( ( distances[cubeid] = compute_distance( c, cube, bit_pos ) ) == 0 )
+      _packed.distances( to_cube2( cube ), distances );
+      auto it = boost::find( distances, 0 );
+      if ( it != distances.end() )
       {
-        remove_cube( cubeid );
+        remove_cube( std::distance( distances.begin(), it ) );
         return;
       }
+
+      it = boost::find( distances, 1 );
+      if ( it != distances.end() )
+      {
+        bit_pos = diff_cube( _cubes.at( std::distance( distances.begin(), it ) ), cube ).find_first();
+      }
+    }
+    else
+    {
+      for ( ; cubeid < _cubes.size(); ++cubeid )
+      {
+        const cube_t& c = _cubes.at( cubeid );
+
+        /* distance-0 */
+        if ( ( distances[cubeid] = compute_distance( c, cube, bit_pos ) ) == 0 )
+        {
+          remove_cube( cubeid );
+          return;
+        }
+      }
     }
 
     /* distance-1 */
@@ -181,6 +212,10 @@ public:
     }
 
     _cubes += cube;
+    if ( packed )
+    {
+      _packed.push_back( to_cube2( cube ) );
+    }
   }
 
   void remove_from_distance_list( cube_pair_list_t& l, unsigned cubeid, bool remove_first = true, bool remove_second = true )
@@ -198,6 +233,10 @@ public:
   void remove_cube( unsigned cubeid )
   {
     _cubes.erase( _cubes.begin() + cubeid );
+    if ( packed )
+    {
+      _packed.erase( cubeid );
+    }
 
     /* remove from distance lists */
     for ( unsigned i = 0u; i < 3u; ++i )
@@ -288,13 +327,17 @@ public:
         }
 
         bit_pos = -1;
+        if ( packed )
+        {
+          _packed.distances( to_cube2( tmp_cubes[i] ), tmp_distances );
+        }
+
         for ( unsigned cubeid = 0u; cubeid < _cubes.size(); ++cubeid )
         {
           /* do not calculate distance to given cubes */
           if ( cubeid == cubeid1 || cubeid == cubeid2 ) continue;
 
-          const cube_t& ex_cube = _cubes.at( cubeid );
-          auto d = compute_distance( ex_cube, tmp_cubes[i], bit_pos );
+          const auto d = packed ? tmp_distances[cubeid] : compute_distance( _cubes.at( cubeid ), tmp_cubes[i], bit_pos );
           if ( d == 0u )
           {
             improvement -= 2;
@@ -461,6 +504,11 @@ private:
   std::vector<cube_t> _cubes;
   std::vector<cube_pair_list_t> distance_lists;
 
+  /* cubes with up to 32 variables are also stored as cube2_array for distance sweeps */
+  bool packed = false;
+  cube2_array _packed;
+  std::vector<unsigned char> tmp_distances;
+
   static unsigned cube_groups[];
   static unsigned cube_group_count[];
   static unsigned cube_group_offsets[];
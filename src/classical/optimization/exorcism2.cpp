@@ -32,6 +32,7 @@
 #include <core/utils/buckets.hpp>
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
+#include <classical/utils/cube2_array.hpp>
 
 namespace cirkit
 {
@@ -216,9 +217,17 @@ private:
 
   int pair_with_others( const cube2& c, unsigned level )
   {
+    const auto count = cubes.size( level );
+    if ( !count ) return -1;
+
+    /* distances to all cubes of the bucket in one sweep (the buffer is not
+       used anymore after the recursive call to add_cube below) */
+    distances.resize( count );
+    cube2_distances( c, &*cubes.begin( level ), count, distances.data() );
+
     for ( auto it = cubes.begin( level ); it != cubes.end( level ); ++it )
     {
-      const auto d = c.distance( *it );
+      const int d = distances[std::distance( cubes.begin( level ), it )];
       if ( d == 1 )
       {
         const auto new_cube = c.merge( *it );
@@ -417,6 +426,8 @@ private:
   std::vector<boost::circular_buffer<std::pair<cube2, cube2>>> pairs;
   std::vector<std::vector<std::pair<cube2, cube2>>> pairs_tmp;
 
+  std::vector<unsigned char> distances;
+
   /* bookkeeping */
   cube2 last_added;
   cube2 last_removed;
@@ -32,6 +32,7 @@
 #include <cstdlib>
 #include <fstream>
 #include <iostream>
+#include <mutex>
 
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
@@ -44,6 +45,8 @@
 #include <classical/abc/abc_api.hpp>
 #include <classical/abc/abc_manager.hpp>
 #include <classical/abc/functions/cirkit_to_gia.hpp>
+#include <classical/optimization/exorcism_parallel.hpp>
+#include <classical/utils/cube2.hpp>
 
 #include <base/exor/exor.h>
 #include <misc/vec/vecInt.h>
@@ -71,6 +74,9 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+/* EXORCISM keeps the cover in global variables */
+static std::mutex exorcism_mutex;
+
 class exorcism_processor : public pla_processor
 {
 public:
@@ -288,6 +294,55 @@ void reduce_cover_script_def_wo4( bool progress )
   }
 }
 
+gia_graph::esop_ptr exorcism_parallel_minimization( const gia_graph::esop_ptr& esop, unsigned ninputs,
+                                                    const properties::ptr& settings,
+                                                    const properties::ptr& statistics )
+{
+  std::vector<cube2> cubes;
+  cubes.reserve( abc::Vec_WecSize( esop.get() ) );
+
+  int i;
+  abc::Vec_Int_t *vec;
+  Vec_WecForEachLevel( esop.get(), vec, i )
+  {
+    cube2 c;
+    for ( auto j = 0; j < abc::Vec_IntSize( vec ); ++j )
+    {
+      const auto lit = abc::Vec_IntEntry( vec, j );
+      if ( lit < 0 ) continue; /* single output */
+
+      c.mask |= 1u << abc::Abc_Lit2Var( lit );
+      if ( !abc::Abc_LitIsCompl( lit ) )
+      {
+        c.bits |= 1u << abc::Abc_Lit2Var( lit );
+      }
+    }
+    cubes.push_back( c );
+  }
+
+  std::vector<cube2> result;
+  {
+    properties_timer t( statistics, "exorcism_opt_time" );
+    result = exorcism_parallel( cubes, ninputs, settings );
+  }
+
+  auto * esop_opt = abc::Vec_WecAlloc( result.size() );
+  for ( const auto& c : result )
+  {
+    auto * level = abc::Vec_WecPushLevel( esop_opt );
+    for ( auto v = 0u; v < ninputs; ++v )
+    {
+      if ( ( c.mask >> v ) & 1 )
+      {
+        abc::Vec_IntPush( level, abc::Abc_Var2Lit( v, !( ( c.bits >> v ) & 1 ) ) );
+      }
+    }
+    abc::Vec_IntPush( level, -1 );
+  }
+
+  return gia_graph::esop_ptr( esop_opt, &abc::Vec_WecFree );
+}
+
 void reduce_cover( bool progress, exorcism_script script )
 {
   switch ( script )
@@ -298,6 +353,7 @@ void reduce_cover( bool progress, exorcism_script script )
     reduce_cover_script_def( progress );
     break;
   case exorcism_script::def_wo4:
+  case exorcism_script::parallel:
     reduce_cover_script_def_wo4( progress );
     break;
   }
@@ -376,6 +432,13 @@ gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsi
 
   properties_timer t( statistics );
 
+  if ( script == exorcism_script::parallel && noutputs == 1u && ninputs <= 32u )
+  {
+    return exorcism_parallel_minimization( esop, ninputs, settings, statistics );
+  }
+
+  std::lock_guard<std::mutex> lock( exorcism_mutex );
+
   /* initialize */
   memset( &abc::g_CoverInfo, 0, sizeof( abc::cinfo ) );
   abc::g_CoverInfo.Quality = static_cast<int>( quality );
@@ -74,7 +74,8 @@ enum class exorcism_script
 {
   none,
   def,
-  def_wo4
+  def_wo4,
+  parallel /* exorcism_parallel for single-output covers with up to 32 inputs, otherwise def_wo4 */
 };
 
 gia_graph::esop_ptr exorcism_minimization( const gia_graph::esop_ptr& esop, unsigned ninputs, unsigned noutputs,
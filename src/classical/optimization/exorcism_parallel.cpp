@@ -0,0 +1,561 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "exorcism_parallel.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+
+#include <core/utils/terminal.hpp>
+#include <core/utils/thread_pool.hpp>
+#include <core/utils/timer.hpp>
+#include <classical/utils/cube2_array.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+namespace
+{
+
+struct reduction_t
+{
+  unsigned             c1, c2;   /* pair in the cover */
+  int                  cubes;    /* change in number of cubes */
+  int                  literals; /* change in number of literals */
+  unsigned             num_new;
+  std::array<cube2, 4> new_cubes;
+  std::array<int, 4>   partner;  /* cube in the cover that cancels or merges with new cube, or -1 */
+  std::array<bool, 4>  add;      /* false, if new cube cancels with partner */
+};
+
+inline bool operator<( const reduction_t& r1, const reduction_t& r2 )
+{
+  return std::tie( r1.cubes, r1.literals, r1.c1, r1.c2 ) < std::tie( r2.cubes, r2.literals, r2.c1, r2.c2 );
+}
+
+}
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+class exorcism_parallel_manager
+{
+public:
+  exorcism_parallel_manager( const std::vector<cube2>& original, int num_vars, const properties::ptr& settings )
+    : cover( original ),
+      num_vars( num_vars ),
+      init_cubes_size( original.size() ),
+
+      num_threads( get( settings, "num_threads", 0u ) ),
+      deterministic( get( settings, "deterministic", true ) ),
+      max_distance( std::min( get( settings, "max_distance", 4u ), 4u ) ),
+      quality( get( settings, "quality", 2u ) ),
+      improve_literals( get( settings, "improve_literals", true ) ),
+      progress( get( settings, "progress", false ) )
+  {
+    if ( num_threads == 0u )
+    {
+      num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+    }
+
+    canonicalize();
+  }
+
+  std::vector<cube2> run()
+  {
+    unsigned no_gain = 0u;
+    double runtime = 0.0;
+
+    progress_line p( "[i] exorcism   iter = %3d   i/o = %2d/1   cubes = %6d/%6d   total = %6.2f", progress );
+
+    do
+    {
+      increment_timer t( &runtime );
+      p( ++iterations, num_vars, cover.size(), init_cubes_size, runtime );
+
+      auto gain = pass( 1u );
+      gain += pass( 2u );
+      gain += pass( 1u );
+      gain += pass( 3u );
+      gain += pass( 1u );
+
+      /* distance 4 is expensive, only try it when the others got stuck */
+      if ( no_gain > 0u )
+      {
+        gain += pass( 4u );
+        gain += pass( 1u );
+      }
+
+      no_gain = gain ? 0u : no_gain + 1u;
+    } while ( no_gain < std::max( quality, 1u ) );
+
+    if ( improve_literals )
+    {
+      literal_mode = true;
+      pass( 2u );
+      pass( 3u );
+      pass( 1u );
+      literal_mode = false;
+    }
+
+    return cover;
+  }
+
+  unsigned iterations = 0u;
+  unsigned rounds     = 0u;
+  unsigned reductions = 0u;
+
+private:
+  /* equal cubes cancel each other */
+  void canonicalize()
+  {
+    std::sort( cover.begin(), cover.end(), []( const cube2& c1, const cube2& c2 ) { return c1.value < c2.value; } );
+
+    auto out = cover.begin();
+    for ( auto it = cover.begin(); it != cover.end(); )
+    {
+      auto next = it + 1;
+      while ( next != cover.end() && *next == *it ) { ++next; }
+      if ( ( next - it ) % 2 )
+      {
+        *out++ = *it;
+      }
+      it = next;
+    }
+    cover.erase( out, cover.end() );
+  }
+
+  inline int lookup( const cube2& c ) const
+  {
+    const auto it = index.find( c.value );
+    return it == index.end() ? -1 : static_cast<int>( it->second );
+  }
+
+  /* the two cubes that differ from c only in variable v */
+  inline std::array<cube2, 2> neighbors( const cube2& c, unsigned v ) const
+  {
+    const auto bit = 1u << v;
+    if ( !( c.mask & bit ) )           /* * -> x, ~x */
+    {
+      return {{cube2( c.bits | bit, c.mask | bit ), cube2( c.bits, c.mask | bit )}};
+    }
+    else if ( c.bits & bit )           /* x -> ~x, * */
+    {
+      return {{cube2( c.bits & ~bit, c.mask ), cube2( c.bits & ~bit, c.mask & ~bit )}};
+    }
+    else                               /* ~x -> x, * */
+    {
+      return {{cube2( c.bits | bit, c.mask ), cube2( c.bits, c.mask & ~bit )}};
+    }
+  }
+
+  inline bool is_partner( const reduction_t& r, unsigned k, int p ) const
+  {
+    if ( p == -1 || p == static_cast<int>( r.c1 ) || p == static_cast<int>( r.c2 ) ) return false;
+    for ( auto l = 0u; l < k; ++l )
+    {
+      if ( r.partner[l] == p ) return false;
+    }
+    return true;
+  }
+
+  /* new cubes are checked against the snapshot of the cover */
+  void check_variant( unsigned i, unsigned j, const std::array<cube2, 4>& nc, unsigned num_new, int cubes, int literals,
+                      reduction_t& best, bool& found ) const
+  {
+    reduction_t r;
+    r.c1 = i;
+    r.c2 = j;
+    r.cubes = cubes;
+    r.literals = literals;
+    r.num_new = num_new;
+
+    for ( auto k = 0u; k < num_new; ++k )
+    {
+      const auto lits = nc[k].num_literals();
+
+      r.new_cubes[k] = nc[k];
+      r.partner[k] = -1;
+      r.add[k] = true;
+      r.literals += lits;
+
+      const auto p = lookup( nc[k] );
+      if ( is_partner( r, k, p ) )
+      {
+        r.partner[k] = p;
+        r.add[k] = false;
+        r.cubes -= 2;
+        r.literals -= 2 * lits;
+        continue;
+      }
+
+      for ( auto v = 0; v < num_vars && r.partner[k] == -1; ++v )
+      {
+        for ( const auto& x : neighbors( nc[k], v ) )
+        {
+          const auto p = lookup( x );
+          if ( is_partner( r, k, p ) )
+          {
+            r.partner[k] = p;
+            r.new_cubes[k] = nc[k].merge( x );
+            r.cubes -= 1;
+            r.literals += r.new_cubes[k].num_literals() - lits - x.num_literals();
+            break;
+          }
+        }
+      }
+    }
+
+    if ( !found || std::tie( r.cubes, r.literals ) < std::tie( best.cubes, best.literals ) )
+    {
+      best = r;
+      found = true;
+    }
+  }
+
+  void evaluate( unsigned i, unsigned j, unsigned d, std::vector<reduction_t>& out )
+  {
+    const auto& a = cover[i];
+    const auto& b = cover[j];
+    const auto literals = -a.num_literals() - b.num_literals();
+
+    reduction_t best;
+    bool found = false;
+
+    if ( d == 1u )
+    {
+      std::array<cube2, 4> nc;
+      nc[0] = a.merge( b );
+      check_variant( i, j, nc, 1u, -1, literals, best, found );
+    }
+    else
+    {
+      const auto diff = a.differences( b );
+      for ( auto g = 0u; g < cube2_exorlink_num_groups( d ); ++g )
+      {
+        check_variant( i, j, a.exorlink( b, d, diff, cube2_exorlink_group( d, g ) ), d, static_cast<int>( d ) - 2, literals, best, found );
+      }
+    }
+
+    if ( best.cubes > 0 || ( best.cubes == 0 && ( !literal_mode || best.literals >= 0 ) ) )
+    {
+      return;
+    }
+
+    if ( !deterministic && !claim( best ) )
+    {
+      return;
+    }
+
+    out.push_back( best );
+  }
+
+  /* in non-deterministic mode, the first worker that claims all cubes of a reduction applies it */
+  bool claim( const reduction_t& r )
+  {
+    std::vector<unsigned> cubes{r.c1, r.c2};
+    for ( auto k = 0u; k < r.num_new; ++k )
+    {
+      if ( r.partner[k] != -1 )
+      {
+        cubes.push_back( r.partner[k] );
+      }
+    }
+
+    for ( auto k = 0u; k < cubes.size(); ++k )
+    {
+      if ( claimed[cubes[k]].exchange( true ) )
+      {
+        for ( auto l = 0u; l < k; ++l )
+        {
+          claimed[cubes[l]].store( false );
+        }
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void find_reductions( unsigned i, unsigned d, std::vector<reduction_t>& out )
+  {
+    const auto& a = cover[i];
+
+    if ( d == 1u )
+    {
+      for ( auto v = 0; v < num_vars; ++v )
+      {
+        for ( const auto& x : neighbors( a, v ) )
+        {
+          const auto j = lookup( x );
+          if ( j > static_cast<int>( i ) && !( !deterministic && claimed[i].load() ) )
+          {
+            evaluate( i, j, d, out );
+          }
+        }
+      }
+    }
+    else
+    {
+      const int lits = a.num_literals();
+      const auto lower = std::max( 0, lits - static_cast<int>( d ) );
+      const auto upper = std::min( num_vars, lits + static_cast<int>( d ) );
+
+      std::vector<unsigned> positions;
+      by_literals_cubes.find_distance( a, d, positions, bucket_offset[lower], bucket_offset[upper + 1] );
+
+      for ( auto pos : positions )
+      {
+        const auto j = by_literals[pos];
+        if ( j <= i ) continue;
+        if ( !deterministic && claimed[i].load() ) return;
+
+        evaluate( i, j, d, out );
+      }
+    }
+  }
+
+  /* returns the number of applied reductions */
+  unsigned round( unsigned d )
+  {
+    const auto n = cover.size();
+    if ( n < 2u ) { return 0u; }
+
+    ++rounds;
+
+    /* snapshot */
+    index.clear();
+    index.reserve( 2u * n );
+    for ( auto i = 0u; i < n; ++i )
+    {
+      index[cover[i].value] = i;
+    }
+
+    /* buckets by literal count */
+    std::vector<unsigned> offsets( num_vars + 2, 0u );
+    for ( const auto& c : cover )
+    {
+      ++offsets[c.num_literals() + 1];
+    }
+    std::partial_sum( offsets.begin(), offsets.end(), offsets.begin() );
+    by_literals.resize( n );
+    for ( auto i = 0u; i < n; ++i )
+    {
+      by_literals[offsets[cover[i].num_literals()]++] = i;
+    }
+    bucket_offset.resize( num_vars + 2 );
+    bucket_offset[0] = 0u;
+    std::copy( offsets.begin(), offsets.end() - 1, bucket_offset.begin() + 1 );
+
+    by_literals_cubes.clear();
+    for ( auto i : by_literals )
+    {
+      by_literals_cubes.push_back( cover[i] );
+    }
+
+    if ( !deterministic )
+    {
+      claimed.reset( new std::atomic<bool>[n] );
+      for ( auto i = 0u; i < n; ++i )
+      {
+        claimed[i].store( false, std::memory_order_relaxed );
+      }
+    }
+
+    /* find reductions, chunk c takes every num_chunks-th cube to balance the work */
+    const auto use_pool = num_threads > 1u && n >= parallel_threshold;
+    if ( use_pool && !pool )
+    {
+      pool.reset( new thread_pool( num_threads - 1u ) );
+    }
+
+    const auto num_chunks = use_pool ? std::min<unsigned>( n, 16u * num_threads ) : 1u;
+    std::vector<std::vector<reduction_t>> found( num_chunks );
+    const auto work = [&]( unsigned c ) {
+      for ( auto i = c; i < n; i += num_chunks )
+      {
+        find_reductions( i, d, found[c] );
+      }
+    };
+
+    if ( use_pool )
+    {
+      pool->parallel_for( 0u, num_chunks, work, 1u );
+    }
+    else
+    {
+      work( 0u );
+    }
+
+    /* select non-conflicting reductions */
+    std::vector<reduction_t> selected;
+    for ( auto& f : found )
+    {
+      selected.insert( selected.end(), f.begin(), f.end() );
+    }
+
+    if ( deterministic )
+    {
+      std::sort( selected.begin(), selected.end() );
+
+      std::vector<unsigned char> used( n, 0u );
+      auto out = selected.begin();
+      for ( const auto& r : selected )
+      {
+        auto conflict = used[r.c1] || used[r.c2];
+        for ( auto k = 0u; k < r.num_new && !conflict; ++k )
+        {
+          conflict = r.partner[k] != -1 && used[r.partner[k]];
+        }
+        if ( conflict ) continue;
+
+        used[r.c1] = used[r.c2] = 1u;
+        for ( auto k = 0u; k < r.num_new; ++k )
+        {
+          if ( r.partner[k] != -1 )
+          {
+            used[r.partner[k]] = 1u;
+          }
+        }
+        *out++ = r;
+      }
+      selected.erase( out, selected.end() );
+    }
+
+    apply( selected );
+    reductions += selected.size();
+
+    return selected.size();
+  }
+
+  void apply( const std::vector<reduction_t>& selected )
+  {
+    std::vector<unsigned char> removed( cover.size(), 0u );
+    std::vector<cube2> added;
+
+    for ( const auto& r : selected )
+    {
+      removed[r.c1] = removed[r.c2] = 1u;
+      for ( auto k = 0u; k < r.num_new; ++k )
+      {
+        if ( r.partner[k] != -1 )
+        {
+          removed[r.partner[k]] = 1u;
+        }
+        if ( r.add[k] )
+        {
+          added.push_back( r.new_cubes[k] );
+        }
+      }
+    }
+
+    auto out = cover.begin();
+    for ( auto i = 0u; i < cover.size(); ++i )
+    {
+      if ( !removed[i] )
+      {
+        *out++ = cover[i];
+      }
+    }
+    cover.erase( out, cover.end() );
+    cover.insert( cover.end(), added.begin(), added.end() );
+
+    /* new cubes of different reductions may coincide */
+    canonicalize();
+  }
+
+  /* returns the number of saved cubes */
+  unsigned pass( unsigned d )
+  {
+    if ( d > max_distance ) { return 0u; }
+
+    const auto before = cover.size();
+    while ( round( d ) ) {}
+    return before - cover.size();
+  }
+
+private:
+  std::vector<cube2> cover;
+  int num_vars;
+  unsigned init_cubes_size;
+
+  unsigned num_threads;
+  bool deterministic;
+  unsigned max_distance;
+  unsigned quality;
+  bool improve_literals;
+  bool progress;
+
+  bool literal_mode = false;
+
+  /* snapshot of the cover in the current round */
+  std::unordered_map<uint64_t, unsigned> index;
+  std::vector<unsigned> by_literals;
+  std::vector<unsigned> bucket_offset;
+  cube2_array by_literals_cubes;
+  std::unique_ptr<std::atomic<bool>[]> claimed;
+
+  std::unique_ptr<thread_pool> pool;
+  static constexpr unsigned parallel_threshold = 256u;
+};
+
+constexpr unsigned exorcism_parallel_manager::parallel_threshold;
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+std::vector<cube2> exorcism_parallel( const std::vector<cube2>& cubes, int num_vars, const properties::ptr& settings, const properties::ptr& statistics )
+{
+  properties_timer t( statistics );
+
+  exorcism_parallel_manager mgr( cubes, num_vars, settings );
+  const auto result = mgr.run();
+
+  set( statistics, "iterations", mgr.iterations );
+  set( statistics, "rounds", mgr.rounds );
+  set( statistics, "reductions", mgr.reductions );
+
+  return result;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,85 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file exorcism_parallel.hpp
+ *
+ * @brief Multi-threaded Exorcism implementation (single output)
+ *
+ * The cover is reduced in rounds.  In each round, all cube pairs of one
+ * distance (1 to 4) are collected and their EXORLINK variants are
+ * evaluated in parallel against a snapshot of the cover.  Pairs are
+ * bucketed by literal count, two cubes of distance d can only differ by
+ * at most d literals.  All improving reductions that do not share a cube
+ * are applied in one batch at the end of the round.
+ *
+ * In deterministic mode (default), the batch is selected greedily from a
+ * sorted candidate list and the result does not depend on the number of
+ * threads.  Otherwise, cubes are claimed by the worker that finds the
+ * reduction first.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef EXORCISM_PARALLEL_HPP
+#define EXORCISM_PARALLEL_HPP
+
+#include <vector>
+
+#include <core/properties.hpp>
+#include <classical/utils/cube2.hpp>
+
+namespace cirkit
+{
+
+/**
+ * @brief Multi-threaded ESOP minimization
+ *
+ * Settings:
+ *   num_threads      (unsigned) : number of threads, 0 for one per core (0)
+ *   deterministic    (bool)     : result does not depend on num_threads (true)
+ *   max_distance     (unsigned) : largest EXORLINK distance, at most 4 (4)
+ *   quality          (unsigned) : iterations without gain before stopping (2)
+ *   improve_literals (bool)     : finally accept reductions that only save literals (true)
+ *   progress         (bool)     : show progress line (false)
+ *
+ * Statistics:
+ *   runtime, iterations, rounds, reductions
+ */
+std::vector<cube2> exorcism_parallel( const std::vector<cube2>& cubes, int num_vars,
+                                      const properties::ptr& settings = properties::ptr(),
+                                      const properties::ptr& statistics = properties::ptr() );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
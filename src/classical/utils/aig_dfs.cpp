@@ -104,6 +104,58 @@ aig_partial_dfs::color_amap& aig_partial_dfs::color()
   return _color;
 }
 
+/******************************************************************************
+ * aig_flat_dfs                                                               *
+ ******************************************************************************/
+
+void aig_flat_dfs( const aig_flat& aig, aig_flat_dfs_visitor& vis )
+{
+  std::vector<aig_node> roots;
+  roots.reserve( aig.num_outputs() );
+  aig.foreach_output( [&roots]( aig_flat::literal_t f, unsigned ) { roots.push_back( aig_flat::literal_node( f ) ); } );
+
+  aig_flat_dfs( aig, roots, vis );
+}
+
+void aig_flat_dfs( const aig_flat& aig, const std::vector<aig_node>& roots, aig_flat_dfs_visitor& vis )
+{
+  if ( roots.empty() ) { return; }
+
+  /* mark transitive fanin, children always have a smaller index than their parents */
+  std::vector<unsigned char> visited( aig.size(), 0u );
+  aig_node max_root = 0u;
+  for ( const auto& r : roots )
+  {
+    visited[r] = 1u;
+    max_root = std::max( max_root, r );
+  }
+
+  for ( auto n = max_root; n > 0u; --n )
+  {
+    if ( !visited[n] || !aig.is_and( n ) ) { continue; }
+    visited[aig_flat::literal_node( aig.fanin0( n ) )] = 1u;
+    visited[aig_flat::literal_node( aig.fanin1( n ) )] = 1u;
+  }
+
+  for ( aig_node n = 0u; n <= max_root; ++n )
+  {
+    if ( !visited[n] ) { continue; }
+
+    if ( aig.is_constant( n ) )
+    {
+      vis.finish_constant( n, aig );
+    }
+    else if ( aig.is_input( n ) )
+    {
+      vis.finish_input( n, aig.input_name( aig.input_index( n ) ), aig );
+    }
+    else
+    {
+      vis.finish_aig_node( n, aig_flat_to_function( aig.fanin0( n ) ), aig_flat_to_function( aig.fanin1( n ) ), aig );
+    }
+  }
+}
+
 }
 
 // Local Variables:
@@ -42,6 +42,7 @@
 #include <boost/optional.hpp>
 
 #include <classical/aig.hpp>
+#include <classical/aig_flat.hpp>
 
 namespace cirkit
 {
@@ -93,6 +94,27 @@ private:
   term_func_opt    _term;
 };
 
+/**
+ * @brief DFS visitor for aig_flat
+ *
+ * Since the nodes in an aig_flat are stored in topological order, no actual
+ * graph search is required.  aig_flat_dfs marks the transitive fanin of the
+ * roots and calls the finish methods in ascending index order, which is a
+ * valid post-order.
+ */
+class aig_flat_dfs_visitor
+{
+public:
+  virtual ~aig_flat_dfs_visitor() {}
+
+  virtual void finish_input( const aig_node& node, const std::string& name, const aig_flat& aig ) = 0;
+  virtual void finish_constant( const aig_node& node, const aig_flat& aig ) = 0;
+  virtual void finish_aig_node( const aig_node& node, const aig_function& left, const aig_function& right, const aig_flat& aig ) = 0;
+};
+
+void aig_flat_dfs( const aig_flat& aig, aig_flat_dfs_visitor& vis );
+void aig_flat_dfs( const aig_flat& aig, const std::vector<aig_node>& roots, aig_flat_dfs_visitor& vis );
+
 }
 
 #endif
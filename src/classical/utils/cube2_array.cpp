@@ -0,0 +1,482 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "cube2_array.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+namespace
+{
+
+/* d! groups with d x d entries for each distance d from 2 to 4 */
+class exorlink_groups
+{
+public:
+  exorlink_groups()
+  {
+    for ( auto d = 2u; d <= 4u; ++d )
+    {
+      std::vector<unsigned> perm( d );
+      std::iota( perm.begin(), perm.end(), 0u );
+
+      do
+      {
+        /* new cube i takes the positions perm[0], ..., perm[i - 1] from
+           that, perm[i] from the other value, and the rest from this */
+        for ( auto i = 0u; i < d; ++i )
+        {
+          for ( auto j = 0u; j < d; ++j )
+          {
+            const unsigned r = std::find( perm.begin(), perm.end(), j ) - perm.begin();
+            tables[d].push_back( r < i ? 1u : ( r == i ? 2u : 0u ) );
+          }
+        }
+      } while ( std::next_permutation( perm.begin(), perm.end() ) );
+    }
+  }
+
+  std::vector<unsigned> tables[5u];
+};
+
+exorlink_groups& groups()
+{
+  static exorlink_groups g;
+  return g;
+}
+
+}
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+namespace
+{
+
+void distances_scalar( uint32_t cb, uint32_t cm, const uint32_t* bits, const uint32_t* mask, std::size_t count, unsigned char* dist )
+{
+  for ( auto i = 0u; i < count; ++i )
+  {
+    dist[i] = __builtin_popcount( ( bits[i] ^ cb ) | ( mask[i] ^ cm ) );
+  }
+}
+
+void find_distance_scalar( uint32_t cb, uint32_t cm, const uint32_t* bits, const uint32_t* mask, std::size_t begin, std::size_t end,
+                           int distance, std::vector<unsigned>& indexes )
+{
+  for ( auto i = begin; i < end; ++i )
+  {
+    if ( __builtin_popcount( ( bits[i] ^ cb ) | ( mask[i] ^ cm ) ) == distance )
+    {
+      indexes.push_back( i );
+    }
+  }
+}
+
+void cube_distances_scalar( const cube2& c, const cube2* cubes, std::size_t count, unsigned char* dist )
+{
+  for ( auto i = 0u; i < count; ++i )
+  {
+    dist[i] = c.distance( cubes[i] );
+  }
+}
+
+#if CIRKIT_SIMD_X86
+/* number of ones in each 32-bit lane */
+CIRKIT_TARGET_AVX2 inline __m256i popcount_epi32_avx2( __m256i v )
+{
+  const auto lookup = _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+  const auto nibble = _mm256_set1_epi8( 0x0f );
+
+  const auto lo = _mm256_shuffle_epi8( lookup, _mm256_and_si256( v, nibble ) );
+  const auto hi = _mm256_shuffle_epi8( lookup, _mm256_and_si256( _mm256_srli_epi16( v, 4 ), nibble ) );
+  const auto bytes = _mm256_add_epi8( lo, hi );
+
+  return _mm256_madd_epi16( _mm256_maddubs_epi16( bytes, _mm256_set1_epi8( 1 ) ), _mm256_set1_epi16( 1 ) );
+}
+
+CIRKIT_TARGET_AVX2 inline __m256i distance_avx2( __m256i cb, __m256i cm, const uint32_t* bits, const uint32_t* mask )
+{
+  const auto b = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( bits ) );
+  const auto m = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( mask ) );
+  return popcount_epi32_avx2( _mm256_or_si256( _mm256_xor_si256( b, cb ), _mm256_xor_si256( m, cm ) ) );
+}
+
+CIRKIT_TARGET_AVX2 void distances_avx2( uint32_t cb, uint32_t cm, const uint32_t* bits, const uint32_t* mask, std::size_t count, unsigned char* dist )
+{
+  const auto vb = _mm256_set1_epi32( static_cast<int>( cb ) );
+  const auto vm = _mm256_set1_epi32( static_cast<int>( cm ) );
+
+  /* moves the low byte of each 32-bit lane to the first 4 bytes of its 128-bit half */
+  const auto pack = _mm256_setr_epi8( 0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                      0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1 );
+
+  auto i = 0u;
+  for ( ; i + 8u <= count; i += 8u )
+  {
+    const auto packed = _mm256_shuffle_epi8( distance_avx2( vb, vm, bits + i, mask + i ), pack );
+    const uint32_t lo = _mm256_extract_epi32( packed, 0 );
+    const uint32_t hi = _mm256_extract_epi32( packed, 4 );
+    std::memcpy( dist + i, &lo, 4u );
+    std::memcpy( dist + i + 4u, &hi, 4u );
+  }
+
+  distances_scalar( cb, cm, bits + i, mask + i, count - i, dist + i );
+}
+
+CIRKIT_TARGET_AVX2 void find_distance_avx2( uint32_t cb, uint32_t cm, const uint32_t* bits, const uint32_t* mask, std::size_t begin, std::size_t end,
+                                            int distance, std::vector<unsigned>& indexes )
+{
+  const auto vb = _mm256_set1_epi32( static_cast<int>( cb ) );
+  const auto vm = _mm256_set1_epi32( static_cast<int>( cm ) );
+  const auto vd = _mm256_set1_epi32( distance );
+
+  auto i = begin;
+  for ( ; i + 8u <= end; i += 8u )
+  {
+    const auto eq = _mm256_cmpeq_epi32( distance_avx2( vb, vm, bits + i, mask + i ), vd );
+    auto hits = static_cast<unsigned>( _mm256_movemask_ps( _mm256_castsi256_ps( eq ) ) );
+    while ( hits )
+    {
+      indexes.push_back( i + __builtin_ctz( hits ) );
+      hits &= hits - 1u;
+    }
+  }
+
+  find_distance_scalar( cb, cm, bits, mask, i, end, distance, indexes );
+}
+
+/* cube2 arrays, 4 cubes per register */
+CIRKIT_TARGET_AVX2 void cube_distances_avx2( const cube2& c, const cube2* cubes, std::size_t count, unsigned char* dist )
+{
+  const auto vc    = _mm256_set1_epi64x( static_cast<long long>( c.value ) );
+  const auto low32 = _mm256_set1_epi64x( 0xffffffffll );
+  const auto lookup = _mm256_setr_epi8( 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                        0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 );
+  const auto nibble = _mm256_set1_epi8( 0x0f );
+
+  auto i = 0u;
+  for ( ; i + 4u <= count; i += 4u )
+  {
+    const auto x = _mm256_xor_si256( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( cubes + i ) ), vc );
+    const auto d = _mm256_and_si256( _mm256_or_si256( x, _mm256_srli_epi64( x, 32 ) ), low32 );
+
+    const auto lo = _mm256_shuffle_epi8( lookup, _mm256_and_si256( d, nibble ) );
+    const auto hi = _mm256_shuffle_epi8( lookup, _mm256_and_si256( _mm256_srli_epi16( d, 4 ), nibble ) );
+    const auto sums = _mm256_sad_epu8( _mm256_add_epi8( lo, hi ), _mm256_setzero_si256() );
+
+    dist[i]      = _mm256_extract_epi8( sums, 0 );
+    dist[i + 1u] = _mm256_extract_epi8( sums, 8 );
+    dist[i + 2u] = _mm256_extract_epi8( sums, 16 );
+    dist[i + 3u] = _mm256_extract_epi8( sums, 24 );
+  }
+
+  cube_distances_scalar( c, cubes + i, count - i, dist + i );
+}
+
+/* gathers the cubes at indexes[k], ..., indexes[k + 7] */
+CIRKIT_TARGET_AVX2 inline void gather_avx2( const uint32_t* bits, const uint32_t* mask, const unsigned* indexes, __m256i& b, __m256i& m )
+{
+  const auto idx = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( indexes ) );
+  b = _mm256_i32gather_epi32( reinterpret_cast<const int*>( bits ), idx, 4 );
+  m = _mm256_i32gather_epi32( reinterpret_cast<const int*>( mask ), idx, 4 );
+}
+
+/* stores the cubes ( b[l], m[l] ) for l = 0, ..., 7 to out */
+CIRKIT_TARGET_AVX2 inline void store_cubes_avx2( __m256i b, __m256i m, cube2* out )
+{
+  const auto lo = _mm256_unpacklo_epi32( b, m ); /* cubes 0, 1, 4, 5 */
+  const auto hi = _mm256_unpackhi_epi32( b, m ); /* cubes 2, 3, 6, 7 */
+  _mm256_storeu_si256( reinterpret_cast<__m256i*>( out ),      _mm256_permute2x128_si256( lo, hi, 0x20 ) );
+  _mm256_storeu_si256( reinterpret_cast<__m256i*>( out + 4u ), _mm256_permute2x128_si256( lo, hi, 0x31 ) );
+}
+
+CIRKIT_TARGET_AVX2 inline __m256i blend_avx2( __m256i a, __m256i b, __m256i p )
+{
+  return _mm256_or_si256( _mm256_andnot_si256( p, a ), _mm256_and_si256( b, p ) );
+}
+
+CIRKIT_TARGET_AVX2 std::size_t merge_avx2( const cube2& c, const uint32_t* bits, const uint32_t* mask, const std::vector<unsigned>& indexes, cube2* out )
+{
+  const auto cb = _mm256_set1_epi32( static_cast<int>( c.bits ) );
+  const auto cm = _mm256_set1_epi32( static_cast<int>( c.mask ) );
+
+  auto k = 0u;
+  for ( ; k + 8u <= indexes.size(); k += 8u )
+  {
+    __m256i b, m;
+    gather_avx2( bits, mask, &indexes[k], b, m );
+
+    const auto d = _mm256_or_si256( _mm256_xor_si256( b, cb ), _mm256_xor_si256( m, cm ) );
+    store_cubes_avx2( _mm256_xor_si256( cb, _mm256_andnot_si256( b, d ) ), _mm256_xor_si256( cm, _mm256_and_si256( m, d ) ), out + k );
+  }
+
+  return k;
+}
+
+CIRKIT_TARGET_AVX2 std::size_t exorlink_avx2( const cube2& c, int distance, const uint32_t* bits, const uint32_t* mask,
+                                              const std::vector<unsigned>& indexes, cube2* out )
+{
+  const auto num_groups = cube2_exorlink_num_groups( distance );
+  const auto count = indexes.size();
+
+  const auto cb   = _mm256_set1_epi32( static_cast<int>( c.bits ) );
+  const auto cm   = _mm256_set1_epi32( static_cast<int>( c.mask ) );
+  const auto one  = _mm256_set1_epi32( 1 );
+  const auto zero = _mm256_setzero_si256();
+
+  auto k = 0u;
+  for ( ; k + 8u <= count; k += 8u )
+  {
+    __m256i b, m;
+    gather_avx2( bits, mask, &indexes[k], b, m );
+
+    const auto diff  = _mm256_or_si256( _mm256_xor_si256( b, cb ), _mm256_xor_si256( m, cm ) );
+    const auto obits = _mm256_andnot_si256( _mm256_or_si256( b, cb ), _mm256_set1_epi32( -1 ) );
+    const auto omask = _mm256_xor_si256( m, cm );
+
+    for ( auto g = 0u; g < num_groups; ++g )
+    {
+      const auto* group = cube2_exorlink_group( distance, g );
+
+      for ( auto i = 0; i < distance; ++i )
+      {
+        auto tb = cb, tm = cm, tpos = diff;
+
+        for ( auto j = 0; j < distance; ++j )
+        {
+          const auto p = _mm256_and_si256( tpos, _mm256_sub_epi32( zero, tpos ) );
+          tpos = _mm256_and_si256( tpos, _mm256_sub_epi32( tpos, one ) );
+
+          switch ( *group++ )
+          {
+          case 1u:
+            tb = blend_avx2( tb, b, p );
+            tm = blend_avx2( tm, m, p );
+            break;
+          case 2u:
+            tb = blend_avx2( tb, obits, p );
+            tm = blend_avx2( tm, omask, p );
+            break;
+          }
+        }
+
+        store_cubes_avx2( tb, tm, out + ( g * distance + i ) * count + k );
+      }
+    }
+  }
+
+  return k;
+}
+#endif
+
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+constexpr std::size_t cube2_array::npos;
+
+cube2_array::cube2_array( simd_level level )
+  : _level( simd_select( level ) )
+{
+}
+
+cube2_array::cube2_array( const std::vector<cube2>& cubes, simd_level level )
+  : _level( simd_select( level ) )
+{
+  reserve( cubes.size() );
+  for ( const auto& c : cubes )
+  {
+    push_back( c );
+  }
+}
+
+void cube2_array::reserve( std::size_t capacity )
+{
+  _bits.reserve( capacity );
+  _mask.reserve( capacity );
+}
+
+void cube2_array::clear()
+{
+  _bits.clear();
+  _mask.clear();
+}
+
+void cube2_array::push_back( const cube2& c )
+{
+  _bits.push_back( c.bits );
+  _mask.push_back( c.mask );
+}
+
+void cube2_array::set( std::size_t index, const cube2& c )
+{
+  _bits[index] = c.bits;
+  _mask[index] = c.mask;
+}
+
+void cube2_array::erase( std::size_t index )
+{
+  _bits.erase( _bits.begin() + index );
+  _mask.erase( _mask.begin() + index );
+}
+
+void cube2_array::swap_remove( std::size_t index )
+{
+  _bits[index] = _bits.back();
+  _mask[index] = _mask.back();
+  _bits.pop_back();
+  _mask.pop_back();
+}
+
+std::vector<cube2> cube2_array::to_vector() const
+{
+  std::vector<cube2> v( size() );
+  for ( auto i = 0u; i < size(); ++i )
+  {
+    v[i] = (*this)[i];
+  }
+  return v;
+}
+
+void cube2_array::distances( const cube2& c, unsigned char* dist ) const
+{
+#if CIRKIT_SIMD_X86
+  if ( _level != simd_level::scalar )
+  {
+    distances_avx2( c.bits, c.mask, _bits.data(), _mask.data(), size(), dist );
+    return;
+  }
+#endif
+  distances_scalar( c.bits, c.mask, _bits.data(), _mask.data(), size(), dist );
+}
+
+void cube2_array::distances( const cube2& c, std::vector<unsigned char>& dist ) const
+{
+  dist.resize( size() );
+  distances( c, dist.data() );
+}
+
+void cube2_array::find_distance( const cube2& c, int distance, std::vector<unsigned>& indexes, std::size_t begin, std::size_t end ) const
+{
+  end = std::min( end, size() );
+  if ( begin >= end ) { return; }
+
+#if CIRKIT_SIMD_X86
+  if ( _level != simd_level::scalar )
+  {
+    find_distance_avx2( c.bits, c.mask, _bits.data(), _mask.data(), begin, end, distance, indexes );
+    return;
+  }
+#endif
+  find_distance_scalar( c.bits, c.mask, _bits.data(), _mask.data(), begin, end, distance, indexes );
+}
+
+void cube2_array::merge( const cube2& c, const std::vector<unsigned>& indexes, std::vector<cube2>& out ) const
+{
+  out.resize( indexes.size() );
+
+  std::size_t k = 0u;
+#if CIRKIT_SIMD_X86
+  if ( _level != simd_level::scalar )
+  {
+    k = merge_avx2( c, _bits.data(), _mask.data(), indexes, out.data() );
+  }
+#endif
+  for ( ; k < indexes.size(); ++k )
+  {
+    out[k] = c.merge( (*this)[indexes[k]] );
+  }
+}
+
+void cube2_array::exorlink( const cube2& c, int distance, const std::vector<unsigned>& indexes, std::vector<cube2>& out ) const
+{
+  const auto num_groups = cube2_exorlink_num_groups( distance );
+  out.resize( indexes.size() * num_groups * distance );
+
+  std::size_t k = 0u;
+#if CIRKIT_SIMD_X86
+  if ( _level != simd_level::scalar )
+  {
+    k = exorlink_avx2( c, distance, _bits.data(), _mask.data(), indexes, out.data() );
+  }
+#endif
+  for ( ; k < indexes.size(); ++k )
+  {
+    const auto that = (*this)[indexes[k]];
+    const auto diff = c.differences( that );
+    for ( auto g = 0u; g < num_groups; ++g )
+    {
+      const auto n = c.exorlink( that, distance, diff, cube2_exorlink_group( distance, g ) );
+      for ( auto i = 0; i < distance; ++i )
+      {
+        out[( g * distance + i ) * indexes.size() + k] = n[i];
+      }
+    }
+  }
+}
+
+void cube2_distances( const cube2& c, const cube2* cubes, std::size_t count, unsigned char* dist, simd_level level )
+{
+#if CIRKIT_SIMD_X86
+  if ( simd_select( level ) != simd_level::scalar )
+  {
+    cube_distances_avx2( c, cubes, count, dist );
+    return;
+  }
+#endif
+  cube_distances_scalar( c, cubes, count, dist );
+}
+
+unsigned cube2_exorlink_num_groups( int distance )
+{
+  return groups().tables[distance].size() / ( distance * distance );
+}
+
+unsigned* cube2_exorlink_group( int distance, unsigned group )
+{
+  return &groups().tables[distance][group * distance * distance];
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
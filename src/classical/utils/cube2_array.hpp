@@ -0,0 +1,127 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file cube2_array.hpp
+ *
+ * @brief Structure-of-arrays container for cube2 with SIMD kernels
+ *
+ * Bits and masks are stored in two separate arrays such that one cube can
+ * be compared against many others in a single sweep, 8 cubes per AVX2
+ * register.  Next to distance computation, the container supports
+ * batched merging and EXORLINK candidate generation.  The kernel is
+ * selected at runtime (AVX2 or scalar).
+ *
+ * cube2_distances provides the distance sweep for contiguous arrays of
+ * cube2 (e.g., buckets of cubes in Exorcism).
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef CUBE2_ARRAY_HPP
+#define CUBE2_ARRAY_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <core/utils/simd_utils.hpp>
+#include <classical/utils/cube2.hpp>
+
+namespace cirkit
+{
+
+class cube2_array
+{
+public:
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  explicit cube2_array( simd_level level = simd_level::avx2 );
+  explicit cube2_array( const std::vector<cube2>& cubes, simd_level level = simd_level::avx2 );
+
+  inline std::size_t size() const                     { return _bits.size(); }
+  inline bool empty() const                           { return _bits.empty(); }
+  inline cube2 operator[]( std::size_t index ) const  { return cube2( _bits[index], _mask[index] ); }
+  inline simd_level level() const                     { return _level; }
+
+  void reserve( std::size_t capacity );
+  void clear();
+  void push_back( const cube2& c );
+  void set( std::size_t index, const cube2& c );
+
+  /* keeps the order of the remaining cubes */
+  void erase( std::size_t index );
+  /* moves the last cube to index */
+  void swap_remove( std::size_t index );
+
+  std::vector<cube2> to_vector() const;
+
+  /* dist[i] = c.distance( (*this)[i] ) for all cubes */
+  void distances( const cube2& c, unsigned char* dist ) const;
+  void distances( const cube2& c, std::vector<unsigned char>& dist ) const;
+
+  /* appends all indexes i in [begin, end) with c.distance( (*this)[i] ) == distance */
+  void find_distance( const cube2& c, int distance, std::vector<unsigned>& indexes,
+                      std::size_t begin = 0u, std::size_t end = npos ) const;
+
+  /* out[k] = c.merge( (*this)[indexes[k]] ), all cubes must have distance 1 to c */
+  void merge( const cube2& c, const std::vector<unsigned>& indexes, std::vector<cube2>& out ) const;
+
+  /**
+   * @brief All EXORLINK variants of c with the cubes at indexes
+   *
+   * All cubes must have the given distance (2 to 4) to c.  The i-th new
+   * cube of group g for indexes[k] is stored at
+   * out[( g * distance + i ) * indexes.size() + k], i.e., results of
+   * different pairs for the same group and cube are adjacent.
+   */
+  void exorlink( const cube2& c, int distance, const std::vector<unsigned>& indexes, std::vector<cube2>& out ) const;
+
+private:
+  std::vector<uint32_t> _bits;
+  std::vector<uint32_t> _mask;
+  simd_level            _level;
+};
+
+/* dist[i] = c.distance( cubes[i] ) for i < count */
+void cube2_distances( const cube2& c, const cube2* cubes, std::size_t count, unsigned char* dist,
+                      simd_level level = simd_level::avx2 );
+
+/* EXORLINK groups as expected by cube2::exorlink, there are distance! groups for distance 2 to 4 */
+unsigned cube2_exorlink_num_groups( int distance );
+unsigned* cube2_exorlink_group( int distance, unsigned group );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
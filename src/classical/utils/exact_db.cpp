@@ -0,0 +1,187 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "exact_db.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+constexpr uint64_t exact_db_magic   = UINT64_C( 0x314458454b524943 ); /* "CIRKEXD1" */
+constexpr uint32_t exact_db_version = 2u;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+uint64_t exact_db::hash( uint64_t func, unsigned num_vars, unsigned basis )
+{
+  return mapped_hash_table::hash( func, ( static_cast<uint64_t>( num_vars ) << 58u ) ^ ( static_cast<uint64_t>( basis ) << 52u ) );
+}
+
+const exact_db::record_t* exact_db::find( exact_db_basis basis, const tt& npn ) const
+{
+  if ( !is_storable( npn ) ) { return nullptr; }
+
+  const auto func = npn.to_ulong();
+  const auto num_vars = tt_num_vars( npn );
+  const auto b = static_cast<unsigned>( basis );
+
+  return table->find<record_t>( hash( func, num_vars, b ), [func, num_vars, b]( const record_t& r ) {
+      return r.func == func && r.num_vars == num_vars && r.basis == b;
+    } );
+}
+
+void exact_db::read_entry( const record_t& r, exact_db_entry& entry ) const
+{
+  entry.size = r.size;
+  entry.depth = r.depth;
+  entry.expression.assign( table->arena() + r.offset, r.length );
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+std::string exact_db_basis_name( exact_db_basis basis )
+{
+  switch ( basis )
+  {
+  case exact_db_basis::mig: return "mig";
+  case exact_db_basis::xmg: return "xmg";
+  case exact_db_basis::aig: return "aig";
+  }
+  return "unknown";
+}
+
+exact_db_basis exact_db_basis_from_name( const std::string& name )
+{
+  if ( name == "mig" ) { return exact_db_basis::mig; }
+  if ( name == "xmg" ) { return exact_db_basis::xmg; }
+  if ( name == "aig" ) { return exact_db_basis::aig; }
+  throw "Error: basis must be mig, xmg, or aig";
+}
+
+exact_db::exact_db( const std::string& filename, unsigned capacity, uint64_t arena_capacity )
+{
+  if ( capacity == 0u )
+  {
+    throw "Error: exact synthesis database capacity must be positive";
+  }
+
+  /* the header of an existing file decides about the layout, capacities
+     are only used for new files */
+  table.reset( new mapped_hash_table( filename, exact_db_magic, exact_db_version, sizeof( record_t ), capacity, arena_capacity ) );
+
+  if ( table->magic() != exact_db_magic )
+  {
+    throw "Error: file is not an exact synthesis database";
+  }
+  if ( table->version() != exact_db_version )
+  {
+    throw "Error: exact synthesis database has an unsupported version";
+  }
+}
+
+bool exact_db::is_storable( const tt& npn )
+{
+  return npn.size() <= 64u;
+}
+
+bool exact_db::lookup( exact_db_basis basis, const tt& npn, exact_db_entry& entry ) const
+{
+  const auto* r = find( basis, npn );
+  if ( !r ) { return false; }
+
+  read_entry( *r, entry );
+  return true;
+}
+
+bool exact_db::contains( exact_db_basis basis, const tt& npn ) const
+{
+  return find( basis, npn ) != nullptr;
+}
+
+bool exact_db::insert( exact_db_basis basis, const tt& npn, const exact_db_entry& entry )
+{
+  if ( !is_storable( npn ) || entry.expression.size() > std::numeric_limits<uint16_t>::max() ) { return false; }
+
+  /* reserve arena before the record, such that a failed reservation does
+     not leave an unused record */
+  uint64_t offset;
+  uint32_t slot;
+  if ( !table->reserve_arena( entry.expression.size(), offset ) || !table->reserve( slot ) ) { return false; }
+
+  const auto num_vars = tt_num_vars( npn );
+  std::memcpy( table->arena() + offset, entry.expression.data(), entry.expression.size() );
+
+  auto& r = table->record<record_t>( slot );
+  r.func = npn.to_ulong();
+  r.offset = offset;
+  r.length = entry.expression.size();
+  r.basis = static_cast<unsigned>( basis );
+  r.num_vars = num_vars;
+  r.size = std::min( entry.size, 0xffffu );
+  r.depth = std::min( entry.depth, 0xffffu );
+
+  table->publish<record_t>( slot, hash( r.func, num_vars, r.basis ) );
+  return true;
+}
+
+unsigned exact_db::size() const
+{
+  return table->size();
+}
+
+unsigned exact_db::capacity() const
+{
+  return table->capacity();
+}
+
+uint64_t exact_db::arena_size() const
+{
+  return table->arena_size();
+}
+
+uint64_t exact_db::arena_capacity() const
+{
+  return table->arena_capacity();
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,136 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file exact_db.hpp
+ *
+ * @brief Persistent database of optimum circuits
+ *
+ * The database is a persistent hash table (see mapped_hash_table.hpp)
+ * that maps NPN representatives of functions with up to 6 variables to an
+ * optimum circuit for a given gate basis (MIG, XMG, or AIG).  A circuit is
+ * stored as expression string in the table's arena together with its size
+ * and depth.  Like npn_cache, opening only maps the file, lookups are
+ * O(1), and several threads and processes can read from and append to the
+ * same file concurrently without locks.  When the capacity of records or
+ * of the expression arena is exhausted, new entries are dropped.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef EXACT_DB_HPP
+#define EXACT_DB_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <core/utils/mapped_hash_table.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+namespace cirkit
+{
+
+enum class exact_db_basis : unsigned { mig = 0u, xmg = 1u, aig = 2u };
+
+std::string exact_db_basis_name( exact_db_basis basis );
+
+/* throws a string if name is neither "mig", "xmg", nor "aig" */
+exact_db_basis exact_db_basis_from_name( const std::string& name );
+
+struct exact_db_entry
+{
+  unsigned    size = 0u;
+  unsigned    depth = 0u;
+  std::string expression;
+};
+
+class exact_db
+{
+public:
+  using ptr = std::shared_ptr<exact_db>;
+
+  exact_db( const std::string& filename, unsigned capacity = 1u << 16u, uint64_t arena_capacity = UINT64_C( 1 ) << 24u );
+
+  /* only functions with at most 6 variables are stored */
+  static bool is_storable( const tt& npn );
+
+  bool lookup( exact_db_basis basis, const tt& npn, exact_db_entry& entry ) const;
+  bool contains( exact_db_basis basis, const tt& npn ) const;
+
+  /* returns false, if npn is not storable, or the database is full */
+  bool insert( exact_db_basis basis, const tt& npn, const exact_db_entry& entry );
+
+  /* calls f( basis, npn, entry ) for all entries */
+  template<typename Fn>
+  void foreach_entry( Fn&& f ) const
+  {
+    exact_db_entry entry;
+    table->foreach_record<record_t>( [this, &f, &entry]( const record_t& r ) {
+        read_entry( r, entry );
+        f( static_cast<exact_db_basis>( r.basis ), tt( 1u << r.num_vars, r.func ), entry );
+      } );
+  }
+
+  unsigned size() const;
+  unsigned capacity() const;
+  uint64_t arena_size() const;
+  uint64_t arena_capacity() const;
+
+private:
+  struct record_t
+  {
+    uint64_t func;
+    uint64_t offset;      /* position of the expression in the arena */
+    uint32_t next;        /* see mapped_hash_table */
+    uint16_t length;
+    uint8_t  basis;
+    uint8_t  num_vars;
+    uint16_t size;
+    uint16_t depth;
+    uint32_t reserved;
+  };
+
+  static_assert( sizeof( record_t ) == 32u, "unexpected record size" );
+
+  static uint64_t hash( uint64_t func, unsigned num_vars, unsigned basis );
+  const record_t* find( exact_db_basis basis, const tt& npn ) const;
+  void read_entry( const record_t& r, exact_db_entry& entry ) const;
+
+private:
+  std::unique_ptr<mapped_hash_table> table;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
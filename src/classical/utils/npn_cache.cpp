@@ -0,0 +1,143 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "npn_cache.hpp"
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+constexpr uint64_t npn_cache_magic   = UINT64_C( 0x314e504e4b524943 ); /* "CIRKNPN1" */
+constexpr uint32_t npn_cache_version = 2u;
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+uint64_t npn_cache::hash( uint64_t func, unsigned num_vars )
+{
+  return mapped_hash_table::hash( func, static_cast<uint64_t>( num_vars ) << 58u );
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+npn_cache::npn_cache( const std::string& filename, unsigned approach, unsigned capacity )
+{
+  if ( capacity == 0u )
+  {
+    throw "Error: NPN cache capacity must be positive";
+  }
+
+  /* the header of an existing file decides about the layout, capacity is
+     only used for new files */
+  table.reset( new mapped_hash_table( filename, npn_cache_magic, npn_cache_version, sizeof( record_t ), capacity, 0u, approach ) );
+
+  if ( table->magic() != npn_cache_magic )
+  {
+    throw "Error: file is not an NPN cache";
+  }
+  if ( table->version() != npn_cache_version )
+  {
+    throw "Error: NPN cache has an unsupported version";
+  }
+  if ( table->user() != approach )
+  {
+    throw "Error: NPN cache was created for a different canonization approach";
+  }
+}
+
+bool npn_cache::is_cacheable( const tt& t )
+{
+  return t.size() <= 64u;
+}
+
+bool npn_cache::lookup( const tt& t, tt& npn, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) const
+{
+  if ( !is_cacheable( t ) ) { return false; }
+
+  const auto func = t.to_ulong();
+  const auto num_vars = tt_num_vars( t );
+
+  const auto* r = table->find<record_t>( hash( func, num_vars ), [func, num_vars]( const record_t& r ) {
+      return r.func == func && r.num_vars == num_vars;
+    } );
+  if ( !r ) { return false; }
+
+  npn = tt( t.size(), r->npn );
+  phase = boost::dynamic_bitset<>( num_vars + 1u, r->phase );
+  perm.assign( r->perm, r->perm + num_vars );
+  return true;
+}
+
+bool npn_cache::insert( const tt& t, const tt& npn, const boost::dynamic_bitset<>& phase, const std::vector<unsigned>& perm )
+{
+  if ( !is_cacheable( t ) ) { return false; }
+
+  uint32_t slot;
+  if ( !table->reserve( slot ) ) { return false; }
+
+  const auto num_vars = tt_num_vars( t );
+  auto& r = table->record<record_t>( slot );
+  r.func = t.to_ulong();
+  r.npn = npn.to_ulong();
+  r.num_vars = num_vars;
+  r.phase = phase.to_ulong();
+  for ( auto i = 0u; i < num_vars; ++i )
+  {
+    r.perm[i] = perm[i];
+  }
+
+  table->publish<record_t>( slot, hash( r.func, num_vars ) );
+  return true;
+}
+
+unsigned npn_cache::size() const
+{
+  return table->size();
+}
+
+unsigned npn_cache::capacity() const
+{
+  return table->capacity();
+}
+
+unsigned npn_cache::approach() const
+{
+  return table->user();
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,110 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file npn_cache.hpp
+ *
+ * @brief Persistent NPN canonization cache
+ *
+ * The cache is a persistent hash table (see mapped_hash_table.hpp) that
+ * maps truth tables of functions with up to 6 variables to their NPN
+ * representative, phase, and permutation.  Opening the cache only maps the
+ * file, no entries are loaded.  Several threads and processes can read
+ * from and append to the same file concurrently without locks.  When the
+ * capacity is exhausted, new entries are dropped.
+ *
+ * Each file belongs to one canonization approach (e.g., the index of the
+ * approach in the `npn' command), since heuristics may map a function to
+ * different representatives.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef NPN_CACHE_HPP
+#define NPN_CACHE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/dynamic_bitset.hpp>
+
+#include <core/utils/mapped_hash_table.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+namespace cirkit
+{
+
+class npn_cache
+{
+public:
+  using ptr = std::shared_ptr<npn_cache>;
+
+  npn_cache( const std::string& filename, unsigned approach = 0u, unsigned capacity = 1u << 20u );
+
+  /* only functions with at most 6 variables are stored */
+  static bool is_cacheable( const tt& t );
+
+  bool lookup( const tt& t, tt& npn, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) const;
+
+  /* returns false, if t is not cacheable or the cache is full */
+  bool insert( const tt& t, const tt& npn, const boost::dynamic_bitset<>& phase, const std::vector<unsigned>& perm );
+
+  unsigned size() const;
+  unsigned capacity() const;
+  unsigned approach() const;
+
+private:
+  struct record_t
+  {
+    uint64_t func;
+    uint64_t npn;
+    uint32_t next;        /* see mapped_hash_table */
+    uint8_t  num_vars;
+    uint8_t  phase;       /* bit num_vars is output phase */
+    uint8_t  perm[6];
+    uint32_t reserved;
+  };
+
+  static_assert( sizeof( record_t ) == 32u, "unexpected record size" );
+
+  static uint64_t hash( uint64_t func, unsigned num_vars );
+
+private:
+  std::unique_ptr<mapped_hash_table> table;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
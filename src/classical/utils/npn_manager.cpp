@@ -42,6 +42,30 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+tt npn_manager::classify( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
+{
+  boost::dynamic_bitset<> npn;
+
+  if ( persistent_cache && persistent_cache->lookup( tt, npn, phase, perm ) )
+  {
+    ++persistent_cache_hit;
+    return npn;
+  }
+
+  {
+    increment_timer t( &runtime );
+    npn = npn_func( tt, phase, perm );
+  }
+
+  if ( persistent_cache )
+  {
+    ++persistent_cache_miss;
+    persistent_cache->insert( tt, npn, phase, perm );
+  }
+
+  return npn;
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -52,6 +76,11 @@ npn_manager::npn_manager( unsigned hash_table_size, const npn_classifier_t& npn_
 {
 }
 
+void npn_manager::set_persistent_cache( const npn_cache::ptr& cache )
+{
+  persistent_cache = cache;
+}
+
 tt npn_manager::compute( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm )
 {
   boost::dynamic_bitset<> npn;
@@ -73,8 +102,7 @@ tt npn_manager::compute( const tt& tt, boost::dynamic_bitset<>& phase, std::vect
     else
     {
       ++cache_miss;
-      increment_timer t( &runtime );
-      npn = npn_func( tt, phase, perm );
+      npn = classify( tt, phase, perm );
 
       entry.tt    = to_string( tt );
       entry.npn   = to_string( npn );
@@ -84,8 +112,7 @@ tt npn_manager::compute( const tt& tt, boost::dynamic_bitset<>& phase, std::vect
   }
   else
   {
-    increment_timer t( &runtime );
-    npn = npn_func( tt, phase, perm );
+    npn = classify( tt, phase, perm );
   }
 
   return npn;
@@ -94,6 +121,11 @@ tt npn_manager::compute( const tt& tt, boost::dynamic_bitset<>& phase, std::vect
 void npn_manager::print_statistics( std::ostream& os ) const
 {
   os << boost::format( "[i] NPN manager: size = %d   cache hits = %d   cache misses = %d   run-time = %.2f secs" ) % table.size() % cache_hit % cache_miss % runtime << std::endl;
+
+  if ( persistent_cache )
+  {
+    os << boost::format( "[i] NPN cache:   entries = %d/%d   hits = %d   misses = %d" ) % persistent_cache->size() % persistent_cache->capacity() % persistent_cache_hit % persistent_cache_miss << std::endl;
+  }
 }
 
 }
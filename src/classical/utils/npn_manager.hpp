@@ -43,6 +43,7 @@
 #include <boost/dynamic_bitset.hpp>
 
 #include <classical/functions/npn_canonization.hpp>
+#include <classical/utils/npn_cache.hpp>
 #include <classical/utils/truth_table_utils.hpp>
 
 namespace cirkit
@@ -55,6 +56,14 @@ inline std::function<tt(const tt&, boost::dynamic_bitset<>&, std::vector<unsigne
     } );
 }
 
+/* exact canonization on 64-bit truth tables, functions must have at most 6 variables */
+inline std::function<tt(const tt&, boost::dynamic_bitset<>&, std::vector<unsigned>&)> make_fast_exact_npn_canonization_wrapper()
+{
+  return std::function<tt(const tt&, boost::dynamic_bitset<>&, std::vector<unsigned>&)>( []( const tt& t, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm ) {
+      return exact_npn_canonization_fast( t, phase, perm );
+    } );
+}
+
 class npn_manager
 {
 public:
@@ -62,9 +71,15 @@ public:
 
   npn_manager( unsigned hash_table_size = 4096, const npn_classifier_t& npn_func = make_exact_npn_canonization_wrapper() );
 
+  /* misses of the in-process hash table are looked up in (and added to) the persistent cache */
+  void set_persistent_cache( const npn_cache::ptr& cache );
+
   tt compute( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
   void print_statistics( std::ostream& os = std::cout ) const;
 
+private:
+  tt classify( const tt& tt, boost::dynamic_bitset<>& phase, std::vector<unsigned>& perm );
+
 private:
   struct table_entry_t
   {
@@ -83,10 +98,13 @@ private:
   table_t          table;
 
   npn_classifier_t npn_func;
+  npn_cache::ptr   persistent_cache;
 
-  double           runtime    = 0.0;
-  unsigned long    cache_hit  = 0;
-  unsigned long    cache_miss = 0;
+  double           runtime               = 0.0;
+  unsigned long    cache_hit             = 0;
+  unsigned long    cache_miss            = 0;
+  unsigned long    persistent_cache_hit  = 0;
+  unsigned long    persistent_cache_miss = 0;
 };
 
 }
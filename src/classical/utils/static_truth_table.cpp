@@ -0,0 +1,92 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "static_truth_table.hpp"
+
+namespace cirkit
+{
+
+namespace detail
+{
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+#if CIRKIT_SIMD_X86
+CIRKIT_TARGET_AVX2 void static_tt_cof_avx2( uint64_t* blocks, unsigned num_blocks, unsigned var, bool positive )
+{
+  const auto shift = _mm_cvtsi32_si128( 1 << var );
+  const auto mask = _mm256_set1_epi64x( static_cast<long long>( positive ? stt_constants::truths[var] : ~stt_constants::truths[var] ) );
+
+  for ( auto k = 0u; k < num_blocks; k += 4u )
+  {
+    auto* p = reinterpret_cast<__m256i*>( blocks + k );
+    const auto x = _mm256_and_si256( _mm256_loadu_si256( p ), mask );
+    const auto y = positive ? _mm256_srl_epi64( x, shift ) : _mm256_sll_epi64( x, shift );
+    _mm256_storeu_si256( p, _mm256_or_si256( x, y ) );
+  }
+}
+
+CIRKIT_TARGET_AVX2 void static_tt_flip_avx2( uint64_t* blocks, unsigned num_blocks, unsigned var )
+{
+  const auto shift = _mm_cvtsi32_si128( 1 << var );
+  const auto mask = _mm256_set1_epi64x( static_cast<long long>( stt_constants::truths[var] ) );
+
+  for ( auto k = 0u; k < num_blocks; k += 4u )
+  {
+    auto* p = reinterpret_cast<__m256i*>( blocks + k );
+    const auto x = _mm256_loadu_si256( p );
+    const auto hi = _mm256_and_si256( _mm256_sll_epi64( x, shift ), mask );
+    const auto lo = _mm256_srl_epi64( _mm256_and_si256( x, mask ), shift );
+    _mm256_storeu_si256( p, _mm256_or_si256( hi, lo ) );
+  }
+}
+
+CIRKIT_TARGET_AVX2 void static_tt_swap_avx2( uint64_t* blocks, unsigned num_blocks, unsigned i, unsigned j )
+{
+  const auto delta = _mm_cvtsi32_si128( ( 1 << j ) - ( 1 << i ) );
+  const auto omega = _mm256_set1_epi64x( static_cast<long long>( stt_constants::truths[i] & ~stt_constants::truths[j] ) );
+
+  for ( auto k = 0u; k < num_blocks; k += 4u )
+  {
+    auto* p = reinterpret_cast<__m256i*>( blocks + k );
+    const auto x = _mm256_loadu_si256( p );
+    const auto y = _mm256_and_si256( _mm256_xor_si256( x, _mm256_srl_epi64( x, delta ) ), omega );
+    _mm256_storeu_si256( p, _mm256_xor_si256( x, _mm256_xor_si256( y, _mm256_sll_epi64( y, delta ) ) ) );
+  }
+}
+#endif
+
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
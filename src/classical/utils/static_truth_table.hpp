@@ -0,0 +1,523 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file static_truth_table.hpp
+ *
+ * @brief Truth tables of fixed size (up to 16 variables)
+ *
+ * A static_tt<N> stores the truth table of an N-variable function in an
+ * array of 2^{N-6} 64-bit words (one word if N <= 6) and therefore does
+ * not allocate.  Bits beyond 2^N in the last word are always zero, so
+ * that comparison and counting agree with the dynamic `tt' of the same
+ * size.
+ *
+ * Cofactors, flips, and swaps are computed with branch-free masks within
+ * words (variables x_0, ..., x_5) and by moving whole words otherwise.
+ * For N >= 8 the in-word kernels use AVX2 if available at runtime.
+ *
+ * The free functions overload the names in truth_table_utils.hpp, such
+ * that algorithms written as templates work on both representations.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef STATIC_TRUTH_TABLE_HPP
+#define STATIC_TRUTH_TABLE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <utility>
+
+#include <core/utils/simd_utils.hpp>
+#include <classical/utils/small_truth_table_utils.hpp>
+#include <classical/utils/truth_table_utils.hpp>
+
+namespace cirkit
+{
+
+namespace detail
+{
+
+#if CIRKIT_SIMD_X86
+/* in-word kernels for variables x_0, ..., x_5, num_blocks must be a multiple of 4 */
+void static_tt_cof_avx2( uint64_t* blocks, unsigned num_blocks, unsigned var, bool positive );
+void static_tt_flip_avx2( uint64_t* blocks, unsigned num_blocks, unsigned var );
+void static_tt_swap_avx2( uint64_t* blocks, unsigned num_blocks, unsigned i, unsigned j );
+#endif
+
+inline bool static_tt_use_avx2( unsigned num_blocks )
+{
+#if CIRKIT_SIMD_X86
+  return num_blocks >= 4u && simd_detect() != simd_level::scalar;
+#else
+  return false;
+#endif
+}
+
+}
+
+template<unsigned NumVars>
+class static_tt
+{
+  static_assert( NumVars <= 16u, "static_tt supports at most 16 variables" );
+
+public:
+  static constexpr unsigned num_vars   = NumVars;
+  static constexpr unsigned num_blocks = NumVars <= 6u ? 1u : 1u << ( NumVars - 6u );
+  static constexpr uint64_t block_mask = NumVars >= 6u ? ~UINT64_C( 0 ) : ( UINT64_C( 1 ) << ( ( 1u << NumVars ) & 63u ) ) - 1u;
+
+  using blocks_t = std::array<uint64_t, num_blocks>;
+
+  static_tt() : _blocks() {}
+
+  /* initializes the first word, other words are 0 */
+  explicit static_tt( uint64_t value ) : _blocks()
+  {
+    _blocks[0u] = value & block_mask;
+  }
+
+  static static_tt nth_var( unsigned i )
+  {
+    assert( i < NumVars );
+
+    static_tt t;
+    if ( i < 6u )
+    {
+      t._blocks.fill( stt_constants::truths[i] & block_mask );
+    }
+    else
+    {
+      const auto shift = i - 6u;
+      for ( auto k = 0u; k < num_blocks; ++k )
+      {
+        t._blocks[k] = ( ( k >> shift ) & 1u ) ? ~UINT64_C( 0 ) : UINT64_C( 0 );
+      }
+    }
+    return t;
+  }
+
+  static static_tt const0() { return static_tt(); }
+  static static_tt const1() { return ~static_tt(); }
+
+  inline std::size_t size() const                 { return std::size_t( 1u ) << NumVars; }
+  inline const blocks_t& blocks() const           { return _blocks; }
+  inline blocks_t& blocks()                       { return _blocks; }
+  inline uint64_t block( unsigned i ) const       { return _blocks[i]; }
+
+  inline bool test( unsigned pos ) const
+  {
+    return ( _blocks[pos >> 6u] >> ( pos & 63u ) ) & 1u;
+  }
+
+  inline static_tt& set( unsigned pos, bool value = true )
+  {
+    const auto bit = UINT64_C( 1 ) << ( pos & 63u );
+    if ( value ) { _blocks[pos >> 6u] |= bit; } else { _blocks[pos >> 6u] &= ~bit; }
+    return *this;
+  }
+
+  inline std::size_t count() const
+  {
+    std::size_t c = 0u;
+    for ( auto b : _blocks ) { c += __builtin_popcountll( b ); }
+    return c;
+  }
+
+  inline bool none() const
+  {
+    for ( auto b : _blocks ) { if ( b ) { return false; } }
+    return true;
+  }
+
+  inline bool any() const { return !none(); }
+
+  inline bool all() const
+  {
+    for ( auto b : _blocks ) { if ( b != block_mask ) { return false; } }
+    return true;
+  }
+
+  /* complements in place (like boost::dynamic_bitset::flip) */
+  inline static_tt& flip()
+  {
+    for ( auto& b : _blocks ) { b = ~b & block_mask; }
+    return *this;
+  }
+
+  inline static_tt operator~() const { auto t = *this; return t.flip(); }
+
+  inline static_tt& operator&=( const static_tt& other ) { for ( auto k = 0u; k < num_blocks; ++k ) { _blocks[k] &= other._blocks[k]; } return *this; }
+  inline static_tt& operator|=( const static_tt& other ) { for ( auto k = 0u; k < num_blocks; ++k ) { _blocks[k] |= other._blocks[k]; } return *this; }
+  inline static_tt& operator^=( const static_tt& other ) { for ( auto k = 0u; k < num_blocks; ++k ) { _blocks[k] ^= other._blocks[k]; } return *this; }
+
+  inline static_tt operator&( const static_tt& other ) const { auto t = *this; return t &= other; }
+  inline static_tt operator|( const static_tt& other ) const { auto t = *this; return t |= other; }
+  inline static_tt operator^( const static_tt& other ) const { auto t = *this; return t ^= other; }
+
+  inline bool operator==( const static_tt& other ) const { return _blocks == other._blocks; }
+  inline bool operator!=( const static_tt& other ) const { return _blocks != other._blocks; }
+
+  /* compares as numbers (most significant word first), as boost::dynamic_bitset does */
+  inline bool operator<( const static_tt& other ) const
+  {
+    for ( auto k = num_blocks; k-- > 0u; )
+    {
+      if ( _blocks[k] != other._blocks[k] ) { return _blocks[k] < other._blocks[k]; }
+    }
+    return false;
+  }
+
+  /* in-place kernels, see the free functions below */
+  void cofactor( unsigned i, bool positive )
+  {
+    assert( i < NumVars );
+
+    if ( i < 6u )
+    {
+#if CIRKIT_SIMD_X86
+      if ( detail::static_tt_use_avx2( num_blocks ) )
+      {
+        detail::static_tt_cof_avx2( _blocks.data(), num_blocks, i, positive );
+        return;
+      }
+#endif
+      const auto shift = 1u << i;
+      if ( positive )
+      {
+        const auto mask = stt_constants::truths[i];
+        for ( auto& b : _blocks ) { const auto x = b & mask; b = x | ( x >> shift ); }
+      }
+      else
+      {
+        const auto mask = ~stt_constants::truths[i];
+        for ( auto& b : _blocks ) { const auto x = b & mask; b = x | ( x << shift ); }
+      }
+    }
+    else
+    {
+      const auto step = 1u << ( i - 6u );
+      for ( auto k = 0u; k < num_blocks; k += 2u * step )
+      {
+        for ( auto j = k; j < k + step; ++j )
+        {
+          if ( positive ) { _blocks[j] = _blocks[j + step]; } else { _blocks[j + step] = _blocks[j]; }
+        }
+      }
+    }
+  }
+
+  void flip( unsigned i )
+  {
+    assert( i < NumVars );
+
+    if ( i < 6u )
+    {
+#if CIRKIT_SIMD_X86
+      if ( detail::static_tt_use_avx2( num_blocks ) )
+      {
+        detail::static_tt_flip_avx2( _blocks.data(), num_blocks, i );
+        return;
+      }
+#endif
+      const auto shift = 1u << i;
+      const auto mask = stt_constants::truths[i];
+      for ( auto& b : _blocks ) { b = ( ( b << shift ) & mask ) | ( ( b & mask ) >> shift ); }
+    }
+    else
+    {
+      const auto step = 1u << ( i - 6u );
+      for ( auto k = 0u; k < num_blocks; k += 2u * step )
+      {
+        for ( auto j = k; j < k + step; ++j )
+        {
+          std::swap( _blocks[j], _blocks[j + step] );
+        }
+      }
+    }
+  }
+
+  void swap( unsigned i, unsigned j )
+  {
+    assert( i < NumVars && j < NumVars );
+
+    if ( i == j ) { return; }
+    if ( i > j ) { std::swap( i, j ); }
+
+    if ( j < 6u )
+    {
+#if CIRKIT_SIMD_X86
+      if ( detail::static_tt_use_avx2( num_blocks ) )
+      {
+        detail::static_tt_swap_avx2( _blocks.data(), num_blocks, i, j );
+        return;
+      }
+#endif
+      /* exchange bits with x_i = 1, x_j = 0 and x_i = 0, x_j = 1, see TAOCP 7.1.3-(69) */
+      const auto delta = ( 1u << j ) - ( 1u << i );
+      const auto omega = stt_constants::truths[i] & ~stt_constants::truths[j];
+      for ( auto& b : _blocks )
+      {
+        const auto y = ( b ^ ( b >> delta ) ) & omega;
+        b ^= y ^ ( y << delta );
+      }
+    }
+    else if ( i < 6u )
+    {
+      const auto shift = 1u << i;
+      const auto mask = stt_constants::truths[i];
+      const auto step = 1u << ( j - 6u );
+      for ( auto k = 0u; k < num_blocks; k += 2u * step )
+      {
+        for ( auto l = k; l < k + step; ++l )
+        {
+          const auto lo = _blocks[l], hi = _blocks[l + step];
+          _blocks[l]        = ( lo & ~mask ) | ( ( hi << shift ) & mask );
+          _blocks[l + step] = ( hi & mask )  | ( ( lo & mask ) >> shift );
+        }
+      }
+    }
+    else
+    {
+      const auto si = 1u << ( i - 6u ), sj = 1u << ( j - 6u );
+      for ( auto k = 0u; k < num_blocks; ++k )
+      {
+        if ( ( k & si ) && !( k & sj ) )
+        {
+          std::swap( _blocks[k], _blocks[k - si + sj] );
+        }
+      }
+    }
+  }
+
+  bool has_var( unsigned i ) const
+  {
+    if ( i >= NumVars ) { return false; }
+
+    if ( i < 6u )
+    {
+      const auto shift = 1u << i;
+      const auto mask = ~stt_constants::truths[i];
+      for ( auto b : _blocks )
+      {
+        if ( ( ( b >> shift ) & mask ) != ( b & mask ) ) { return true; }
+      }
+    }
+    else
+    {
+      const auto step = 1u << ( i - 6u );
+      for ( auto k = 0u; k < num_blocks; k += 2u * step )
+      {
+        for ( auto j = k; j < k + step; ++j )
+        {
+          if ( _blocks[j] != _blocks[j + step] ) { return true; }
+        }
+      }
+    }
+    return false;
+  }
+
+private:
+  blocks_t _blocks;
+};
+
+template<unsigned NumVars> constexpr unsigned static_tt<NumVars>::num_vars;
+template<unsigned NumVars> constexpr unsigned static_tt<NumVars>::num_blocks;
+template<unsigned NumVars> constexpr uint64_t static_tt<NumVars>::block_mask;
+
+/******************************************************************************
+ * Overloads of truth_table_utils.hpp                                         *
+ ******************************************************************************/
+
+template<unsigned N>
+inline unsigned tt_num_vars( const static_tt<N>& )
+{
+  return N;
+}
+
+template<unsigned N>
+inline static_tt<N> tt_cof0( const static_tt<N>& t, unsigned i )
+{
+  auto tc = t; tc.cofactor( i, false ); return tc;
+}
+
+template<unsigned N>
+inline static_tt<N> tt_cof1( const static_tt<N>& t, unsigned i )
+{
+  auto tc = t; tc.cofactor( i, true ); return tc;
+}
+
+template<unsigned N>
+inline static_tt<N> tt_flip( const static_tt<N>& t, unsigned i )
+{
+  auto tc = t; tc.flip( i ); return tc;
+}
+
+template<unsigned N>
+inline static_tt<N> tt_permute( const static_tt<N>& t, unsigned i, unsigned j )
+{
+  auto tc = t; tc.swap( i, j ); return tc;
+}
+
+template<unsigned N>
+inline static_tt<N> tt_exists( const static_tt<N>& t, unsigned i )
+{
+  return tt_cof0( t, i ) | tt_cof1( t, i );
+}
+
+template<unsigned N>
+inline static_tt<N> tt_forall( const static_tt<N>& t, unsigned i )
+{
+  return tt_cof0( t, i ) & tt_cof1( t, i );
+}
+
+template<unsigned N>
+inline bool tt_has_var( const static_tt<N>& t, unsigned i )
+{
+  return t.has_var( i );
+}
+
+template<unsigned N>
+inline unsigned tt_support_size( const static_tt<N>& t )
+{
+  auto size = 0u;
+  for ( auto i = 0u; i < N; ++i )
+  {
+    if ( t.has_var( i ) ) { ++size; }
+  }
+  return size;
+}
+
+template<unsigned N>
+inline bool tt_is_const0( const static_tt<N>& t )
+{
+  return t.none();
+}
+
+template<unsigned N>
+inline bool tt_is_const1( const static_tt<N>& t )
+{
+  return t.all();
+}
+
+/******************************************************************************
+ * Conversion                                                                 *
+ ******************************************************************************/
+
+/**
+ * @brief Converts a truth table into a static one
+ *
+ * Smaller truth tables are extended (as tt_extend) and larger ones are
+ * cut off (as tt_shrink).
+ */
+template<unsigned N>
+static_tt<N> to_static_tt( const tt& t )
+{
+  assert( t.size() != 0u );
+
+  static_tt<N> st;
+  auto& blocks = st.blocks();
+
+  const auto size = std::min<std::size_t>( t.size(), st.size() );
+  for ( auto pos = t.find_first(); pos < size; pos = t.find_next( pos ) )
+  {
+    st.set( pos );
+  }
+
+  if ( size < st.size() )
+  {
+    for ( auto len = size; len < 64u && len < st.size(); len <<= 1u )
+    {
+      blocks[0u] |= blocks[0u] << len;
+    }
+    const auto used = std::max<std::size_t>( size >> 6u, 1u );
+    for ( auto k = used; k < blocks.size(); ++k )
+    {
+      blocks[k] = blocks[k % used];
+    }
+  }
+
+  return st;
+}
+
+template<unsigned N>
+tt to_tt( const static_tt<N>& t )
+{
+  if ( N <= 6u )
+  {
+    return tt( t.size(), t.block( 0u ) );
+  }
+  else
+  {
+    return tt( t.blocks().begin(), t.blocks().end() );
+  }
+}
+
+/**
+ * @brief Calls fn.run<N>() for N = num_vars
+ *
+ * This turns a runtime number of variables into a static_tt size,
+ * callers are responsible to check that num_vars is at most 16.
+ */
+template<typename Fn>
+auto static_tt_dispatch( unsigned num_vars, Fn&& fn ) -> decltype( fn.template run<0u>() )
+{
+  switch ( num_vars )
+  {
+  case 0u:  return fn.template run<0u>();
+  case 1u:  return fn.template run<1u>();
+  case 2u:  return fn.template run<2u>();
+  case 3u:  return fn.template run<3u>();
+  case 4u:  return fn.template run<4u>();
+  case 5u:  return fn.template run<5u>();
+  case 6u:  return fn.template run<6u>();
+  case 7u:  return fn.template run<7u>();
+  case 8u:  return fn.template run<8u>();
+  case 9u:  return fn.template run<9u>();
+  case 10u: return fn.template run<10u>();
+  case 11u: return fn.template run<11u>();
+  case 12u: return fn.template run<12u>();
+  case 13u: return fn.template run<13u>();
+  case 14u: return fn.template run<14u>();
+  case 15u: return fn.template run<15u>();
+  case 16u: return fn.template run<16u>();
+  default:
+    throw "static_tt supports at most 16 variables";
+  }
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
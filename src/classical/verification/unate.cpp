@@ -463,14 +463,8 @@ boost::dynamic_bitset<> unateness_split_parallel( const aig_graph& aig,
     result_mutex.unlock();
   };
 
-  {
-    thread_pool pool;
-
-    for ( auto j = 0u; j < m; ++j )
-    {
-      pool.enqueue( thread, j );
-    }
-  }
+  thread_pool pool;
+  pool.parallel_for( 0u, static_cast<unsigned>( m ), thread, 1u );
 
   return result;
 }
@@ -497,14 +491,8 @@ boost::dynamic_bitset<> unateness_split_inputs_parallel( const aig_graph& aig,
     result_mutex.unlock();
   };
 
-  {
-    thread_pool pool;
-
-    for ( auto i = 0u; i < n; ++i )
-    {
-      pool.enqueue( thread, i );
-    }
-  }
+  thread_pool pool;
+  pool.parallel_for( 0u, static_cast<unsigned>( n ), thread, 1u );
 
   return result;
 }
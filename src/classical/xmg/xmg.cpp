@@ -26,6 +26,9 @@
 
 #include "xmg.hpp"
 
+#include <algorithm>
+#include <numeric>
+
 #include <range/v3/iterator_range.hpp>
 
 #include <core/utils/range_utils.hpp>
@@ -43,6 +46,59 @@ namespace cirkit
  * Private functions                                                          *
  ******************************************************************************/
 
+constexpr unsigned xmg_graph::invalid_literal;
+
+xmg_graph::node_t xmg_graph::add_node( unsigned a, unsigned b, unsigned c )
+{
+  assert( _nodes.size() < ( 1u << 31u ) );
+
+  const auto n = _nodes.size();
+  _nodes.push_back( {{a, b, c}} );
+  if ( a != invalid_literal )
+  {
+    strash_insert( n );
+  }
+  return n;
+}
+
+xmg_graph::node_t xmg_graph::strash_lookup( unsigned a, unsigned b, unsigned c ) const
+{
+  if ( strash.empty() ) { return 0u; }
+
+  const auto mask = strash.size() - 1u;
+  for ( auto i = strash_hash( a, b, c ) & mask; strash[i]; i = ( i + 1u ) & mask )
+  {
+    const auto& f = _nodes[strash[i]].fanin;
+    if ( f[0u] == a && f[1u] == b && f[2u] == c )
+    {
+      return strash[i];
+    }
+  }
+  return 0u;
+}
+
+void xmg_graph::strash_insert( node_t n )
+{
+  /* keep load below 1/2 */
+  if ( ( strash_count + 1u ) << 1u > strash.size() )
+  {
+    std::vector<unsigned> old( std::max<std::size_t>( 1024u, strash.size() << 1u ), 0u );
+    old.swap( strash );
+    strash_count = 0u;
+    for ( auto m : old )
+    {
+      if ( m ) { strash_insert( m ); }
+    }
+  }
+
+  const auto& f = _nodes[n].fanin;
+  const auto mask = strash.size() - 1u;
+  auto i = strash_hash( f[0u], f[1u], f[2u] ) & mask;
+  while ( strash[i] ) { i = ( i + 1u ) & mask; }
+  strash[i] = n;
+  ++strash_count;
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -52,21 +108,40 @@ namespace cirkit
  ******************************************************************************/
 
 xmg_graph::xmg_graph( const std::string& name )
-  : constant( add_vertex( g ) ),
-    _name( name ),
-    _complement( boost::get( boost::edge_complement, g ) )
+  : constant( add_node( invalid_literal, invalid_literal, invalid_literal ) ),
+    _name( name )
 {
   assert( constant == 0 );
 }
 
 void xmg_graph::compute_fanout()
 {
-  fanout.update( [this]() { return precompute_in_degrees( g ); } );
+  fanout.update( [this]() {
+      std::vector<unsigned> f( size(), 0u );
+      for ( auto n = 0u; n < size(); ++n )
+      {
+        for ( auto i = 0u; i < fanin_count( n ); ++i )
+        {
+          ++f[_nodes[n].fanin[i] >> 1u];
+        }
+      }
+      return f;
+    } );
 }
 
 void xmg_graph::compute_parents()
 {
-  parentss.update( [this]() { return precompute_ingoing_vertices( g ); } );
+  parentss.update( [this]() {
+      std::vector<std::vector<node_t>> p( size() );
+      for ( auto n = 0u; n < size(); ++n )
+      {
+        for ( auto i = 0u; i < fanin_count( n ); ++i )
+        {
+          p[_nodes[n].fanin[i] >> 1u].push_back( n );
+        }
+      }
+      return p;
+    } );
 }
 
 void xmg_graph::compute_levels()
@@ -81,7 +156,8 @@ xmg_function xmg_graph::get_constant( bool value ) const
 
 xmg_function xmg_graph::create_pi( const std::string& name )
 {
-  const auto node = add_vertex( g );
+  const auto node = add_node( invalid_literal, invalid_literal, invalid_literal );
+  mark_as_modified();
   _input_to_id.insert( {node, _inputs.size()} );
   _inputs.push_back( {node, name} );
   return xmg_function( node );
@@ -124,29 +200,24 @@ xmg_function xmg_graph::create_maj( const xmg_function& a, const xmg_function& b
     children[2].complemented = !children[2].complemented;
   }
 
-  auto key = std::make_tuple( children[0], children[1], children[2] );
+  const auto la = to_literal( children[0] );
+  const auto lb = to_literal( children[1] );
+  const auto lc = to_literal( children[2] );
 
-  const auto it = maj_strash.find( key );
-  if ( _enable_structural_hashing && it != maj_strash.end() )
+  if ( _enable_structural_hashing )
   {
-    return xmg_function( it->second, node_complement );
+    if ( const auto node = strash_lookup( la, lb, lc ) )
+    {
+      return xmg_function( node, node_complement );
+    }
   }
 
   /* insert node */
-  const auto node = add_vertex( g );
+  const auto node = add_node( la, lb, lc );
   ++_num_maj;
 
-  const auto ea = add_edge( node, children[0].node, g ).first;
-  const auto eb = add_edge( node, children[1].node, g ).first;
-  const auto ec = add_edge( node, children[2].node, g ).first;
-
-  _complement[ea] = children[0].complemented;
-  _complement[eb] = children[1].complemented;
-  _complement[ec] = children[2].complemented;
-
   mark_as_modified();
 
-  maj_strash[key] = node;
   return xmg_function( node, node_complement );
 }
 
@@ -172,25 +243,23 @@ xmg_function xmg_graph::create_xor( const xmg_function& a, const xmg_function& b
       key.first.complemented = key.second.complemented = false;
     }
 
-    const auto it = xor_strash.find( key );
-    if ( _enable_structural_hashing && it != xor_strash.end() )
+    const auto la = to_literal( key.first );
+    const auto lb = to_literal( key.second );
+
+    if ( _enable_structural_hashing )
     {
-      return xmg_function( it->second, node_complement );
+      if ( const auto node = strash_lookup( la, lb, invalid_literal ) )
+      {
+        return xmg_function( node, node_complement );
+      }
     }
 
     /* insert node */
-    const auto node = add_vertex( g );
+    const auto node = add_node( la, lb, invalid_literal );
     ++_num_xor;
 
-    const auto ea = add_edge( node, key.first.node, g ).first;
-    const auto eb = add_edge( node, key.second.node, g ).first;
-
-    _complement[ea] = key.first.complemented;
-    _complement[eb] = key.second.complemented;
-
     mark_as_modified();
 
-    xor_strash[key] = node;
     return xmg_function( node, node_complement );
   }
   else
@@ -224,11 +293,6 @@ xmg_function xmg_graph::create_nary_or( const std::vector<xmg_function>& ops )
   return balanced_accumulate( ops.begin(), ops.end(), [this]( const xmg_function& a, const xmg_function& b ) { return create_or( a, b ); } );
 }
 
-unsigned xmg_graph::fanin_count( node_t n ) const
-{
-  return boost::out_degree( n, g );
-}
-
 unsigned xmg_graph::fanout_count( node_t n ) const
 {
   return (*fanout)[n];
@@ -244,26 +308,6 @@ unsigned xmg_graph::level( node_t n ) const
   return (*levels)[n];
 }
 
-bool xmg_graph::is_input( node_t n ) const
-{
-  return fanin_count( n ) == 0u;
-}
-
-bool xmg_graph::is_maj( node_t n ) const
-{
-  return fanin_count( n ) == 3u;
-}
-
-bool xmg_graph::is_pure_maj( node_t n ) const
-{
-  return fanin_count( n ) == 3u && ( *( boost::adjacent_vertices( n, g ).first ) != 0 );
-}
-
-bool xmg_graph::is_xor( node_t n ) const
-{
-  return fanin_count( n ) == 2u;
-}
-
 const std::string& xmg_graph::name() const
 {
   return _name;
@@ -276,7 +320,7 @@ void xmg_graph::set_name( const std::string& name )
 
 std::size_t xmg_graph::size() const
 {
-  return num_vertices( g );
+  return _nodes.size();
 }
 
 unsigned xmg_graph::num_gates() const
@@ -296,12 +340,20 @@ unsigned xmg_graph::num_xor() const
 
 const xmg_graph::graph_t& xmg_graph::graph() const
 {
-  return g;
-}
-
-xmg_graph::graph_t& xmg_graph::graph()
-{
-  return g;
+  g.update( [this]() {
+      graph_t graph( size() );
+      auto complement = boost::get( boost::edge_complement, graph );
+      for ( auto n = 0u; n < size(); ++n )
+      {
+        for ( auto i = 0u; i < fanin_count( n ); ++i )
+        {
+          const auto e = add_edge( n, _nodes[n].fanin[i] >> 1u, graph ).first;
+          complement[e] = _nodes[n].fanin[i] & 1u;
+        }
+      }
+      return graph;
+    } );
+  return *g;
 }
 
 const xmg_graph::input_vec_t& xmg_graph::inputs() const
@@ -336,30 +388,21 @@ const unsigned xmg_graph::input_index( xmg_node n ) const
 
 xmg_graph::vertex_range_t xmg_graph::nodes() const
 {
-  const auto v = boost::vertices( g );
-  return ranges::make_iterator_range( v.first, v.second );
+  using vertex_iterator = boost::graph_traits<graph_t>::vertex_iterator;
+  return ranges::make_iterator_range( vertex_iterator( 0u ), vertex_iterator( size() ) );
 }
 
 xmg_graph::edge_range_t xmg_graph::edges() const
 {
-  const auto e = boost::edges( g );
+  const auto e = boost::edges( graph() );
   return ranges::make_iterator_range( e.first, e.second );
 }
 
-std::vector<xmg_function> xmg_graph::children( xmg_node n ) const
-{
-  std::vector<xmg_function> c;
-  for ( const auto& e : boost::make_iterator_range( boost::out_edges( n, g ) ) )
-  {
-    c.push_back( xmg_function( boost::target( e, g ), _complement[e] ) );
-  }
-  return c;
-}
-
 std::vector<xmg_graph::node_t> xmg_graph::topological_nodes() const
 {
-  std::vector<node_t> top( num_vertices( g ) );
-  boost::topological_sort( g, top.begin() );
+  /* nodes are created in topological order */
+  std::vector<node_t> top( size() );
+  std::iota( top.begin(), top.end(), 0u );
   return top;
 }
 
@@ -436,18 +479,13 @@ void xmg_graph::mark_as_modified()
   fanout.make_dirty();
   parentss.make_dirty();
   levels.make_dirty();
+  g.make_dirty();
 }
 
 /******************************************************************************
  * xmg_fuction                                                            *
  ******************************************************************************/
 
-xmg_function::xmg_function( xmg_node node, bool complemented )
-  : node( node ),
-    complemented( complemented )
-{
-}
-
 bool xmg_function::operator==( const xmg_function& other ) const
 {
   return node == other.node && complemented == other.complemented;
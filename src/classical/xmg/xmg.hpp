@@ -36,6 +36,7 @@
 #ifndef XMG_HPP
 #define XMG_HPP
 
+#include <cassert>
 #include <functional>
 #include <string>
 #include <unordered_map>
@@ -47,7 +48,6 @@
 
 #include <core/utils/dirty.hpp>
 #include <core/utils/graph_utils.hpp>
-#include <core/utils/hash_utils.hpp>
 
 namespace cirkit
 {
@@ -59,7 +59,7 @@ using xmg_edge    = edge_t<xmg_graph_t>;
 class xmg_function
 {
 public:
-  xmg_function( xmg_node node = 0, bool complemented = false );
+  inline xmg_function( xmg_node node = 0, bool complemented = false ) : node( node ), complemented( complemented ) {}
 
   bool operator==( const xmg_function& other ) const;
   bool operator!=( const xmg_function& other ) const;
@@ -93,8 +93,46 @@ struct hash<cirkit::xmg_function>
 namespace cirkit
 {
 
+/**
+ * Children of a node, returned by value by xmg_graph::children without
+ * allocating memory
+ */
+class xmg_children
+{
+public:
+  using value_type     = xmg_function;
+  using iterator       = const xmg_function*;
+  using const_iterator = const xmg_function*;
+  using size_type      = unsigned;
+
+  inline const_iterator begin() const { return _data; }
+  inline const_iterator end() const   { return _data + _size; }
+  inline size_type size() const       { return _size; }
+  inline bool empty() const           { return _size == 0u; }
+
+  inline const xmg_function& operator[]( unsigned i ) const { assert( i < _size ); return _data[i]; }
+  inline const xmg_function& front() const                 { return _data[0u]; }
+  inline const xmg_function& back() const                  { return _data[_size - 1u]; }
+
+private:
+  friend class xmg_graph;
+
+  xmg_function _data[3];
+  unsigned     _size = 0u;
+};
+
 class xmg_cover;
 
+/**
+ * Nodes are stored in a contiguous array, each node keeps its up to 3
+ * children inline as 32-bit literals (2 * node + complemented).  Nodes are
+ * created in topological order, i.e., children have smaller indexes than
+ * their parents.  Structural hashing uses an open-addressing table of node
+ * indexes whose keys are the children stored in the node array.
+ *
+ * The Boost graph returned by graph() is built from the node array on
+ * demand, it is only needed for generic graph algorithms.
+ */
 class xmg_graph
 {
 public:
@@ -107,7 +145,7 @@ public:
   using vertex_range_t = ranges::iterator_range<boost::graph_traits<xmg_graph_t>::vertex_iterator>;
   using edge_range_t   = ranges::iterator_range<boost::graph_traits<xmg_graph_t>::edge_iterator>;
 
-  using complement_property_map_t = boost::property_map<graph_t, boost::edge_complement_t>::type;
+  using complement_property_map_t = boost::property_map<graph_t, boost::edge_complement_t>::const_type;
 
 public:
   xmg_graph( const std::string& name = std::string() );
@@ -128,15 +166,20 @@ public:
   xmg_function create_nary_and( const std::vector<xmg_function>& ops );
   xmg_function create_nary_or( const std::vector<xmg_function>& ops );
 
-  unsigned fanin_count( node_t n ) const;
+  inline unsigned fanin_count( node_t n ) const
+  {
+    const auto& f = _nodes[n].fanin;
+    return f[0u] == invalid_literal ? 0u : ( f[2u] == invalid_literal ? 2u : 3u );
+  }
+
   unsigned fanout_count( node_t n ) const;
   const std::vector<node_t>& parents( node_t n ) const;
   unsigned level( node_t n ) const;
 
-  bool is_input( node_t n ) const;
-  bool is_maj( node_t n ) const;
-  bool is_pure_maj( node_t n ) const;
-  bool is_xor( node_t n ) const;
+  inline bool is_input( node_t n ) const    { return fanin_count( n ) == 0u; }
+  inline bool is_maj( node_t n ) const      { return fanin_count( n ) == 3u; }
+  inline bool is_pure_maj( node_t n ) const { return fanin_count( n ) == 3u && ( _nodes[n].fanin[0u] >> 1u ) != 0u; }
+  inline bool is_xor( node_t n ) const      { return fanin_count( n ) == 2u; }
 
   const std::string& name() const;
   void set_name( const std::string& name );
@@ -145,18 +188,31 @@ public:
   unsigned num_maj() const;
   unsigned num_xor() const;
   const graph_t& graph() const;
-  graph_t& graph();
   const input_vec_t& inputs() const;
   const output_vec_t& outputs() const;
   input_vec_t& inputs();
   output_vec_t& outputs();
   const std::string& input_name( xmg_node n ) const;
   const unsigned input_index( xmg_node n ) const;
-  std::vector<xmg_function> children( xmg_node n ) const;
+
+  inline xmg_children children( xmg_node n ) const
+  {
+    xmg_children c;
+    const auto& f = _nodes[n].fanin;
+    for ( ; c._size < 3u && f[c._size] != invalid_literal; ++c._size )
+    {
+      c._data[c._size] = xmg_function( f[c._size] >> 1u, f[c._size] & 1u );
+    }
+    return c;
+  }
+
+  /* i-th child as literal ( 2 * node + complemented ) */
+  inline unsigned child_literal( xmg_node n, unsigned i ) const { return _nodes[n].fanin[i]; }
+
   vertex_range_t nodes() const;
   edge_range_t edges() const;
   std::vector<node_t> topological_nodes() const;
-  inline const complement_property_map_t& complement() { return _complement; }
+  inline complement_property_map_t complement() const { return boost::get( boost::edge_complement, graph() ); }
 
   /* cover */
   bool has_cover() const;
@@ -188,20 +244,43 @@ public: /* properties */
   inline bool has_inverter_propagation() const         { return _enable_inverter_propagation; }
 
 private:
-  graph_t g;
-  node_t  constant;
+  static constexpr unsigned invalid_literal = -1u;
+
+  struct storage_node
+  {
+    unsigned fanin[3];
+  };
+
+  static inline unsigned to_literal( const xmg_function& f )
+  {
+    return ( static_cast<unsigned>( f.node ) << 1u ) | static_cast<unsigned>( f.complemented );
+  }
+
+  node_t add_node( unsigned a, unsigned b, unsigned c );
+  node_t strash_lookup( unsigned a, unsigned b, unsigned c ) const;
+  void strash_insert( node_t n );
+
+  static inline unsigned strash_hash( unsigned a, unsigned b, unsigned c )
+  {
+    const auto h = a * 2654435761u ^ b * 2246822519u ^ c * 3266489917u;
+    return h ^ ( h >> 15u );
+  }
+
+private:
+  std::vector<storage_node> _nodes;
+  node_t                    constant;
 
   std::string  _name;
   input_vec_t  _inputs;
   output_vec_t _outputs;
   std::unordered_map<xmg_node, unsigned> _input_to_id;
 
-  using maj_strash_key_t = std::tuple<xmg_function, xmg_function, xmg_function>;
-  using xor_strash_key_t = std::pair<xmg_function, xmg_function>;
-  std::unordered_map<maj_strash_key_t, node_t, hash<maj_strash_key_t>> maj_strash;
-  std::unordered_map<xor_strash_key_t, node_t, hash<xor_strash_key_t>> xor_strash;
+  /* node indexes, 0 (the constant) marks an empty slot */
+  std::vector<unsigned>                   strash;
+  unsigned                                strash_count = 0u;
 
-  complement_property_map_t               _complement;
+  /* built on demand in graph() */
+  mutable dirty<graph_t>                  g;
 
   /* additional network information */
   dirty<std::vector<unsigned>>            fanout;
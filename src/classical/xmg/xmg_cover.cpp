@@ -46,21 +46,6 @@ xmg_cover::xmg_cover( unsigned cut_size, const xmg_graph& xmg )
 {
 }
 
-void xmg_cover::add_cut( xmg_node n, const xmg_cuts_paged::cut& cut )
-{
-  assert( offset[n] == 0u );
-
-  offset[n] = leafs.size();
-  leafs.push_back( cut.size() );
-
-  for ( auto l : cut )
-  {
-    leafs.push_back( l );
-  }
-
-  ++count;
-}
-
 bool xmg_cover::has_cut( xmg_node n ) const
 {
   return offset[n] != 0u;
@@ -42,7 +42,6 @@
 #include <boost/range/iterator_range.hpp>
 
 #include <classical/xmg/xmg.hpp>
-#include <classical/xmg/xmg_cuts_paged.hpp>
 
 namespace cirkit
 {
@@ -54,7 +53,23 @@ public:
 
   xmg_cover( unsigned cut_size, const xmg_graph& xmg );
 
-  void add_cut( xmg_node n, const xmg_cuts_paged::cut& cut );
+  /* cut is a range of leafs with size(), e.g., xmg_cuts_paged::cut or priority_cut */
+  template<typename Cut>
+  void add_cut( xmg_node n, const Cut& cut )
+  {
+    assert( offset[n] == 0u );
+
+    offset[n] = leafs.size();
+    leafs.push_back( cut.size() );
+
+    for ( auto l : cut )
+    {
+      leafs.push_back( l );
+    }
+
+    ++count;
+  }
+
   bool has_cut( xmg_node n ) const;
   index_range cut( xmg_node n ) const;
 
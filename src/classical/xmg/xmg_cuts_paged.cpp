@@ -410,7 +410,8 @@ void xmg_cuts_paged::enumerate_partial( const std::vector<xmg_node>& start, cons
     {
     case 0u:
       {
-        for ( const auto& c : _xmg.children( n ) | reversed )
+        const auto children = _xmg.children( n );
+        for ( const auto& c : children | reversed )
         {
           stack.push( c.node );
         }
@@ -51,6 +51,11 @@ xmg_dfs_visitor::xmg_dfs_visitor( const xmg_graph& xmg )
 void xmg_dfs_visitor::finish_vertex( const xmg_node& node, const xmg_graph::graph_t& g )
 {
   boost::default_dfs_visitor::finish_vertex( node, g );
+  finish_node( node );
+}
+
+void xmg_dfs_visitor::finish_node( const xmg_node& node )
+{
   if ( xmg.is_input( node ) )
   {
     if ( node == 0u )
@@ -74,6 +79,43 @@ void xmg_dfs_visitor::finish_vertex( const xmg_node& node, const xmg_graph::grap
   }
 }
 
+void xmg_depth_first_visit( const xmg_graph& xmg, xmg_node node, xmg_dfs_visitor& visitor,
+                            std::map<xmg_node, boost::default_color_type>& colors,
+                            const std::function<bool(xmg_node)>& terminate )
+{
+  using color = boost::color_traits<boost::default_color_type>;
+
+  /* node and index of next child */
+  std::vector<std::pair<xmg_node, unsigned>> stack;
+  const auto discover = [&]( xmg_node n ) {
+    colors[n] = color::gray();
+    stack.push_back( {n, terminate( n ) ? 3u : 0u} );
+  };
+
+  discover( node );
+  while ( !stack.empty() )
+  {
+    const auto n = stack.back().first;
+    const auto i = stack.back().second;
+
+    if ( i < xmg.fanin_count( n ) )
+    {
+      ++stack.back().second;
+      const auto child = xmg.child_literal( n, i ) >> 1u;
+      if ( colors[child] == color::white() )
+      {
+        discover( child );
+      }
+    }
+    else
+    {
+      stack.pop_back();
+      colors[n] = color::black();
+      visitor.finish_node( n );
+    }
+  }
+}
+
 }
 
 // Local Variables:
@@ -36,6 +36,9 @@
 #ifndef XMG_DFS_HPP
 #define XMG_DFS_HPP
 
+#include <functional>
+#include <map>
+
 #include <boost/graph/depth_first_search.hpp>
 
 #include <classical/xmg/xmg.hpp>
@@ -50,6 +53,9 @@ public:
 
   virtual void finish_vertex( const xmg_node& node, const xmg_graph::graph_t& g );
 
+  /* dispatches to the finish_* methods based on the node type */
+  void finish_node( const xmg_node& node );
+
   virtual void finish_input( const xmg_node& node, const xmg_graph& xmg ) = 0;
   virtual void finish_constant( const xmg_node& node, const xmg_graph& xmg ) = 0;
   virtual void finish_xor_node( const xmg_node& node, const xmg_function& a, const xmg_function& b, const xmg_graph& xmg ) = 0;
@@ -59,6 +65,18 @@ private:
   const xmg_graph& xmg;
 };
 
+/**
+ * @brief Depth-first traversal along the children of an XMG
+ *
+ * Works like boost::depth_first_visit on xmg.graph(), but directly on the
+ * node array without building the Boost graph.  Calls visitor.finish_node in
+ * post-order, children are visited in order.  Nodes for which terminate
+ * returns true are finished without visiting their children.
+ */
+void xmg_depth_first_visit( const xmg_graph& xmg, xmg_node node, xmg_dfs_visitor& visitor,
+                            std::map<xmg_node, boost::default_color_type>& colors,
+                            const std::function<bool(xmg_node)>& terminate = []( xmg_node ) { return false; } );
+
 }
 
 #endif
@@ -33,6 +33,7 @@
 
 #include <core/utils/terminal.hpp>
 #include <core/utils/timer.hpp>
+#include <classical/functions/cuts/priority.hpp>
 #include <classical/xmg/xmg_cover.hpp>
 #include <classical/xmg/xmg_cuts_paged.hpp>
 #include <classical/xmg/xmg_utils.hpp>
@@ -62,44 +63,68 @@ private:
   void find_best_cuts();
   void extract_cover();
 
+  template<typename Cut>
+  void add_cut( xmg_cover& cover, std::deque<xmg_node>& deque, xmg_node node, const Cut& cut );
+
 private:
+  using priority_cuts_t = priority_cuts<xmg_graph, 8u>;
+
   xmg_graph&            xmg;
   std::vector<unsigned> node_to_cut;
   std::vector<unsigned> node_to_level;
 
-  std::shared_ptr<xmg_cuts_paged> cuts;
+  std::shared_ptr<xmg_cuts_paged>  cuts;
+  std::shared_ptr<priority_cuts_t> pcuts;
 
   /* settings */
   unsigned cut_size;
+  unsigned priority; /* 0: all cuts (depth-optimal), otherwise: priority cuts per node */
   bool     progress;
   bool     verbose;
 };
 
 xmg_flow_map_manager::xmg_flow_map_manager( xmg_graph& xmg, const properties::ptr& settings )
-  : xmg( xmg ),
-    node_to_cut( xmg.size() ),
-    node_to_level( xmg.size() )
+  : xmg( xmg )
 {
   cut_size = get( settings, "cut_size", 4u );
+  priority = get( settings, "priority", 0u );
   progress = get( settings, "progress", false );
   verbose  = get( settings, "verbose",  false );
 }
 
 void xmg_flow_map_manager::run()
 {
-  /* compute cuts */
   auto cuts_settings = std::make_shared<properties>();
-  cuts_settings->set( "progress", progress );
 
-  cuts = std::make_shared<xmg_cuts_paged>( xmg, cut_size, cuts_settings );
-  LN( boost::format( "[i] enumerated %d cuts in %.2f secs" ) % cuts->total_cut_count() % cuts->enumeration_time() );
+  if ( priority == 0u )
+  {
+    /* compute all cuts */
+    cuts_settings->set( "progress", progress );
+
+    cuts = std::make_shared<xmg_cuts_paged>( xmg, cut_size, cuts_settings );
+    LN( boost::format( "[i] enumerated %d cuts in %.2f secs" ) % cuts->total_cut_count() % cuts->enumeration_time() );
+
+    find_best_cuts();
+  }
+  else
+  {
+    /* compute priority cuts, the best cut of each node has minimum depth
+       among the kept ones */
+    cuts_settings->set( "priority", priority );
+    cuts_settings->set( "cost",     priority_cut_cost::depth );
+
+    pcuts = std::make_shared<priority_cuts_t>( xmg, cut_size, cuts_settings );
+    LN( boost::format( "[i] enumerated %d priority cuts in %.2f secs" ) % pcuts->total_cut_count() % pcuts->enumeration_time() );
+  }
 
-  find_best_cuts();
   extract_cover();
 }
 
 void xmg_flow_map_manager::find_best_cuts()
 {
+  node_to_cut.resize( xmg.size() );
+  node_to_level.resize( xmg.size() );
+
   null_stream ns;
   std::ostream null_out( &ns );
   boost::progress_display show_progress( xmg.size(), progress ? std::cout : null_out );
@@ -159,18 +184,30 @@ void xmg_flow_map_manager::extract_cover()
     if ( xmg.is_input( node ) || visited[node] ) { continue; }
     visited[node] = true;
 
-    auto cut = cuts->from_address( node_to_cut[node] );
-    cover.add_cut( node, cut );
-
-    for ( auto leaf : cut )
+    if ( pcuts )
     {
-      deque.push_back( leaf );
+      add_cut( cover, deque, node, pcuts->best_cut( node ) );
+    }
+    else
+    {
+      add_cut( cover, deque, node, cuts->from_address( node_to_cut[node] ) );
     }
   }
 
   xmg.set_cover( cover );
 }
 
+template<typename Cut>
+void xmg_flow_map_manager::add_cut( xmg_cover& cover, std::deque<xmg_node>& deque, xmg_node node, const Cut& cut )
+{
+  cover.add_cut( node, cut );
+
+  for ( auto leaf : cut )
+  {
+    deque.push_back( leaf );
+  }
+}
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
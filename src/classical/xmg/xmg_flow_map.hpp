@@ -42,6 +42,8 @@
 namespace cirkit
 {
 
+/* settings: cut_size (4u), priority (0u: enumerate all cuts, depth-optimal;
+   otherwise: keep at most this many priority cuts per node), progress, verbose */
 void xmg_flow_map( xmg_graph& xmg, const properties::ptr& settings = properties::ptr(), const properties::ptr& statistics = properties::ptr() );
 
 }
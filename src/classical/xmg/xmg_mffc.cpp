@@ -237,10 +237,9 @@ unsigned xmg_mffc_size( const xmg_graph& xmg, xmg_node n, const std::vector<xmg_
   std::map<xmg_node, boost::default_color_type> colors;
   auto size = 0u;
 
-  boost::depth_first_visit( xmg.graph(), n,
-                            xmg_size_visitor( xmg, support, size ),
-                            boost::make_assoc_property_map( colors ),
-                            [&support]( const xmg_node& node, const xmg_graph::graph_t& g ) { return boost::find( support, node ) != support.end(); } );
+  xmg_size_visitor visitor( xmg, support, size );
+  xmg_depth_first_visit( xmg, n, visitor, colors,
+                         [&support]( xmg_node node ) { return boost::find( support, node ) != support.end(); } );
 
   return size;
 }
@@ -250,10 +249,9 @@ std::vector<xmg_node> xmg_mffc_cone( const xmg_graph& xmg, xmg_node n, const std
   std::map<xmg_node, boost::default_color_type> colors;
   std::vector<xmg_node> cone;
 
-  boost::depth_first_visit( xmg.graph(), n,
-                            xmg_cone_visitor( xmg, support, cone ),
-                            boost::make_assoc_property_map( colors ),
-                            [&support]( const xmg_node& node, const xmg_graph::graph_t& g ) { return boost::find( support, node ) != support.end(); } );
+  xmg_cone_visitor visitor( xmg, support, cone );
+  xmg_depth_first_visit( xmg, n, visitor, colors,
+                         [&support]( xmg_node node ) { return boost::find( support, node ) != support.end(); } );
 
   return cone;
 }
@@ -232,10 +232,9 @@ T simulate_xmg_node( const xmg_graph& xmg, const xmg_node& node,
                      xmg_node_color_map& colors,
                      std::map<xmg_node, T>& node_values )
 {
-  boost::depth_first_visit( xmg.graph(), node,
-                            simulate_xmg_node_visitor<T>( xmg, simulator, node_values ),
-                            boost::make_assoc_property_map( colors ),
-                            [&simulator, &xmg]( const xmg_node& node, const xmg_graph::graph_t& g ) { return simulator.terminate( node, xmg ); } );
+  simulate_xmg_node_visitor<T> visitor( xmg, simulator, node_values );
+  xmg_depth_first_visit( xmg, node, visitor, colors,
+                         [&simulator, &xmg]( xmg_node node ) { return simulator.terminate( node, xmg ); } );
 
   return node_values[node];
 }
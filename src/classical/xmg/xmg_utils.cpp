@@ -26,10 +26,13 @@
 
 #include "xmg_utils.hpp"
 
+#include <unordered_map>
+
 #include <boost/format.hpp>
 #include <boost/range/iterator_range.hpp>
 #include <range/v3/action/remove_if.hpp>
 
+#include <classical/utils/static_truth_table.hpp>
 #include <classical/xmg/xmg_cover.hpp>
 #include <classical/xmg/xmg_simulate.hpp>
 
@@ -40,6 +43,82 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+struct xmg_simulate_cut_fn
+{
+  const xmg_graph& xmg;
+  xmg_node root;
+  const std::vector<xmg_node>& leafs;
+
+  template<unsigned N>
+  tt run() const
+  {
+    std::unordered_map<xmg_node, unsigned> index;
+    std::vector<static_tt<N>> values;
+
+    for ( auto i = 0u; i < leafs.size(); ++i )
+    {
+      index[leafs[i]] = i;
+      values.push_back( static_tt<N>::nth_var( i ) );
+    }
+
+    std::vector<xmg_node> stack( 1u, root );
+    while ( !stack.empty() )
+    {
+      const auto node = stack.back();
+      if ( index.find( node ) != index.end() )
+      {
+        stack.pop_back();
+        continue;
+      }
+
+      if ( xmg.is_input( node ) )
+      {
+        if ( node != 0u )
+        {
+          std::cout << "[w] no assignment given for '" << node << "', assume default" << std::endl;
+        }
+        index[node] = values.size();
+        values.push_back( static_tt<N>::const0() );
+        stack.pop_back();
+        continue;
+      }
+
+      /* post-order: evaluate node once all children have values */
+      auto ready = true;
+      for ( const auto& c : xmg.children( node ) )
+      {
+        if ( index.find( c.node ) == index.end() )
+        {
+          stack.push_back( c.node );
+          ready = false;
+        }
+      }
+      if ( !ready ) { continue; }
+
+      const auto children = xmg.children( node );
+      std::array<static_tt<N>, 3u> ops;
+      for ( auto i = 0u; i < children.size(); ++i )
+      {
+        ops[i] = values[index[children[i].node]];
+        if ( children[i].complemented ) { ops[i].flip(); }
+      }
+
+      index[node] = values.size();
+      if ( xmg.is_maj( node ) )
+      {
+        values.push_back( ( ops[0u] & ops[1u] ) | ( ops[0u] & ops[2u] ) | ( ops[1u] & ops[2u] ) );
+      }
+      else
+      {
+        values.push_back( ops[0u] ^ ops[1u] );
+      }
+      stack.pop_back();
+    }
+
+    return to_tt( values[index[root]] );
+  }
+};
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
@@ -117,7 +196,7 @@ unsigned compute_pure_maj_count( const xmg_graph& xmg )
 std::vector<unsigned> xmg_compute_levels( const xmg_graph& xmg )
 {
   std::vector<unsigned> levels( xmg.size() );
-  for ( const auto& n : xmg.topological_nodes() )
+  for ( const auto& n : xmg.nodes() )
   {
     if ( xmg.is_input( n ) )
     {
@@ -162,6 +241,11 @@ std::deque<xmg_node> xmg_output_deque( const xmg_graph& xmg )
 
 tt xmg_simulate_cut( const xmg_graph& xmg, xmg_node root, const std::vector<xmg_node>& leafs )
 {
+  if ( leafs.size() <= 16u )
+  {
+    return static_tt_dispatch( leafs.size(), xmg_simulate_cut_fn{xmg, root, leafs} );
+  }
+
   std::map<xmg_node, tt> inputs;
   auto i = 0u;
   for ( auto child : leafs )
@@ -61,6 +61,7 @@ std::stack<xmg_node> xmg_output_stack( const xmg_graph& xmg );
 
 std::deque<xmg_node> xmg_output_deque( const xmg_graph& xmg );
 
+/* for at most 16 leafs, the truth table has 2^k bits for k = leafs.size() */
 tt xmg_simulate_cut( const xmg_graph& xmg, xmg_node root, const std::vector<xmg_node>& leafs );
 
 boost::dynamic_bitset<> xmg_output_mask( const xmg_graph& xmg );
@@ -0,0 +1,168 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mapped_file.hpp"
+
+#include <cerrno>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+mapped_file::mapped_file( const std::string& filename )
+{
+  const auto fd = open( filename.c_str(), O_RDONLY );
+  if ( fd == -1 )
+  {
+    throw "Error: could not open file (check path and permissions)";
+  }
+
+  struct stat st;
+  if ( fstat( fd, &st ) == -1 )
+  {
+    close( fd );
+    throw "Error: could not determine file size";
+  }
+  _size = st.st_size;
+
+  /* mmap does not accept empty mappings */
+  if ( _size != 0u )
+  {
+    auto* p = mmap( nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if ( p == MAP_FAILED )
+    {
+      close( fd );
+      throw "Error: could not map file into memory";
+    }
+    _data = static_cast<char*>( p );
+  }
+
+  close( fd );
+}
+
+mapped_file::mapped_file( const std::string& filename, std::size_t size )
+  : _writable( true )
+{
+  const auto fd = open( filename.c_str(), O_RDWR | O_CREAT, 0644 );
+  if ( fd == -1 )
+  {
+    throw "Error: could not open or create file (check path and permissions)";
+  }
+
+  /* the lock prevents a concurrent opener from truncating the file to a smaller size */
+  flock( fd, LOCK_EX );
+
+  struct stat st;
+  if ( fstat( fd, &st ) == -1 )
+  {
+    close( fd );
+    throw "Error: could not determine file size";
+  }
+  _size = st.st_size;
+
+  if ( _size < size )
+  {
+    if ( ftruncate( fd, size ) == -1 )
+    {
+      close( fd );
+      throw "Error: could not extend file";
+    }
+    _size = size;
+    _extended = true;
+  }
+
+  flock( fd, LOCK_UN );
+
+  if ( _size != 0u )
+  {
+    auto* p = mmap( nullptr, _size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if ( p == MAP_FAILED )
+    {
+      close( fd );
+      throw "Error: could not map file into memory";
+    }
+    _data = static_cast<char*>( p );
+  }
+
+  close( fd );
+}
+
+mapped_file::~mapped_file()
+{
+  if ( _data )
+  {
+    munmap( _data, _size );
+  }
+}
+
+file_lock::file_lock( const std::string& filename )
+  : _fd( open( filename.c_str(), O_RDWR | O_CREAT, 0644 ) )
+{
+  if ( _fd == -1 )
+  {
+    throw "Error: could not open file for locking (check path and permissions)";
+  }
+
+  while ( flock( _fd, LOCK_EX ) == -1 )
+  {
+    if ( errno != EINTR )
+    {
+      close( _fd );
+      throw "Error: could not lock file";
+    }
+  }
+}
+
+file_lock::~file_lock()
+{
+  flock( _fd, LOCK_UN );
+  close( _fd );
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,107 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file mapped_file.hpp
+ *
+ * @brief Memory-mapped files
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace cirkit
+{
+
+/**
+ * Maps a whole file into memory.  A read-write mapping is shared, i.e.,
+ * writes are visible to all processes that map the same file and end up
+ * in the file.  Errors are thrown as strings.
+ */
+class mapped_file
+{
+public:
+  /* maps an existing file read-only */
+  explicit mapped_file( const std::string& filename );
+
+  /* opens or creates a file for reading and writing, smaller files are
+     extended with zeros to size bytes */
+  mapped_file( const std::string& filename, std::size_t size );
+
+  ~mapped_file();
+
+  mapped_file( const mapped_file& ) = delete;
+  mapped_file& operator=( const mapped_file& ) = delete;
+
+  inline const char* data() const { return _data; }
+  inline char* data()             { return _data; }
+  inline std::size_t size() const { return _size; }
+  inline bool writable() const    { return _writable; }
+
+  /* true, if the file was created or extended when opened */
+  inline bool extended() const    { return _extended; }
+
+private:
+  char*       _data = nullptr;
+  std::size_t _size = 0u;
+  bool        _writable = false;
+  bool        _extended = false;
+};
+
+/**
+ * Holds an exclusive advisory lock (flock) on a file for its lifetime.
+ * The operating system releases the lock if the process terminates, so a
+ * crashed process never blocks later ones.  Must not be held while
+ * opening a read-write mapped_file for the same file.
+ */
+class file_lock
+{
+public:
+  explicit file_lock( const std::string& filename );
+  ~file_lock();
+
+  file_lock( const file_lock& ) = delete;
+  file_lock& operator=( const file_lock& ) = delete;
+
+private:
+  int _fd = -1;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
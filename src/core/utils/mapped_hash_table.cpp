@@ -0,0 +1,151 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "mapped_hash_table.hpp"
+
+#include <algorithm>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+void mapped_hash_table::initialize( const std::string& filename, uint64_t magic, uint32_t version, uint32_t record_size,
+                                    unsigned capacity, uint64_t arena_capacity, uint64_t user )
+{
+  auto* h = header();
+
+  /* the first process that sees an empty file writes the header; the lock
+     is released by the system if that process dies, and the next opener
+     finds the file still empty */
+  file_lock lock( filename );
+
+  if ( __atomic_load_n( &h->magic, __ATOMIC_ACQUIRE ) == UINT64_C( 0 ) )
+  {
+    auto num_buckets = 1u;
+    while ( num_buckets < capacity ) { num_buckets <<= 1u; }
+
+    h->version        = version;
+    h->record_size    = record_size;
+    h->num_buckets    = num_buckets;
+    h->capacity       = capacity;
+    h->count          = 0u;
+    h->arena_capacity = arena_capacity;
+    h->arena_used     = 0u;
+    h->user           = user;
+
+    __atomic_store_n( &h->magic, magic, __ATOMIC_RELEASE );
+  }
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+mapped_hash_table::mapped_hash_table( const std::string& filename, uint64_t magic, uint32_t version, uint32_t record_size,
+                                      unsigned capacity, uint64_t arena_capacity, uint64_t user )
+{
+  if ( capacity == 0u )
+  {
+    throw "Error: hash table capacity must be positive";
+  }
+
+  file.reset( new mapped_file( filename, sizeof( header_t ) ) );
+  initialize( filename, magic, version, record_size, capacity, arena_capacity, user );
+
+  /* only map the whole file if its layout is known */
+  const auto* h = header();
+  if ( h->magic != magic || h->version != version || h->record_size != record_size ) { return; }
+
+  const auto size = sizeof( header_t ) + h->num_buckets * sizeof( uint32_t ) + static_cast<std::size_t>( h->capacity ) * h->record_size + h->arena_capacity;
+  if ( file->size() < size )
+  {
+    file.reset( new mapped_file( filename, size ) );
+  }
+}
+
+uint64_t mapped_hash_table::hash( uint64_t key, uint64_t salt )
+{
+  auto h = key ^ salt;
+  h ^= h >> 33u;
+  h *= UINT64_C( 0xff51afd7ed558ccd );
+  h ^= h >> 33u;
+  h *= UINT64_C( 0xc4ceb9fe1a85ec53 );
+  h ^= h >> 33u;
+  return h;
+}
+
+bool mapped_hash_table::reserve( uint32_t& slot )
+{
+  auto* h = header();
+  if ( __atomic_load_n( &h->count, __ATOMIC_RELAXED ) >= h->capacity ) { return false; }
+
+  slot = __atomic_fetch_add( &h->count, 1u, __ATOMIC_RELAXED );
+  return slot < h->capacity;
+}
+
+bool mapped_hash_table::reserve_arena( uint64_t length, uint64_t& offset )
+{
+  auto* h = header();
+  if ( __atomic_load_n( &h->arena_used, __ATOMIC_RELAXED ) + length > h->arena_capacity ) { return false; }
+
+  offset = __atomic_fetch_add( &h->arena_used, length, __ATOMIC_RELAXED );
+  return offset + length <= h->arena_capacity;
+}
+
+unsigned mapped_hash_table::size() const
+{
+  return std::min( __atomic_load_n( &header()->count, __ATOMIC_RELAXED ), header()->capacity );
+}
+
+unsigned mapped_hash_table::capacity() const
+{
+  return header()->capacity;
+}
+
+uint64_t mapped_hash_table::arena_size() const
+{
+  return std::min( __atomic_load_n( &header()->arena_used, __ATOMIC_RELAXED ), header()->arena_capacity );
+}
+
+uint64_t mapped_hash_table::arena_capacity() const
+{
+  return header()->arena_capacity;
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
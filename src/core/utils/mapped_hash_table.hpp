@@ -0,0 +1,181 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file mapped_hash_table.hpp
+ *
+ * @brief Persistent append-only hash table in a memory-mapped file
+ *
+ * The file consists of a header, a power-of-two array of buckets,
+ * fixed-size records, and an optional arena for variable-length data.
+ * Records are appended and never changed or removed; each bucket is a
+ * singly linked list of records that grows by prepending new records
+ * with a compare-and-swap.  Several threads and processes can therefore
+ * read from and append to the same file concurrently without locks, only
+ * writing the header of a new file takes a file lock.  When the capacity
+ * of records or of the arena is exhausted, reservations fail.
+ *
+ * Record types must be standard layout and have a uint32_t member next,
+ * which holds the index + 1 of the next record in the bucket, 0
+ * terminates.  Keys are hashed with hash(), which must not change between
+ * runs (std::hash may).
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef MAPPED_HASH_TABLE_HPP
+#define MAPPED_HASH_TABLE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <core/utils/mapped_file.hpp>
+
+namespace cirkit
+{
+
+class mapped_hash_table
+{
+public:
+  /* opens or creates filename; capacity, arena_capacity, and user are
+     only used for new files, otherwise the header decides */
+  mapped_hash_table( const std::string& filename, uint64_t magic, uint32_t version, uint32_t record_size,
+                     unsigned capacity, uint64_t arena_capacity = 0u, uint64_t user = 0u );
+
+  /* identification of the file, records are only accessible if they
+     match the values passed to the constructor */
+  inline uint64_t magic() const   { return header()->magic; }
+  inline uint32_t version() const { return header()->version; }
+  inline uint64_t user() const    { return header()->user; }
+
+  static uint64_t hash( uint64_t key, uint64_t salt );
+
+  /* returns the first record in the bucket of hash that satisfies pred */
+  template<typename Record, typename Pred>
+  const Record* find( uint64_t hash, Pred&& pred ) const
+  {
+    auto index = __atomic_load_n( bucket( hash ), __ATOMIC_ACQUIRE );
+    while ( index != 0u )
+    {
+      const auto& r = record<Record>( index - 1u );
+      if ( pred( r ) )
+      {
+        return &r;
+      }
+      index = r.next;
+    }
+    return nullptr;
+  }
+
+  /* calls f( record ) for all published records */
+  template<typename Record, typename Fn>
+  void foreach_record( Fn&& f ) const
+  {
+    for ( auto b = 0u; b < header()->num_buckets; ++b )
+    {
+      auto index = __atomic_load_n( &buckets()[b], __ATOMIC_ACQUIRE );
+      while ( index != 0u )
+      {
+        const auto& r = record<Record>( index - 1u );
+        f( r );
+        index = r.next;
+      }
+    }
+  }
+
+  /* reserves space for a record (or length bytes in the arena), returns
+     false if the capacity is exhausted; reserved space is never reused */
+  bool reserve( uint32_t& slot );
+  bool reserve_arena( uint64_t length, uint64_t& offset );
+
+  /* makes the record in slot visible to find, must be called exactly once
+     after the record is written */
+  template<typename Record>
+  void publish( uint32_t slot, uint64_t hash )
+  {
+    auto& r = record<Record>( slot );
+    auto* b = bucket( hash );
+    auto head = __atomic_load_n( b, __ATOMIC_ACQUIRE );
+    do
+    {
+      r.next = head;
+    } while ( !__atomic_compare_exchange_n( b, &head, slot + 1u, true, __ATOMIC_RELEASE, __ATOMIC_ACQUIRE ) );
+  }
+
+  template<typename Record>
+  inline Record& record( uint32_t slot ) const
+  {
+    return reinterpret_cast<Record*>( records() )[slot];
+  }
+
+  inline char* arena() const { return records() + static_cast<std::size_t>( header()->capacity ) * header()->record_size; }
+
+  unsigned size() const;
+  unsigned capacity() const;
+  uint64_t arena_size() const;
+  uint64_t arena_capacity() const;
+
+private:
+  struct header_t
+  {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t num_buckets;
+    uint32_t capacity;
+    uint32_t count;
+    uint32_t reserved0;
+    uint64_t arena_capacity;
+    uint64_t arena_used;
+    uint64_t user;        /* owner-specific, e.g., canonization approach */
+    uint64_t reserved1;
+  };
+
+  static_assert( sizeof( header_t ) == 64u, "unexpected header size" );
+
+  inline header_t* header() const  { return reinterpret_cast<header_t*>( const_cast<char*>( file->data() ) ); }
+  inline uint32_t* buckets() const { return reinterpret_cast<uint32_t*>( header() + 1 ); }
+  inline char*     records() const { return reinterpret_cast<char*>( buckets() + header()->num_buckets ); }
+  inline uint32_t* bucket( uint64_t hash ) const { return &buckets()[hash & ( header()->num_buckets - 1u )]; }
+
+  void initialize( const std::string& filename, uint64_t magic, uint32_t version, uint32_t record_size,
+                   unsigned capacity, uint64_t arena_capacity, uint64_t user );
+
+private:
+  std::unique_ptr<mapped_file> file;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
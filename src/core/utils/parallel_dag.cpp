@@ -0,0 +1,234 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#include "parallel_dag.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include <core/utils/work_stealing_deque.hpp>
+
+namespace cirkit
+{
+
+/******************************************************************************
+ * Types                                                                      *
+ ******************************************************************************/
+
+/******************************************************************************
+ * Private functions                                                          *
+ ******************************************************************************/
+
+void sequential_dag_process( const dag_schedule& schedule, const std::function<void( unsigned )>& process )
+{
+  std::vector<unsigned> pending( schedule.num_nodes() );
+  std::vector<unsigned> stack;
+
+  for ( auto n = 0u; n < schedule.num_nodes(); ++n )
+  {
+    pending[n] = schedule.num_fanins( n );
+    if ( pending[n] == 0u ) { stack.push_back( n ); }
+  }
+
+  while ( !stack.empty() )
+  {
+    const auto n = stack.back();
+    stack.pop_back();
+
+    process( n );
+
+    for ( auto it = schedule.fanouts_begin( n ); it != schedule.fanouts_end( n ); ++it )
+    {
+      if ( --pending[*it] == 0u ) { stack.push_back( *it ); }
+    }
+  }
+}
+
+/******************************************************************************
+ * Public functions                                                           *
+ ******************************************************************************/
+
+dag_schedule::dag_schedule( unsigned num_nodes )
+  : _num_fanins( num_nodes, 0u ),
+    _offsets( num_nodes + 1u, 0u )
+{
+}
+
+void dag_schedule::add_edge( unsigned fanin, unsigned node )
+{
+  _edges.push_back( {fanin, node} );
+  ++_num_fanins[node];
+  ++_offsets[fanin + 1u];
+}
+
+void dag_schedule::finalize()
+{
+  for ( auto n = 0u; n < num_nodes(); ++n )
+  {
+    _offsets[n + 1u] += _offsets[n];
+  }
+
+  _fanouts.resize( _edges.size() + 1u );
+  std::vector<unsigned> pos( _offsets.begin(), _offsets.end() - 1 );
+  for ( const auto& e : _edges )
+  {
+    _fanouts[pos[e.first]++] = e.second;
+  }
+
+  _edges.clear();
+  _edges.shrink_to_fit();
+}
+
+void parallel_dag_process( const dag_schedule& schedule, const std::function<void( unsigned )>& process, unsigned num_threads )
+{
+  if ( num_threads == 0u )
+  {
+    num_threads = std::max( 1u, std::thread::hardware_concurrency() );
+  }
+
+  if ( num_threads == 1u || schedule.num_nodes() == 0u )
+  {
+    sequential_dag_process( schedule, process );
+    return;
+  }
+
+  const auto num_nodes = schedule.num_nodes();
+  std::unique_ptr<std::atomic<unsigned>[]> pending( new std::atomic<unsigned>[num_nodes] );
+  std::vector<std::unique_ptr<work_stealing_deque<unsigned>>> deques;
+  std::atomic<unsigned> remaining( num_nodes );
+
+  for ( auto i = 0u; i < num_threads; ++i )
+  {
+    deques.emplace_back( new work_stealing_deque<unsigned>() );
+  }
+
+  /* distribute initially ready nodes round-robin (before any worker starts) */
+  auto next = 0u;
+  for ( auto n = 0u; n < num_nodes; ++n )
+  {
+    pending[n].store( schedule.num_fanins( n ), std::memory_order_relaxed );
+    if ( schedule.num_fanins( n ) == 0u )
+    {
+      deques[next]->push( n );
+      next = ( next + 1u ) % num_threads;
+    }
+  }
+
+  /* the first exception thrown by process stops all workers and is rethrown */
+  std::atomic<bool>  stop( false );
+  std::exception_ptr exception;
+  std::mutex         exception_mutex;
+
+  const auto worker = [&]( unsigned id ) {
+    auto& own = *deques[id];
+    std::minstd_rand gen( id + 1u );
+    std::uniform_int_distribution<unsigned> victim( 0u, num_threads - 1u );
+
+    unsigned n;
+    while ( remaining.load( std::memory_order_acquire ) > 0u && !stop.load( std::memory_order_relaxed ) )
+    {
+      if ( !own.take( n ) )
+      {
+        const auto v = victim( gen );
+        if ( v == id || !deques[v]->steal( n ) )
+        {
+          std::this_thread::yield();
+          continue;
+        }
+      }
+
+      try
+      {
+        process( n );
+      }
+      catch ( ... )
+      {
+        std::lock_guard<std::mutex> lock( exception_mutex );
+        if ( !exception )
+        {
+          exception = std::current_exception();
+        }
+        stop.store( true, std::memory_order_relaxed );
+        return;
+      }
+
+      for ( auto it = schedule.fanouts_begin( n ); it != schedule.fanouts_end( n ); ++it )
+      {
+        /* acq_rel makes the results of all fanins visible to the last one decrementing */
+        if ( pending[*it].fetch_sub( 1u, std::memory_order_acq_rel ) == 1u )
+        {
+          own.push( *it );
+        }
+      }
+
+      remaining.fetch_sub( 1u, std::memory_order_release );
+    }
+  };
+
+  std::vector<std::thread> threads;
+  try
+  {
+    for ( auto i = 1u; i < num_threads; ++i )
+    {
+      threads.emplace_back( worker, i );
+    }
+  }
+  catch ( ... )
+  {
+    /* could not start all threads, stop the started ones and report the
+       failure (std::system_error) like thread_pool does */
+    stop.store( true, std::memory_order_relaxed );
+    for ( auto& t : threads )
+    {
+      t.join();
+    }
+    throw;
+  }
+  worker( 0u );
+
+  for ( auto& t : threads )
+  {
+    t.join();
+  }
+
+  if ( exception )
+  {
+    std::rethrow_exception( exception );
+  }
+}
+
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,94 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file parallel_dag.hpp
+ *
+ * @brief Parallel processing of directed acyclic graphs
+ *
+ * Processes all nodes of a DAG such that each node is processed after
+ * all its fanins.  A fixed number of workers is used, each owning a
+ * work-stealing deque.  Every node has a counter of unprocessed fanins;
+ * the worker that decrements it to zero pushes the node to its own
+ * deque, hence no thread ever blocks waiting for a fanin.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef PARALLEL_DAG_HPP
+#define PARALLEL_DAG_HPP
+
+#include <functional>
+#include <vector>
+
+namespace cirkit
+{
+
+/* DAG in compressed form (fanout lists and fanin counts) */
+class dag_schedule
+{
+public:
+  explicit dag_schedule( unsigned num_nodes );
+
+  /* all edges must be added before calling finalize */
+  void add_edge( unsigned fanin, unsigned node );
+  void finalize();
+
+  inline unsigned num_nodes() const                     { return _num_fanins.size(); }
+  inline unsigned num_fanins( unsigned node ) const     { return _num_fanins[node]; }
+  inline const unsigned* fanouts_begin( unsigned node ) const { return &_fanouts[_offsets[node]]; }
+  inline const unsigned* fanouts_end( unsigned node ) const   { return &_fanouts[0] + _offsets[node + 1u]; }
+
+private:
+  std::vector<unsigned>                     _num_fanins;
+  std::vector<std::pair<unsigned, unsigned>> _edges;
+  std::vector<unsigned>                     _offsets;
+  std::vector<unsigned>                     _fanouts;
+};
+
+/**
+ * @brief Processes all nodes of the schedule in parallel
+ *
+ * If process throws, no further nodes are started and the first exception
+ * is rethrown after all workers have finished.  If a worker thread cannot
+ * be started, std::system_error is thrown.
+ *
+ * @param process     Called exactly once for each node, after all its fanins
+ * @param num_threads Number of workers (0 means number of cores), with
+ *                    1 the nodes are processed in the calling thread
+ */
+void parallel_dag_process( const dag_schedule& schedule, const std::function<void( unsigned )>& process, unsigned num_threads = 0u );
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
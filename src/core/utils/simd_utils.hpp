@@ -0,0 +1,98 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file simd_utils.hpp
+ *
+ * @brief Helpers for SIMD kernels with runtime dispatch
+ *
+ * Kernels are compiled with function-level target attributes such that
+ * no global -mavx2 or -march flag is needed.  The available instruction
+ * set is queried once at runtime.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef SIMD_UTILS_HPP
+#define SIMD_UTILS_HPP
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define CIRKIT_SIMD_X86 1
+#define CIRKIT_TARGET_AVX2   __attribute__((target("avx2")))
+#define CIRKIT_TARGET_AVX512 __attribute__((target("avx512f")))
+#include <immintrin.h>
+#else
+#define CIRKIT_SIMD_X86 0
+#endif
+
+namespace cirkit
+{
+
+enum class simd_level { scalar, avx2, avx512 };
+
+inline simd_level simd_detect()
+{
+#if CIRKIT_SIMD_X86
+  static const auto level = []() {
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports( "avx512f" ) ) { return simd_level::avx512; }
+    if ( __builtin_cpu_supports( "avx2" ) )    { return simd_level::avx2; }
+    return simd_level::scalar;
+  }();
+  return level;
+#else
+  return simd_level::scalar;
+#endif
+}
+
+/* returns the requested level if supported, otherwise the best available one below */
+inline simd_level simd_select( simd_level requested )
+{
+  const auto available = simd_detect();
+  return static_cast<int>( requested ) <= static_cast<int>( available ) ? requested : available;
+}
+
+inline const char* simd_level_name( simd_level level )
+{
+  switch ( level )
+  {
+  case simd_level::scalar: return "scalar";
+  case simd_level::avx2:   return "avx2";
+  case simd_level::avx512: return "avx512";
+  }
+  return "unknown";
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
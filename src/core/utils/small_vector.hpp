@@ -0,0 +1,358 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file small_vector.hpp
+ *
+ * @brief Vector with inline storage for few elements
+ *
+ * Stores up to N elements inside the object and only allocates heap
+ * memory when more elements are added.  Elements must be trivially
+ * copyable, iterators are plain pointers.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+namespace cirkit
+{
+
+template<typename T, unsigned N>
+class small_vector
+{
+  static_assert( std::is_trivially_copyable<T>::value, "small_vector requires trivially copyable elements" );
+
+public:
+  using value_type             = T;
+  using size_type              = std::size_t;
+  using difference_type        = std::ptrdiff_t;
+  using reference              = T&;
+  using const_reference        = const T&;
+  using pointer                = T*;
+  using const_pointer          = const T*;
+  using iterator               = T*;
+  using const_iterator         = const T*;
+  using reverse_iterator       = std::reverse_iterator<iterator>;
+  using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+public:
+  small_vector() {}
+
+  small_vector( size_type n, const T& value = T() )
+  {
+    resize( n, value );
+  }
+
+  small_vector( std::initializer_list<T> init )
+  {
+    assign( init.begin(), init.end() );
+  }
+
+  template<typename InputIt, typename = typename std::iterator_traits<InputIt>::iterator_category>
+  small_vector( InputIt first, InputIt last )
+  {
+    assign( first, last );
+  }
+
+  small_vector( const std::vector<T>& v )
+  {
+    assign( v.begin(), v.end() );
+  }
+
+  small_vector( const small_vector& other )
+  {
+    assign( other.begin(), other.end() );
+  }
+
+  small_vector( small_vector&& other )
+  {
+    steal( other );
+  }
+
+  ~small_vector()
+  {
+    release();
+  }
+
+  small_vector& operator=( const small_vector& other )
+  {
+    if ( this != &other )
+    {
+      assign( other.begin(), other.end() );
+    }
+    return *this;
+  }
+
+  small_vector& operator=( small_vector&& other )
+  {
+    if ( this != &other )
+    {
+      release();
+      steal( other );
+    }
+    return *this;
+  }
+
+  small_vector& operator=( std::initializer_list<T> init )
+  {
+    assign( init.begin(), init.end() );
+    return *this;
+  }
+
+  operator std::vector<T>() const
+  {
+    return std::vector<T>( begin(), end() );
+  }
+
+  template<typename InputIt>
+  void assign( InputIt first, InputIt last )
+  {
+    clear();
+    for ( ; first != last; ++first )
+    {
+      push_back( *first );
+    }
+  }
+
+  /* element access */
+  inline reference       operator[]( size_type pos )       { return ptr[pos]; }
+  inline const_reference operator[]( size_type pos ) const { return ptr[pos]; }
+
+  reference at( size_type pos )
+  {
+    if ( pos >= _size ) { throw std::out_of_range( "small_vector::at" ); }
+    return ptr[pos];
+  }
+
+  const_reference at( size_type pos ) const
+  {
+    if ( pos >= _size ) { throw std::out_of_range( "small_vector::at" ); }
+    return ptr[pos];
+  }
+
+  inline reference       front()       { return ptr[0u]; }
+  inline const_reference front() const { return ptr[0u]; }
+  inline reference       back()        { return ptr[_size - 1u]; }
+  inline const_reference back() const  { return ptr[_size - 1u]; }
+  inline pointer         data()        { return ptr; }
+  inline const_pointer   data() const  { return ptr; }
+
+  /* iterators */
+  inline iterator               begin()         { return ptr; }
+  inline const_iterator         begin() const   { return ptr; }
+  inline const_iterator         cbegin() const  { return ptr; }
+  inline iterator               end()           { return ptr + _size; }
+  inline const_iterator         end() const     { return ptr + _size; }
+  inline const_iterator         cend() const    { return ptr + _size; }
+  inline reverse_iterator       rbegin()        { return reverse_iterator( end() ); }
+  inline const_reverse_iterator rbegin() const  { return const_reverse_iterator( end() ); }
+  inline reverse_iterator       rend()          { return reverse_iterator( begin() ); }
+  inline const_reverse_iterator rend() const    { return const_reverse_iterator( begin() ); }
+
+  /* capacity */
+  inline bool      empty() const    { return _size == 0u; }
+  inline size_type size() const     { return _size; }
+  inline size_type capacity() const { return _capacity; }
+  inline bool      is_inline() const { return ptr == inline_data(); }
+
+  void reserve( size_type n )
+  {
+    if ( n <= _capacity ) { return; }
+
+    auto* data = static_cast<T*>( ::operator new( n * sizeof( T ) ) );
+    std::memcpy( data, ptr, _size * sizeof( T ) );
+    if ( !is_inline() )
+    {
+      ::operator delete( ptr );
+    }
+    ptr = data;
+    _capacity = n;
+  }
+
+  /* modifiers */
+  inline void clear() { _size = 0u; }
+
+  void push_back( const T& value )
+  {
+    if ( _size == _capacity )
+    {
+      const auto copy = value; /* value may be an element of this vector */
+      reserve( 2u * _capacity );
+      ptr[_size++] = copy;
+    }
+    else
+    {
+      ptr[_size++] = value;
+    }
+  }
+
+  template<typename... Args>
+  void emplace_back( Args&&... args )
+  {
+    push_back( T( std::forward<Args>( args )... ) );
+  }
+
+  inline void pop_back() { --_size; }
+
+  iterator insert( const_iterator pos, const T& value )
+  {
+    const auto index = pos - ptr;
+    push_back( value );
+    std::rotate( ptr + index, ptr + _size - 1u, ptr + _size );
+    return ptr + index;
+  }
+
+  template<typename InputIt>
+  iterator insert( const_iterator pos, InputIt first, InputIt last )
+  {
+    /* [first, last) may point into this vector, copy it before growing */
+    const std::vector<T> values( first, last );
+    const auto index = pos - ptr;
+    const auto n = values.size();
+
+    if ( _size + n > _capacity )
+    {
+      reserve( std::max<size_type>( _size + n, 2u * _capacity ) );
+    }
+    std::memmove( ptr + index + n, ptr + index, ( _size - index ) * sizeof( T ) );
+    std::copy( values.begin(), values.end(), ptr + index );
+    _size += n;
+    return ptr + index;
+  }
+
+  iterator erase( const_iterator pos )
+  {
+    return erase( pos, pos + 1 );
+  }
+
+  iterator erase( const_iterator first, const_iterator last )
+  {
+    auto* f = ptr + ( first - ptr );
+    auto* l = ptr + ( last - ptr );
+    std::copy( l, end(), f );
+    _size -= ( l - f );
+    return f;
+  }
+
+  void resize( size_type n, const T& value = T() )
+  {
+    const auto copy = value; /* value may be an element of this vector */
+    reserve( n );
+    for ( auto i = _size; i < n; ++i )
+    {
+      ptr[i] = copy;
+    }
+    _size = n;
+  }
+
+  void swap( small_vector& other )
+  {
+    small_vector tmp( std::move( other ) );
+    other = std::move( *this );
+    *this = std::move( tmp );
+  }
+
+private:
+  inline T*       inline_data()       { return reinterpret_cast<T*>( &storage ); }
+  inline const T* inline_data() const { return reinterpret_cast<const T*>( &storage ); }
+
+  void release()
+  {
+    if ( !is_inline() )
+    {
+      ::operator delete( ptr );
+    }
+    ptr = inline_data();
+    _size = 0u;
+    _capacity = N;
+  }
+
+  void steal( small_vector& other )
+  {
+    if ( other.is_inline() )
+    {
+      std::memcpy( inline_data(), other.ptr, other._size * sizeof( T ) );
+      ptr = inline_data();
+      _capacity = N;
+    }
+    else
+    {
+      ptr = other.ptr;
+      _capacity = other._capacity;
+    }
+    _size = other._size;
+
+    other.ptr = other.inline_data();
+    other._size = 0u;
+    other._capacity = N;
+  }
+
+private:
+  typename std::aligned_storage<sizeof( T ) * N, alignof( T )>::type storage;
+  T*                                                             ptr = inline_data();
+  unsigned                                                       _size = 0u;
+  unsigned                                                       _capacity = N;
+};
+
+template<typename T, unsigned N>
+inline bool operator==( const small_vector<T, N>& a, const small_vector<T, N>& b )
+{
+  return a.size() == b.size() && std::equal( a.begin(), a.end(), b.begin() );
+}
+
+template<typename T, unsigned N>
+inline bool operator!=( const small_vector<T, N>& a, const small_vector<T, N>& b )
+{
+  return !( a == b );
+}
+
+template<typename T, unsigned N>
+inline bool operator<( const small_vector<T, N>& a, const small_vector<T, N>& b )
+{
+  return std::lexicographical_compare( a.begin(), a.end(), b.begin(), b.end() );
+}
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -33,10 +33,168 @@ namespace cirkit
  * Types                                                                      *
  ******************************************************************************/
 
+namespace detail
+{
+
+/* pool and deque index of the current thread, if it is a worker */
+thread_local void*    current_pool = nullptr;
+thread_local unsigned current_index = 0u;
+
+/* xorshift state for victim selection */
+thread_local unsigned steal_state = 0x9e3779b9u;
+
+}
+
 /******************************************************************************
  * Private functions                                                          *
  ******************************************************************************/
 
+void thread_pool::push( task_base* t )
+{
+  if ( _stop.load() )
+  {
+    delete t;
+    throw std::runtime_error( "enqueue on stopped thread_pool" );
+  }
+
+  _active.fetch_add( 1u );
+
+  if ( detail::current_pool == this )
+  {
+    _deques[detail::current_index]->push( t );
+  }
+  else
+  {
+    std::unique_lock<std::mutex> lock( _shared_mutex );
+    _shared.push_back( t );
+  }
+
+  _pending.fetch_add( 1u );
+
+  /* a sleeping worker increments _sleeping before checking _pending, so
+     one of both threads sees the other's update */
+  if ( _sleeping.load() > 0u )
+  {
+    {
+      std::unique_lock<std::mutex> lock( _sleep_mutex );
+    }
+    _sleep_condition.notify_one();
+  }
+}
+
+thread_pool::task_base* thread_pool::pop_local()
+{
+  task_base* t = nullptr;
+  if ( detail::current_pool == this && _deques[detail::current_index]->take( t ) )
+  {
+    return t;
+  }
+  return nullptr;
+}
+
+thread_pool::task_base* thread_pool::pop_shared()
+{
+  std::unique_lock<std::mutex> lock( _shared_mutex );
+  if ( _shared.empty() ) { return nullptr; }
+
+  auto* t = _shared.front();
+  _shared.pop_front();
+  return t;
+}
+
+thread_pool::task_base* thread_pool::steal()
+{
+  auto& s = detail::steal_state;
+  s ^= s << 13u; s ^= s >> 17u; s ^= s << 5u;
+
+  const unsigned n = _deques.size();
+  const unsigned start = s % n;
+
+  task_base* t = nullptr;
+  for ( auto i = 0u; i < n; ++i )
+  {
+    const auto victim = ( start + i ) % n;
+    if ( detail::current_pool == this && victim == detail::current_index ) { continue; }
+    if ( _deques[victim]->steal( t ) )
+    {
+      return t;
+    }
+  }
+  return nullptr;
+}
+
+thread_pool::task_base* thread_pool::find_task()
+{
+  task_base* t = pop_local();
+  if ( !t ) { t = pop_shared(); }
+  if ( !t ) { t = steal(); }
+  if ( t ) { _pending.fetch_sub( 1u ); }
+  return t;
+}
+
+void thread_pool::execute( task_base* t )
+{
+  auto* group = t->group;
+
+  try
+  {
+    t->run();
+  }
+  catch ( ... )
+  {
+    if ( group )
+    {
+      std::unique_lock<std::mutex> lock( group->_exception_mutex );
+      if ( !group->_exception )
+      {
+        group->_exception = std::current_exception();
+      }
+    }
+  }
+
+  delete t;
+
+  if ( group )
+  {
+    group->_count.fetch_sub( 1u, std::memory_order_acq_rel );
+  }
+  _active.fetch_sub( 1u );
+}
+
+void thread_pool::worker_loop( unsigned index )
+{
+  detail::current_pool = this;
+  detail::current_index = index;
+  detail::steal_state = 0x9e3779b9u * ( index + 1u );
+
+  auto idle = 0u;
+  while ( true )
+  {
+    if ( auto* t = find_task() )
+    {
+      execute( t );
+      idle = 0u;
+      continue;
+    }
+
+    if ( ++idle < 16u )
+    {
+      std::this_thread::yield();
+      continue;
+    }
+
+    _sleeping.fetch_add( 1u );
+    {
+      std::unique_lock<std::mutex> lock( _sleep_mutex );
+      _sleep_condition.wait( lock, [this]() { return _stop.load() || _pending.load() > 0u; } );
+    }
+    _sleeping.fetch_sub( 1u );
+    idle = 0u;
+
+    if ( _stop.load() ) { return; }
+  }
+}
+
 /******************************************************************************
  * Public functions                                                           *
  ******************************************************************************/
@@ -47,42 +205,76 @@ thread_pool::thread_pool()
 }
 
 thread_pool::thread_pool( unsigned num_threads )
+  : _pending( 0u ),
+    _active( 0u ),
+    _sleeping( 0u ),
+    _stop( false )
 {
+  num_threads = std::max( 1u, num_threads );
+
+  for ( auto i = 0u; i < num_threads; ++i )
+  {
+    _deques.emplace_back( new work_stealing_deque<task_base*>() );
+  }
+
   for ( auto i = 0u; i < num_threads; ++i )
   {
-    workers.emplace_back( [this] {
-        while ( true )
-        {
-          std::function<void()> task;
-
-          {
-            std::unique_lock<std::mutex> lock( this->queue_mutex );
-            this->condition.wait( lock,
-                                  [this]{ return this->stop || !this->tasks.empty(); } );
-            if ( this->stop && this->tasks.empty() ) { return; }
-            task = std::move( this->tasks.front() );
-            this->tasks.pop();
-          }
-          task();
-        }
-      });
+    _workers.emplace_back( [this, i]() { worker_loop( i ); } );
   }
 }
 
 thread_pool::~thread_pool()
 {
+  /* help until all tasks (including those spawned by tasks) are finished */
+  while ( _active.load() > 0u )
   {
-    std::unique_lock<std::mutex> lock( queue_mutex );
-    stop = true;
+    if ( auto* t = find_task() )
+    {
+      execute( t );
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
   }
 
-  condition.notify_all();
-  for ( auto& worker : workers )
+  {
+    std::unique_lock<std::mutex> lock( _sleep_mutex );
+    _stop = true;
+  }
+
+  _sleep_condition.notify_all();
+  for ( auto& worker : _workers )
   {
     worker.join();
   }
 }
 
+void thread_pool::wait( task_group& group )
+{
+  while ( !group.done() )
+  {
+    if ( auto* t = find_task() )
+    {
+      execute( t );
+    }
+    else
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  std::exception_ptr exception;
+  {
+    std::unique_lock<std::mutex> lock( group._exception_mutex );
+    std::swap( exception, group._exception );
+  }
+
+  if ( exception )
+  {
+    std::rethrow_exception( exception );
+  }
+}
 
 }
 
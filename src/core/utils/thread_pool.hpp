@@ -29,8 +29,15 @@
  *
  * @brief Thread pool
  *
- * based on an implementation of Jakob Progsch and Václav Zeman
- * (see copyright notice below)
+ * Work-stealing thread pool.  Each worker owns a lock-free deque (see
+ * work_stealing_deque.hpp); tasks submitted from a worker go to its own
+ * deque, tasks submitted from other threads go to a shared queue.  Idle
+ * workers steal from random victims.  Threads that wait for a task group
+ * execute pending tasks meanwhile, which allows nested parallelism
+ * without deadlocks.
+ *
+ * The future-based enqueue interface is based on an implementation of
+ * Jakob Progsch and Václav Zeman (see copyright notice below)
  * https://github.com/progschj/ThreadPool
  *
  * @author Mathias Soeken
@@ -40,58 +47,174 @@
 #ifndef THREAD_POOL_HPP
 #define THREAD_POOL_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <exception>
 #include <functional>
 #include <future>
+#include <iterator>
 #include <memory>
 #include <mutex>
-#include <queue>
+#include <stdexcept>
 #include <thread>
 #include <vector>
 
+#include <core/utils/work_stealing_deque.hpp>
+
 namespace cirkit
 {
 
+/* counts unfinished tasks and keeps the first exception thrown by one of
+   them, see thread_pool::wait */
+class task_group
+{
+public:
+  task_group() : _count( 0u ) {}
+
+  task_group( const task_group& ) = delete;
+  task_group& operator=( const task_group& ) = delete;
+
+  inline bool done() const { return _count.load( std::memory_order_acquire ) == 0u; }
+
+private:
+  friend class thread_pool;
+  std::atomic<unsigned> _count;
+  std::exception_ptr    _exception;
+  std::mutex            _exception_mutex;
+};
+
 class thread_pool
 {
 public:
   /* number of threads is the same as number of cores */
   thread_pool();
   thread_pool( unsigned num_threads );
+
+  /* executes all remaining tasks before joining the workers */
   ~thread_pool();
 
+  inline unsigned num_threads() const { return _workers.size(); }
+
+  /* fire-and-forget, exceptions thrown by f are dropped */
+  template<class F>
+  void submit( F&& f )
+  {
+    push( new task<typename std::decay<F>::type>( std::forward<F>( f ), nullptr ) );
+  }
+
+  template<class F>
+  void submit( task_group& group, F&& f )
+  {
+    group._count.fetch_add( 1u, std::memory_order_relaxed );
+    push( new task<typename std::decay<F>::type>( std::forward<F>( f ), &group ) );
+  }
+
+  /* waits until all tasks of the group are finished, executes other tasks meanwhile;
+     rethrows the first exception thrown by a task of the group */
+  void wait( task_group& group );
+
   template<class F, class... Args>
   auto enqueue( F&& f, Args&&... args ) -> std::future<typename std::result_of<F(Args...)>::type>
   {
     using return_type = typename std::result_of<F(Args...)>::type;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    auto t = std::make_shared<std::packaged_task<return_type()>>(
         std::bind( std::forward<F>( f ), std::forward<Args>( args )... )
       );
 
-    std::future<return_type> res = task->get_future();
-    {
-      std::unique_lock<std::mutex> lock( queue_mutex );
+    std::future<return_type> res = t->get_future();
+    submit( [t]() { (*t)(); } );
+    return res;
+  }
 
-      /* don't allow enqueueing after stopping the pool */
-      if ( stop )
-      {
-        throw std::runtime_error( "enqueue on stopped thread pool" );
-      }
+  /**
+   * @brief Calls f( i ) for all i in [begin, end)
+   *
+   * The range is split into chunks of grain_size indexes, each chunk is one
+   * task.  If grain_size is 0, a grain size is chosen that yields about
+   * 8 chunks per thread.  Returns after all calls are finished; if calls
+   * throw, the first exception is rethrown and the remaining calls of the
+   * throwing chunk are skipped.
+   */
+  template<class Index, class F>
+  void parallel_for( Index begin, Index end, F&& f, Index grain_size = Index( 0 ) )
+  {
+    if ( begin >= end ) { return; }
 
-      tasks.emplace( [task]() { (*task)(); } );
+    const Index size = end - begin;
+    if ( grain_size == Index( 0 ) )
+    {
+      grain_size = std::max( Index( 1 ), Index( size / ( 8u * std::max( 1u, num_threads() ) ) ) );
     }
 
-    condition.notify_one();
-    return res;
+    task_group group;
+    auto* fn = &f;
+    for ( Index b = begin; b < end; b = ( end - b > grain_size ) ? b + grain_size : end )
+    {
+      const Index e = ( end - b > grain_size ) ? b + grain_size : end;
+      submit( group, [fn, b, e]() {
+          for ( Index i = b; i < e; ++i )
+          {
+            ( *fn )( i );
+          }
+        } );
+    }
+    wait( group );
   }
 
+  /* calls f( *it ) for all elements in [first, last), requires random access iterators */
+  template<class Iterator, class F>
+  void parallel_for_each( Iterator first, Iterator last, F&& f, std::size_t grain_size = 0u )
+  {
+    using difference_type = typename std::iterator_traits<Iterator>::difference_type;
+    auto* fn = &f;
+    parallel_for<difference_type>( 0, std::distance( first, last ), [fn, first]( difference_type i ) { ( *fn )( *( first + i ) ); }, grain_size );
+  }
+
+private:
+  struct task_base
+  {
+    explicit task_base( task_group* group ) : group( group ) {}
+    virtual ~task_base() {}
+    virtual void run() = 0;
+
+    task_group* group;
+  };
+
+  template<class F>
+  struct task : public task_base
+  {
+    task( F&& f, task_group* group ) : task_base( group ), f( std::move( f ) ) {}
+    task( const F& f, task_group* group ) : task_base( group ), f( f ) {}
+    void run() { f(); }
+
+    F f;
+  };
+
+  void push( task_base* t );
+  task_base* pop_local();
+  task_base* pop_shared();
+  task_base* steal();
+  task_base* find_task();
+  void execute( task_base* t );
+  void worker_loop( unsigned index );
+
 private:
-  std::vector<std::thread>          workers;
-  std::queue<std::function<void()>> tasks;
-  std::mutex                        queue_mutex;
-  std::condition_variable           condition;
-  bool                              stop = false;
+  std::vector<std::thread>                                     _workers;
+  std::vector<std::unique_ptr<work_stealing_deque<task_base*>>> _deques;
+
+  /* tasks submitted from threads that are not workers of this pool */
+  std::deque<task_base*>                                       _shared;
+  std::mutex                                                   _shared_mutex;
+
+  std::atomic<unsigned>                                        _pending;   /* submitted, not started */
+  std::atomic<unsigned>                                        _active;    /* submitted, not finished */
+  std::atomic<unsigned>                                        _sleeping;
+  std::mutex                                                   _sleep_mutex;
+  std::condition_variable                                      _sleep_condition;
+  std::atomic<bool>                                            _stop;
 };
 
 }
@@ -168,6 +168,32 @@ private:
   double* runtime;
 };
 
+/* like increment_timer, but adds wall time, useful when work is spread over several threads */
+class increment_wall_timer : public boost::timer::cpu_timer
+{
+public:
+  increment_wall_timer( double* runtime ) : runtime( runtime )
+  {
+    start();
+  };
+
+  ~increment_wall_timer()
+  {
+    if ( !is_stopped() )
+    {
+      stop();
+      if ( runtime )
+      {
+        const double sec = 1000000000.0L;
+        *runtime += elapsed().wall / sec;
+      }
+    }
+  }
+
+private:
+  double* runtime;
+};
+
 }
 
 #endif
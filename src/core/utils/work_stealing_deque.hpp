@@ -0,0 +1,191 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+/**
+ * @file work_stealing_deque.hpp
+ *
+ * @brief Lock-free work-stealing deque
+ *
+ * Chase-Lev deque following the C11 formulation of Lê, Pop, Cohen, and
+ * Zappa Nardelli, ``Correct and efficient work-stealing for weak memory
+ * models'', PPoPP 2013.  The owner thread pushes and takes at the bottom,
+ * all other threads steal from the top.  Elements must be trivially
+ * copyable (e.g., indexes or pointers).  Arrays that are replaced when
+ * the deque grows are kept until destruction, since thieves may still
+ * read from them.
+ *
+ * @author Mathias Soeken
+ * @since  2.3
+ */
+
+#ifndef WORK_STEALING_DEQUE_HPP
+#define WORK_STEALING_DEQUE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace cirkit
+{
+
+template<typename T>
+class work_stealing_deque
+{
+public:
+  explicit work_stealing_deque( unsigned log_capacity = 10u )
+    : _top( 0 ),
+      _bottom( 0 )
+  {
+    _arrays.emplace_back( new circular_array( log_capacity ) );
+    _array.store( _arrays.back().get(), std::memory_order_relaxed );
+  }
+
+  work_stealing_deque( const work_stealing_deque& ) = delete;
+  work_stealing_deque& operator=( const work_stealing_deque& ) = delete;
+
+  /* owner only */
+  void push( T item )
+  {
+    const auto b = _bottom.load( std::memory_order_relaxed );
+    const auto t = _top.load( std::memory_order_acquire );
+    auto a = _array.load( std::memory_order_relaxed );
+
+    if ( b - t > a->capacity() - 1 )
+    {
+      a = grow( a, b, t );
+    }
+
+    a->put( b, item );
+    std::atomic_thread_fence( std::memory_order_release );
+    _bottom.store( b + 1, std::memory_order_relaxed );
+  }
+
+  /* owner only */
+  bool take( T& item )
+  {
+    const auto b = _bottom.load( std::memory_order_relaxed ) - 1;
+    auto a = _array.load( std::memory_order_relaxed );
+    _bottom.store( b, std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    auto t = _top.load( std::memory_order_relaxed );
+
+    if ( t > b )
+    {
+      /* empty */
+      _bottom.store( b + 1, std::memory_order_relaxed );
+      return false;
+    }
+
+    item = a->get( b );
+    if ( t == b )
+    {
+      /* last element, race against thieves */
+      const auto won = _top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+      _bottom.store( b + 1, std::memory_order_relaxed );
+      return won;
+    }
+
+    return true;
+  }
+
+  /* any thread */
+  bool steal( T& item )
+  {
+    auto t = _top.load( std::memory_order_acquire );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    const auto b = _bottom.load( std::memory_order_acquire );
+
+    if ( t >= b ) { return false; }
+
+    /* consume ordering is promoted to acquire by all relevant compilers */
+    const auto a = _array.load( std::memory_order_acquire );
+    item = a->get( t );
+    return _top.compare_exchange_strong( t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed );
+  }
+
+  /* approximation, only exact if called by the owner while no thread steals */
+  inline bool empty() const
+  {
+    return _bottom.load( std::memory_order_relaxed ) <= _top.load( std::memory_order_relaxed );
+  }
+
+private:
+  class circular_array
+  {
+  public:
+    explicit circular_array( unsigned log_capacity )
+      : _mask( ( std::int64_t( 1 ) << log_capacity ) - 1 ),
+        _log_capacity( log_capacity ),
+        _items( new std::atomic<T>[std::size_t( 1u ) << log_capacity] )
+    {
+    }
+
+    inline std::int64_t capacity() const { return _mask + 1; }
+    inline unsigned log_capacity() const { return _log_capacity; }
+
+    inline T get( std::int64_t i ) const       { return _items[i & _mask].load( std::memory_order_relaxed ); }
+    inline void put( std::int64_t i, T item )  { _items[i & _mask].store( item, std::memory_order_relaxed ); }
+
+  private:
+    std::int64_t                     _mask;
+    unsigned                         _log_capacity;
+    std::unique_ptr<std::atomic<T>[]> _items;
+  };
+
+  circular_array* grow( circular_array* a, std::int64_t b, std::int64_t t )
+  {
+    _arrays.emplace_back( new circular_array( a->log_capacity() + 1u ) );
+    const auto na = _arrays.back().get();
+
+    for ( auto i = t; i < b; ++i )
+    {
+      na->put( i, a->get( i ) );
+    }
+
+    _array.store( na, std::memory_order_release );
+    return na;
+  }
+
+private:
+  /* top and bottom are on separate cache lines to avoid false sharing between owner and thieves */
+  std::atomic<std::int64_t>                    _top;
+  char                                         _pad0[64 - sizeof( std::atomic<std::int64_t> )];
+  std::atomic<std::int64_t>                    _bottom;
+  char                                         _pad1[64 - sizeof( std::atomic<std::int64_t> )];
+  std::atomic<circular_array*>                 _array;
+  std::vector<std::unique_ptr<circular_array>> _arrays;
+};
+
+}
+
+#endif
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End:
@@ -0,0 +1,124 @@
+/* CirKit: A circuit toolkit
+ * Copyright (C) 2009-2015  University of Bremen
+ * Copyright (C) 2015-2017  EPFL
+ *
+ * Permission is hereby granted, free of charge, to any person
+ * obtaining a copy of this software and associated documentation
+ * files (the "Software"), to deal in the Software without
+ * restriction, including without limitation the rights to use,
+ * copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following
+ * conditions:
+ *
+ * The above copyright notice and this permission notice shall be
+ * included in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+ * EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES
+ * OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+ * NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,
+ * WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR
+ * OTHER DEALINGS IN THE SOFTWARE.
+ */
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE thread_pool
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include <core/utils/thread_pool.hpp>
+
+using namespace cirkit;
+
+BOOST_AUTO_TEST_CASE(simple)
+{
+  thread_pool pool( 4u );
+
+  auto f = pool.enqueue( []( int a, int b ) { return a + b; }, 20, 22 );
+  BOOST_CHECK_EQUAL( f.get(), 42 );
+
+  std::vector<unsigned> v( 10000u, 0u );
+  pool.parallel_for( 0u, 10000u, [&v]( unsigned i ) { v[i] = i; } );
+  for ( auto i = 0u; i < v.size(); ++i )
+  {
+    BOOST_CHECK_EQUAL( v[i], i );
+  }
+}
+
+BOOST_AUTO_TEST_CASE(nested)
+{
+  thread_pool pool( 2u );
+
+  /* tasks that wait for subtasks must not deadlock the pool */
+  std::atomic<unsigned> sum( 0u );
+  pool.parallel_for( 0u, 16u, [&]( unsigned i ) {
+      task_group group;
+      for ( auto j = 0u; j < 16u; ++j )
+      {
+        pool.submit( group, [&sum, i, j]() { sum += i * 16u + j; } );
+      }
+      pool.wait( group );
+    }, 1u );
+
+  BOOST_CHECK_EQUAL( sum.load(), 255u * 256u / 2u );
+}
+
+BOOST_AUTO_TEST_CASE(destructor)
+{
+  std::atomic<unsigned> count( 0u );
+  {
+    thread_pool pool( 3u );
+    for ( auto i = 0u; i < 1000u; ++i )
+    {
+      pool.submit( [&count]() { ++count; } );
+    }
+  }
+  BOOST_CHECK_EQUAL( count.load(), 1000u );
+}
+
+BOOST_AUTO_TEST_CASE(exceptions)
+{
+  thread_pool pool( 4u );
+
+  /* the exception is rethrown by wait and the other tasks still finish */
+  std::atomic<unsigned> count( 0u );
+  task_group group;
+  for ( auto i = 0u; i < 100u; ++i )
+  {
+    pool.submit( group, [&count, i]() {
+        if ( i == 42u ) { throw std::runtime_error( "task 42" ); }
+        ++count;
+      } );
+  }
+  BOOST_CHECK_THROW( pool.wait( group ), std::runtime_error );
+  BOOST_CHECK( group.done() );
+  BOOST_CHECK_EQUAL( count.load(), 99u );
+
+  /* the exception is consumed, the group can be reused */
+  pool.submit( group, [&count]() { ++count; } );
+  pool.wait( group );
+  BOOST_CHECK_EQUAL( count.load(), 100u );
+
+  BOOST_CHECK_THROW( pool.parallel_for( 0u, 1000u, []( unsigned i ) { if ( i % 100u == 7u ) { throw std::logic_error( "call" ); } } ), std::logic_error );
+
+  /* the pool is still usable */
+  auto f = pool.enqueue( []() { return 42; } );
+  BOOST_CHECK_EQUAL( f.get(), 42 );
+
+  auto g = pool.enqueue( []() -> int { throw std::runtime_error( "enqueue" ); } );
+  BOOST_CHECK_THROW( g.get(), std::runtime_error );
+}
+
+// Local Variables:
+// c-basic-offset: 2
+// eval: (c-set-offset 'substatement-open 0)
+// eval: (c-set-offset 'innamespace 0)
+// End: